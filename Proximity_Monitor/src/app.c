@@ -56,18 +56,22 @@
 #include "app.h"
 #include "definitions.h"
 #include "app_ble.h"
+#include "ble_dm/ble_dm.h"
 #include "ble_pxpm/ble_pxpm.h"
 #include "ble_tps/ble_tps.h"
 #include "ble_ias/ble_ias.h"
 #include "ble_lls/ble_lls.h"
+#include "app_pxpm_ctx.h"
+#include "app_scan_sched.h"
+#include "app_cl_prox.h"
+#include "app_log/app_log.h"
+#include "app_uart/app_uart.h"
 
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Data Definitions
 // *****************************************************************************
 // *****************************************************************************
-extern uint16_t conn_hdl;
-extern uint8_t  zone_Entered;
 uint8_t cnt;
 // *****************************************************************************
 /* Application Data
@@ -89,8 +93,6 @@ APP_DATA appData;
 // Section: Application Callback Functions
 // *****************************************************************************
 // *****************************************************************************
-BLE_PXPM_AlertLevel_T current_zone=BLE_PXPM_ALERT_LEVEL_NO;
-BLE_PXPM_AlertLevel_T level=BLE_PXPM_ALERT_LEVEL_NO;
 /* TODO:  Add any necessary callback functions.
 */
 
@@ -101,26 +103,61 @@ BLE_PXPM_AlertLevel_T level=BLE_PXPM_ALERT_LEVEL_NO;
 // *****************************************************************************
 void IAS_update(uint16_t conn_handle,uint8_t  alert_level)
 {
-    if(current_zone!=alert_level)
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(conn_handle);
+
+    uint32_t latency;
+
+    if ((p_ctx != NULL) && (p_ctx->iasLevel != alert_level))
     {
-        current_zone=alert_level;
-        BLE_PXPM_WriteIasAlertLevel(conn_handle,current_zone);
-        printf("Zone Entered:%d\r\n",alert_level);
+        p_ctx->iasLevel = alert_level;
+        BLE_PXPM_WriteIasAlertLevel(conn_handle,(BLE_PXPM_AlertLevel_T)alert_level);
+        APP_LOG2(APP_LOG_ID_ZONE_ENTERED, p_ctx->index, alert_level);
+
+        if (APP_PXPM_CTX_TakeZoneLatency(p_ctx, &latency))
+        {
+            APP_LOG3(APP_LOG_ID_ZONE_LATENCY, p_ctx->index, latency, p_ctx->zoneLatencyMax);
+        }
+
+        //Open the rate limit window; changes until it closes are written by the timer expiry
+        if (APP_PXPM_CTX_IAS_MIN_INTERVAL != 0)
+        {
+            APP_TIMER_SetTimer(p_ctx->timerId, APP_PXPM_CTX_IAS_MIN_INTERVAL, false);
+        }
     }
 
 }
 /* TODO:  Add any necessary local functions.
 */
-void user_btn_cb( uintptr_t context)
+void LLS_update(void)
 {
+   APP_PXPM_Ctx_T *p_ctx;
+   uint8_t i;
+
    cnt++;
    if(cnt>2)
    {
        cnt=0;
    }
-   level=cnt;
-   BLE_PXPM_WriteLlsAlertLevel(conn_hdl,level);
-   printf("LLS level:%d\r\n",cnt);
+   for (i = 0; i < APP_PXPM_CTX_MAX_NUM; i++)
+   {
+       p_ctx = APP_PXPM_CTX_GetByIndex(i);
+       if ((p_ctx != NULL) && (p_ctx->state == APP_PXPM_CTX_STATE_MONITORING))
+       {
+           p_ctx->llsLevel = cnt;
+           BLE_PXPM_WriteLlsAlertLevel(p_ctx->connHandle,(BLE_PXPM_AlertLevel_T)cnt);
+       }
+   }
+   APP_LOG1(APP_LOG_ID_LLS_LEVEL, cnt);
+}
+
+void user_btn_cb( uintptr_t context)
+{
+   APP_Msg_T appMsg;
+
+   //EIC interrupt context, the contexts and the PXPM write queue belong to the application task
+   appMsg.msgId = APP_MSG_BTN_EVT;
+   appMsg.msgLen = 0;
+   (void)OSAL_QUEUE_SendISR(&appData.appQueue, &appMsg);
 }
 // *****************************************************************************
 // *****************************************************************************
@@ -141,8 +178,11 @@ void APP_Initialize ( void )
     /* Place the App state machine in its initial state. */
     appData.state = APP_STATE_INIT;
 
+    APP_UART_Init();
+    APP_LOG_Init();
 
-    appData.appQueue = xQueueCreate( 64, sizeof(APP_Msg_T) );
+    appData.appQueue = xQueueCreate( APP_MSG_QUEUE_LEN, sizeof(APP_Msg_T) );
+    APP_TIMER_Init();
     /* TODO: Initialize your application's state machine and other
      * parameters.
      */
@@ -175,8 +215,9 @@ void APP_Tasks ( void )
             BLE_IAS_Add();
             BLE_LLS_Add();
             BLE_TPS_Add();
-            BLE_GAP_SetScanningEnable(true, BLE_GAP_SCAN_FD_ENABLE, BLE_GAP_SCAN_MODE_OBSERVER, 1000);
-            printf("[BLE] Started Scanning!!!\r\n");
+            APP_PXPM_CTX_Init();
+            APP_SCAN_SCHED_StartBurst(BLE_DM_PEER_DEV_ID_INVALID);
+            APP_LOG0(APP_LOG_ID_SCAN_STARTED);
             EIC_CallbackRegister(EIC_PIN_0,user_btn_cb,0);
             if (appInitialized)
             {
@@ -199,19 +240,80 @@ void APP_Tasks ( void )
                     // Pass BLE LOG Event Message to User Application for handling
                     APP_BleStackLogHandler((BT_SYS_LogEvent_T *)p_appMsg->msgData);
                 }
-                else if(p_appMsg->msgId==APP_TIMER_ID_0_MSG)
+                else if(p_appMsg->msgId==APP_MSG_RSSI_EVT)
                 {
-                    // Pass BLE LOG Event Message to User Application for handling
-                    IAS_update(conn_hdl,zone_Entered);
+                    APP_ZONE_EST_SampleLinks();
+                }
+                else if(p_appMsg->msgId==APP_MSG_ZONE_EVT)
+                {
+                    APP_PXPM_CTX_ZoneEvtHandler((APP_PXPM_CtxZoneEvt_T *)p_appMsg->msgData);
+                }
+                else if(p_appMsg->msgId==APP_MSG_BTN_EVT)
+                {
+                    LLS_update();
+                }
+                else if(p_appMsg->msgId==APP_MSG_CONNECT_TIMEOUT)
+                {
+                    result = APP_PXPM_CTX_ConnectTimeoutHandler();
+                    APP_LOG1(APP_LOG_ID_CONNECT_TIMEOUT, result);
+                }
+#if APP_BLE_CONNECTIONLESS
+                else if(p_appMsg->msgId==APP_MSG_PERI_ADV_EVT)
+                {
+                    APP_CL_PROX_SampleHandler((APP_ClProxSample_T *)p_appMsg->msgData);
+                }
+#endif
+                else if(p_appMsg->msgId==APP_MSG_TIMER_EVT)
+                {
+                    uint32_t expired = APP_TIMER_GetExpired();
+                    uint8_t timerId;
+
+                    // Each monitored reporter owns the IAS rate limit timer matching its context index
+                    for (timerId = 0; expired != 0; timerId++, expired >>= 1)
+                    {
+                        APP_PXPM_Ctx_T *p_ctx;
+
+                        if ((expired & 0x01) == 0)
+                        {
+                            continue;
+                        }
+
+                        p_ctx = APP_PXPM_CTX_GetByIndex(timerId);
+                        if (p_ctx != NULL)
+                        {
+                            IAS_update(p_ctx->connHandle,p_ctx->zone);
+                        }
+                    }
                 }
                 else if(p_appMsg->msgId == APP_MSG_BLE_SCAN_EVT)
                 {
                     uint16_t connStatus;
-                    BLE_GAP_EvtAdvReport_T addrDevAddr;
+                    APP_BleScanEvt_T addrDevAddr;
+#if APP_BLE_EXT_API
+                    BLE_GAP_ExtCreateConnPhy_T createConnPhy_t;
+                    BLE_GAP_ExtCreateConnParams_T *p_connPhy;
+#else
                     BLE_GAP_CreateConnParams_T createConnParam_t;
+#endif
+
+                    // One connection is created at a time, up to the link budget
+                    if (APP_PXPM_CTX_CanConnect())
+                    {
+                        memcpy(&addrDevAddr, p_appMsg->msgData, sizeof(APP_BleScanEvt_T));
                     
-                        memcpy(&addrDevAddr, &p_appMsg->msgData, sizeof(BLE_GAP_EvtAdvReport_T));
-                    
+#if APP_BLE_EXT_API
+                        // The reporter was found on APP_BLE_EXT_PHY, initiate on that PHY only
+                        memset(&createConnPhy_t, 0, sizeof(BLE_GAP_ExtCreateConnPhy_T));
+                        p_connPhy = (APP_BLE_EXT_PHY == BLE_GAP_PHY_TYPE_LE_CODED) ? &createConnPhy_t.leCodedPhy : &createConnPhy_t.le1mPhy;
+                        p_connPhy->enable = true;
+                        p_connPhy->scanInterval = 0x3C; // 37.5 ms
+                        p_connPhy->scanWindow = 0x1E; // 18.75 ms
+                        p_connPhy->connParams.intervalMin = 0x10; // 20ms
+                        p_connPhy->connParams.intervalMax = 0x10; // 20ms
+                        p_connPhy->connParams.latency = 0;
+                        p_connPhy->connParams.supervisionTimeout = 0x48; // 720ms
+                        connStatus = BLE_GAP_ExtCreateConnection(BLE_GAP_INIT_FP_FILTER_ACCEPT_LIST_NOT_USED, &addrDevAddr.addr, &createConnPhy_t);
+#else
                         createConnParam_t.scanInterval = 0x3C; // 37.5 ms 
                         createConnParam_t.scanWindow = 0x1E; // 18.75 ms
                         createConnParam_t.filterPolicy = BLE_GAP_SCAN_FP_ACCEPT_ALL;
@@ -222,47 +324,47 @@ void APP_Tasks ( void )
                         createConnParam_t.connParams.latency = 0;
                         createConnParam_t.connParams.supervisionTimeout = 0x48; // 720ms
                         connStatus = BLE_GAP_CreateConnection(&createConnParam_t);
-                        printf("Connecting to BLE Device: RSSI:%ddBm, ", addrDevAddr.rssi);
+#endif
+                        APP_LOG1(APP_LOG_ID_CONNECTING, addrDevAddr.rssi);
                         if(connStatus == MBA_RES_SUCCESS)
                         {
-                            printf(" - Success\r\n");
+                            APP_PXPM_CTX_SetConnecting(true);
+                            APP_LOG0(APP_LOG_ID_CONNECTING_SUCCESS);
                         }
                         else
                         {
-                            printf(" - Failed: 0x%X\r\n", connStatus);
+                            APP_LOG1(APP_LOG_ID_CONNECTING_FAILED, connStatus);
                         }
+                    }
                 }
                 else if(p_appMsg->msgId==APP_MSG_CONNECT_CB)
                 {
                     APP_Msg_T appMsg;
-                   // Create an instance of the BLE_GAP_SetPathLossReportingParams_T structure
-                    BLE_GAP_SetPathLossReportingParams_T params;
-
-                        // Fill in the structure fields with appropriate values
-                    params.connHandle = conn_hdl/* Set the connection handle */;
-                    params.highThreshold = 55 /* Set the high threshold */;
-                    params.highHysteresis = 5/* Set the high hysteresis */;
-                    params.lowThreshold = 30/* Set the low threshold */;
-                    params.lowHysteresis = 5/* Set the low hysteresis */;
-                    params.minTimeSpent = 3/* Set the minimum time spent */;
-                   result = BLE_GAP_SetPathLossReportingParams(&params);
-                   if(result == 0)
-                   {
-                       appMsg.msgId = APP_MSG_PATHLOSS_CB;
-                       
-                       OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
-                   }
-                   else
-                   {
-                       appMsg.msgId = APP_MSG_CONNECT_CB;
-                       
-                       OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
-                   }
-                }      
-               else if(p_appMsg->msgId==APP_MSG_PATHLOSS_CB)
+                    APP_PXPM_Ctx_T *p_ctx;
+                    uint16_t connHandle;
+
+                    memcpy(&connHandle, p_appMsg->msgData, sizeof(uint16_t));
+                    p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+                    if (p_ctx != NULL)
+                    {
+                        result = BLE_GAP_SetPathLossReportingParams(&p_ctx->pathLossParams);
+                        appMsg.msgId = (result == MBA_RES_SUCCESS) ? APP_MSG_PATHLOSS_CB : APP_MSG_CONNECT_CB;
+                        appMsg.msgLen = sizeof(uint16_t);
+                        memcpy(appMsg.msgData, &connHandle, sizeof(uint16_t));
+
+                        OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+                    }
+                }
+                else if(p_appMsg->msgId==APP_MSG_PATHLOSS_CB)
                 {
-                    result = BLE_GAP_SetPathLossReportingEnable(conn_hdl, 0x01);
-                } 
+                    uint16_t connHandle;
+
+                    memcpy(&connHandle, p_appMsg->msgData, sizeof(uint16_t));
+                    if (APP_PXPM_CTX_GetByHandle(connHandle) != NULL)
+                    {
+                        result = BLE_GAP_SetPathLossReportingEnable(connHandle, 0x01);
+                    }
+                }
             }
             break;
         }
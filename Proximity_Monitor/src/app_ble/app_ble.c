@@ -50,6 +50,14 @@
 
 
 #include "app_pxpm_handler.h"
+#include "app_ble_evt_pool.h"
+#include "app_ble_scan_filter.h"
+#include "app_gatt_cache.h"
+#include "app_pxpm_ctx.h"
+#include "app_scan_sched.h"
+#include "app_link_opt.h"
+#include "app_cl_prox.h"
+#include "ble_util/ble_conn_reg.h"
 
 
 
@@ -65,6 +73,25 @@
 
 #define GAP_DEV_NAME_VALUE          "Microchip"
 
+#define APP_BLE_DISPATCH_EVT_NUM    (32U)               /**< Event IDs of a group with a dispatch entry, higher ones go to every subscriber. */
+#define APP_BLE_DISPATCH_EVT_ALL    (0xFFFFFFFFUL)
+
+/**@brief Stack event subscribers, in dispatch order: handler and the BLE GAP, BLE L2CAP, BLE SMP and GATT events it consumes.
+ *        At most 8 subscribers. The connection registry must stay first so that every later subscriber can resolve a new connection,
+ *        and its release last so that every earlier subscriber can still resolve a terminated one. */
+#define APP_BLE_DISPATCH_TABLE \
+    APP_BLE_DISPATCH_SUB(BLE_CONN_REG_BleEventHandler,      BLE_CONN_REG_GAP_EVT_MASK,      0,                          0,                          0) \
+    APP_BLE_DISPATCH_SUB(app_ble_AppEvtHandler,             APP_BLE_DISPATCH_EVT_ALL,       APP_BLE_DISPATCH_EVT_ALL,   APP_BLE_DISPATCH_EVT_ALL,   APP_BLE_DISPATCH_EVT_ALL) \
+    APP_BLE_DISPATCH_SUB(BLE_DM_BleEventHandler,            BLE_DM_GAP_EVT_MASK,            BLE_DM_L2CAP_EVT_MASK,      BLE_DM_SMP_EVT_MASK,        0) \
+    APP_BLE_DISPATCH_SUB(app_ble_DdEvtHandler,              (BLE_DD_GAP_EVT_MASK | APP_GATT_CACHE_GAP_EVT_MASK), 0, 0,                          BLE_DD_GATT_EVT_MASK) \
+    APP_BLE_DISPATCH_SUB(BLE_PXPM_BleEventHandler,          BLE_PXPM_GAP_EVT_MASK,          0,                          0,                          BLE_PXPM_GATT_EVT_MASK) \
+    APP_BLE_DISPATCH_SUB(APP_GATT_CACHE_BleEventHandler,    APP_GATT_CACHE_GAP_EVT_MASK,    0,                          0,                          APP_GATT_CACHE_GATT_EVT_MASK) \
+    APP_BLE_DISPATCH_SUB(BLE_CONN_REG_BleReleaseHandler,    BLE_CONN_REG_RELEASE_GAP_EVT_MASK, 0,                       0,                          0)
+
+/* Queued by copy in APP_Msg_T.msgData */
+APP_MSG_DATA_FITS(STACK_Event_T);
+APP_MSG_DATA_FITS(BT_SYS_LogEvent_T);
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Variables
@@ -72,11 +99,38 @@
 // *****************************************************************************
 static BLE_DD_Config_T         ddConfig;
 
+/**@brief Subscriber of stack events. */
+typedef struct APP_BLE_DispatchSub_T
+{
+    STACK_EventCb_T     handler;
+    uint32_t            evtMask[STACK_GRP_END];             /**< Consumed event IDs of each group. */
+} APP_BLE_DispatchSub_T;
+
+typedef enum APP_BLE_DispatchId_T
+{
+#define APP_BLE_DISPATCH_SUB(handler, gap, l2cap, smp, gatt)    APP_BLE_DISPATCH_ID_##handler,
+    APP_BLE_DISPATCH_TABLE
+#undef APP_BLE_DISPATCH_SUB
+    APP_BLE_DISPATCH_ID_TOTAL
+} APP_BLE_DispatchId_T;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Function Prototypes
 // *****************************************************************************
 // *****************************************************************************
+static void app_ble_AppEvtHandler(STACK_Event_T *p_stackEvt);
+static void app_ble_DdEvtHandler(STACK_Event_T *p_stackEvt);
+
+static const APP_BLE_DispatchSub_T s_bleDispatchSub[APP_BLE_DISPATCH_ID_TOTAL] =
+{
+#define APP_BLE_DISPATCH_SUB(handler, gap, l2cap, smp, gatt)    { handler, { [STACK_GRP_BLE_GAP] = (gap), [STACK_GRP_BLE_L2CAP] = (l2cap), [STACK_GRP_BLE_SMP] = (smp), [STACK_GRP_GATT] = (gatt) } },
+    APP_BLE_DISPATCH_TABLE
+#undef APP_BLE_DISPATCH_SUB
+};
+
+/* Subscribers of each event, one bit per APP_BLE_DispatchId_T. */
+static uint8_t s_bleDispatchMap[STACK_GRP_END][APP_BLE_DISPATCH_EVT_NUM];
 
 
 // *****************************************************************************
@@ -92,7 +146,40 @@ static void APP_BleStackCb(STACK_Event_T *p_stack)
     APP_Msg_T   *p_appMsg;
 
     (void)memcpy((uint8_t *)&stackEvent, (uint8_t *)p_stack, sizeof(STACK_Event_T));
-    stackEvent.p_event=OSAL_Malloc(p_stack->evtLen);
+
+    //Reject advertising reports from other devices before any buffer is claimed
+    if ((p_stack->groupId==STACK_GRP_BLE_GAP)
+        && (((BLE_GAP_Event_T *)p_stack->p_event)->eventId == BLE_GAP_EVT_ADV_REPORT)
+        && !APP_SCAN_FILTER_ProcAdvReport(&((BLE_GAP_Event_T *)p_stack->p_event)->eventField.evtAdvReport))
+    {
+        return;
+    }
+    if ((p_stack->groupId==STACK_GRP_BLE_GAP)
+        && (((BLE_GAP_Event_T *)p_stack->p_event)->eventId == BLE_GAP_EVT_EXT_ADV_REPORT)
+        && !APP_SCAN_FILTER_ProcExtAdvReport(&((BLE_GAP_Event_T *)p_stack->p_event)->eventField.evtExtAdvReport))
+    {
+        return;
+    }
+
+#if APP_BLE_CONNECTIONLESS
+    //Periodic reports are parsed here and queued as a compact sample, they never claim an event pool buffer
+    if ((p_stack->groupId==STACK_GRP_BLE_GAP)
+        && (((BLE_GAP_Event_T *)p_stack->p_event)->eventId == BLE_GAP_EVT_PERI_ADV_REPORT))
+    {
+        APP_CL_PROX_ProcPeriAdvReport(&((BLE_GAP_Event_T *)p_stack->p_event)->eventField.evtPeriAdvReport);
+        return;
+    }
+#endif
+
+    //Zone changes are queued with their delivery time, so the measured latency covers the wait in the application queue
+    if ((p_stack->groupId==STACK_GRP_BLE_GAP)
+        && (((BLE_GAP_Event_T *)p_stack->p_event)->eventId == BLE_GAP_EVT_PATH_LOSS_THRESHOLD))
+    {
+        APP_PXPM_CTX_ProcPathLossEvt(&((BLE_GAP_Event_T *)p_stack->p_event)->eventField.evtPathLossThreshold);
+        return;
+    }
+
+    stackEvent.p_event=APP_EVT_POOL_Alloc(p_stack->evtLen);
     if(stackEvent.p_event==NULL)
     {
         return;
@@ -108,7 +195,7 @@ static void APP_BleStackCb(STACK_Event_T *p_stack)
         {
             uint8_t *p_payload;
 
-            p_payload = (uint8_t *)OSAL_Malloc((p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
+            p_payload = (uint8_t *)APP_EVT_POOL_Alloc((p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
             if (p_payload != NULL)
             {
                 (void)memcpy(p_payload, (uint8_t *)p_evtGatt->eventField.onClientCccdListChange.p_cccdList, (p_evtGatt->eventField.onClientCccdListChange.numOfCccd*4));
@@ -118,16 +205,31 @@ static void APP_BleStackCb(STACK_Event_T *p_stack)
     }
 
     appMsg.msgId=APP_MSG_BLE_STACK_EVT;
+    appMsg.msgLen=sizeof(STACK_Event_T);
 
     ((STACK_Event_T *)appMsg.msgData)->groupId=p_stack->groupId;
     ((STACK_Event_T *)appMsg.msgData)->evtLen=p_stack->evtLen;
     ((STACK_Event_T *)appMsg.msgData)->p_event=stackEvent.p_event;
 
     p_appMsg = &appMsg;
-    OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0);
+    if (OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0) != OSAL_RESULT_TRUE)
+    {
+        if ((p_stack->groupId==STACK_GRP_BLE_GAP)
+            && ((((BLE_GAP_Event_T *)stackEvent.p_event)->eventId == BLE_GAP_EVT_ADV_REPORT)
+                || (((BLE_GAP_Event_T *)stackEvent.p_event)->eventId == BLE_GAP_EVT_EXT_ADV_REPORT)))
+        {
+            APP_SCAN_FILTER_CountPostAllocDrop();
+        }
+        if ((p_stack->groupId==STACK_GRP_GATT)
+            && (((GATT_Event_T *)stackEvent.p_event)->eventId == GATTS_EVT_CLIENT_CCCDLIST_CHANGE))
+        {
+            APP_EVT_POOL_Free(((GATT_Event_T *)stackEvent.p_event)->eventField.onClientCccdListChange.p_cccdList);
+        }
+        APP_EVT_POOL_Free(stackEvent.p_event);
+    }
 }
 
-void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
+static void app_ble_AppEvtHandler(STACK_Event_T *p_stackEvt)
 {
     switch(p_stackEvt->groupId)
     {
@@ -158,27 +260,86 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
         break;
 
     }
+}
 
-    //Direct event to BLE middleware
-    BLE_DM_BleEventHandler(p_stackEvt);
-
+static void app_ble_DdEvtHandler(STACK_Event_T *p_stackEvt)
+{
+    APP_GATT_CACHE_ConfigDd(&ddConfig, p_stackEvt);
     BLE_DD_BleEventHandler(&ddConfig, p_stackEvt);
+}
 
-    //Direct event to BLE profiles
+static void app_ble_DispatchInit(void)
+{
+    uint8_t grp;
+    uint8_t evt;
+    uint8_t i;
 
-    
+    (void)memset(s_bleDispatchMap, 0, sizeof(s_bleDispatchMap));
 
+    for (grp = 0; grp < STACK_GRP_END; grp++)
+    {
+        for (evt = 0; evt < APP_BLE_DISPATCH_EVT_NUM; evt++)
+        {
+            for (i = 0; i < APP_BLE_DISPATCH_ID_TOTAL; i++)
+            {
+                if (s_bleDispatchSub[i].evtMask[grp] & (1UL << evt))
+                {
+                    s_bleDispatchMap[grp][evt] |= (uint8_t)(1U << i);
+                }
+            }
+        }
+    }
+}
 
-    /* Proximity Profile */
-    BLE_PXPM_BleEventHandler(p_stackEvt);
+static uint32_t app_ble_GetEvtId(STACK_Event_T *p_stackEvt)
+{
+    switch (p_stackEvt->groupId)
+    {
+        case STACK_GRP_BLE_GAP:
+            return (uint32_t)((BLE_GAP_Event_T *)p_stackEvt->p_event)->eventId;
 
+        case STACK_GRP_BLE_L2CAP:
+            return (uint32_t)((BLE_L2CAP_Event_T *)p_stackEvt->p_event)->eventId;
 
+        case STACK_GRP_BLE_SMP:
+            return (uint32_t)((BLE_SMP_Event_T *)p_stackEvt->p_event)->eventId;
 
+        case STACK_GRP_GATT:
+            return (uint32_t)((GATT_Event_T *)p_stackEvt->p_event)->eventId;
+
+        default:
+            return APP_BLE_DISPATCH_EVT_NUM;
+    }
+}
+
+void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
+{
+    uint32_t evtId = app_ble_GetEvtId(p_stackEvt);
+    uint8_t subs;
 
+    if (p_stackEvt->groupId >= STACK_GRP_END)
+    {
+        subs = 0;
+    }
+    else if (evtId >= APP_BLE_DISPATCH_EVT_NUM)
+    {
+        subs = (uint8_t)((1U << APP_BLE_DISPATCH_ID_TOTAL) - 1U);
+    }
+    else
+    {
+        subs = s_bleDispatchMap[p_stackEvt->groupId][evtId];
+    }
 
+    //Subscribers are called in table order, lowest bit first
+    while (subs != 0U)
+    {
+        uint8_t i = (uint8_t)__builtin_ctz(subs);
 
+        s_bleDispatchSub[i].handler(p_stackEvt);
+        subs &= (uint8_t)(subs - 1U);
+    }
 
-    OSAL_Free(p_stackEvt->p_event);
+    APP_EVT_POOL_Free(p_stackEvt->p_event);
 }
 
 
@@ -192,6 +353,7 @@ static void APP_DdEvtHandler(BLE_DD_Event_T *p_event)
 
 
     BLE_PXPM_BleDdEventHandler(p_event);
+    APP_GATT_CACHE_DdEventHandler(p_event);
 
 
 }
@@ -210,7 +372,9 @@ static void APP_BleConfigAdvance(void)
 
     BLE_SMP_Config_T                smpParam;
 
+#if !APP_BLE_EXT_API
     BLE_GAP_ScanningParams_T        scanParam;
+#endif
     BLE_DM_Config_T                 dmConfig;
     BLE_GAP_ServiceOption_T         gapServiceOptions;
     
@@ -227,13 +391,15 @@ static void APP_BleConfigAdvance(void)
 
     BLE_GAP_ConfigureBuildInService(&gapServiceOptions);
 
+#if !APP_BLE_EXT_API
     // Configure scan parameters
     scanParam.type = BLE_GAP_SCAN_TYPE_PASSIVE_SCAN;      /* Scan Type */
     scanParam.interval = 160;      /* Scan Interval */
     scanParam.window = 32;      /* Scan Window */
-    scanParam.filterPolicy = BLE_GAP_SCAN_FP_ACCEPT_ALL;       /* Scan Filter Policy */
+    scanParam.filterPolicy = APP_SCAN_FILTER_GetScanFilterPolicy();       /* Scan Filter Policy */
     scanParam.disChannel = 0;      /* Disable specific channel during scanning */
     BLE_GAP_SetScanningParam(&scanParam);
+#endif
 
     BLE_GAP_SetConnTxPowerLevel(15, &connTxPower);      /* Connection TX Power */
 
@@ -258,6 +424,7 @@ static void APP_BleConfigAdvance(void)
     ddConfig.waitForSecurity = false;
     ddConfig.initDiscInCentral = true;
     ddConfig.initDiscInPeripheral = false;
+    ddConfig.singlePassDisc = true;
 }
 
 void APP_BleStackInitBasic(void)
@@ -273,13 +440,23 @@ void APP_BleStackInitAdvance(void)
 
     uint16_t gattcInitParam=GATTC_CONFIG_NONE;
 
+    APP_EVT_POOL_Init();
     STACK_EventRegister(APP_BleStackCb);
 
 
 
     BLE_GAP_ScanInit();     /* Scan */
+#if APP_BLE_EXT_API
+    BLE_GAP_ExtScanInit(BLE_GAP_EXT_SCAN_DATA_LEN_MIN, 0);     /* Extended Scan, the reporter advertising data fits in one PDU */
+#endif
+#if APP_BLE_CONNECTIONLESS
+    BLE_GAP_SyncInit();     /* Periodic Advertising Sync */
+#endif
 
     BLE_GAP_ConnCentralInit();  /* Central */
+#if APP_BLE_EXT_API
+    BLE_GAP_ExtConnCentralInit();   /* Extended Central */
+#endif
 
     BLE_L2CAP_Init();
 
@@ -291,11 +468,19 @@ void APP_BleStackInitAdvance(void)
 
 
     //Initialize BLE middleware
+    app_ble_DispatchInit();
+    BLE_CONN_REG_Init();
     BLE_DM_Init();
     BLE_DM_EventRegister(APP_DmEvtHandler);
 
     BLE_DD_Init();
     BLE_DD_EventRegister(APP_DdEvtHandler);
+    APP_SCAN_FILTER_Init();
+    APP_SCAN_SCHED_Init();
+    APP_LINK_OPT_Init();
+#if APP_BLE_CONNECTIONLESS
+    APP_CL_PROX_Init();
+#endif
     
 
 
@@ -309,6 +494,7 @@ void APP_BleStackInitAdvance(void)
     /* Proximity Profile */
     BLE_PXPM_Init();                                    /* Enable Monitor Role */
     BLE_PXPM_EventRegister(APP_PxpmEvtHandler);     /* Enable Monitor Role */
+    APP_GATT_CACHE_Init();
 
 
 
@@ -62,6 +62,33 @@
 #include "gatt.h"
 
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/* Long-range mode. When set, the monitor scans for and connects to reporters
+   on the LE Coded PHY with the extended scanning APIs, which the stack does not
+   allow to be mixed with the legacy ones. Reporters must be built alike. */
+#ifndef APP_BLE_LONG_RANGE
+#define APP_BLE_LONG_RANGE                 0
+#endif
+
+/* Connectionless proximity mode. When set, the monitor synchronizes to the
+   periodic advertising of reporters and estimates their zone from it; a link
+   is only created to deliver an IAS alert. See app_cl_prox.h. */
+#ifndef APP_BLE_CONNECTIONLESS
+#define APP_BLE_CONNECTIONLESS             0
+#endif
+
+/* Both modes need the extended scanning APIs; long-range moves them to LE Coded. */
+#define APP_BLE_EXT_API                    (APP_BLE_LONG_RANGE || APP_BLE_CONNECTIONLESS)
+#if APP_BLE_LONG_RANGE
+#define APP_BLE_EXT_PHY                    BLE_GAP_PHY_TYPE_LE_CODED
+#else
+#define APP_BLE_EXT_PHY                    BLE_GAP_PHY_TYPE_LE_1M
+#endif
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -75,6 +102,14 @@ extern "C" {
 // Section: Type Definitions
 // *****************************************************************************
 // *****************************************************************************
+/* Payload of APP_MSG_BLE_SCAN_EVT. Only the fields needed to initiate the
+   connection are queued, not the whole advertising report. */
+typedef struct APP_BleScanEvt_T
+{
+    BLE_GAP_Addr_T  addr;
+    int8_t          rssi;
+} APP_BleScanEvt_T;
+
 
 // *****************************************************************************
 // *****************************************************************************
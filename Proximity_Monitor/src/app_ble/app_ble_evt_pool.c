@@ -0,0 +1,208 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Event Pool Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_evt_pool.c
+
+  Summary:
+    This file contains the Application BLE stack event pool for this project.
+
+  Description:
+    Each size class keeps a free bitmap. A block is claimed by atomically
+    clearing its bit and released by atomically setting it again, so claim and
+    release never take a lock and never touch the heap allocator.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "app_ble_evt_pool.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_EVT_POOL_MASK(num)                 (((num) >= 32U) ? 0xFFFFFFFFUL : ((1UL << (num)) - 1UL))
+
+#if (APP_EVT_POOL_SMALL_BLOCK_NUM > 32) || (APP_EVT_POOL_LARGE_BLOCK_NUM > 32)
+#error "APP_EVT_POOL block number of a class must not exceed 32"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_EVT_POOL_ClassInfo_T
+{
+    uint8_t     *p_base;
+    uint16_t    blockSize;
+    uint8_t     blockNum;
+} APP_EVT_POOL_ClassInfo_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static uint32_t s_evtPoolSmall[APP_EVT_POOL_SMALL_BLOCK_NUM][APP_EVT_POOL_SMALL_BLOCK_SIZE / sizeof(uint32_t)];
+static uint32_t s_evtPoolLarge[APP_EVT_POOL_LARGE_BLOCK_NUM][APP_EVT_POOL_LARGE_BLOCK_SIZE / sizeof(uint32_t)];
+
+static const APP_EVT_POOL_ClassInfo_T s_evtPoolClass[APP_EVT_POOL_CLASS_TOTAL] =
+{
+    { (uint8_t *)s_evtPoolSmall, APP_EVT_POOL_SMALL_BLOCK_SIZE, APP_EVT_POOL_SMALL_BLOCK_NUM },
+    { (uint8_t *)s_evtPoolLarge, APP_EVT_POOL_LARGE_BLOCK_SIZE, APP_EVT_POOL_LARGE_BLOCK_NUM },
+};
+
+static volatile uint32_t s_evtPoolFreeMask[APP_EVT_POOL_CLASS_TOTAL];
+static APP_EVT_POOL_Stats_T s_evtPoolStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_evt_pool_UpdateHighWater(uint8_t poolClass)
+{
+    uint8_t inUse;
+    uint8_t highWater;
+
+    inUse = __atomic_add_fetch(&s_evtPoolStats.inUse[poolClass], 1, __ATOMIC_RELAXED);
+    highWater = __atomic_load_n(&s_evtPoolStats.highWater[poolClass], __ATOMIC_RELAXED);
+    while (inUse > highWater)
+    {
+        if (__atomic_compare_exchange_n(&s_evtPoolStats.highWater[poolClass], &highWater, inUse,
+            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+}
+
+static void *app_evt_pool_Claim(uint8_t poolClass)
+{
+    uint32_t freeMask;
+    uint8_t idx;
+
+    freeMask = __atomic_load_n(&s_evtPoolFreeMask[poolClass], __ATOMIC_ACQUIRE);
+    while (freeMask != 0)
+    {
+        idx = (uint8_t)__builtin_ctz(freeMask);
+        if (__atomic_compare_exchange_n(&s_evtPoolFreeMask[poolClass], &freeMask, freeMask & ~(1UL << idx),
+            true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            __atomic_add_fetch(&s_evtPoolStats.claimCnt[poolClass], 1, __ATOMIC_RELAXED);
+            app_evt_pool_UpdateHighWater(poolClass);
+            return s_evtPoolClass[poolClass].p_base + ((uint32_t)idx * s_evtPoolClass[poolClass].blockSize);
+        }
+        //freeMask is reloaded by the failed compare-exchange
+    }
+
+    __atomic_add_fetch(&s_evtPoolStats.exhaustCnt[poolClass], 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+void APP_EVT_POOL_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < APP_EVT_POOL_CLASS_TOTAL; i++)
+    {
+        s_evtPoolFreeMask[i] = APP_EVT_POOL_MASK(s_evtPoolClass[i].blockNum);
+    }
+    (void)memset(&s_evtPoolStats, 0, sizeof(APP_EVT_POOL_Stats_T));
+}
+
+void *APP_EVT_POOL_Alloc(uint16_t size)
+{
+    void *p_buf = NULL;
+    uint8_t i;
+
+    for (i = 0; i < APP_EVT_POOL_CLASS_TOTAL; i++)
+    {
+        if (size <= s_evtPoolClass[i].blockSize)
+        {
+            p_buf = app_evt_pool_Claim(i);
+            if (p_buf != NULL)
+            {
+                return p_buf;
+            }
+        }
+    }
+
+    //Oversized event (e.g. L2CAP SDU) or every fitting class is exhausted
+    p_buf = OSAL_Malloc(size);
+    if (p_buf != NULL)
+    {
+        __atomic_add_fetch(&s_evtPoolStats.heapFallbackCnt, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_add_fetch(&s_evtPoolStats.failCnt, 1, __ATOMIC_RELAXED);
+    }
+
+    return p_buf;
+}
+
+void APP_EVT_POOL_Free(void *p_buf)
+{
+    uint8_t *p_block = (uint8_t *)p_buf;
+    uint32_t offset;
+    uint8_t i;
+
+    if (p_block == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < APP_EVT_POOL_CLASS_TOTAL; i++)
+    {
+        if ((p_block >= s_evtPoolClass[i].p_base)
+            && (p_block < (s_evtPoolClass[i].p_base + ((uint32_t)s_evtPoolClass[i].blockNum * s_evtPoolClass[i].blockSize))))
+        {
+            offset = (uint32_t)(p_block - s_evtPoolClass[i].p_base);
+            __atomic_sub_fetch(&s_evtPoolStats.inUse[i], 1, __ATOMIC_RELAXED);
+            __atomic_or_fetch(&s_evtPoolFreeMask[i], (1UL << (offset / s_evtPoolClass[i].blockSize)), __ATOMIC_RELEASE);
+            return;
+        }
+    }
+
+    OSAL_Free(p_buf);
+}
+
+void APP_EVT_POOL_GetStats(APP_EVT_POOL_Stats_T *p_stats)
+{
+    (void)memcpy(p_stats, &s_evtPoolStats, sizeof(APP_EVT_POOL_Stats_T));
+}
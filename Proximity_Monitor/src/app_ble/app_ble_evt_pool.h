@@ -0,0 +1,144 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Event Pool Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_evt_pool.h
+
+  Summary:
+    This file contains the Application BLE stack event pool for this project.
+
+  Description:
+    Fixed-block, size-classed buffers used to hold copies of BLE stack events
+    between the stack callback and the application task. Blocks are claimed
+    and released without locks, so the pool may be used from the stack
+    callback context.
+ *******************************************************************************/
+
+#ifndef APP_BLE_EVT_POOL_H
+#define APP_BLE_EVT_POOL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@defgroup APP_EVT_POOL_CLASS APP_EVT_POOL_CLASS
+ * @brief The definition of the block size and block number of each size class.
+ *        The block number of a class must not exceed 32.
+ * @{ */
+#define APP_EVT_POOL_SMALL_BLOCK_SIZE          (64)     /**< Block size of small class. Fits advertising reports and most GAP/SMP events. */
+#define APP_EVT_POOL_SMALL_BLOCK_NUM           (24)     /**< Block number of small class. */
+#define APP_EVT_POOL_LARGE_BLOCK_SIZE          (272)    /**< Block size of large class. Fits GATT events carrying a full ATT payload. */
+#define APP_EVT_POOL_LARGE_BLOCK_NUM           (8)      /**< Block number of large class. */
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The definition of the size classes. */
+typedef enum APP_EVT_POOL_Class_T
+{
+    APP_EVT_POOL_CLASS_SMALL,
+    APP_EVT_POOL_CLASS_LARGE,
+    APP_EVT_POOL_CLASS_TOTAL
+} APP_EVT_POOL_Class_T;
+
+/**@brief Usage statistics of the event pool. */
+typedef struct APP_EVT_POOL_Stats_T
+{
+    uint8_t     inUse[APP_EVT_POOL_CLASS_TOTAL];        /**< Blocks currently claimed per class. */
+    uint8_t     highWater[APP_EVT_POOL_CLASS_TOTAL];    /**< Maximum blocks claimed at once per class. */
+    uint32_t    claimCnt[APP_EVT_POOL_CLASS_TOTAL];     /**< Successful claims per class. */
+    uint32_t    exhaustCnt[APP_EVT_POOL_CLASS_TOTAL];   /**< Claims that found the class exhausted. */
+    uint32_t    heapFallbackCnt;                        /**< Claims served from the heap (oversized request or pool exhausted). */
+    uint32_t    failCnt;                                /**< Claims that could not be served at all. */
+} APP_EVT_POOL_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the event pool. All blocks are released.
+ */
+void APP_EVT_POOL_Init(void);
+
+/**@brief The function is used to claim a buffer. The smallest size class that fits is tried first,
+ *        then the larger classes. If no block is available the buffer is allocated from the heap.
+ *        It is safe to call from the BLE stack callback context.
+ *@param[in] size                             Requested size in bytes.
+ *
+ * @retval Pointer to the buffer, or NULL if no memory is available.
+ *
+ */
+void *APP_EVT_POOL_Alloc(uint16_t size);
+
+/**@brief The function is used to release a buffer got from @ref APP_EVT_POOL_Alloc.
+ *@param[in] p_buf                            Pointer to the buffer. NULL is ignored.
+ *
+ */
+void APP_EVT_POOL_Free(void *p_buf);
+
+/**@brief The function is used to get a snapshot of the pool statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_EVT_POOL_GetStats(APP_EVT_POOL_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_BLE_EVT_POOL_H */
+
+
+/*******************************************************************************
+ End of File
+ */
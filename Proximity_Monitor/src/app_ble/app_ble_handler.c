@@ -48,59 +48,56 @@
 #include <stdio.h>
 #include<app.h>
 #include "osal/osal_freertos_extend.h"
+#include "app_ble.h"
 #include "app_ble_handler.h"
-#include "peripheral/sercom/usart/plib_sercom0_usart.h"
 #include "app_timer/app_timer.h"
+#include "app_ble_evt_pool.h"
+#include "app_ble_scan_filter.h"
+#include "ble_dm/ble_dm_info.h"
+#include "app_pxpm_ctx.h"
+#include "app_scan_sched.h"
+#include "app_gatt_cache.h"
+#include "app_link_opt.h"
+#include "app_cl_prox.h"
+#include "app_log/app_log.h"
+
+/* Queued by copy in APP_Msg_T.msgData */
+APP_MSG_DATA_FITS(APP_BleScanEvt_T);
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Global Variables
 // *****************************************************************************
 // *****************************************************************************
-uint16_t conn_hdl;
 extern bool conn_st;
-#define AD_TYPE_SERVICE_ID    0x16
-#define AD_TYPE_SERVICE_UUID  0xFEDA        
-#define AD_TYPE_SERVICE_DATA  0xFF20
 extern APP_DATA appData;
-uint8_t  zone_Entered;
-bool APP_CheckForServiceItemInAdvertisingString(uint8_t *adv, uint8_t advLength)
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_ble_EvictPairedDevice(void)
 {
-    uint8_t currentPos = 0;
-    uint8_t sectionLength;
-    uint16_t service_uuid, service_data;
-    
-    while(currentPos < advLength)
+    uint8_t devId[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t devCnt = 0;
+    uint16_t connHandle;
+    uint8_t i;
+
+    //Drop the first bond that is not connected, BLE_DM stores the new one in its slot
+    BLE_DM_GetPairedDeviceList(devId, &devCnt);
+    for (i = 0; i < devCnt; i++)
     {
-        sectionLength = adv[currentPos];
-        
-        if( adv[currentPos+1] == AD_TYPE_SERVICE_ID)
+        if (BLE_DM_InfoGetConnHandleByDevId(devId[i], &connHandle) != MBA_RES_SUCCESS)
         {
-            service_uuid = ( adv[currentPos+2+1]<<8 | adv[currentPos+2]   );
-            service_data = ( adv[currentPos+2+2]<<8 | adv[currentPos+2+3] );  
-
-            if((service_uuid == AD_TYPE_SERVICE_UUID) && (service_data == AD_TYPE_SERVICE_DATA))
-            {
-                return true; 
-            }
-            else
+            if (BLE_DM_DeletePairedDevice(devId[i]) == MBA_RES_SUCCESS)
             {
-                currentPos += (sectionLength + 1);
+                (void)APP_SCAN_FILTER_ForgetPeer(devId[i]);
             }
+            return;
         }
-        else
-        {
-            currentPos += (sectionLength + 1);
-        }
-            
-        
     }
-    return false;
 }
-// *****************************************************************************
-// *****************************************************************************
-// Section: Functions
-// *****************************************************************************
-// *****************************************************************************
+
 void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 {
     APP_Msg_T appMsg;
@@ -108,26 +105,84 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
     {
         case BLE_GAP_EVT_CONNECTED:
         {
-            /* TODO: implement your application code.*/
-            SERCOM0_USART_Write((uint8_t *)"\r\n[BLE] Connected",17);
-            conn_hdl = p_event->eventField.evtConnect.connHandle;
-            appMsg.msgId = APP_MSG_CONNECT_CB;
-            OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+            BLE_GAP_EvtConnect_T *p_evtConnect = &p_event->eventField.evtConnect;
+            APP_PXPM_Ctx_T *p_ctx;
+
+            APP_PXPM_CTX_SetConnecting(false);
+            if (p_evtConnect->status != GAP_STATUS_SUCCESS)
+            {
+                break;
+            }
+
+            APP_LOG0(APP_LOG_ID_CONNECTED);
+            p_ctx = APP_PXPM_CTX_Alloc(p_evtConnect->connHandle, &p_evtConnect->remoteAddr);
+            if (p_ctx == NULL)
+            {
+                //Not created by the monitor, or no context left for it
+                BLE_GAP_Disconnect(p_evtConnect->connHandle, GAP_DISC_REASON_REMOTE_TERMINATE);
+                break;
+            }
+
+            p_ctx->connInterval = p_evtConnect->interval;
+            p_ctx->connLatency = p_evtConnect->latency;
+            APP_LINK_OPT_Connected(p_evtConnect->connHandle);
+#if APP_BLE_CONNECTIONLESS
+            APP_CL_PROX_ConnectedHandler(p_ctx);
+#endif
+
+            //The RSSI estimator owns the zone when enabled, the controller path loss reporting is then left off
+            if (!APP_ZONE_EST_ENABLE)
+            {
+                appMsg.msgId = APP_MSG_CONNECT_CB;
+                appMsg.msgLen = sizeof(uint16_t);
+                memcpy(appMsg.msgData, &p_evtConnect->connHandle, sizeof(uint16_t));
+                OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+            }
+
+            APP_SCAN_SCHED_ConnectedHandler();
+
+            //Keep looking for other reporters until every link is in use
+            if (APP_PXPM_CTX_GetActiveNum() < APP_PXPM_CTX_MAX_NUM)
+            {
+                APP_SCAN_SCHED_Resume();
+            }
+            else
+            {
+                APP_SCAN_SCHED_Stop();
+            }
         }
         break;
 
         case BLE_GAP_EVT_DISCONNECTED:
         {
-            /* TODO: implement your application code.*/
-            SERCOM0_USART_Write((uint8_t *)"\r\n[BLE] Disconnected",19);
-            BLE_GAP_SetScanningEnable(true, BLE_GAP_SCAN_FD_ENABLE, BLE_GAP_SCAN_MODE_OBSERVER, 1000);
-            printf("[BLE] Started Scanning!!!\r\n");
+            APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(p_event->eventField.evtDisconnect.connHandle);
+            BLE_DM_InfoConn_T *p_dmConn = BLE_DM_InfoGetConnByHandle(p_event->eventField.evtDisconnect.connHandle);
+            uint8_t devId = BLE_DM_PEER_DEV_ID_INVALID;
+
+            //The lost reporter is most likely still nearby: burst with the profile of its bond.
+            //BLE_DM handles the event after the application, its record still holds the bond found at connection.
+            if ((p_ctx != NULL) && (p_dmConn != NULL))
+            {
+                devId = p_dmConn->devId;
+            }
+            APP_PXPM_CTX_Free(p_ctx);
+            APP_LOG0(APP_LOG_ID_DISCONNECTED);
+            APP_SCAN_SCHED_StartBurst(devId);
+            APP_LOG0(APP_LOG_ID_SCAN_STARTED);
         }
         break;
 
         case BLE_GAP_EVT_CONN_PARAM_UPDATE:
         {
-            /* TODO: implement your application code.*/
+            BLE_GAP_EvtConnParamUpdateParams_T *p_evtUpdate = &p_event->eventField.evtConnParamUpdate;
+            APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(p_evtUpdate->connHandle);
+
+            //The zone estimator samples the RSSI once per effective connection event
+            if ((p_ctx != NULL) && (p_evtUpdate->status == GAP_STATUS_SUCCESS))
+            {
+                p_ctx->connInterval = p_evtUpdate->connParam.intervalMax;
+                p_ctx->connLatency = p_evtUpdate->connParam.latency;
+            }
         }
         break;
 
@@ -139,13 +194,16 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
-            if(APP_CheckForServiceItemInAdvertisingString(p_event->eventField.evtAdvReport.advData,p_event->eventField.evtAdvReport.length) )
+            /* Reports from other devices are already dropped by APP_BleStackCb */
+            APP_BleScanEvt_T *p_scanEvt = (APP_BleScanEvt_T *)appMsg.msgData;
+
+            appMsg.msgId = APP_MSG_BLE_SCAN_EVT;
+            appMsg.msgLen = sizeof(APP_BleScanEvt_T);
+            memcpy(&p_scanEvt->addr, &p_event->eventField.evtAdvReport.addr, sizeof(BLE_GAP_Addr_T));
+            p_scanEvt->rssi = p_event->eventField.evtAdvReport.rssi;
+            if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) != OSAL_RESULT_TRUE)
             {
-                APP_Msg_T appMsg;
-                appMsg.msgId = APP_MSG_BLE_SCAN_EVT;
-                memcpy(appMsg.msgData, &p_event->eventField.evtAdvReport, sizeof(BLE_GAP_EvtAdvReport_T));
-                OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+                APP_SCAN_FILTER_CountPostAllocDrop();
             }
         }
         break;
@@ -164,7 +222,22 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_EXT_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
+            /* Reports from other devices are already dropped by APP_BleStackCb */
+#if APP_BLE_CONNECTIONLESS
+            //Only periodic advertising sets pass the filter; connections are requested by APP_CL_PROX
+            APP_CL_PROX_ProcAdvReport(&p_event->eventField.evtExtAdvReport);
+#else
+            APP_BleScanEvt_T *p_scanEvt = (APP_BleScanEvt_T *)appMsg.msgData;
+
+            appMsg.msgId = APP_MSG_BLE_SCAN_EVT;
+            appMsg.msgLen = sizeof(APP_BleScanEvt_T);
+            memcpy(&p_scanEvt->addr, &p_event->eventField.evtExtAdvReport.addr, sizeof(BLE_GAP_Addr_T));
+            p_scanEvt->rssi = p_event->eventField.evtExtAdvReport.rssi;
+            if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) != OSAL_RESULT_TRUE)
+            {
+                APP_SCAN_FILTER_CountPostAllocDrop();
+            }
+#endif
         }
         break;
 
@@ -194,7 +267,7 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_PHY_UPDATE:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_OPT_PhyUpdated(&p_event->eventField.evtPhyUpdate);
         }
         break;
 
@@ -212,19 +285,23 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_PERI_ADV_SYNC_EST:
         {
-            /* TODO: implement your application code.*/
+#if APP_BLE_CONNECTIONLESS
+            APP_CL_PROX_SyncEstHandler(&p_event->eventField.evtPeriAdvSyncEst);
+#endif
         }
         break;
 
         case BLE_GAP_EVT_PERI_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
+            /* Parsed by APP_BleStackCb in connectionless mode */
         }
         break;
 
         case BLE_GAP_EVT_PERI_ADV_SYNC_LOST:
         {
-            /* TODO: implement your application code.*/
+#if APP_BLE_CONNECTIONLESS
+            APP_CL_PROX_SyncLostHandler(&p_event->eventField.evtPeriAdvSyncLost);
+#endif
         }
         break;
 
@@ -236,8 +313,8 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_SCAN_TIMEOUT:
         {
-            /* TODO: implement your application code.*/
-            printf("Scan Completed \r\n");
+            APP_LOG0(APP_LOG_ID_SCAN_COMPLETED);
+            APP_SCAN_SCHED_TimeoutHandler();
         }
         break;
 
@@ -256,10 +333,9 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
         
         case BLE_GAP_EVT_PATH_LOSS_THRESHOLD:
         {
-            /* TODO: implement your application code.*/
 //            uint8_t  Current_Path_Loss;
-            
-            zone_Entered= p_event->eventField.evtPathLossThreshold.zoneEntered;
+
+            //Not queued as a stack event: the stack callback posts APP_MSG_ZONE_EVT, see APP_PXPM_CTX_ZoneEvtHandler
             
 //            Current_Path_Loss= p_event->eventField.evtPathLossThreshold.currentPathLoss;
             
@@ -330,7 +406,11 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
     {
         case GATTC_EVT_ERROR_RESP:
         {
-            /* TODO: implement your application code.*/
+            //The peer does not support the exchange, the link stays at the default MTU
+            if (p_event->eventField.onError.reqOpcode == ATT_EXCHANGE_MTU_REQ)
+            {
+                APP_LINK_OPT_MtuUpdated(p_event->eventField.onError.connHandle, BLE_ATT_DEFAULT_MTU_LEN);
+            }
         }
         break;
 
@@ -414,7 +494,7 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
 
         case ATT_EVT_UPDATE_MTU:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_OPT_MtuUpdated(p_event->eventField.onUpdateMTU.connHandle, p_event->eventField.onUpdateMTU.exchangedMTU);
         }
         break;
 
@@ -439,13 +519,13 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
         case GATTS_EVT_CLIENT_CCCDLIST_CHANGE:
         {
             /* TODO: implement your application code.*/
-            OSAL_Free(p_event->eventField.onClientCccdListChange.p_cccdList);
+            APP_EVT_POOL_Free(p_event->eventField.onClientCccdListChange.p_cccdList);
         }
         break;
 
         case GATTC_EVT_PROTOCOL_AVAILABLE:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_OPT_ProtocolAvailable(p_event->eventField.onClientProtocolAvailable.connHandle);
         }
         break;
 
@@ -537,6 +617,8 @@ void APP_BleSmpEvtHandler(BLE_SMP_Event_T *p_event)
 
 void APP_DmEvtHandler(BLE_DM_Event_T *p_event)
 {
+    APP_GATT_CACHE_DmEventHandler(p_event);
+
     switch(p_event->eventId)
     {
         case BLE_DM_EVT_DISCONNECTED:
@@ -571,25 +653,27 @@ void APP_DmEvtHandler(BLE_DM_Event_T *p_event)
 
         case BLE_DM_EVT_PAIRED_DEVICE_FULL:
         {
-            /* TODO: implement your application code.*/
+            /* BLE_DM only stores the new bond if a paired device is deleted in this callback */
+            app_ble_EvictPairedDevice();
         }
         break;
 
         case BLE_DM_EVT_PAIRED_DEVICE_UPDATED:
         {
-            /* TODO: implement your application code.*/
+            /* Bonded reporters passed the scan filter once, let the controller accept them from now on */
+            APP_SCAN_FILTER_LearnPeer(p_event->peerDevId);
         }
         break;
 
         case BLE_DM_EVT_CONN_UPDATE_SUCCESS:
         {
-            /* TODO: implement your application code.*/
+            APP_CONN_POLICY_UpdateCompleted(p_event->connHandle, true);
         }
         break;
 
         case BLE_DM_EVT_CONN_UPDATE_FAIL:
         {
-            /* TODO: implement your application code.*/
+            APP_CONN_POLICY_UpdateCompleted(p_event->connHandle, false);
         }
         break;
 
@@ -175,7 +175,6 @@ void APP_BleSmpEvtHandler(BLE_SMP_Event_T *p_event);
 
 */
 void APP_DmEvtHandler(BLE_DM_Event_T *p_event);
-bool APP_CheckForServiceItemInAdvertisingString(uint8_t *adv, uint8_t advLength);
 
 #endif /* _APP_BLE_HANDLER_H */
 
@@ -0,0 +1,244 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Scan Filter Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_scan_filter.c
+
+  Summary:
+    This file contains the Application BLE scan filter for this project.
+
+  Description:
+    This file contains the Application BLE scan filter for this project.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "mba_error_defs.h"
+#include "ble_dm/ble_dm.h"
+#include "app_ble.h"
+#include "app_ble_scan_filter.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_SCAN_FILTER_Stats_T  s_scanFilterStats;
+static uint8_t                  s_acceptListDevId[BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static bool app_scan_filter_MatchServiceData(const uint8_t *p_adv, uint8_t advLength)
+{
+    uint8_t currentPos = 0;
+    uint8_t sectionLength;
+    uint16_t serviceUuid, serviceData;
+
+    while ((currentPos + 1U) < advLength)
+    {
+        sectionLength = p_adv[currentPos];
+
+        if ((sectionLength == 0U) || ((currentPos + 1U + sectionLength) > advLength))
+        {
+            //Zero padding or malformed AD structure
+            break;
+        }
+
+        //Type, 2 bytes UUID and at least 2 bytes service data
+        if ((p_adv[currentPos + 1U] == APP_SCAN_FILTER_AD_TYPE_SERVICE_DATA) && (sectionLength >= 5U))
+        {
+            serviceUuid = (uint16_t)(p_adv[currentPos + 3U] << 8 | p_adv[currentPos + 2U]);
+            serviceData = (uint16_t)(p_adv[currentPos + 4U] << 8 | p_adv[currentPos + 5U]);
+
+            if ((serviceUuid == APP_SCAN_FILTER_SERVICE_UUID) && (serviceData == APP_SCAN_FILTER_SERVICE_DATA))
+            {
+                return true;
+            }
+        }
+
+        currentPos += (sectionLength + 1U);
+    }
+
+    return false;
+}
+
+static void app_scan_filter_ConfigStackFilter(void)
+{
+    BLE_GAP_ScanFilterConfig_T filterConfig;
+
+    (void)memset(&filterConfig, 0, sizeof(BLE_GAP_ScanFilterConfig_T));
+    filterConfig.svcDataFilterEnable = true;
+    filterConfig.serviceDataFilter.uuidLen = 2;
+    filterConfig.serviceDataFilter.uuidData[0] = (uint8_t)(APP_SCAN_FILTER_SERVICE_UUID & 0xFF);
+    filterConfig.serviceDataFilter.uuidData[1] = (uint8_t)(APP_SCAN_FILTER_SERVICE_UUID >> 8);
+    filterConfig.serviceDataFilter.svcDataLen = 2;
+    filterConfig.serviceDataFilter.svcData[0] = (uint8_t)(APP_SCAN_FILTER_SERVICE_DATA >> 8);
+    filterConfig.serviceDataFilter.svcData[1] = (uint8_t)(APP_SCAN_FILTER_SERVICE_DATA & 0xFF);
+
+    s_scanFilterStats.stackFilterEnabled = (BLE_GAP_SetScanningFilter(&filterConfig) == MBA_RES_SUCCESS);
+}
+
+void APP_SCAN_FILTER_Init(void)
+{
+    uint8_t devId[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t devCnt = 0;
+    uint8_t i;
+
+    (void)memset(&s_scanFilterStats, 0, sizeof(APP_SCAN_FILTER_Stats_T));
+    app_scan_filter_ConfigStackFilter();
+
+    //Every bonded device was accepted by the filter before, so start from the bonded list
+    BLE_DM_GetPairedDeviceList(devId, &devCnt);
+    for (i = 0; i < devCnt; i++)
+    {
+        (void)APP_SCAN_FILTER_LearnPeer(devId[i]);
+    }
+}
+
+bool APP_SCAN_FILTER_ProcAdvReport(const BLE_GAP_EvtAdvReport_T *p_report)
+{
+    s_scanFilterStats.rxCnt++;
+
+    if (app_scan_filter_MatchServiceData(p_report->advData, p_report->length))
+    {
+        s_scanFilterStats.acceptCnt++;
+        return true;
+    }
+
+    s_scanFilterStats.dropPreAllocCnt++;
+    return false;
+}
+
+bool APP_SCAN_FILTER_ProcExtAdvReport(const BLE_GAP_EvtExtAdvReport_T *p_report)
+{
+    s_scanFilterStats.rxCnt++;
+
+    //Partial reports of chained advertising data cannot be matched on their own
+#if APP_BLE_CONNECTIONLESS
+    if ((p_report->periodAdvInterval != 0U)
+#else
+    if (((p_report->eventType & BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_CONNECTABLE) != 0U)
+#endif
+        && (p_report->dataStatus == BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE)
+        && app_scan_filter_MatchServiceData(p_report->advData, p_report->length))
+    {
+        s_scanFilterStats.acceptCnt++;
+        return true;
+    }
+
+    s_scanFilterStats.dropPreAllocCnt++;
+    return false;
+}
+
+void APP_SCAN_FILTER_CountPostAllocDrop(void)
+{
+    //Called from both the stack callback and the application task
+    __atomic_add_fetch(&s_scanFilterStats.dropPostAllocCnt, 1, __ATOMIC_RELAXED);
+}
+
+static uint8_t app_scan_filter_FindPeer(uint8_t devId)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_scanFilterStats.acceptListCnt; i++)
+    {
+        if (s_acceptListDevId[i] == devId)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+uint16_t APP_SCAN_FILTER_LearnPeer(uint8_t devId)
+{
+    uint16_t result;
+    uint8_t idx;
+
+    idx = app_scan_filter_FindPeer(devId);
+    if (idx < s_scanFilterStats.acceptListCnt)
+    {
+        //Bonded again under the same ID, the identity address may have changed
+        return BLE_DM_SetFilterAcceptList(s_scanFilterStats.acceptListCnt, s_acceptListDevId);
+    }
+
+    if (s_scanFilterStats.acceptListCnt >= BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM)
+    {
+        return MBA_RES_NO_RESOURCE;
+    }
+
+    s_acceptListDevId[s_scanFilterStats.acceptListCnt] = devId;
+    result = BLE_DM_SetFilterAcceptList(s_scanFilterStats.acceptListCnt + 1U, s_acceptListDevId);
+    if (result == MBA_RES_SUCCESS)
+    {
+        s_scanFilterStats.acceptListCnt++;
+    }
+
+    return result;
+}
+
+uint16_t APP_SCAN_FILTER_ForgetPeer(uint8_t devId)
+{
+    uint8_t idx;
+
+    idx = app_scan_filter_FindPeer(devId);
+    if (idx >= s_scanFilterStats.acceptListCnt)
+    {
+        return MBA_RES_SUCCESS;
+    }
+
+    (void)memmove(&s_acceptListDevId[idx], &s_acceptListDevId[idx + 1U], s_scanFilterStats.acceptListCnt - idx - 1U);
+    s_scanFilterStats.acceptListCnt--;
+
+    return BLE_DM_SetFilterAcceptList(s_scanFilterStats.acceptListCnt, s_acceptListDevId);
+}
+
+uint8_t APP_SCAN_FILTER_GetScanFilterPolicy(void)
+{
+    if (APP_SCAN_FILTER_ACCEPT_LIST_ONLY && (s_scanFilterStats.acceptListCnt > 0U))
+    {
+        return BLE_GAP_SCAN_FP_ACCEPT_LIST;
+    }
+
+    return BLE_GAP_SCAN_FP_ACCEPT_ALL;
+}
+
+void APP_SCAN_FILTER_GetStats(APP_SCAN_FILTER_Stats_T *p_stats)
+{
+    (void)memcpy(p_stats, &s_scanFilterStats, sizeof(APP_SCAN_FILTER_Stats_T));
+}
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application BLE Scan Filter Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_ble_scan_filter.h
+
+  Summary:
+    This file contains the Application BLE scan filter for this project.
+
+  Description:
+    Selects Proximity Reporters among the received advertising reports. The
+    service data match is offloaded to the BLE stack scanning filter, reports
+    that still do not match are dropped in the stack callback before any
+    buffer is allocated, and bonded reporters are learned into the controller
+    Filter Accept List.
+ *******************************************************************************/
+
+#ifndef APP_BLE_SCAN_FILTER_H
+#define APP_BLE_SCAN_FILTER_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@defgroup APP_SCAN_FILTER_MATCH APP_SCAN_FILTER_MATCH
+ * @brief The definition of the Service Data AD structure advertised by the Proximity Reporter.
+ * @{ */
+#define APP_SCAN_FILTER_AD_TYPE_SERVICE_DATA   0x16     /**< AD type of Service Data - 16-bit UUID. */
+#define APP_SCAN_FILTER_SERVICE_UUID           0xFEDA   /**< Service UUID to match. */
+#define APP_SCAN_FILTER_SERVICE_DATA           0xFF20   /**< Service data to match, big endian as advertised. */
+/** @} */
+
+/**@brief Set true to scan with @ref BLE_GAP_SCAN_FP_ACCEPT_LIST when bonded reporters are known at start-up.
+ *        New, not yet bonded reporters are then no longer discovered, so a second tag could never be paired;
+ *        this is why it is off by default. The Filter Accept List is kept up to date either way. */
+#define APP_SCAN_FILTER_ACCEPT_LIST_ONLY       false
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Statistics of the scan filter. */
+typedef struct APP_SCAN_FILTER_Stats_T
+{
+    uint32_t    rxCnt;              /**< Advertising reports delivered by the stack. */
+    uint32_t    dropPreAllocCnt;    /**< Reports rejected in the stack callback, before allocation. */
+    uint32_t    dropPostAllocCnt;   /**< Reports accepted by the filter but dropped afterwards (no buffer or app queue full). */
+    uint32_t    acceptCnt;          /**< Reports accepted by the filter. acceptCnt - dropPostAllocCnt reached the application. */
+    uint8_t     acceptListCnt;      /**< Bonded reporters in the Filter Accept List. */
+    bool        stackFilterEnabled; /**< The stack scanning filter has been configured. */
+} APP_SCAN_FILTER_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the scan filter. It configures the stack scanning filter and
+ *        loads the already bonded devices into the Filter Accept List.
+ *        Must be called after BLE_DM is initialized.
+ */
+void APP_SCAN_FILTER_Init(void);
+
+/**@brief The function is used to check an advertising report against the filter.
+ *        It is safe to call from the BLE stack callback context.
+ *@param[in] p_report                         Pointer to the advertising report.
+ *
+ * @retval true                               The report comes from a Proximity Reporter.
+ * @retval false                              The report shall be dropped.
+ *
+ */
+bool APP_SCAN_FILTER_ProcAdvReport(const BLE_GAP_EvtAdvReport_T *p_report);
+
+/**@brief The function is used to check an extended advertising report against the filter.
+ *        Only complete reports of connectable advertising are accepted, as they are the only ones a connection can follow.
+ *        In connectionless mode only complete reports of periodic advertising sets are accepted instead.
+ *        It is safe to call from the BLE stack callback context.
+ *@param[in] p_report                         Pointer to the extended advertising report.
+ *
+ * @retval true                               The report comes from a Proximity Reporter.
+ * @retval false                              The report shall be dropped.
+ *
+ */
+bool APP_SCAN_FILTER_ProcExtAdvReport(const BLE_GAP_EvtExtAdvReport_T *p_report);
+
+/**@brief The function is used to count an accepted report that could not be delivered.
+ *        It is safe to call from both the BLE stack callback and the application task.
+ */
+void APP_SCAN_FILTER_CountPostAllocDrop(void);
+
+/**@brief The function is used to add a bonded device to the Filter Accept List.
+ *@param[in] devId                            Paired device ID.
+ *
+ * @retval MBA_RES_SUCCESS                    The device is in the Filter Accept List.
+ * @retval MBA_RES_NO_RESOURCE                The Filter Accept List is full.
+ * @retval Others                             See @ref BLE_DM_SetFilterAcceptList.
+ *
+ */
+uint16_t APP_SCAN_FILTER_LearnPeer(uint8_t devId);
+
+/**@brief The function is used to remove a device from the Filter Accept List. Call it whenever its bond is deleted.
+ *@param[in] devId                            Paired device ID.
+ *
+ * @retval MBA_RES_SUCCESS                    The device is not in the Filter Accept List anymore.
+ * @retval Others                             See @ref BLE_DM_SetFilterAcceptList.
+ *
+ */
+uint16_t APP_SCAN_FILTER_ForgetPeer(uint8_t devId);
+
+/**@brief The function is used to get the scanning filter policy to use with @ref BLE_GAP_SetScanningParam or @ref BLE_GAP_SetExtScanningParams.
+ *
+ * @retval Scan filter policy. See @ref BLE_GAP_SCAN_FP.
+ *
+ */
+uint8_t APP_SCAN_FILTER_GetScanFilterPolicy(void);
+
+/**@brief The function is used to get a snapshot of the scan filter statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_SCAN_FILTER_GetStats(APP_SCAN_FILTER_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_BLE_SCAN_FILTER_H */
+
+
+/*******************************************************************************
+ End of File
+ */
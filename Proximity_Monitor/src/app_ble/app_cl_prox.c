@@ -0,0 +1,509 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Connectionless Proximity Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_cl_prox.c
+
+  Summary:
+    This file contains the connectionless proximity mode of the Proximity Monitor.
+
+  Description:
+    This file contains the connectionless proximity mode of the Proximity Monitor.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app.h"
+#include "mba_error_defs.h"
+#include "app_ble.h"
+#include "app_cl_prox.h"
+#include "ble_pxpm/ble_pxpm.h"
+#include "app_zone_est.h"
+#include "app_log/app_log.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_CL_PROX_TAG_INVALID         APP_CL_PROX_TAG_NUM
+#define APP_CL_PROX_SYNC_FAIL_MAX       3           /**< Failed syncs before a reporter is forgotten until it is seen again. */
+#define APP_CL_PROX_RSSI_UNAVAILABLE    127
+
+/* Queued by copy in APP_Msg_T.msgData */
+APP_MSG_DATA_FITS(APP_ClProxSample_T);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The definition of the tag state. */
+typedef enum APP_CL_PROX_TagState_T
+{
+    APP_CL_PROX_TAG_STATE_FREE,         /**< Entry is free. */
+    APP_CL_PROX_TAG_STATE_UNSYNCED,     /**< Reporter seen, waiting for its turn to synchronize. */
+    APP_CL_PROX_TAG_STATE_SYNCING,      /**< Sync requested. */
+    APP_CL_PROX_TAG_STATE_SYNCED,       /**< Receiving the periodic advertising train. */
+} APP_CL_PROX_TagState_T;
+
+/**@brief Reporter followed through its periodic advertising. */
+typedef struct APP_CL_PROX_Tag_T
+{
+    APP_CL_PROX_TagState_T  state;          /**< Tag state. */
+    BLE_GAP_Addr_T          addr;           /**< Address of the reporter. */
+    uint8_t                 sid;            /**< Advertising SID of the periodic advertising set. */
+    uint8_t                 syncFailCnt;    /**< Consecutive failed syncs. */
+    uint16_t                periAdvInterval;/**< Periodic advertising interval (unit: 1.25ms). */
+    uint16_t                syncHandle;     /**< Sync handle of the train. */
+    uint16_t                seq;            /**< Sequence number of the last payload. */
+    uint8_t                 alertLevel;     /**< Alert level advertised by the reporter. */
+    bool                    alertPending;   /**< Set from a connection request until the advertised alert level changes. */
+    TickType_t              retryTick;      /**< Earliest time of the next sync or alert attempt, or when the tag started waiting for a sync. */
+    TickType_t              syncTick;       /**< Time the sync was established. */
+    APP_ZONE_EST_State_T    zoneEst;        /**< Zone estimator of the reporter. */
+} APP_CL_PROX_Tag_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_CL_PROX_Tag_T    s_clProxTag[APP_CL_PROX_TAG_NUM];
+static uint8_t              s_clProxSyncIdx;
+static TickType_t           s_clProxSyncTick;
+static bool                 s_clProxSyncCancelled;
+static APP_CL_PROX_Stats_T  s_clProxStats;
+
+/* Same zones as the connected mode. Only the thresholds and hysteresis are used by the estimator. */
+static const BLE_GAP_SetPathLossReportingParams_T s_clProxThr =
+{
+    .highThreshold = APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD,
+    .highHysteresis = APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS,
+    .lowThreshold = APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD,
+    .lowHysteresis = APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS,
+    .minTimeSpent = APP_PXPM_CTX_PATH_LOSS_MIN_TIME_SPENT,
+};
+
+/* Length and type of the Service Data AD structure, service UUID and frame ID. */
+static const uint8_t s_clProxFrameHdr[] =
+{
+    APP_CL_PROX_FRAME_LEN - 1, 0x16, 0xDA, 0xFE, (uint8_t)(APP_CL_PROX_FRAME_ID >> 8), (uint8_t)(APP_CL_PROX_FRAME_ID & 0xFF)
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static bool app_cl_prox_IsDue(TickType_t tick)
+{
+    return ((int32_t)(xTaskGetTickCount() - tick) >= 0);
+}
+
+static APP_CL_PROX_Tag_T *app_cl_prox_FindByAddr(const BLE_GAP_Addr_T *p_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < APP_CL_PROX_TAG_NUM; i++)
+    {
+        if ((s_clProxTag[i].state != APP_CL_PROX_TAG_STATE_FREE)
+            && (s_clProxTag[i].addr.addrType == p_addr->addrType)
+            && (memcmp(s_clProxTag[i].addr.addr, p_addr->addr, GAP_MAX_BD_ADDRESS_LEN) == 0))
+        {
+            return &s_clProxTag[i];
+        }
+    }
+
+    return NULL;
+}
+
+static APP_CL_PROX_Tag_T *app_cl_prox_FindBySyncHandle(uint16_t syncHandle)
+{
+    uint8_t i;
+
+    for (i = 0; i < APP_CL_PROX_TAG_NUM; i++)
+    {
+        if ((s_clProxTag[i].state == APP_CL_PROX_TAG_STATE_SYNCED) && (s_clProxTag[i].syncHandle == syncHandle))
+        {
+            return &s_clProxTag[i];
+        }
+    }
+
+    return NULL;
+}
+
+static uint16_t app_cl_prox_CreateSync(APP_CL_PROX_Tag_T *p_tag)
+{
+    BLE_GAP_CreateSync_T createSync;
+    uint32_t syncTimeout;
+
+    //Timeout in 10ms units from the interval in 1.25ms units
+    syncTimeout = ((uint32_t)p_tag->periAdvInterval * APP_CL_PROX_SYNC_TIMEOUT_EVTS) / 8U;
+    if (syncTimeout < BLE_GAP_SYNC_TIMEOUT_MIN)
+    {
+        syncTimeout = BLE_GAP_SYNC_TIMEOUT_MIN;
+    }
+    else if (syncTimeout > BLE_GAP_SYNC_TIMEOUT_MAX)
+    {
+        syncTimeout = BLE_GAP_SYNC_TIMEOUT_MAX;
+    }
+
+    (void)memset(&createSync, 0, sizeof(BLE_GAP_CreateSync_T));
+    createSync.options = 0;
+    createSync.advSid = p_tag->sid;
+    (void)memcpy(&createSync.advAddr, &p_tag->addr, sizeof(BLE_GAP_Addr_T));
+    createSync.skip = 0;
+    createSync.syncTimeout = (uint16_t)syncTimeout;
+
+    return BLE_GAP_CreateSync(&createSync);
+}
+
+static void app_cl_prox_SyncFailed(APP_CL_PROX_Tag_T *p_tag)
+{
+    s_clProxStats.syncFailCnt++;
+    p_tag->syncFailCnt++;
+    if (p_tag->syncFailCnt >= APP_CL_PROX_SYNC_FAIL_MAX)
+    {
+        p_tag->state = APP_CL_PROX_TAG_STATE_FREE;
+        return;
+    }
+
+    p_tag->state = APP_CL_PROX_TAG_STATE_UNSYNCED;
+    p_tag->retryTick = xTaskGetTickCount() + pdMS_TO_TICKS(APP_CL_PROX_RETRY_MS);
+}
+
+static void app_cl_prox_Pump(void)
+{
+    APP_CL_PROX_Tag_T *p_next = NULL;
+    APP_CL_PROX_Tag_T *p_oldest = NULL;
+    uint8_t syncCnt = 0;
+    uint8_t i;
+
+    //The stack takes one sync request at a time
+    if (s_clProxSyncIdx != APP_CL_PROX_TAG_INVALID)
+    {
+        if (!s_clProxSyncCancelled
+            && ((xTaskGetTickCount() - s_clProxSyncTick) * portTICK_PERIOD_MS >= APP_CL_PROX_SYNC_PENDING_MAX_MS))
+        {
+            //Completed by BLE_GAP_EVT_PERI_ADV_SYNC_EST with an error status
+            s_clProxSyncCancelled = (BLE_GAP_CreateSyncCancel() == MBA_RES_SUCCESS);
+        }
+        return;
+    }
+
+    //The tag waiting the longest, and the synced tag past its dwell for the longest
+    for (i = 0; i < APP_CL_PROX_TAG_NUM; i++)
+    {
+        APP_CL_PROX_Tag_T *p_tag = &s_clProxTag[i];
+
+        if (p_tag->state == APP_CL_PROX_TAG_STATE_SYNCED)
+        {
+            syncCnt++;
+            //A tag with an alert pending keeps its sync to see the advertised level change
+            if (!p_tag->alertPending
+                && app_cl_prox_IsDue(p_tag->syncTick + pdMS_TO_TICKS(APP_CL_PROX_SYNC_DWELL_MS))
+                && ((p_oldest == NULL) || ((int32_t)(p_tag->syncTick - p_oldest->syncTick) < 0)))
+            {
+                p_oldest = p_tag;
+            }
+        }
+        else if ((p_tag->state == APP_CL_PROX_TAG_STATE_UNSYNCED) && app_cl_prox_IsDue(p_tag->retryTick)
+            && ((p_next == NULL) || ((int32_t)(p_tag->retryTick - p_next->retryTick) < 0)))
+        {
+            p_next = p_tag;
+        }
+    }
+
+    if (p_next == NULL)
+    {
+        return;
+    }
+
+    if (syncCnt >= APP_CL_PROX_SYNC_NUM)
+    {
+        if ((p_oldest == NULL) || (BLE_GAP_TerminateSync(p_oldest->syncHandle) != MBA_RES_SUCCESS))
+        {
+            return;
+        }
+
+        //Back in line behind every tag already waiting
+        p_oldest->state = APP_CL_PROX_TAG_STATE_UNSYNCED;
+        p_oldest->retryTick = xTaskGetTickCount();
+        s_clProxStats.syncRotateCnt++;
+    }
+
+    if (app_cl_prox_CreateSync(p_next) == MBA_RES_SUCCESS)
+    {
+        p_next->state = APP_CL_PROX_TAG_STATE_SYNCING;
+        s_clProxSyncIdx = (uint8_t)(p_next - s_clProxTag);
+        s_clProxSyncTick = xTaskGetTickCount();
+        s_clProxSyncCancelled = false;
+        return;
+    }
+
+    app_cl_prox_SyncFailed(p_next);
+}
+
+void APP_CL_PROX_Init(void)
+{
+    (void)memset(s_clProxTag, 0, sizeof(s_clProxTag));
+    (void)memset(&s_clProxStats, 0, sizeof(APP_CL_PROX_Stats_T));
+    s_clProxSyncIdx = APP_CL_PROX_TAG_INVALID;
+    s_clProxSyncCancelled = false;
+}
+
+void APP_CL_PROX_ProcAdvReport(const BLE_GAP_EvtExtAdvReport_T *p_report)
+{
+    APP_CL_PROX_Tag_T *p_tag = app_cl_prox_FindByAddr(&p_report->addr);
+    uint8_t i;
+
+    if (p_tag == NULL)
+    {
+        for (i = 0; i < APP_CL_PROX_TAG_NUM; i++)
+        {
+            if (s_clProxTag[i].state == APP_CL_PROX_TAG_STATE_FREE)
+            {
+                p_tag = &s_clProxTag[i];
+                (void)memset(p_tag, 0, sizeof(APP_CL_PROX_Tag_T));
+                (void)memcpy(&p_tag->addr, &p_report->addr, sizeof(BLE_GAP_Addr_T));
+                p_tag->state = APP_CL_PROX_TAG_STATE_UNSYNCED;
+                p_tag->retryTick = xTaskGetTickCount();
+                break;
+            }
+        }
+    }
+
+    if ((p_tag != NULL) && (p_tag->state == APP_CL_PROX_TAG_STATE_UNSYNCED))
+    {
+        p_tag->sid = p_report->sid;
+        p_tag->periAdvInterval = p_report->periodAdvInterval;
+    }
+
+    app_cl_prox_Pump();
+}
+
+void APP_CL_PROX_ProcPeriAdvReport(const BLE_GAP_EvtPeriAdvReport_T *p_report)
+{
+    APP_Msg_T appMsg;
+    APP_ClProxSample_T *p_sample = (APP_ClProxSample_T *)appMsg.msgData;
+    const uint8_t *p_frame = p_report->advData;
+
+    if ((p_report->dataStatus != BLE_GAP_DATA_STATUS_COMPLETE)
+        || (p_report->dataLength < APP_CL_PROX_FRAME_LEN)
+        || (memcmp(p_frame, s_clProxFrameHdr, sizeof(s_clProxFrameHdr)) != 0))
+    {
+        return;
+    }
+
+    appMsg.msgId = APP_MSG_PERI_ADV_EVT;
+    appMsg.msgLen = sizeof(APP_ClProxSample_T);
+    p_sample->syncHandle = p_report->syncHandle;
+    p_sample->seq = (uint16_t)(p_frame[APP_CL_PROX_FRAME_POS_SEQ] | (p_frame[APP_CL_PROX_FRAME_POS_SEQ + 1] << 8));
+    p_sample->rssi = p_report->rssi;
+    p_sample->txPower = (int8_t)p_frame[APP_CL_PROX_FRAME_POS_TX_POWER];
+    p_sample->alertLevel = p_frame[APP_CL_PROX_FRAME_POS_ALERT_LEVEL];
+
+    if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) != OSAL_RESULT_TRUE)
+    {
+        s_clProxStats.reportDropCnt++;
+    }
+}
+
+void APP_CL_PROX_SyncEstHandler(const BLE_GAP_EvtPeriAdvSyncEst_T *p_evt)
+{
+    APP_CL_PROX_Tag_T *p_tag;
+    uint8_t idx = s_clProxSyncIdx;
+
+    s_clProxSyncIdx = APP_CL_PROX_TAG_INVALID;
+    s_clProxSyncCancelled = false;
+
+    if ((idx != APP_CL_PROX_TAG_INVALID) && (s_clProxTag[idx].state == APP_CL_PROX_TAG_STATE_SYNCING))
+    {
+        p_tag = &s_clProxTag[idx];
+        APP_LOG3(APP_LOG_ID_CL_PROX_SYNC, idx, p_evt->status, p_evt->periAdvInterval);
+
+        if (p_evt->status == GAP_STATUS_SUCCESS)
+        {
+            p_tag->state = APP_CL_PROX_TAG_STATE_SYNCED;
+            p_tag->syncHandle = p_evt->syncHandle;
+            p_tag->syncTick = xTaskGetTickCount();
+            p_tag->syncFailCnt = 0;
+            p_tag->alertPending = false;
+            //The first report seeds the estimator with the alert level the reporter advertises
+            APP_ZONE_EST_Reset(&p_tag->zoneEst, APP_ZONE_EST_ZONE_LOW);
+            s_clProxStats.syncEstCnt++;
+        }
+        else
+        {
+            app_cl_prox_SyncFailed(p_tag);
+        }
+    }
+
+    app_cl_prox_Pump();
+}
+
+void APP_CL_PROX_SyncLostHandler(const BLE_GAP_EvtPeriAdvSyncLost_T *p_evt)
+{
+    APP_CL_PROX_Tag_T *p_tag = app_cl_prox_FindBySyncHandle(p_evt->syncHandle);
+
+    if (p_tag == NULL)
+    {
+        return;
+    }
+
+    //The reporter is learned again from its extended advertising if it comes back
+    APP_LOG1(APP_LOG_ID_CL_PROX_LOST, (uint8_t)(p_tag - s_clProxTag));
+    p_tag->state = APP_CL_PROX_TAG_STATE_FREE;
+    s_clProxStats.syncLostCnt++;
+}
+
+void APP_CL_PROX_SampleHandler(const APP_ClProxSample_T *p_sample)
+{
+    APP_CL_PROX_Tag_T *p_tag = app_cl_prox_FindBySyncHandle(p_sample->syncHandle);
+    uint8_t idx;
+    APP_Msg_T appMsg;
+    APP_BleScanEvt_T *p_scanEvt = (APP_BleScanEvt_T *)appMsg.msgData;
+
+    if ((p_tag == NULL) || (p_sample->rssi == APP_CL_PROX_RSSI_UNAVAILABLE))
+    {
+        return;
+    }
+
+    idx = (uint8_t)(p_tag - s_clProxTag);
+    s_clProxStats.reportCnt++;
+
+    //The sequence number only moves when the payload changes
+    if (!p_tag->zoneEst.primed)
+    {
+        APP_ZONE_EST_Reset(&p_tag->zoneEst, p_sample->alertLevel);
+    }
+    else if ((uint16_t)(p_sample->seq - p_tag->seq) > 1U)
+    {
+        s_clProxStats.seqGapCnt++;
+    }
+    p_tag->seq = p_sample->seq;
+
+    //Only the reporter advertising another level confirms the alert, a finished connection does not
+    if (p_tag->alertPending && (p_sample->alertLevel != p_tag->alertLevel))
+    {
+        p_tag->alertPending = false;
+        s_clProxStats.alertConfirmCnt++;
+        APP_LOG2(APP_LOG_ID_CL_PROX_CONFIRM, idx, p_sample->alertLevel);
+    }
+    p_tag->alertLevel = p_sample->alertLevel;
+
+    if (APP_ZONE_EST_Update(&p_tag->zoneEst, &s_clProxThr, (int16_t)p_sample->txPower - p_sample->rssi))
+    {
+        APP_LOG3(APP_LOG_ID_CL_PROX_ZONE, idx, p_tag->zoneEst.pathLoss >> 8, p_tag->zoneEst.zone);
+    }
+
+    if (p_tag->zoneEst.zone == p_tag->alertLevel)
+    {
+        //Zone and advertised level agree: an alert not confirmed yet is no longer needed
+        p_tag->alertPending = false;
+        return;
+    }
+
+    if (p_tag->alertPending && !app_cl_prox_IsDue(p_tag->retryTick))
+    {
+        return;
+    }
+
+    //Connect through the same path as a scanned reporter; the IAS is written once discovery completes
+    appMsg.msgId = APP_MSG_BLE_SCAN_EVT;
+    appMsg.msgLen = sizeof(APP_BleScanEvt_T);
+    (void)memcpy(&p_scanEvt->addr, &p_tag->addr, sizeof(BLE_GAP_Addr_T));
+    p_scanEvt->rssi = p_sample->rssi;
+    if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) == OSAL_RESULT_TRUE)
+    {
+        p_tag->alertPending = true;
+        p_tag->retryTick = xTaskGetTickCount() + pdMS_TO_TICKS(APP_CL_PROX_RETRY_MS);
+        s_clProxStats.alertConnCnt++;
+        APP_LOG3(APP_LOG_ID_CL_PROX_ALERT, idx, p_tag->zoneEst.zone, p_tag->alertLevel);
+    }
+}
+
+void APP_CL_PROX_ConnectedHandler(APP_PXPM_Ctx_T *p_ctx)
+{
+    APP_CL_PROX_Tag_T *p_tag = app_cl_prox_FindByAddr(&p_ctx->peerAddr);
+
+    if ((p_tag == NULL) || (p_tag->state != APP_CL_PROX_TAG_STATE_SYNCED))
+    {
+        return;
+    }
+
+    //The connect bootstrap writes the zone to the IAS
+    p_ctx->zone = p_tag->zoneEst.zone;
+}
+
+void APP_CL_PROX_AlertDelivered(uint16_t connHandle)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+
+    if (p_ctx == NULL)
+    {
+        return;
+    }
+
+    //An IAS write without response may still wait for a TX buffer
+    if (!BLE_PXPM_IsWriteQueueEmpty(connHandle))
+    {
+        p_ctx->releasePending = true;
+        return;
+    }
+
+    (void)BLE_GAP_Disconnect(connHandle, GAP_DISC_REASON_REMOTE_TERMINATE);
+}
+
+void APP_CL_PROX_WriteQueueEmpty(uint16_t connHandle)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+
+    if ((p_ctx == NULL) || !p_ctx->releasePending)
+    {
+        return;
+    }
+
+    p_ctx->releasePending = false;
+    (void)BLE_GAP_Disconnect(connHandle, GAP_DISC_REASON_REMOTE_TERMINATE);
+}
+
+void APP_CL_PROX_GetStats(APP_CL_PROX_Stats_T *p_stats)
+{
+    (void)memcpy(p_stats, &s_clProxStats, sizeof(APP_CL_PROX_Stats_T));
+}
@@ -0,0 +1,205 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Connectionless Proximity Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_cl_prox.h
+
+  Summary:
+    This file contains the connectionless proximity mode of the Proximity Monitor.
+
+  Description:
+    Reporters broadcast their TX power, IAS alert level and a sequence number
+    in periodic advertising. The monitor synchronizes to the train of every
+    reporter it finds, feeds TX power minus RSSI of each report to the zone
+    estimator, and only connects to a reporter to write its IAS when the
+    estimated zone differs from the alert level the reporter broadcasts.
+    Enabled by APP_BLE_CONNECTIONLESS.
+ *******************************************************************************/
+
+#ifndef APP_CL_PROX_H
+#define APP_CL_PROX_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "app_pxpm_ctx.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Maximum number of reporters tracked. Reporters seen beyond this are ignored until an entry is freed. */
+#define APP_CL_PROX_TAG_NUM                    32
+
+/**@brief Periodic advertising trains synchronized at once. Must not exceed the sync sets of the controller.
+ *        With more reporters tracked, the slots are time-shared: a reporter gives up its sync after
+ *        APP_CL_PROX_SYNC_DWELL_MS when another one waits, so each tracked reporter is followed for
+ *        APP_CL_PROX_SYNC_DWELL_MS out of about (APP_CL_PROX_TAG_NUM / APP_CL_PROX_SYNC_NUM) times that. */
+#define APP_CL_PROX_SYNC_NUM                   4
+#define APP_CL_PROX_SYNC_DWELL_MS              10000    /**< Time a reporter keeps its sync while others wait (unit: ms). */
+
+#define APP_CL_PROX_SYNC_TIMEOUT_EVTS          6        /**< Periodic advertising events missed before the sync is lost. */
+#define APP_CL_PROX_SYNC_PENDING_MAX_MS        5000     /**< A sync not established in this time is cancelled (unit: ms). */
+#define APP_CL_PROX_RETRY_MS                   5000     /**< Wait before a failed sync or alert of a reporter is retried (unit: ms). */
+
+/**@defgroup APP_CL_PROX_FRAME APP_CL_PROX_FRAME
+ * @brief The definition of the periodic advertising payload of the reporter. Must match the reporter.
+ * @{ */
+#define APP_CL_PROX_FRAME_LEN                  10       /**< Payload length, including the AD length byte. */
+#define APP_CL_PROX_FRAME_ID                   0xFF21   /**< Service data identifying the frame, big endian as advertised. */
+#define APP_CL_PROX_FRAME_POS_TX_POWER         6        /**< TX power of the train (unit: dBm). */
+#define APP_CL_PROX_FRAME_POS_ALERT_LEVEL      7        /**< Alert level last written to the IAS. */
+#define APP_CL_PROX_FRAME_POS_SEQ              8        /**< Sequence number, little endian. */
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief One periodic advertising report, parsed in the stack callback and queued with APP_MSG_PERI_ADV_EVT. */
+typedef struct APP_ClProxSample_T
+{
+    uint16_t    syncHandle;                 /**< Sync handle of the train. */
+    uint16_t    seq;                        /**< Sequence number of the payload. */
+    int8_t      rssi;                       /**< RSSI of the report (unit: dBm). */
+    int8_t      txPower;                    /**< TX power advertised by the reporter (unit: dBm). */
+    uint8_t     alertLevel;                 /**< Alert level advertised by the reporter. */
+} APP_ClProxSample_T;
+
+/**@brief Statistics of the connectionless proximity mode. */
+typedef struct APP_CL_PROX_Stats_T
+{
+    uint32_t    syncEstCnt;                 /**< Syncs established. */
+    uint32_t    syncFailCnt;                /**< Syncs failed or cancelled. */
+    uint32_t    syncLostCnt;                /**< Syncs lost. */
+    uint32_t    reportCnt;                  /**< Reports fed to the zone estimator. */
+    uint32_t    reportDropCnt;              /**< Reports dropped because the application queue was full. */
+    uint32_t    seqGapCnt;                  /**< Payload updates missed, from sequence number jumps. */
+    uint32_t    alertConnCnt;               /**< Connections requested to deliver an alert. */
+    uint32_t    alertConfirmCnt;            /**< Alerts confirmed by a change of the alert level the reporter advertises. */
+    uint32_t    syncRotateCnt;              /**< Syncs terminated to give the slot to a waiting reporter. */
+} APP_CL_PROX_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the tag table. All tags are released.
+ */
+void APP_CL_PROX_Init(void);
+
+/**@brief The function is used to learn a reporter from an extended advertising report of its periodic advertising set,
+ *        and synchronize to the next reporter waiting for a sync.
+ *@param[in] p_report                         Pointer to the report, already accepted by the scan filter.
+ *
+ */
+void APP_CL_PROX_ProcAdvReport(const BLE_GAP_EvtExtAdvReport_T *p_report);
+
+/**@brief The function is used to parse a periodic advertising report and queue it to the application task.
+ *        Called from the stack callback, so the report does not claim an event pool buffer.
+ *@param[in] p_report                         Pointer to the report.
+ *
+ */
+void APP_CL_PROX_ProcPeriAdvReport(const BLE_GAP_EvtPeriAdvReport_T *p_report);
+
+/**@brief The function is used to handle @ref BLE_GAP_EVT_PERI_ADV_SYNC_EST.
+ *@param[in] p_evt                            Pointer to the event.
+ *
+ */
+void APP_CL_PROX_SyncEstHandler(const BLE_GAP_EvtPeriAdvSyncEst_T *p_evt);
+
+/**@brief The function is used to handle @ref BLE_GAP_EVT_PERI_ADV_SYNC_LOST.
+ *@param[in] p_evt                            Pointer to the event.
+ *
+ */
+void APP_CL_PROX_SyncLostHandler(const BLE_GAP_EvtPeriAdvSyncLost_T *p_evt);
+
+/**@brief The function is used to feed one report to the zone estimator of its reporter. Called by the application task
+ *        on APP_MSG_PERI_ADV_EVT. A connection is requested when the zone and the advertised alert level differ,
+ *        and requested again every APP_CL_PROX_RETRY_MS until the advertised alert level changes.
+ *@param[in] p_sample                         Pointer to the parsed report.
+ *
+ */
+void APP_CL_PROX_SampleHandler(const APP_ClProxSample_T *p_sample);
+
+/**@brief The function is used to prepare the context of a new link with the zone of its reporter,
+ *        which the connect bootstrap writes to the IAS.
+ *@param[in] p_ctx                            Pointer to the context.
+ *
+ */
+void APP_CL_PROX_ConnectedHandler(APP_PXPM_Ctx_T *p_ctx);
+
+/**@brief The function is used to release a link once the connect bootstrap is finished.
+ *        The link is kept until every Alert Level write of the PXP Monitor has gone out.
+ *@param[in] connHandle                       Connection handle.
+ *
+ */
+void APP_CL_PROX_AlertDelivered(uint16_t connHandle);
+
+/**@brief The function is used to handle @ref BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND. A link waiting for its writes is released.
+ *@param[in] connHandle                       Connection handle.
+ *
+ */
+void APP_CL_PROX_WriteQueueEmpty(uint16_t connHandle);
+
+/**@brief The function is used to get the statistics of the connectionless proximity mode.
+ *@param[out] p_stats                         Pointer to the statistics.
+ *
+ */
+void APP_CL_PROX_GetStats(APP_CL_PROX_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_CL_PROX_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,250 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Connection Parameter Policy Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_conn_policy.c
+
+  Summary:
+    This file contains the zone driven connection parameter policy of the Proximity Monitor.
+
+  Description:
+    This file contains the zone driven connection parameter policy of the Proximity Monitor.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mba_error_defs.h"
+#include "ble_dm/ble_dm.h"
+#include "app_conn_policy.h"
+#include "app_pxpm_ctx.h"
+#include "app_log/app_log.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_CONN_POLICY_Level_T
+{
+    uint16_t    interval;                   /**< Connection interval (unit: 1.25ms). */
+    uint16_t    latency;                    /**< Peripheral latency (unit: connection events). */
+    uint16_t    timeout;                    /**< Supervision timeout (unit: 10ms). */
+} APP_CONN_POLICY_Level_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+/* Level 0 is the connection the monitor creates. The zone estimator gets one RSSI sample per effective connection
+   event, interval x (1 + latency), and needs about a dozen of them to see a zone change; longer effective
+   intervals than 150ms put alerts seconds late (see tools/host_test/test_conn_policy.c). */
+static const APP_CONN_POLICY_Level_T s_connPolicyLevel[APP_CONN_POLICY_LEVEL_MAX + 1] =
+{
+    {16,    0,  72},        /* 20ms */
+    {40,    0,  100},       /* 50ms */
+    {40,    1,  100},       /* 50ms, reporter listens every 100ms */
+    {40,    2,  100},       /* 50ms, reporter listens every 150ms */
+};
+
+static APP_CONN_POLICY_Stats_T s_connPolicyStats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint32_t app_conn_policy_Distance(int32_t pathLoss, int32_t boundary)
+{
+    return (uint32_t)((pathLoss > boundary) ? (pathLoss - boundary) : (boundary - pathLoss));
+}
+
+static bool app_conn_policy_NearBoundary(const APP_PXPM_Ctx_T *p_ctx)
+{
+    const BLE_GAP_SetPathLossReportingParams_T *p_thr = &p_ctx->pathLossParams;
+    int32_t pathLoss = p_ctx->zoneEst.pathLoss;
+    uint32_t margin = (uint32_t)APP_CONN_POLICY_MARGIN << 8;
+
+    //The boundaries are the enter and leave points of the high and low zones, see the zone estimator
+    return (app_conn_policy_Distance(pathLoss, ((int32_t)p_thr->highThreshold + p_thr->highHysteresis) << 8) < margin)
+        || (app_conn_policy_Distance(pathLoss, ((int32_t)p_thr->highThreshold - p_thr->highHysteresis) << 8) < margin)
+        || (app_conn_policy_Distance(pathLoss, ((int32_t)p_thr->lowThreshold + p_thr->lowHysteresis) << 8) < margin)
+        || (app_conn_policy_Distance(pathLoss, ((int32_t)p_thr->lowThreshold - p_thr->lowHysteresis) << 8) < margin);
+}
+
+static void app_conn_policy_Apply(APP_PXPM_Ctx_T *p_ctx)
+{
+    APP_CONN_POLICY_State_T *p_state = &p_ctx->connPolicy;
+    const APP_CONN_POLICY_Level_T *p_level = &s_connPolicyLevel[p_state->desired];
+    BLE_DM_ConnConfig_T bounds;
+    BLE_DM_ConnParamUpdate_T params;
+    uint32_t minTimeout;
+    TickType_t now = xTaskGetTickCount();
+
+    if (p_state->inFlight || (p_state->desired == p_state->applied)
+        || ((now - p_state->failTick) < pdMS_TO_TICKS(APP_CONN_POLICY_RETRY_TIME)))
+    {
+        return;
+    }
+
+    if (BLE_DM_GetConnConfig(&bounds) != MBA_RES_SUCCESS)
+    {
+        bounds.minAcceptConnInterval = BLE_GAP_CP_MIN_CONN_INTVAL_MIN;
+        bounds.maxAcceptConnInterval = BLE_GAP_CP_MAX_CONN_INTVAL_MAX;
+        bounds.minAcceptPeripheralLatency = BLE_GAP_CP_LATENCY_MIN;
+        bounds.maxAcceptPeripheralLatency = BLE_GAP_CP_LATENCY_MAX;
+    }
+
+    params.intervalMin = p_level->interval;
+    if (params.intervalMin < bounds.minAcceptConnInterval)
+    {
+        params.intervalMin = bounds.minAcceptConnInterval;
+    }
+    else if (params.intervalMin > bounds.maxAcceptConnInterval)
+    {
+        params.intervalMin = bounds.maxAcceptConnInterval;
+    }
+    params.intervalMax = params.intervalMin;
+
+    params.latency = p_level->latency;
+    if (params.latency < bounds.minAcceptPeripheralLatency)
+    {
+        params.latency = bounds.minAcceptPeripheralLatency;
+    }
+    else if (params.latency > bounds.maxAcceptPeripheralLatency)
+    {
+        params.latency = bounds.maxAcceptPeripheralLatency;
+    }
+
+    //The supervision timeout must exceed twice the effective interval: timeout x 10ms > (1 + latency) x interval x 1.25ms x 2
+    minTimeout = (((uint32_t)params.latency + 1U) * params.intervalMax) / 4U + 1U;
+    params.timeout = (p_level->timeout > minTimeout) ? p_level->timeout : (uint16_t)minTimeout;
+    if (params.timeout > BLE_GAP_CP_CONN_SUPERVISION_TIMEOUT_MAX)
+    {
+        params.timeout = BLE_GAP_CP_CONN_SUPERVISION_TIMEOUT_MAX;
+    }
+
+    if (BLE_DM_ConnectionParameterUpdate(p_ctx->connHandle, &params) != MBA_RES_SUCCESS)
+    {
+        p_state->failTick = now;
+        s_connPolicyStats.failCnt++;
+        return;
+    }
+
+    p_state->inFlight = true;
+    p_state->requested = p_state->desired;
+    s_connPolicyStats.requestCnt++;
+}
+
+void APP_CONN_POLICY_Reset(APP_CONN_POLICY_State_T *p_state)
+{
+    (void)memset(p_state, 0, sizeof(APP_CONN_POLICY_State_T));
+    p_state->stableTick = xTaskGetTickCount();
+    p_state->failTick = p_state->stableTick - pdMS_TO_TICKS(APP_CONN_POLICY_RETRY_TIME);
+}
+
+void APP_CONN_POLICY_Update(uint16_t connHandle, bool zoneChanged)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+    APP_CONN_POLICY_State_T *p_state;
+    TickType_t now = xTaskGetTickCount();
+
+    if (p_ctx == NULL)
+    {
+        return;
+    }
+
+    p_state = &p_ctx->connPolicy;
+
+    if (zoneChanged || app_conn_policy_NearBoundary(p_ctx))
+    {
+        //Heading for a threshold: alerts must go out at the short interval again
+        if (p_state->desired != 0)
+        {
+            s_connPolicyStats.snapCnt++;
+        }
+        p_state->desired = 0;
+        p_state->stableTick = now;
+    }
+    else if (((now - p_state->stableTick) >= pdMS_TO_TICKS(APP_CONN_POLICY_STABLE_TIME))
+        && (p_state->desired < APP_CONN_POLICY_LEVEL_MAX))
+    {
+        p_state->desired++;
+        p_state->stableTick = now;
+    }
+
+    app_conn_policy_Apply(p_ctx);
+}
+
+void APP_CONN_POLICY_UpdateCompleted(uint16_t connHandle, bool success)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+    APP_CONN_POLICY_State_T *p_state;
+
+    if ((p_ctx == NULL) || !p_ctx->connPolicy.inFlight)
+    {
+        return;
+    }
+
+    p_state = &p_ctx->connPolicy;
+    p_state->inFlight = false;
+
+    if (success)
+    {
+        p_state->applied = p_state->requested;
+        s_connPolicyStats.successCnt++;
+        APP_LOG3(APP_LOG_ID_CONN_LEVEL, p_ctx->index, p_state->applied, s_connPolicyLevel[p_state->applied].interval);
+    }
+    else
+    {
+        p_state->failTick = xTaskGetTickCount();
+        s_connPolicyStats.failCnt++;
+        //Only give up a relax step; a snap back is retried
+        if (p_state->desired > p_state->applied)
+        {
+            p_state->desired = p_state->applied;
+        }
+    }
+
+    //The policy may have moved on while the procedure was running
+    app_conn_policy_Apply(p_ctx);
+}
+
+void APP_CONN_POLICY_GetStats(APP_CONN_POLICY_Stats_T *p_stats)
+{
+    (void)memcpy(p_stats, &s_connPolicyStats, sizeof(APP_CONN_POLICY_Stats_T));
+}
@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Connection Parameter Policy Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_conn_policy.h
+
+  Summary:
+    This file contains the zone driven connection parameter policy of the Proximity Monitor.
+
+  Description:
+    Every monitored link starts at the short connection interval it was
+    created with. While the filtered path loss stays clear of the zone
+    thresholds, the link steps to longer intervals and more peripheral
+    latency; as soon as the path loss comes close to a threshold, or the zone
+    changes, it snaps back to the short interval. Parameters are requested
+    with BLE_DM_ConnectionParameterUpdate and kept within the acceptable
+    range given to BLE_DM_Config.
+ *******************************************************************************/
+
+#ifndef APP_CONN_POLICY_H
+#define APP_CONN_POLICY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_CONN_POLICY_LEVEL_MAX              3        /**< Most relaxed level, see the level table in app_conn_policy.c. */
+#define APP_CONN_POLICY_STABLE_TIME            10000    /**< Time the zone must stay clear of the thresholds before the next relax step (unit: ms). */
+#define APP_CONN_POLICY_MARGIN                 4        /**< Distance to a zone boundary that snaps back to the short interval (unit: dB). Twice that must fit in the middle zone for it to relax. */
+#define APP_CONN_POLICY_RETRY_TIME             1000     /**< Minimum time between a failed update and the next attempt (unit: ms). */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Policy state of one link. */
+typedef struct APP_CONN_POLICY_State_T
+{
+    uint32_t    stableTick;                 /**< Tick the path loss last came close to a boundary, or the last relax step. */
+    uint32_t    failTick;                   /**< Tick of the last failed update, retries wait @ref APP_CONN_POLICY_RETRY_TIME. */
+    uint8_t     applied;                    /**< Level in use on the link. */
+    uint8_t     desired;                    /**< Level the policy wants. */
+    uint8_t     requested;                  /**< Level of the update in flight. */
+    bool        inFlight;                   /**< Set while an update procedure is running. */
+} APP_CONN_POLICY_State_T;
+
+/**@brief Statistics of the connection parameter policy. */
+typedef struct APP_CONN_POLICY_Stats_T
+{
+    uint32_t    requestCnt;                 /**< Update procedures started. */
+    uint32_t    successCnt;                 /**< Update procedures completed. */
+    uint32_t    failCnt;                    /**< Update procedures rejected or failed. */
+    uint32_t    snapCnt;                    /**< Snaps back to the short interval. */
+} APP_CONN_POLICY_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to reset the policy of a link created with the level 0 parameters.
+ *@param[in] p_state                          Pointer to the policy state.
+ *
+ */
+void APP_CONN_POLICY_Reset(APP_CONN_POLICY_State_T *p_state);
+
+/**@brief The function is used to run the policy of a link after a zone estimator sample.
+ *@param[in] connHandle                       Connection handle of the link.
+ *@param[in] zoneChanged                      Set true if the sample changed the zone.
+ *
+ */
+void APP_CONN_POLICY_Update(uint16_t connHandle, bool zoneChanged);
+
+/**@brief The function is used to handle the end of an update procedure. Called on BLE_DM_EVT_CONN_UPDATE_SUCCESS/FAIL.
+ *@param[in] connHandle                       Connection handle of the link.
+ *@param[in] success                          Set true if the new parameters are in use.
+ *
+ */
+void APP_CONN_POLICY_UpdateCompleted(uint16_t connHandle, bool success);
+
+/**@brief The function is used to get a snapshot of the policy statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_CONN_POLICY_GetStats(APP_CONN_POLICY_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_CONN_POLICY_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,457 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+
+/*******************************************************************************
+  Application GATT Cache Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_gatt_cache.c
+
+  Summary:
+    This file contains the GATT handle cache of bonded Proximity Reporters.
+
+  Description:
+    This file contains the GATT handle cache of bonded Proximity Reporters.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "mba_error_defs.h"
+#include "gatt.h"
+#include "ble_util/byte_stream.h"
+#include "ble_pxpm/ble_pxpm.h"
+#include "app_gatt_cache.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_GATT_CACHE_UUID_GATT_SVC           0x1801   /**< Generic Attribute Service UUID. */
+#define APP_GATT_CACHE_UUID_SVC_CHANGED        0x2A05   /**< Service Changed characteristic UUID. */
+#define APP_GATT_CACHE_VERSION                 0x01     /**< Layout version of the stored record. */
+#define APP_GATT_CACHE_CCCD_INDICATION         0x0002   /**< CCCD value enabling indications. */
+
+typedef enum APP_GATT_CACHE_CharIndex_T
+{
+    APP_GATT_CACHE_INDEX_SVC_CHANGED = 0x00,
+    APP_GATT_CACHE_INDEX_SVC_CHANGED_CCCD,
+    APP_GATT_CACHE_CHAR_NUM
+} APP_GATT_CACHE_CharIndex_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Record stored in flash for each bonded reporter. */
+typedef struct APP_GATT_CACHE_Record_T
+{
+    uint8_t                 version;
+    uint8_t                 reserved;
+    uint16_t                svcChangedHandle;
+    uint16_t                svcChangedCccdHandle;
+    BLE_PXPM_HandleCache_T  pxpm;
+} APP_GATT_CACHE_Record_T;
+
+typedef char app_gatt_cache_RecordSizeCheck[(sizeof(APP_GATT_CACHE_Record_T) <= BLE_DM_GATT_CACHE_SIZE) ? 1 : -1];
+
+typedef struct APP_GATT_CACHE_Conn_T
+{
+    bool                    inUse;
+    uint16_t                connHandle;
+    uint8_t                 devId;              /**< Paired device ID, @ref BLE_DM_PEER_DEV_ID_INVALID if not bonded. */
+    bool                    isHit;              /**< Handles are restored from the cache. */
+    bool                    isDiscovered;       /**< Handles are discovered on this link. */
+    bool                    isCccdPending;      /**< Enabling Service Changed indication is postponed (ATT busy). */
+    APP_GATT_CACHE_Record_T record;
+} APP_GATT_CACHE_Conn_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_GATT_CACHE_Conn_T    s_gattCacheConn[BLE_GAP_MAX_LINK_NBR];
+static APP_GATT_CACHE_Stats_T   s_gattCacheStats;
+static GATTC_WriteParams_T      s_gattCacheWriteParams;
+
+static BLE_DD_CharInfo_T        s_gattCacheCharInfoList[BLE_GAP_MAX_LINK_NBR][APP_GATT_CACHE_CHAR_NUM];
+static BLE_DD_CharList_T        s_gattCacheCharList[BLE_GAP_MAX_LINK_NBR];
+
+static const ATT_Uuid_T         gattCacheDiscCharSvcChanged =       { { UINT16_TO_BYTES(APP_GATT_CACHE_UUID_SVC_CHANGED) }, ATT_UUID_LENGTH_2 };
+static const ATT_Uuid_T         gattCacheDiscCharSvcChangedCccd =   { { UINT16_TO_BYTES(UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG) }, ATT_UUID_LENGTH_2 };
+
+static BLE_DD_DiscChar_T        gattCacheSvcChanged =       { &gattCacheDiscCharSvcChanged, 0 };
+static BLE_DD_DiscChar_T        gattCacheSvcChangedCccd =   { &gattCacheDiscCharSvcChangedCccd, CHAR_SET_DESCRIPTOR };
+
+static BLE_DD_DiscChar_T        *gattCacheDiscCharList[] =
+{
+    &gattCacheSvcChanged,       /* Service Changed Characteristic */
+    &gattCacheSvcChangedCccd,   /* Service Changed Client Characteristic Configuration Descriptor */
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_GATT_CACHE_Conn_T *app_gatt_cache_GetConnByHandle(uint16_t connHandle)
+{
+    uint8_t i;
+
+    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    {
+        if (s_gattCacheConn[i].inUse && (s_gattCacheConn[i].connHandle == connHandle))
+        {
+            return &s_gattCacheConn[i];
+        }
+    }
+
+    return NULL;
+}
+
+static APP_GATT_CACHE_Conn_T *app_gatt_cache_GetFreeConn(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    {
+        if (!s_gattCacheConn[i].inUse)
+        {
+            (void)memset(&s_gattCacheConn[i], 0, sizeof(APP_GATT_CACHE_Conn_T));
+            s_gattCacheConn[i].inUse = true;
+            return &s_gattCacheConn[i];
+        }
+    }
+
+    return NULL;
+}
+
+static BLE_DD_CharInfo_T *app_gatt_cache_GetDiscCharInfo(uint16_t connHandle)
+{
+    uint8_t i;
+
+    //BLE_DD reuses the lowest free index, stale entries with the same handle can only follow the live one
+    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    {
+        if (s_gattCacheCharList[i].connHandle == connHandle)
+        {
+            return s_gattCacheCharList[i].p_charInfo;
+        }
+    }
+
+    return NULL;
+}
+
+static void app_gatt_cache_EnableSvcChangedInd(APP_GATT_CACHE_Conn_T *p_conn)
+{
+    uint16_t result;
+
+    //GATTC_Write copies the parameters, and it is only called from the application task
+    s_gattCacheWriteParams.charHandle = p_conn->record.svcChangedCccdHandle;
+    s_gattCacheWriteParams.charLength = 2;
+    U16_TO_BUF_LE(s_gattCacheWriteParams.charValue, APP_GATT_CACHE_CCCD_INDICATION);
+    s_gattCacheWriteParams.writeType = ATT_WRITE_REQ;
+    s_gattCacheWriteParams.valueOffset = 0x0000;
+    result = GATTC_Write(p_conn->connHandle, &s_gattCacheWriteParams);
+
+    p_conn->isCccdPending = (result == MBA_RES_BUSY);
+}
+
+static void app_gatt_cache_Store(APP_GATT_CACHE_Conn_T *p_conn)
+{
+    uint8_t blob[BLE_DM_GATT_CACHE_SIZE];
+
+    if ((p_conn->devId == BLE_DM_PEER_DEV_ID_INVALID) || (p_conn->isDiscovered == false))
+    {
+        return;
+    }
+
+    p_conn->record.version = APP_GATT_CACHE_VERSION;
+    if (BLE_PXPM_GetHandleCache(p_conn->connHandle, &p_conn->record.pxpm) != MBA_RES_SUCCESS)
+    {
+        //Not a reporter, nothing worth caching
+        return;
+    }
+
+    (void)memset(blob, 0, sizeof(blob));
+    (void)memcpy(blob, &p_conn->record, sizeof(APP_GATT_CACHE_Record_T));
+    if (BLE_DM_SetGattCache(p_conn->devId, blob) == MBA_RES_SUCCESS)
+    {
+        s_gattCacheStats.storeCnt++;
+    }
+}
+
+static void app_gatt_cache_Load(APP_GATT_CACHE_Conn_T *p_conn)
+{
+    uint8_t blob[BLE_DM_GATT_CACHE_SIZE];
+
+    if (p_conn->devId == BLE_DM_PEER_DEV_ID_INVALID)
+    {
+        return;
+    }
+
+    if (BLE_DM_GetGattCache(p_conn->devId, blob) == MBA_RES_SUCCESS)
+    {
+        (void)memcpy(&p_conn->record, blob, sizeof(APP_GATT_CACHE_Record_T));
+        if ((p_conn->record.version == APP_GATT_CACHE_VERSION) && (p_conn->record.pxpm.llsAlertLvHandle != 0U))
+        {
+            p_conn->isHit = true;
+            s_gattCacheStats.hitCnt++;
+            return;
+        }
+    }
+
+    (void)memset(&p_conn->record, 0, sizeof(APP_GATT_CACHE_Record_T));
+    s_gattCacheStats.missCnt++;
+}
+
+static void app_gatt_cache_Invalidate(APP_GATT_CACHE_Conn_T *p_conn)
+{
+    if (p_conn->devId != BLE_DM_PEER_DEV_ID_INVALID)
+    {
+        (void)BLE_DM_DeleteGattCache(p_conn->devId);
+    }
+
+    p_conn->isHit = false;
+    p_conn->isDiscovered = false;
+    p_conn->isCccdPending = false;
+    s_gattCacheStats.invalidateCnt++;
+
+    (void)BLE_DD_RestartServicesDiscovery(p_conn->connHandle);
+}
+
+void APP_GATT_CACHE_Init(void)
+{
+    BLE_DD_DiscSvc_T gattDisc;
+    uint8_t i;
+
+    (void)memset(s_gattCacheConn, 0, sizeof(s_gattCacheConn));
+    (void)memset(&s_gattCacheStats, 0, sizeof(APP_GATT_CACHE_Stats_T));
+
+    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    {
+        (void)memset(&s_gattCacheCharList[i], 0, sizeof(BLE_DD_CharList_T));
+        (void)memset(s_gattCacheCharInfoList[i], 0, sizeof(BLE_DD_CharInfo_T) * APP_GATT_CACHE_CHAR_NUM);
+        s_gattCacheCharList[i].p_charInfo = s_gattCacheCharInfoList[i];
+    }
+
+    (void)memset(&gattDisc, 0, sizeof(BLE_DD_DiscSvc_T));
+    gattDisc.svcUuid.uuidLength = ATT_UUID_LENGTH_2;
+    gattDisc.svcUuid.uuid[0] = (uint8_t)(APP_GATT_CACHE_UUID_GATT_SVC & 0xFF);
+    gattDisc.svcUuid.uuid[1] = (uint8_t)(APP_GATT_CACHE_UUID_GATT_SVC >> 8);
+    gattDisc.p_discChars = gattCacheDiscCharList;
+    gattDisc.p_charList = s_gattCacheCharList;
+    gattDisc.discCharsNum = APP_GATT_CACHE_CHAR_NUM;
+    (void)BLE_DD_ServiceDiscoveryRegister(&gattDisc);
+}
+
+void APP_GATT_CACHE_DmEventHandler(BLE_DM_Event_T *p_event)
+{
+    APP_GATT_CACHE_Conn_T *p_conn;
+
+    switch (p_event->eventId)
+    {
+        case BLE_DM_EVT_CONNECTED:
+        {
+            p_conn = app_gatt_cache_GetFreeConn();
+            if (p_conn != NULL)
+            {
+                p_conn->connHandle = p_event->connHandle;
+                p_conn->devId = p_event->peerDevId;
+                app_gatt_cache_Load(p_conn);
+            }
+        }
+        break;
+
+        case BLE_DM_EVT_DISCONNECTED:
+        {
+            p_conn = app_gatt_cache_GetConnByHandle(p_event->connHandle);
+            if (p_conn != NULL)
+            {
+                p_conn->inUse = false;
+            }
+        }
+        break;
+
+        case BLE_DM_EVT_PAIRED_DEVICE_UPDATED:
+        {
+            //A new bond, possibly reusing the ID of an older one: whatever is cached for it is stale
+            (void)BLE_DM_DeleteGattCache(p_event->peerDevId);
+
+            p_conn = app_gatt_cache_GetConnByHandle(p_event->connHandle);
+            if (p_conn != NULL)
+            {
+                p_conn->devId = p_event->peerDevId;
+                if (p_conn->isHit)
+                {
+                    //The peer lost its bond, its database may have changed with it
+                    app_gatt_cache_Invalidate(p_conn);
+                }
+                else
+                {
+                    //First bonding: discovery usually completes before the keys are stored
+                    app_gatt_cache_Store(p_conn);
+                }
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void APP_GATT_CACHE_ConfigDd(BLE_DD_Config_T *p_ddConfig, STACK_Event_T *p_stackEvent)
+{
+    BLE_GAP_Event_T *p_gapEvt;
+    APP_GATT_CACHE_Conn_T *p_conn;
+
+    if (p_stackEvent->groupId != STACK_GRP_BLE_GAP)
+    {
+        return;
+    }
+
+    p_gapEvt = (BLE_GAP_Event_T *)p_stackEvent->p_event;
+    if ((p_gapEvt->eventId == BLE_GAP_EVT_CONNECTED) && (p_gapEvt->eventField.evtConnect.status == GAP_STATUS_SUCCESS))
+    {
+        p_conn = app_gatt_cache_GetConnByHandle(p_gapEvt->eventField.evtConnect.connHandle);
+        if ((p_conn != NULL) && p_conn->isHit)
+        {
+            p_ddConfig->disableConnectedDisc = 1;
+        }
+    }
+}
+
+void APP_GATT_CACHE_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    APP_GATT_CACHE_Conn_T *p_conn;
+
+    if (p_stackEvent->groupId == STACK_GRP_BLE_GAP)
+    {
+        BLE_GAP_Event_T *p_gapEvt = (BLE_GAP_Event_T *)p_stackEvent->p_event;
+
+        if ((p_gapEvt->eventId == BLE_GAP_EVT_CONNECTED) && (p_gapEvt->eventField.evtConnect.status == GAP_STATUS_SUCCESS))
+        {
+            p_conn = app_gatt_cache_GetConnByHandle(p_gapEvt->eventField.evtConnect.connHandle);
+            if ((p_conn != NULL) && p_conn->isHit)
+            {
+                if (BLE_PXPM_RestoreHandleCache(p_conn->connHandle, &p_conn->record.pxpm) != MBA_RES_SUCCESS)
+                {
+                    app_gatt_cache_Invalidate(p_conn);
+                }
+            }
+        }
+        else if (p_gapEvt->eventId == BLE_GAP_EVT_DISCONNECTED)
+        {
+            BLE_DD_CharInfo_T *p_charInfo = app_gatt_cache_GetDiscCharInfo(p_gapEvt->eventField.evtDisconnect.connHandle);
+
+            if (p_charInfo != NULL)
+            {
+                (void)memset(p_charInfo, 0, sizeof(BLE_DD_CharInfo_T) * APP_GATT_CACHE_CHAR_NUM);
+            }
+        }
+        else
+        {
+            //Nothing to do
+        }
+    }
+    else if (p_stackEvent->groupId == STACK_GRP_GATT)
+    {
+        GATT_Event_T *p_gattEvt = (GATT_Event_T *)p_stackEvent->p_event;
+
+        if (p_gattEvt->eventId == GATTC_EVT_HV_INDICATE)
+        {
+            p_conn = app_gatt_cache_GetConnByHandle(p_gattEvt->eventField.onIndication.connHandle);
+            if ((p_conn != NULL) && (p_conn->record.svcChangedHandle != 0U)
+                && (p_gattEvt->eventField.onIndication.charHandle == p_conn->record.svcChangedHandle))
+            {
+                app_gatt_cache_Invalidate(p_conn);
+            }
+        }
+        else if (p_gattEvt->eventId == GATTC_EVT_PROTOCOL_AVAILABLE)
+        {
+            p_conn = app_gatt_cache_GetConnByHandle(p_gattEvt->eventField.onClientProtocolAvailable.connHandle);
+            if ((p_conn != NULL) && p_conn->isCccdPending)
+            {
+                app_gatt_cache_EnableSvcChangedInd(p_conn);
+            }
+        }
+        else
+        {
+            //Nothing to do
+        }
+    }
+    else
+    {
+        //Nothing to do
+    }
+}
+
+void APP_GATT_CACHE_DdEventHandler(BLE_DD_Event_T *p_event)
+{
+    APP_GATT_CACHE_Conn_T *p_conn;
+    BLE_DD_CharInfo_T *p_charInfo;
+
+    if (p_event->eventId != BLE_DD_EVT_DISC_COMPLETE)
+    {
+        return;
+    }
+
+    p_conn = app_gatt_cache_GetConnByHandle(p_event->eventField.evtDiscResult.connHandle);
+    if (p_conn == NULL)
+    {
+        return;
+    }
+
+    p_conn->isDiscovered = true;
+    p_charInfo = app_gatt_cache_GetDiscCharInfo(p_conn->connHandle);
+    if (p_charInfo != NULL)
+    {
+        p_conn->record.svcChangedHandle = p_charInfo[APP_GATT_CACHE_INDEX_SVC_CHANGED].charHandle;
+        p_conn->record.svcChangedCccdHandle = p_charInfo[APP_GATT_CACHE_INDEX_SVC_CHANGED_CCCD].charHandle;
+    }
+
+    //The CCCD of a bonded client is kept by the server, so this is only needed once per bonding
+    if (p_conn->record.svcChangedCccdHandle != 0U)
+    {
+        app_gatt_cache_EnableSvcChangedInd(p_conn);
+    }
+
+    app_gatt_cache_Store(p_conn);
+}
+
+void APP_GATT_CACHE_GetStats(APP_GATT_CACHE_Stats_T *p_stats)
+{
+    (void)memcpy(p_stats, &s_gattCacheStats, sizeof(APP_GATT_CACHE_Stats_T));
+}
@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application GATT Cache Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_gatt_cache.h
+
+  Summary:
+    This file contains the GATT handle cache of bonded Proximity Reporters.
+
+  Description:
+    The attribute handles discovered on a bonded reporter are stored in flash
+    through BLE_DM. When the reporter reconnects, BLE_DD discovery is skipped
+    and the handles are restored into BLE_PXPM directly, so alerting is
+    possible right after the connection is established. A Service Changed
+    indication from the reporter drops the cache and restarts discovery.
+ *******************************************************************************/
+
+#ifndef APP_GATT_CACHE_H
+#define APP_GATT_CACHE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stack_mgr.h"
+#include "ble_gcm/ble_dd.h"
+#include "ble_dm/ble_dm.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Stack events handled by @ref APP_GATT_CACHE_ConfigDd and @ref APP_GATT_CACHE_BleEventHandler, one bit per event ID. */
+#define APP_GATT_CACHE_GAP_EVT_MASK         ((1UL << BLE_GAP_EVT_CONNECTED) | (1UL << BLE_GAP_EVT_DISCONNECTED))
+#define APP_GATT_CACHE_GATT_EVT_MASK        ((1UL << GATTC_EVT_HV_INDICATE) | (1UL << GATTC_EVT_PROTOCOL_AVAILABLE))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Statistics of the GATT cache. */
+typedef struct APP_GATT_CACHE_Stats_T
+{
+    uint32_t    hitCnt;             /**< Connections restored from the cache, discovery skipped. */
+    uint32_t    missCnt;            /**< Connections of bonded devices without a valid cache. */
+    uint32_t    storeCnt;           /**< Caches stored to flash. */
+    uint32_t    invalidateCnt;      /**< Caches dropped by Service Changed indication or restore failure. */
+} APP_GATT_CACHE_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the GATT cache. It registers the Service Changed characteristic
+ *        to BLE_DD. Must be called after BLE_DD is initialized.
+ */
+void APP_GATT_CACHE_Init(void);
+
+/**@brief The function is used to handle BLE_DM events. Must be called for every BLE_DM event.
+ *@param[in] p_event                          Pointer to the BLE_DM event.
+ *
+ */
+void APP_GATT_CACHE_DmEventHandler(BLE_DM_Event_T *p_event);
+
+/**@brief The function is used to disable the connected discovery of BLE_DD when the cache of the peer is valid.
+ *        Must be called after BLE_DM and before BLE_DD handle the stack event.
+ *@param[in] p_ddConfig                       Pointer to the BLE_DD configuration.
+ *@param[in] p_stackEvent                     Pointer to the stack event.
+ *
+ */
+void APP_GATT_CACHE_ConfigDd(BLE_DD_Config_T *p_ddConfig, STACK_Event_T *p_stackEvent);
+
+/**@brief The function is used to handle stack events. Must be called after BLE_PXPM handles the stack event.
+ *@param[in] p_stackEvent                     Pointer to the stack event.
+ *
+ */
+void APP_GATT_CACHE_BleEventHandler(STACK_Event_T *p_stackEvent);
+
+/**@brief The function is used to handle BLE_DD events. Must be called after BLE_PXPM handles the BLE_DD event.
+ *@param[in] p_event                          Pointer to the BLE_DD event.
+ *
+ */
+void APP_GATT_CACHE_DdEventHandler(BLE_DD_Event_T *p_event);
+
+/**@brief The function is used to get a snapshot of the GATT cache statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_GATT_CACHE_GetStats(APP_GATT_CACHE_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_GATT_CACHE_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,407 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Link Optimization Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_link_opt.c
+
+  Summary:
+    This file contains the MTU and PHY negotiation policy of the Proximity Monitor.
+
+  Description:
+    This file contains the MTU and PHY negotiation policy of the Proximity Monitor.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mba_error_defs.h"
+#include "gatt.h"
+#include "app_link_opt.h"
+#include "app_pxpm_ctx.h"
+#include "app_log/app_log.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_LINK_OPT_Peer_T  s_linkOptPeer[APP_LINK_OPT_PEER_NUM];
+static uint8_t              s_linkOptPeerNum;
+static uint8_t              s_linkOptPeerNext;              /* Entry replaced when the table is full. */
+static APP_LINK_OPT_Stats_T s_linkOptStats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_LINK_OPT_Peer_T *app_link_opt_FindPeer(const BLE_GAP_Addr_T *p_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_linkOptPeerNum; i++)
+    {
+        if ((s_linkOptPeer[i].addr.addrType == p_addr->addrType)
+            && (memcmp(s_linkOptPeer[i].addr.addr, p_addr->addr, GAP_MAX_BD_ADDRESS_LEN) == 0))
+        {
+            return &s_linkOptPeer[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void app_link_opt_SavePeer(const APP_PXPM_Ctx_T *p_ctx)
+{
+    APP_LINK_OPT_Peer_T *p_peer = app_link_opt_FindPeer(&p_ctx->peerAddr);
+
+    if (p_peer == NULL)
+    {
+        if (s_linkOptPeerNum < APP_LINK_OPT_PEER_NUM)
+        {
+            p_peer = &s_linkOptPeer[s_linkOptPeerNum++];
+        }
+        else
+        {
+            p_peer = &s_linkOptPeer[s_linkOptPeerNext];
+            s_linkOptPeerNext = (uint8_t)((s_linkOptPeerNext + 1U) % APP_LINK_OPT_PEER_NUM);
+        }
+        (void)memcpy(&p_peer->addr, &p_ctx->peerAddr, sizeof(BLE_GAP_Addr_T));
+        p_peer->mtu = 0;
+    }
+
+    if (p_ctx->linkOpt.mtu != 0U)
+    {
+        p_peer->mtu = p_ctx->linkOpt.mtu;
+    }
+    p_peer->capKnown = p_ctx->linkOpt.capKnown;
+    p_peer->capSupported = p_ctx->linkOpt.capSupported;
+}
+
+static uint8_t app_link_opt_PhyCap(uint8_t phy)
+{
+    if (phy == BLE_GAP_PHY_TYPE_LE_2M)
+    {
+        return APP_LINK_OPT_CAP_2M;
+    }
+    if (phy == BLE_GAP_PHY_TYPE_LE_CODED)
+    {
+        return APP_LINK_OPT_CAP_CODED;
+    }
+    return 0;
+}
+
+static uint8_t app_link_opt_WantedPhy(const APP_LINK_OPT_State_T *p_state)
+{
+    int16_t rssi = p_state->rssi >> 4;
+    uint8_t phy;
+    uint8_t cap;
+
+    if (!p_state->rssiValid)
+    {
+        //No sample yet, a fresh link is close enough to have been connected on 1M
+        phy = BLE_GAP_PHY_TYPE_LE_2M;
+    }
+    else if (p_state->txPhy == BLE_GAP_PHY_TYPE_LE_2M)
+    {
+        phy = (rssi < APP_LINK_OPT_RSSI_CODED_ENTER) ? BLE_GAP_PHY_TYPE_LE_CODED
+            : ((rssi < APP_LINK_OPT_RSSI_2M_LEAVE) ? BLE_GAP_PHY_TYPE_LE_1M : BLE_GAP_PHY_TYPE_LE_2M);
+    }
+    else if (p_state->txPhy == BLE_GAP_PHY_TYPE_LE_CODED)
+    {
+        phy = (rssi > APP_LINK_OPT_RSSI_2M_ENTER) ? BLE_GAP_PHY_TYPE_LE_2M
+            : ((rssi > APP_LINK_OPT_RSSI_CODED_LEAVE) ? BLE_GAP_PHY_TYPE_LE_1M : BLE_GAP_PHY_TYPE_LE_CODED);
+    }
+    else
+    {
+        phy = (rssi < APP_LINK_OPT_RSSI_CODED_ENTER) ? BLE_GAP_PHY_TYPE_LE_CODED
+            : ((rssi > APP_LINK_OPT_RSSI_2M_ENTER) ? BLE_GAP_PHY_TYPE_LE_2M : BLE_GAP_PHY_TYPE_LE_1M);
+    }
+
+    //A PHY the peer refused before is not asked for again, 1M is always there
+    cap = app_link_opt_PhyCap(phy);
+    if (((p_state->capKnown & cap) != 0U) && ((p_state->capSupported & cap) == 0U))
+    {
+        phy = BLE_GAP_PHY_TYPE_LE_1M;
+    }
+
+    return phy;
+}
+
+static void app_link_opt_ApplyPhy(APP_PXPM_Ctx_T *p_ctx)
+{
+    APP_LINK_OPT_State_T *p_state = &p_ctx->linkOpt;
+    TickType_t now = xTaskGetTickCount();
+    uint8_t phy;
+    uint8_t option;
+
+    if (p_state->inFlight)
+    {
+        if ((now - p_state->reqTick) < pdMS_TO_TICKS(APP_LINK_OPT_PHY_TIMEOUT))
+        {
+            return;
+        }
+        //The completion never came, do not block the policy forever
+        p_state->inFlight = false;
+        p_state->failTick = now;
+        s_linkOptStats.phyFailCnt++;
+    }
+
+    phy = app_link_opt_WantedPhy(p_state);
+    if (((phy == p_state->txPhy) && (phy == p_state->rxPhy))
+        || ((now - p_state->failTick) < pdMS_TO_TICKS(APP_LINK_OPT_RETRY_TIME)))
+    {
+        return;
+    }
+
+    option = (phy == BLE_GAP_PHY_TYPE_LE_2M) ? BLE_GAP_PHY_OPTION_2M
+        : ((phy == BLE_GAP_PHY_TYPE_LE_CODED) ? BLE_GAP_PHY_OPTION_CODED : BLE_GAP_PHY_OPTION_1M);
+
+    if (BLE_GAP_SetPhy(p_ctx->connHandle, option, option,
+        (phy == BLE_GAP_PHY_TYPE_LE_CODED) ? BLE_GAP_PHY_PREF_S8 : BLE_GAP_PHY_PREF_NO) != MBA_RES_SUCCESS)
+    {
+        p_state->failTick = now;
+        s_linkOptStats.phyFailCnt++;
+        return;
+    }
+
+    if ((p_state->txPhy != BLE_GAP_PHY_TYPE_LE_CODED)
+        && ((phy == BLE_GAP_PHY_TYPE_LE_CODED) || ((phy == BLE_GAP_PHY_TYPE_LE_1M) && (p_state->txPhy == BLE_GAP_PHY_TYPE_LE_2M))))
+    {
+        s_linkOptStats.fallbackCnt++;
+    }
+
+    p_state->inFlight = true;
+    p_state->requested = phy;
+    p_state->reqTick = now;
+    s_linkOptStats.phyReqCnt++;
+}
+
+static void app_link_opt_ExchangeMtu(APP_PXPM_Ctx_T *p_ctx)
+{
+    uint16_t result = GATTC_ExchangeMTURequest(p_ctx->connHandle, APP_LINK_OPT_MTU);
+
+    //A request of the application may hold the bearer, the exchange goes out as soon as it is free
+    p_ctx->linkOpt.mtuPending = ((result == MBA_RES_BUSY) || (result == MBA_RES_OOM));
+    if (result == MBA_RES_SUCCESS)
+    {
+        s_linkOptStats.mtuReqCnt++;
+    }
+}
+
+void APP_LINK_OPT_Init(void)
+{
+    uint8_t phys = BLE_GAP_PHY_OPTION_1M | BLE_GAP_PHY_OPTION_2M | BLE_GAP_PHY_OPTION_CODED;
+
+    (void)memset(s_linkOptPeer, 0, sizeof(s_linkOptPeer));
+    (void)memset(&s_linkOptStats, 0, sizeof(APP_LINK_OPT_Stats_T));
+    s_linkOptPeerNum = 0;
+    s_linkOptPeerNext = 0;
+
+    //Let the controller accept any PHY a peer asks for
+    (void)BLE_GAP_SetDefaultPhy(phys, phys);
+}
+
+void APP_LINK_OPT_Connected(uint16_t connHandle)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+    APP_LINK_OPT_State_T *p_state;
+    const APP_LINK_OPT_Peer_T *p_peer;
+
+    if (p_ctx == NULL)
+    {
+        return;
+    }
+
+    p_state = &p_ctx->linkOpt;
+    (void)memset(p_state, 0, sizeof(APP_LINK_OPT_State_T));
+    p_state->mtu = BLE_ATT_DEFAULT_MTU_LEN;
+    p_state->txPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    p_state->rxPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    p_state->failTick = xTaskGetTickCount() - pdMS_TO_TICKS(APP_LINK_OPT_RETRY_TIME);
+
+    p_peer = app_link_opt_FindPeer(&p_ctx->peerAddr);
+    if (p_peer != NULL)
+    {
+        p_state->capKnown = p_peer->capKnown;
+        p_state->capSupported = p_peer->capSupported;
+    }
+
+    //A peer that refused the exchange before stays at the default MTU. The exchange waits for the
+    //bootstrap, it would otherwise hold the bearer for a round trip ahead of discovery and the alert
+    p_state->mtuWanted = ((p_peer == NULL) || (p_peer->mtu != BLE_ATT_DEFAULT_MTU_LEN));
+
+    app_link_opt_ApplyPhy(p_ctx);
+}
+
+void APP_LINK_OPT_BootstrapDone(uint16_t connHandle)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+
+    if ((p_ctx == NULL) || !p_ctx->linkOpt.mtuWanted)
+    {
+        return;
+    }
+
+    p_ctx->linkOpt.mtuWanted = false;
+    app_link_opt_ExchangeMtu(p_ctx);
+}
+
+void APP_LINK_OPT_Update(uint16_t connHandle, int8_t rssi)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+    APP_LINK_OPT_State_T *p_state;
+
+    if (p_ctx == NULL)
+    {
+        return;
+    }
+
+    p_state = &p_ctx->linkOpt;
+
+    //First order filter with a gain of 1/4, a single faded sample does not switch the PHY
+    if (!p_state->rssiValid)
+    {
+        p_state->rssi = (int16_t)(rssi * 16);
+        p_state->rssiValid = true;
+    }
+    else
+    {
+        p_state->rssi += (int16_t)(((int16_t)(rssi * 16) - p_state->rssi) / 4);
+    }
+
+    app_link_opt_ApplyPhy(p_ctx);
+}
+
+void APP_LINK_OPT_PhyUpdated(const BLE_GAP_EvtPhyUpdate_T *p_evt)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(p_evt->connHandle);
+    APP_LINK_OPT_State_T *p_state;
+    uint8_t cap;
+
+    if (p_ctx == NULL)
+    {
+        return;
+    }
+
+    p_state = &p_ctx->linkOpt;
+
+    //Also taken when the peer started the update
+    if (p_evt->status == GAP_STATUS_SUCCESS)
+    {
+        p_state->txPhy = p_evt->txPhy;
+        p_state->rxPhy = p_evt->rxPhy;
+    }
+
+    if (p_state->inFlight)
+    {
+        p_state->inFlight = false;
+        cap = app_link_opt_PhyCap(p_state->requested);
+
+        if (p_evt->status != GAP_STATUS_SUCCESS)
+        {
+            p_state->failTick = xTaskGetTickCount();
+            s_linkOptStats.phyFailCnt++;
+        }
+        else if ((p_evt->txPhy == p_state->requested) && (p_evt->rxPhy == p_state->requested))
+        {
+            p_state->capKnown |= cap;
+            p_state->capSupported |= cap;
+            s_linkOptStats.phyDoneCnt++;
+        }
+        else
+        {
+            //The procedure completed on another PHY: the peer does not support the requested one
+            p_state->capKnown |= cap;
+            p_state->capSupported &= (uint8_t)~cap;
+            s_linkOptStats.phyFailCnt++;
+        }
+        app_link_opt_SavePeer(p_ctx);
+    }
+
+    APP_LOG3(APP_LOG_ID_LINK_OPT, p_ctx->index, p_state->mtu, p_state->txPhy);
+
+    //The policy may have moved on while the procedure was running
+    app_link_opt_ApplyPhy(p_ctx);
+}
+
+void APP_LINK_OPT_MtuUpdated(uint16_t connHandle, uint16_t mtu)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+
+    if (p_ctx == NULL)
+    {
+        return;
+    }
+
+    p_ctx->linkOpt.mtu = mtu;
+    p_ctx->linkOpt.mtuPending = false;
+    if (mtu > BLE_ATT_DEFAULT_MTU_LEN)
+    {
+        s_linkOptStats.mtuDoneCnt++;
+    }
+    app_link_opt_SavePeer(p_ctx);
+
+    APP_LOG3(APP_LOG_ID_LINK_OPT, p_ctx->index, mtu, p_ctx->linkOpt.txPhy);
+}
+
+void APP_LINK_OPT_ProtocolAvailable(uint16_t connHandle)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+
+    if ((p_ctx != NULL) && p_ctx->linkOpt.mtuPending)
+    {
+        app_link_opt_ExchangeMtu(p_ctx);
+    }
+}
+
+bool APP_LINK_OPT_GetPeer(const BLE_GAP_Addr_T *p_addr, APP_LINK_OPT_Peer_T *p_peer)
+{
+    const APP_LINK_OPT_Peer_T *p_entry = app_link_opt_FindPeer(p_addr);
+
+    if (p_entry == NULL)
+    {
+        return false;
+    }
+
+    (void)memcpy(p_peer, p_entry, sizeof(APP_LINK_OPT_Peer_T));
+    return true;
+}
+
+void APP_LINK_OPT_GetStats(APP_LINK_OPT_Stats_T *p_stats)
+{
+    (void)memcpy(p_stats, &s_linkOptStats, sizeof(APP_LINK_OPT_Stats_T));
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Link Optimization Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_link_opt.h
+
+  Summary:
+    This file contains the MTU and PHY negotiation policy of the Proximity Monitor.
+
+  Description:
+    After a link is created the monitor exchanges the largest ATT MTU and asks
+    for the LE 2M PHY, so bulk transfers need fewer and shorter packets. The
+    filtered RSSI of the link moves it back to the LE 1M PHY, and to the LE
+    Coded PHY when the reporter is at the edge of the range. What every peer
+    accepted is remembered, so later connections skip the procedures it
+    already refused.
+ *******************************************************************************/
+
+#ifndef APP_LINK_OPT_H
+#define APP_LINK_OPT_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LINK_OPT_MTU                       247      /**< ATT MTU requested once the connect bootstrap is done. */
+#define APP_LINK_OPT_PEER_NUM                  8        /**< Number of peers whose capabilities are remembered. */
+#define APP_LINK_OPT_RETRY_TIME                2000     /**< Minimum time between a failed PHY update and the next attempt (unit: ms). */
+#define APP_LINK_OPT_PHY_TIMEOUT               5000     /**< PHY update without completion event after which it is given up (unit: ms). */
+
+/**@defgroup APP_LINK_OPT_RSSI APP_LINK_OPT_RSSI
+ * @brief The definition of the filtered RSSI thresholds of the PHY policy. The gaps between them are the hysteresis.
+ * @{ */
+#define APP_LINK_OPT_RSSI_2M_ENTER             (-65)    /**< Above this the link moves to the LE 2M PHY (unit: dBm). */
+#define APP_LINK_OPT_RSSI_2M_LEAVE             (-75)    /**< Below this the link leaves the LE 2M PHY (unit: dBm). */
+#define APP_LINK_OPT_RSSI_CODED_LEAVE          (-80)    /**< Above this the link leaves the LE Coded PHY (unit: dBm). */
+#define APP_LINK_OPT_RSSI_CODED_ENTER          (-88)    /**< Below this the link moves to the LE Coded PHY (unit: dBm). */
+/** @} */
+
+/**@defgroup APP_LINK_OPT_CAP APP_LINK_OPT_CAP
+ * @brief The definition of the peer capabilities learnt by the policy.
+ * @{ */
+#define APP_LINK_OPT_CAP_2M                    (1U << 0) /**< LE 2M PHY. */
+#define APP_LINK_OPT_CAP_CODED                 (1U << 1) /**< LE Coded PHY. */
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief What a peer accepted in earlier connections. */
+typedef struct APP_LINK_OPT_Peer_T
+{
+    BLE_GAP_Addr_T  addr;                   /**< Address of the peer. */
+    uint16_t        mtu;                    /**< ATT MTU exchanged with the peer, 0 if never exchanged. */
+    uint8_t         capKnown;               /**< Capabilities tried on the peer. See @ref APP_LINK_OPT_CAP. */
+    uint8_t         capSupported;           /**< Capabilities the peer accepted. See @ref APP_LINK_OPT_CAP. */
+} APP_LINK_OPT_Peer_T;
+
+/**@brief Link optimization state of one link. */
+typedef struct APP_LINK_OPT_State_T
+{
+    uint32_t    reqTick;                    /**< Tick of the PHY update in flight. */
+    uint32_t    failTick;                   /**< Tick of the last failed PHY update, retries wait @ref APP_LINK_OPT_RETRY_TIME. */
+    int16_t     rssi;                       /**< Filtered RSSI (unit: Q4 dBm). */
+    uint16_t    mtu;                        /**< ATT MTU in use. */
+    uint8_t     txPhy;                      /**< TX PHY in use. See @ref BLE_GAP_PHY_TYPE. */
+    uint8_t     rxPhy;                      /**< RX PHY in use. See @ref BLE_GAP_PHY_TYPE. */
+    uint8_t     requested;                  /**< PHY of the update in flight. See @ref BLE_GAP_PHY_TYPE. */
+    uint8_t     capKnown;                   /**< Capabilities tried on the peer. See @ref APP_LINK_OPT_CAP. */
+    uint8_t     capSupported;               /**< Capabilities the peer accepted. See @ref APP_LINK_OPT_CAP. */
+    bool        rssiValid;                  /**< Set once the first RSSI sample is filtered. */
+    bool        mtuWanted;                  /**< MTU exchange to start when the connect bootstrap is done. */
+    bool        mtuPending;                 /**< MTU exchange waiting for the ATT bearer. */
+    bool        inFlight;                   /**< Set while a PHY update procedure is running. */
+} APP_LINK_OPT_State_T;
+
+/**@brief Statistics of the link optimization. */
+typedef struct APP_LINK_OPT_Stats_T
+{
+    uint32_t    mtuReqCnt;                  /**< MTU exchanges started. */
+    uint32_t    mtuDoneCnt;                 /**< MTU exchanges completed with a larger MTU. */
+    uint32_t    phyReqCnt;                  /**< PHY updates started. */
+    uint32_t    phyDoneCnt;                 /**< PHY updates completed on the requested PHY. */
+    uint32_t    phyFailCnt;                 /**< PHY updates rejected, failed or refused by the peer. */
+    uint32_t    fallbackCnt;                /**< Moves to a slower PHY because of a weak RSSI. */
+} APP_LINK_OPT_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the link optimization. The PHY preferences of new connections are set
+ *        and the peer table is cleared.
+ */
+void APP_LINK_OPT_Init(void);
+
+/**@brief The function is used to start the PHY update of a new link. The MTU exchange waits for @ref APP_LINK_OPT_BootstrapDone.
+ *@param[in] connHandle                       Connection handle of the link.
+ *
+ */
+void APP_LINK_OPT_Connected(uint16_t connHandle);
+
+/**@brief The function is used to start the MTU exchange of a link. Called on BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND, so
+ *        the exchange does not delay discovery and the first alert.
+ *@param[in] connHandle                       Connection handle of the link.
+ *
+ */
+void APP_LINK_OPT_BootstrapDone(uint16_t connHandle);
+
+/**@brief The function is used to run the PHY policy of a link after an RSSI sample.
+ *@param[in] connHandle                       Connection handle of the link.
+ *@param[in] rssi                             RSSI sample (unit: dBm).
+ *
+ */
+void APP_LINK_OPT_Update(uint16_t connHandle, int8_t rssi);
+
+/**@brief The function is used to handle a PHY change. Called on BLE_GAP_EVT_PHY_UPDATE.
+ *@param[in] p_evt                            Pointer to the event.
+ *
+ */
+void APP_LINK_OPT_PhyUpdated(const BLE_GAP_EvtPhyUpdate_T *p_evt);
+
+/**@brief The function is used to handle the end of an MTU exchange. Called on ATT_EVT_UPDATE_MTU, and on
+ *        GATTC_EVT_ERROR_RESP for an Exchange MTU Request with the default MTU.
+ *@param[in] connHandle                       Connection handle of the link.
+ *@param[in] mtu                              ATT MTU in use.
+ *
+ */
+void APP_LINK_OPT_MtuUpdated(uint16_t connHandle, uint16_t mtu);
+
+/**@brief The function is used to retry an MTU exchange refused by a busy ATT bearer. Called on GATTC_EVT_PROTOCOL_AVAILABLE.
+ *@param[in] connHandle                       Connection handle of the link.
+ *
+ */
+void APP_LINK_OPT_ProtocolAvailable(uint16_t connHandle);
+
+/**@brief The function is used to get what a peer accepted in earlier connections.
+ *@param[in] p_addr                           Address of the peer.
+ *@param[out] p_peer                          Pointer to the peer record buffer.
+ *
+ * @retval true                               The peer is known, p_peer is filled.
+ * @retval false                              The peer is not in the table.
+ *
+ */
+bool APP_LINK_OPT_GetPeer(const BLE_GAP_Addr_T *p_addr, APP_LINK_OPT_Peer_T *p_peer);
+
+/**@brief The function is used to get a snapshot of the link optimization statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_LINK_OPT_GetStats(APP_LINK_OPT_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_LINK_OPT_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,275 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Proximity Monitor Context Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_pxpm_ctx.c
+
+  Summary:
+    This file contains the per-connection Proximity Monitor context table.
+
+  Description:
+    This file contains the per-connection Proximity Monitor context table.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "app_pxpm_ctx.h"
+#include "mba_error_defs.h"
+#include "ble_pxpm/ble_pxpm.h"
+#include "peripheral/rtc/plib_rtc.h"
+
+/* Queued by copy in APP_Msg_T.msgData */
+APP_MSG_DATA_FITS(APP_PXPM_CtxZoneEvt_T);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_PXPM_Ctx_T   s_pxpmCtx[APP_PXPM_CTX_MAX_NUM];
+static uint8_t          s_pxpmCtxActiveNum;
+static bool             s_pxpmCtxConnecting;
+static APP_TIMER_Node_T s_pxpmCtxConnTimer;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_pxpm_ctx_Reset(uint8_t index)
+{
+    APP_PXPM_Ctx_T *p_ctx = &s_pxpmCtx[index];
+
+    (void)memset(p_ctx, 0, sizeof(APP_PXPM_Ctx_T));
+    p_ctx->index = index;
+    p_ctx->state = APP_PXPM_CTX_STATE_IDLE;
+    p_ctx->iasLevel = BLE_PXPM_ALERT_LEVEL_NO;
+    p_ctx->llsLevel = BLE_PXPM_ALERT_LEVEL_NO;
+    p_ctx->txPowerLevel = APP_PXPM_CTX_TX_POWER_UNKNOWN;
+    p_ctx->timerId = APP_TIMER_ID_0 + index;
+}
+
+static void app_pxpm_ctx_ConnectTimerExpired(void *p_arg)
+{
+    APP_Msg_T appMsg;
+
+    (void)p_arg;
+
+    //The stack is only called by the application task; a message lost on a full queue is sent again at the next expiry
+    appMsg.msgId = APP_MSG_CONNECT_TIMEOUT;
+    appMsg.msgLen = 0;
+    (void)OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+}
+
+void APP_PXPM_CTX_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < APP_PXPM_CTX_MAX_NUM; i++)
+    {
+        app_pxpm_ctx_Reset(i);
+    }
+    s_pxpmCtxActiveNum = 0;
+    s_pxpmCtxConnecting = false;
+    APP_TIMER_NodeInit(&s_pxpmCtxConnTimer, app_pxpm_ctx_ConnectTimerExpired, NULL);
+}
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_Alloc(uint16_t connHandle, const BLE_GAP_Addr_T *p_peerAddr)
+{
+    APP_PXPM_Ctx_T *p_ctx;
+    uint8_t i;
+
+    for (i = 0; i < APP_PXPM_CTX_MAX_NUM; i++)
+    {
+        p_ctx = &s_pxpmCtx[i];
+        if (p_ctx->state == APP_PXPM_CTX_STATE_IDLE)
+        {
+            p_ctx->state = APP_PXPM_CTX_STATE_CONNECTED;
+            p_ctx->connHandle = connHandle;
+            (void)memcpy(&p_ctx->peerAddr, p_peerAddr, sizeof(BLE_GAP_Addr_T));
+
+            p_ctx->pathLossParams.connHandle = connHandle;
+            p_ctx->pathLossParams.highThreshold = APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD;
+            p_ctx->pathLossParams.highHysteresis = APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS;
+            p_ctx->pathLossParams.lowThreshold = APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD;
+            p_ctx->pathLossParams.lowHysteresis = APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS;
+            p_ctx->pathLossParams.minTimeSpent = APP_PXPM_CTX_PATH_LOSS_MIN_TIME_SPENT;
+
+            s_pxpmCtxActiveNum++;
+            return p_ctx;
+        }
+    }
+
+    return NULL;
+}
+
+void APP_PXPM_CTX_Free(APP_PXPM_Ctx_T *p_ctx)
+{
+    if ((p_ctx == NULL) || (p_ctx->state == APP_PXPM_CTX_STATE_IDLE))
+    {
+        return;
+    }
+
+    if (APP_TIMER_IsTimerExisted(p_ctx->timerId))
+    {
+        (void)APP_TIMER_StopTimer(p_ctx->timerId);
+    }
+    app_pxpm_ctx_Reset(p_ctx->index);
+    s_pxpmCtxActiveNum--;
+}
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByHandle(uint16_t connHandle)
+{
+    uint8_t i;
+
+    for (i = 0; i < APP_PXPM_CTX_MAX_NUM; i++)
+    {
+        if ((s_pxpmCtx[i].state != APP_PXPM_CTX_STATE_IDLE) && (s_pxpmCtx[i].connHandle == connHandle))
+        {
+            return &s_pxpmCtx[i];
+        }
+    }
+
+    return NULL;
+}
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByIndex(uint8_t index)
+{
+    if ((index >= APP_PXPM_CTX_MAX_NUM) || (s_pxpmCtx[index].state == APP_PXPM_CTX_STATE_IDLE))
+    {
+        return NULL;
+    }
+
+    return &s_pxpmCtx[index];
+}
+
+uint8_t APP_PXPM_CTX_GetActiveNum(void)
+{
+    return s_pxpmCtxActiveNum;
+}
+
+void APP_PXPM_CTX_SetConnecting(bool connecting)
+{
+    s_pxpmCtxConnecting = connecting;
+
+    if (connecting)
+    {
+        (void)APP_TIMER_NodeStart(&s_pxpmCtxConnTimer, APP_PXPM_CTX_CONNECT_TIMEOUT, true);
+    }
+    else
+    {
+        APP_TIMER_NodeStop(&s_pxpmCtxConnTimer);
+    }
+}
+
+uint16_t APP_PXPM_CTX_ConnectTimeoutHandler(void)
+{
+    //Expired while the connection completed, the message was already queued
+    if (!s_pxpmCtxConnecting)
+    {
+        return MBA_RES_SUCCESS;
+    }
+
+    return BLE_GAP_CreateConnectionCancel();
+}
+
+void APP_PXPM_CTX_SetZone(APP_PXPM_Ctx_T *p_ctx, uint8_t zone)
+{
+    p_ctx->zone = zone;
+
+    if ((p_ctx->state == APP_PXPM_CTX_STATE_MONITORING) && !APP_TIMER_IsTimerExisted(p_ctx->timerId))
+    {
+        IAS_update(p_ctx->connHandle, zone);
+    }
+}
+
+void APP_PXPM_CTX_ProcPathLossEvt(const BLE_GAP_EvtPathLossThreshold_T *p_evt)
+{
+    APP_Msg_T appMsg;
+    APP_PXPM_CtxZoneEvt_T *p_zoneEvt = (APP_PXPM_CtxZoneEvt_T *)appMsg.msgData;
+
+    //The stamp travels with the message; the context is only touched by the application task
+    appMsg.msgId = APP_MSG_ZONE_EVT;
+    appMsg.msgLen = sizeof(APP_PXPM_CtxZoneEvt_T);
+    p_zoneEvt->stamp = RTC_Timer32CounterGet();
+    (void)memcpy(&p_zoneEvt->evt, p_evt, sizeof(BLE_GAP_EvtPathLossThreshold_T));
+
+    (void)OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+}
+
+void APP_PXPM_CTX_ZoneEvtHandler(const APP_PXPM_CtxZoneEvt_T *p_zoneEvt)
+{
+    APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(p_zoneEvt->evt.connHandle);
+
+    //The RSSI estimator owns the zone when enabled, it reacts well before the controller reports
+    if ((p_ctx == NULL) || APP_ZONE_EST_ENABLE)
+    {
+        return;
+    }
+
+    APP_PXPM_CTX_StampZoneEvt(p_ctx, p_zoneEvt->stamp);
+    APP_PXPM_CTX_SetZone(p_ctx, p_zoneEvt->evt.zoneEntered);
+}
+
+void APP_PXPM_CTX_StampZoneEvt(APP_PXPM_Ctx_T *p_ctx, uint32_t stamp)
+{
+    p_ctx->zoneEvtStamp = stamp;
+    p_ctx->zoneStamped = true;
+}
+
+bool APP_PXPM_CTX_TakeZoneLatency(APP_PXPM_Ctx_T *p_ctx, uint32_t *p_latency)
+{
+    uint32_t counts;
+
+    if (!p_ctx->zoneStamped)
+    {
+        return false;
+    }
+
+    p_ctx->zoneStamped = false;
+    counts = RTC_Timer32CounterGet() - p_ctx->zoneEvtStamp;
+    *p_latency = (uint32_t)(((uint64_t)counts * 1000000U) / RTC_Timer32FrequencyGet());
+
+    if (*p_latency > p_ctx->zoneLatencyMax)
+    {
+        p_ctx->zoneLatencyMax = *p_latency;
+    }
+
+    return true;
+}
+
+bool APP_PXPM_CTX_CanConnect(void)
+{
+    return (!s_pxpmCtxConnecting && (s_pxpmCtxActiveNum < APP_PXPM_CTX_MAX_NUM));
+}
@@ -0,0 +1,266 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Proximity Monitor Context Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_pxpm_ctx.h
+
+  Summary:
+    This file contains the per-connection Proximity Monitor context table.
+
+  Description:
+    One context is kept for every connected Proximity Reporter. It holds the
+    path loss reporting parameters, the zone state, the IAS/LLS alert levels
+    and the timer of that link, so the monitor can watch up to
+    APP_PXPM_CTX_MAX_NUM reporters at once.
+ *******************************************************************************/
+
+#ifndef APP_PXPM_CTX_H
+#define APP_PXPM_CTX_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "app_timer/app_timer.h"
+#include "app_zone_est.h"
+#include "app_conn_policy.h"
+#include "app_link_opt.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Maximum number of reporters monitored at once. Every context owns one application timer. */
+#define APP_PXPM_CTX_MAX_NUM                   ((BLE_GAP_MAX_LINK_NBR < APP_TIMER_TOTAL) ? BLE_GAP_MAX_LINK_NBR : APP_TIMER_TOTAL)
+
+/**@defgroup APP_PXPM_CTX_PATH_LOSS APP_PXPM_CTX_PATH_LOSS
+ * @brief The definition of the default path loss reporting parameters of a new context.
+ * @{ */
+#define APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD  55       /**< High threshold (unit: dB). */
+#define APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS 5        /**< High hysteresis (unit: dB). */
+#define APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD   30       /**< Low threshold (unit: dB). */
+#define APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS  5        /**< Low hysteresis (unit: dB). */
+#define APP_PXPM_CTX_PATH_LOSS_MIN_TIME_SPENT  3        /**< Minimum time spent (unit: connection events). */
+/** @} */
+
+/**@brief Minimum interval between two IAS writes of a link (unit: ms). Zone changes inside the window are
+ *        coalesced into one write of the latest zone when it closes. Set to 0 to write every change at once. */
+#define APP_PXPM_CTX_IAS_MIN_INTERVAL          APP_TIMER_100MS
+
+/**@brief Longest time a connection creation may stay pending before it is cancelled (unit: ms).
+ *        The cancel is retried at this period until the creation completes. */
+#define APP_PXPM_CTX_CONNECT_TIMEOUT           APP_TIMER_3S
+
+/**@brief Invalid TX power level, used until the TPS value has been read. */
+#define APP_PXPM_CTX_TX_POWER_UNKNOWN          (-128)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The definition of the context state. */
+typedef enum APP_PXPM_CtxState_T
+{
+    APP_PXPM_CTX_STATE_IDLE,            /**< Context is free. */
+    APP_PXPM_CTX_STATE_CONNECTED,       /**< Link established, service discovery in progress. */
+    APP_PXPM_CTX_STATE_MONITORING,      /**< Discovery completed, alerts can be written. */
+} APP_PXPM_CtxState_T;
+
+/**@brief Proximity Monitor context of one connected reporter. */
+typedef struct APP_PXPM_Ctx_T
+{
+    uint8_t                                 index;              /**< Index in the context table. */
+    APP_PXPM_CtxState_T                     state;              /**< Context state. */
+    uint16_t                                connHandle;         /**< Connection handle. */
+    BLE_GAP_Addr_T                          peerAddr;           /**< Address of the reporter. */
+    BLE_GAP_SetPathLossReportingParams_T    pathLossParams;     /**< Path loss reporting parameters of the link. */
+    uint16_t                                connInterval;       /**< Connection interval in use (unit: 1.25ms). */
+    uint16_t                                connLatency;        /**< Peripheral latency in use (unit: connection events). */
+    uint32_t                                rssiTick;           /**< Tick of the last RSSI sample of the link. */
+    uint8_t                                 zone;               /**< Last zone reported by the controller. */
+    uint8_t                                 iasLevel;           /**< Last alert level written to the IAS of the reporter. */
+    uint8_t                                 llsLevel;           /**< Alert level written to the LLS of the reporter. */
+    int8_t                                  txPowerLevel;       /**< TX power level read from the TPS of the reporter. */
+    uint8_t                                 timerId;            /**< IAS rate limit timer owned by this context. See @ref APP_TIMER_TimerId_T. */
+    bool                                    releasePending;     /**< Set when the link is released once its Alert Level writes have gone out. */
+    bool                                    zoneStamped;        /**< Set when zoneEvtStamp holds a zone change not yet written to the IAS. */
+    uint32_t                                zoneEvtStamp;       /**< RTC counter when the last zone change was detected. */
+    uint32_t                                zoneLatencyMax;     /**< Worst path loss event to IAS write latency (unit: us). */
+    APP_ZONE_EST_State_T                    zoneEst;            /**< RSSI based zone estimator of the link. */
+    APP_CONN_POLICY_State_T                 connPolicy;         /**< Connection parameter policy of the link. */
+    APP_LINK_OPT_State_T                    linkOpt;            /**< MTU and PHY negotiation state of the link. */
+} APP_PXPM_Ctx_T;
+
+/**@brief Path loss event, queued by the stack callback with APP_MSG_ZONE_EVT. */
+typedef struct APP_PXPM_CtxZoneEvt_T
+{
+    uint32_t                                stamp;              /**< RTC counter when the stack delivered the event. */
+    BLE_GAP_EvtPathLossThreshold_T          evt;                /**< The event. */
+} APP_PXPM_CtxZoneEvt_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the context table. All contexts are released.
+ */
+void APP_PXPM_CTX_Init(void);
+
+/**@brief The function is used to claim a context for a new connection.
+ *@param[in] connHandle                       Connection handle.
+ *@param[in] p_peerAddr                       Address of the reporter.
+ *
+ * @retval Pointer to the context, or NULL if the table is full.
+ *
+ */
+APP_PXPM_Ctx_T *APP_PXPM_CTX_Alloc(uint16_t connHandle, const BLE_GAP_Addr_T *p_peerAddr);
+
+/**@brief The function is used to release a context. The timer of the context is stopped.
+ *@param[in] p_ctx                            Pointer to the context.
+ *
+ */
+void APP_PXPM_CTX_Free(APP_PXPM_Ctx_T *p_ctx);
+
+/**@brief The function is used to get the context of a connection.
+ *@param[in] connHandle                       Connection handle.
+ *
+ * @retval Pointer to the context, or NULL if the connection has no context.
+ *
+ */
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByHandle(uint16_t connHandle);
+
+/**@brief The function is used to get a context by its index.
+ *@param[in] index                            Index in the context table.
+ *
+ * @retval Pointer to the context, or NULL if the index is invalid or the context is free.
+ *
+ */
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByIndex(uint8_t index);
+
+/**@brief The function is used to get the number of contexts in use.
+ *
+ * @retval Number of connected reporters.
+ *
+ */
+uint8_t APP_PXPM_CTX_GetActiveNum(void);
+
+/**@brief The function is used to mark that a connection is being created.
+ *        Setting it arms the connect timer, see @ref APP_PXPM_CTX_CONNECT_TIMEOUT; clearing it stops the timer.
+ *@param[in] connecting                       Set true when @ref BLE_GAP_CreateConnection is issued,
+ *                                            false when it completes or fails.
+ *
+ */
+void APP_PXPM_CTX_SetConnecting(bool connecting);
+
+/**@brief The function is used to cancel a connection creation that did not complete in time.
+ *        Called by the application task on APP_MSG_CONNECT_TIMEOUT. The creation completes with a failed
+ *        BLE_GAP_EVT_CONNECTED, which clears the connecting flag.
+ *
+ * @retval MBA_RES_SUCCESS                    The cancel is issued, or no creation is pending any more.
+ * @retval Others                             The cancel is rejected, it is retried at the next expiry.
+ *
+ */
+uint16_t APP_PXPM_CTX_ConnectTimeoutHandler(void);
+
+/**@brief The function is used to record a new zone of a monitored link and push it to the IAS of the reporter.
+ *        Inside the IAS rate limit window the write is left to the expiry of the context timer.
+ *@param[in] p_ctx                            Pointer to the context.
+ *@param[in] zone                             Zone entered.
+ *
+ */
+void APP_PXPM_CTX_SetZone(APP_PXPM_Ctx_T *p_ctx, uint8_t zone);
+
+/**@brief The function is used to queue a path loss event to the application task with its delivery time.
+ *        Called from the stack callback, the event does not claim an event pool buffer.
+ *@param[in] p_evt                            Pointer to the event.
+ *
+ */
+void APP_PXPM_CTX_ProcPathLossEvt(const BLE_GAP_EvtPathLossThreshold_T *p_evt);
+
+/**@brief The function is used to handle a path loss event queued by @ref APP_PXPM_CTX_ProcPathLossEvt.
+ *        Called by the application task on APP_MSG_ZONE_EVT.
+ *@param[in] p_zoneEvt                        Pointer to the queued event.
+ *
+ */
+void APP_PXPM_CTX_ZoneEvtHandler(const APP_PXPM_CtxZoneEvt_T *p_zoneEvt);
+
+/**@brief The function is used to record when a zone change of a link was detected, for the latency of its IAS write.
+ *        Called by the application task only.
+ *@param[in] p_ctx                            Pointer to the context.
+ *@param[in] stamp                            RTC counter when the change was detected.
+ *
+ */
+void APP_PXPM_CTX_StampZoneEvt(APP_PXPM_Ctx_T *p_ctx, uint32_t stamp);
+
+/**@brief The function is used to take the latency of the last stamped path loss event, and update the worst case.
+ *@param[in] p_ctx                            Pointer to the context.
+ *@param[out] p_latency                       Latency from the stamp to now (unit: us).
+ *
+ * @retval true                               A stamp was pending, it is cleared.
+ * @retval false                              No stamped event since the last call.
+ *
+ */
+bool APP_PXPM_CTX_TakeZoneLatency(APP_PXPM_Ctx_T *p_ctx, uint32_t *p_latency);
+
+/**@brief The function is used to check if another reporter can be connected.
+ *
+ * @retval true                               No connection is being created and the link budget is not full.
+ * @retval false                              Otherwise.
+ *
+ */
+bool APP_PXPM_CTX_CanConnect(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_PXPM_CTX_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -48,13 +48,10 @@
 #include <stdio.h>
 #include "ble_pxpm/ble_pxpm.h"
 #include "app_timer/app_timer.h"
-
-// *****************************************************************************
-// *****************************************************************************
-// Section: Global Variables
-// *****************************************************************************
-// *****************************************************************************
-extern uint16_t conn_hdl;
+#include "app_ble.h"
+#include "app_pxpm_ctx.h"
+#include "app_cl_prox.h"
+#include "app_log/app_log.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -68,18 +65,36 @@ void APP_PxpmEvtHandler(BLE_PXPM_Event_T *p_event)
     {
         case BLE_PXPM_EVT_DISC_COMPLETE_IND:
         {
-            /* TODO: implement your application code.*/
-            APP_TIMER_SetTimer(APP_TIMER_ID_0,APP_TIMER_500MS,true);
-            BLE_PXPM_ReadTpsTxPowerLevel(conn_hdl);
-            BLE_PXPM_WriteLlsAlertLevel(conn_hdl,0);
-            BLE_PXPM_WriteIasAlertLevel(conn_hdl,0);
+            uint16_t connHandle = p_event->eventField.evtDiscComplete.connHandle;
+            APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(connHandle);
+
+            if (p_ctx == NULL)
+            {
+                break;
+            }
+
+            p_ctx->state = APP_PXPM_CTX_STATE_MONITORING;
+            //LLS is confirmed first, TX Power Level follows; both are fetched by Read Using UUID.
+            //The one IAS write carries the current zone, also one entered during discovery;
+            //later changes are pushed as they are detected
+            if (p_ctx->iasLevel != p_ctx->zone)
+            {
+                APP_LOG2(APP_LOG_ID_ZONE_ENTERED, p_ctx->index, p_ctx->zone);
+            }
+            p_ctx->iasLevel = p_ctx->zone;
+            BLE_PXPM_StartBootstrap(connHandle, (BLE_PXPM_AlertLevel_T)p_ctx->llsLevel, (BLE_PXPM_AlertLevel_T)p_ctx->zone);
+            APP_ZONE_EST_Reset(&p_ctx->zoneEst, p_ctx->zone);
+            APP_CONN_POLICY_Reset(&p_ctx->connPolicy);
+#if !APP_BLE_CONNECTIONLESS
+            APP_ZONE_EST_StartSampling();
+#endif
         }
         break;
         
         case BLE_PXPM_EVT_LLS_ALERT_LEVEL_WRITE_RSP_IND:
         {
             /* TODO: implement your application code.*/
-            printf("LLS level write resp\r\n");
+            APP_LOG0(APP_LOG_ID_LLS_WRITE_RESP);
         }
         break;
 
@@ -91,8 +106,35 @@ void APP_PxpmEvtHandler(BLE_PXPM_Event_T *p_event)
         
         case BLE_PXPM_EVT_TPS_TX_POWER_LEVEL_IND:
         {
-            /* TODO: implement your application code.*/
-            printf("Tx Power level:%d\r\n",p_event->eventField.evtTpsTxPwrLvInd.txPowerLevel);
+            APP_PXPM_Ctx_T *p_ctx = APP_PXPM_CTX_GetByHandle(p_event->eventField.evtTpsTxPwrLvInd.connHandle);
+
+            if (p_ctx != NULL)
+            {
+                p_ctx->txPowerLevel = p_event->eventField.evtTpsTxPwrLvInd.txPowerLevel;
+            }
+            APP_LOG1(APP_LOG_ID_TX_POWER_LEVEL, p_event->eventField.evtTpsTxPwrLvInd.txPowerLevel);
+        }
+        break;
+
+        case BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND:
+        {
+            BLE_PXPM_EvtBootstrapComplete_T *p_evt = &p_event->eventField.evtBootstrapComplete;
+
+            APP_LOG3(APP_LOG_ID_PXPM_BOOTSTRAP, p_evt->connToDiscMs, p_evt->discToAlertReadyMs, p_evt->alertReadyToDoneMs);
+#if APP_BLE_CONNECTIONLESS
+            //The link only existed to write the IAS
+            APP_CL_PROX_AlertDelivered(p_evt->connHandle);
+#else
+            APP_LINK_OPT_BootstrapDone(p_evt->connHandle);
+#endif
+        }
+        break;
+
+        case BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND:
+        {
+#if APP_BLE_CONNECTIONLESS
+            APP_CL_PROX_WriteQueueEmpty(p_event->eventField.evtWriteQueueEmpty.connHandle);
+#endif
         }
         break;
 
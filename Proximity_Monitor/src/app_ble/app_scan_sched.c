@@ -0,0 +1,336 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Scan Scheduler Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_scan_sched.c
+
+  Summary:
+    This file contains the adaptive scan duty cycle scheduler of the Proximity Monitor.
+
+  Description:
+    This file contains the adaptive scan duty cycle scheduler of the Proximity Monitor.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mba_error_defs.h"
+#include "ble_dm/ble_dm.h"
+#include "app_ble.h"
+#include "app_scan_sched.h"
+#include "app_ble_scan_filter.h"
+#include "app_log/app_log.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_SCAN_SCHED_Profile_T s_scanProfile[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+static APP_SCAN_SCHED_Profile_T s_scanActiveProfile;
+static uint8_t                  s_scanStage;
+static bool                     s_scanActive;
+static TickType_t               s_scanStageTick;
+static bool                     s_scanLossPending;
+static TickType_t               s_scanLossTick;
+static uint32_t                 s_scanReconnectMs[APP_SCAN_SCHED_RECONNECT_SAMPLES];
+static APP_SCAN_SCHED_Stats_T   s_scanStats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_scan_sched_DefaultProfile(APP_SCAN_SCHED_Profile_T *p_profile)
+{
+    p_profile->firstStage = APP_SCAN_SCHED_DEFAULT_FIRST_STAGE;
+    p_profile->lastStage = APP_SCAN_SCHED_DEFAULT_LAST_STAGE;
+    p_profile->baseDuration = APP_SCAN_SCHED_DEFAULT_BASE_DURATION;
+}
+
+static void app_scan_sched_Account(void)
+{
+    uint32_t elapsed;
+
+    if (!s_scanActive)
+    {
+        return;
+    }
+
+    elapsed = (xTaskGetTickCount() - s_scanStageTick) * portTICK_PERIOD_MS;
+    s_scanStats.scanMs += elapsed;
+    //The duty cycle of stage n is 1 / 2^n
+    s_scanStats.radioOnMs += (elapsed >> s_scanStage);
+    s_scanStageTick = xTaskGetTickCount();
+}
+
+#if APP_BLE_EXT_API
+static void app_scan_sched_Disable(void)
+{
+    BLE_GAP_ExtScanningEnable_T scanEnable;
+
+    (void)memset(&scanEnable, 0, sizeof(BLE_GAP_ExtScanningEnable_T));
+    scanEnable.enable = false;
+    (void)BLE_GAP_SetExtScanningEnable(BLE_GAP_SCAN_MODE_OBSERVER, &scanEnable);
+}
+
+static uint16_t app_scan_sched_Enable(uint16_t interval, uint16_t duration)
+{
+    BLE_GAP_ExtScanningPhy_T scanPhy;
+    BLE_GAP_ExtScanningEnable_T scanEnable;
+    BLE_GAP_ExtScanningParams_T *p_phyParam;
+    uint16_t result;
+
+    //Reporters advertise their extended sets on APP_BLE_EXT_PHY only, the other PHY is left off
+    (void)memset(&scanPhy, 0, sizeof(BLE_GAP_ExtScanningPhy_T));
+    p_phyParam = (APP_BLE_EXT_PHY == BLE_GAP_PHY_TYPE_LE_CODED) ? &scanPhy.leCodedPhy : &scanPhy.le1mPhy;
+    p_phyParam->enable = true;
+    p_phyParam->type = BLE_GAP_SCAN_TYPE_PASSIVE_SCAN;
+    p_phyParam->interval = interval;
+    p_phyParam->window = APP_SCAN_SCHED_WINDOW;
+    p_phyParam->disChannel = 0;
+
+    result = BLE_GAP_SetExtScanningParams(APP_SCAN_FILTER_GetScanFilterPolicy(), &scanPhy);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    //Extended scan duration is in 10ms units
+    scanEnable.enable = true;
+    scanEnable.filterDuplicates = BLE_GAP_SCAN_FD_ENABLE;
+    scanEnable.duration = (uint16_t)(duration * 10U);
+    scanEnable.period = 0;
+
+    return BLE_GAP_SetExtScanningEnable(BLE_GAP_SCAN_MODE_OBSERVER, &scanEnable);
+}
+#else
+static void app_scan_sched_Disable(void)
+{
+    (void)BLE_GAP_SetScanningEnable(false, BLE_GAP_SCAN_FD_ENABLE, BLE_GAP_SCAN_MODE_OBSERVER, 0);
+}
+
+static uint16_t app_scan_sched_Enable(uint16_t interval, uint16_t duration)
+{
+    BLE_GAP_ScanningParams_T scanParam;
+    uint16_t result;
+
+    scanParam.type = BLE_GAP_SCAN_TYPE_PASSIVE_SCAN;
+    scanParam.interval = interval;
+    scanParam.window = APP_SCAN_SCHED_WINDOW;
+    scanParam.filterPolicy = APP_SCAN_FILTER_GetScanFilterPolicy();
+    scanParam.disChannel = 0;
+
+    result = BLE_GAP_SetScanningParam(&scanParam);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    return BLE_GAP_SetScanningEnable(true, BLE_GAP_SCAN_FD_ENABLE, BLE_GAP_SCAN_MODE_OBSERVER, duration);
+}
+#endif
+
+static void app_scan_sched_Apply(void)
+{
+    uint16_t interval;
+    uint16_t duration;
+
+    //Scan parameters can only be changed while scanning is disabled
+    app_scan_sched_Disable();
+
+    interval = (uint16_t)(APP_SCAN_SCHED_WINDOW << s_scanStage);
+
+    if (s_scanStage >= s_scanActiveProfile.lastStage)
+    {
+        duration = APP_SCAN_SCHED_BACKGROUND_DURATION;
+    }
+    else
+    {
+        uint32_t stageDuration = (uint32_t)s_scanActiveProfile.baseDuration << (s_scanStage - s_scanActiveProfile.firstStage);
+
+        duration = (stageDuration > APP_SCAN_SCHED_STAGE_DURATION_MAX) ? APP_SCAN_SCHED_STAGE_DURATION_MAX : (uint16_t)stageDuration;
+    }
+
+    s_scanActive = false;
+    if (app_scan_sched_Enable(interval, duration) != MBA_RES_SUCCESS)
+    {
+        return;
+    }
+
+    s_scanActive = true;
+    s_scanStageTick = xTaskGetTickCount();
+    s_scanStats.stageCnt++;
+    APP_LOG3(APP_LOG_ID_SCAN_STAGE, s_scanStage, interval, duration);
+}
+
+void APP_SCAN_SCHED_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < BLE_DM_MAX_PAIRED_DEVICE_NUM; i++)
+    {
+        app_scan_sched_DefaultProfile(&s_scanProfile[i]);
+    }
+
+    app_scan_sched_DefaultProfile(&s_scanActiveProfile);
+    s_scanStage = APP_SCAN_SCHED_DEFAULT_LAST_STAGE;
+    s_scanActive = false;
+    s_scanLossPending = false;
+    (void)memset(s_scanReconnectMs, 0, sizeof(s_scanReconnectMs));
+    (void)memset(&s_scanStats, 0, sizeof(s_scanStats));
+}
+
+uint16_t APP_SCAN_SCHED_SetProfile(uint8_t devId, const APP_SCAN_SCHED_Profile_T *p_profile)
+{
+    if ((devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM) || (p_profile == NULL) || (p_profile->baseDuration == 0)
+        || (p_profile->firstStage > p_profile->lastStage) || (p_profile->lastStage > APP_SCAN_SCHED_STAGE_MAX))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    (void)memcpy(&s_scanProfile[devId], p_profile, sizeof(APP_SCAN_SCHED_Profile_T));
+
+    return MBA_RES_SUCCESS;
+}
+
+void APP_SCAN_SCHED_StartBurst(uint8_t devId)
+{
+    if (devId < BLE_DM_MAX_PAIRED_DEVICE_NUM)
+    {
+        (void)memcpy(&s_scanActiveProfile, &s_scanProfile[devId], sizeof(APP_SCAN_SCHED_Profile_T));
+    }
+    else
+    {
+        app_scan_sched_DefaultProfile(&s_scanActiveProfile);
+    }
+
+    //The time spent so far counts at the duty cycle of the stage it was spent in
+    app_scan_sched_Account();
+
+    //Keep the first loss of overlapping ones, the reconnect time is measured from the earliest
+    if (!s_scanLossPending)
+    {
+        s_scanLossPending = true;
+        s_scanLossTick = xTaskGetTickCount();
+    }
+
+    s_scanStage = s_scanActiveProfile.firstStage;
+    app_scan_sched_Apply();
+}
+
+void APP_SCAN_SCHED_Resume(void)
+{
+    app_scan_sched_Account();
+
+    if (!s_scanActive)
+    {
+        s_scanStage = s_scanActiveProfile.lastStage;
+    }
+
+    app_scan_sched_Apply();
+}
+
+void APP_SCAN_SCHED_Stop(void)
+{
+    app_scan_sched_Account();
+    s_scanActive = false;
+    app_scan_sched_Disable();
+}
+
+void APP_SCAN_SCHED_TimeoutHandler(void)
+{
+    if (!s_scanActive)
+    {
+        return;
+    }
+
+    app_scan_sched_Account();
+
+    //Back off one stage; the background stage is re-armed as is
+    if (s_scanStage < s_scanActiveProfile.lastStage)
+    {
+        s_scanStage++;
+    }
+
+    app_scan_sched_Apply();
+}
+
+void APP_SCAN_SCHED_ConnectedHandler(void)
+{
+    if (!s_scanLossPending)
+    {
+        return;
+    }
+
+    s_scanLossPending = false;
+    s_scanReconnectMs[s_scanStats.reconnectCnt % APP_SCAN_SCHED_RECONNECT_SAMPLES] = (xTaskGetTickCount() - s_scanLossTick) * portTICK_PERIOD_MS;
+    s_scanStats.reconnectCnt++;
+}
+
+void APP_SCAN_SCHED_GetStats(APP_SCAN_SCHED_Stats_T *p_stats)
+{
+    uint32_t samples[APP_SCAN_SCHED_RECONNECT_SAMPLES];
+    uint8_t num;
+    uint8_t i;
+    uint8_t j;
+
+    app_scan_sched_Account();
+    (void)memcpy(p_stats, &s_scanStats, sizeof(APP_SCAN_SCHED_Stats_T));
+
+    num = (s_scanStats.reconnectCnt < APP_SCAN_SCHED_RECONNECT_SAMPLES) ? (uint8_t)s_scanStats.reconnectCnt : APP_SCAN_SCHED_RECONNECT_SAMPLES;
+    if (num == 0)
+    {
+        p_stats->reconnectMedianMs = 0;
+        return;
+    }
+
+    (void)memcpy(samples, s_scanReconnectMs, sizeof(samples));
+
+    //Insertion sort, only a handful of samples
+    for (i = 1; i < num; i++)
+    {
+        uint32_t sample = samples[i];
+
+        for (j = i; (j > 0) && (samples[j - 1] > sample); j--)
+        {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = sample;
+    }
+
+    p_stats->reconnectMedianMs = samples[num / 2];
+}
@@ -0,0 +1,166 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Scan Scheduler Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_scan_sched.h
+
+  Summary:
+    This file contains the adaptive scan duty cycle scheduler of the Proximity Monitor.
+
+  Description:
+    Scanning runs in stages. Every stage keeps the same scan window and
+    doubles the scan interval of the previous one, and lasts twice as long.
+    A link loss restarts at a full duty cycle burst since the reporter is
+    most likely still nearby; the stages then back off to a low duty
+    background stage which is re-armed on every scan timeout. The burst can
+    be tuned per bonded device.
+ *******************************************************************************/
+
+#ifndef APP_SCAN_SCHED_H
+#define APP_SCAN_SCHED_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_SCAN_SCHED_WINDOW                  0x30     /**< Scan window of every stage, 30ms (unit: 0.625ms). */
+#define APP_SCAN_SCHED_STAGE_MAX               6        /**< Last possible stage, scan interval 64 windows (1.5% duty). */
+#define APP_SCAN_SCHED_STAGE_DURATION_MAX      600      /**< Longest stage of a burst, 60s (unit: 100ms). */
+#define APP_SCAN_SCHED_BACKGROUND_DURATION     3000     /**< Duration of the background stage before it is re-armed, 300s (unit: 100ms). */
+#define APP_SCAN_SCHED_RECONNECT_SAMPLES       16       /**< Reconnect times kept for the median. */
+
+/**@defgroup APP_SCAN_SCHED_DEFAULT APP_SCAN_SCHED_DEFAULT
+ * @brief The definition of the default profile, used for devices without a profile of their own.
+ * @{ */
+#define APP_SCAN_SCHED_DEFAULT_FIRST_STAGE     0        /**< Burst starts at full duty cycle. */
+#define APP_SCAN_SCHED_DEFAULT_LAST_STAGE      APP_SCAN_SCHED_STAGE_MAX
+#define APP_SCAN_SCHED_DEFAULT_BASE_DURATION   20       /**< First burst stage lasts 2s (unit: 100ms). */
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Scan profile of a bonded device. */
+typedef struct APP_SCAN_SCHED_Profile_T
+{
+    uint8_t     firstStage;                 /**< Stage a link loss restarts at. */
+    uint8_t     lastStage;                  /**< Background stage, up to @ref APP_SCAN_SCHED_STAGE_MAX. */
+    uint16_t    baseDuration;               /**< Duration of the first stage, doubled for every next stage (unit: 100ms). */
+} APP_SCAN_SCHED_Profile_T;
+
+/**@brief Statistics of the scan scheduler. */
+typedef struct APP_SCAN_SCHED_Stats_T
+{
+    uint32_t    radioOnMs;                  /**< Time spent inside scan windows (unit: ms). */
+    uint32_t    scanMs;                     /**< Time scanning was enabled (unit: ms). */
+    uint32_t    stageCnt;                   /**< Stages started. */
+    uint32_t    reconnectCnt;               /**< Connections made after a link loss. */
+    uint32_t    reconnectMedianMs;          /**< Median link loss to connection time of the last samples (unit: ms). */
+} APP_SCAN_SCHED_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the scan scheduler. Every bonded device gets the default profile.
+ */
+void APP_SCAN_SCHED_Init(void);
+
+/**@brief The function is used to set the scan profile of a bonded device.
+ *@param[in] devId                            Paired device ID.
+ *@param[in] p_profile                        Pointer to the profile.
+ *
+ * @retval MBA_RES_SUCCESS                    The profile is set.
+ * @retval MBA_RES_INVALID_PARA               Invalid device ID or profile.
+ *
+ */
+uint16_t APP_SCAN_SCHED_SetProfile(uint8_t devId, const APP_SCAN_SCHED_Profile_T *p_profile);
+
+/**@brief The function is used to start a burst, on start-up or after a link loss.
+ *@param[in] devId                            Paired device ID of the lost reporter, or BLE_DM_PEER_DEV_ID_INVALID for the default profile.
+ *
+ */
+void APP_SCAN_SCHED_StartBurst(uint8_t devId);
+
+/**@brief The function is used to resume scanning in the current stage, or in the background stage when idle.
+ */
+void APP_SCAN_SCHED_Resume(void);
+
+/**@brief The function is used to stop scanning.
+ */
+void APP_SCAN_SCHED_Stop(void);
+
+/**@brief The function is used to move to the next stage. Called on BLE_GAP_EVT_SCAN_TIMEOUT.
+ */
+void APP_SCAN_SCHED_TimeoutHandler(void);
+
+/**@brief The function is used to record a connection. Called on BLE_GAP_EVT_CONNECTED.
+ */
+void APP_SCAN_SCHED_ConnectedHandler(void);
+
+/**@brief The function is used to get a snapshot of the scan scheduler statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_SCAN_SCHED_GetStats(APP_SCAN_SCHED_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_SCAN_SCHED_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,295 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Zone Estimator Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_zone_est.c
+
+  Summary:
+    This file contains the RSSI based zone estimator of the Proximity Monitor.
+
+  Description:
+    This file contains the RSSI based zone estimator of the Proximity Monitor.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "app.h"
+#include "mba_error_defs.h"
+#include "app_zone_est.h"
+#include "app_pxpm_ctx.h"
+#include "app_timer/app_timer.h"
+#include "app_conn_policy.h"
+#include "app_link_opt.h"
+#include "app_log/app_log.h"
+#include "peripheral/rtc/plib_rtc.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_TIMER_Node_T s_zoneEstTimer;
+static volatile bool    s_zoneEstMsgPending;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint8_t app_zone_est_Classify(const APP_ZONE_EST_State_T *p_est, const BLE_GAP_SetPathLossReportingParams_T *p_thr)
+{
+    int32_t highEnter = ((int32_t)p_thr->highThreshold + p_thr->highHysteresis) << 8;
+    int32_t highLeave = ((int32_t)p_thr->highThreshold - p_thr->highHysteresis) << 8;
+    int32_t lowEnter = ((int32_t)p_thr->lowThreshold - p_thr->lowHysteresis) << 8;
+    int32_t lowLeave = ((int32_t)p_thr->lowThreshold + p_thr->lowHysteresis) << 8;
+    int32_t pathLoss = p_est->pathLoss;
+
+    //Same hysteresis rules as the controller: a zone is left only once the path loss crosses its threshold by the hysteresis
+    if ((p_est->zone == APP_ZONE_EST_ZONE_HIGH) && (pathLoss >= highLeave))
+    {
+        return APP_ZONE_EST_ZONE_HIGH;
+    }
+
+    if ((p_est->zone == APP_ZONE_EST_ZONE_LOW) && (pathLoss <= lowLeave))
+    {
+        return APP_ZONE_EST_ZONE_LOW;
+    }
+
+    if (pathLoss > highEnter)
+    {
+        return APP_ZONE_EST_ZONE_HIGH;
+    }
+
+    if (pathLoss < lowEnter)
+    {
+        return APP_ZONE_EST_ZONE_LOW;
+    }
+
+    return APP_ZONE_EST_ZONE_MIDDLE;
+}
+
+void APP_ZONE_EST_Reset(APP_ZONE_EST_State_T *p_est, uint8_t zone)
+{
+    (void)memset(p_est, 0, sizeof(APP_ZONE_EST_State_T));
+    p_est->zone = zone;
+    p_est->candidate = zone;
+}
+
+bool APP_ZONE_EST_Update(APP_ZONE_EST_State_T *p_est, const BLE_GAP_SetPathLossReportingParams_T *p_thr, int16_t pathLoss)
+{
+    int32_t measure = (int32_t)pathLoss << 8;
+    int32_t innovation;
+    int32_t gain;
+    uint8_t zone;
+
+    if (!p_est->primed)
+    {
+        p_est->pathLoss = measure;
+        p_est->variance = APP_ZONE_EST_MEAS_VAR;
+        p_est->primed = true;
+    }
+    else
+    {
+        //Scalar Kalman filter, gain in Q16
+        p_est->variance += APP_ZONE_EST_PROC_VAR;
+        gain = (int32_t)(((int64_t)p_est->variance << 16) / (p_est->variance + APP_ZONE_EST_MEAS_VAR));
+
+        innovation = measure - p_est->pathLoss;
+        if (innovation > (APP_ZONE_EST_MAX_STEP << 8))
+        {
+            innovation = (APP_ZONE_EST_MAX_STEP << 8);
+        }
+        else if (innovation < -(APP_ZONE_EST_MAX_STEP << 8))
+        {
+            innovation = -(APP_ZONE_EST_MAX_STEP << 8);
+        }
+
+        p_est->pathLoss += (int32_t)(((int64_t)gain * innovation) >> 16);
+        p_est->variance = (int32_t)(((int64_t)(65536 - gain) * p_est->variance) >> 16);
+    }
+
+    zone = app_zone_est_Classify(p_est, p_thr);
+
+    if (zone == p_est->zone)
+    {
+        p_est->candidate = zone;
+        p_est->dwell = 0;
+        return false;
+    }
+
+    if (zone != p_est->candidate)
+    {
+        p_est->candidate = zone;
+        p_est->dwell = 0;
+    }
+
+    p_est->dwell++;
+    if (p_est->dwell < APP_ZONE_EST_DWELL)
+    {
+        return false;
+    }
+
+    p_est->zone = zone;
+    p_est->dwell = 0;
+
+    return true;
+}
+
+static void app_zone_est_TimerExpired(void *p_arg)
+{
+    APP_Msg_T appMsg;
+
+    (void)p_arg;
+
+    //One sampling message in flight at most, the pass handling it re-arms the timer
+    if (s_zoneEstMsgPending)
+    {
+        return;
+    }
+
+    appMsg.msgId = APP_MSG_RSSI_EVT;
+    appMsg.msgLen = 0;
+
+    if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) == OSAL_RESULT_TRUE)
+    {
+        s_zoneEstMsgPending = true;
+    }
+    else
+    {
+        //A full queue skips the pass rather than stopping the one-shot timer for good
+        (void)APP_TIMER_NodeStart(&s_zoneEstTimer, APP_ZONE_EST_SAMPLE_INTERVAL, false);
+    }
+}
+
+void APP_ZONE_EST_StartSampling(void)
+{
+    if (!APP_ZONE_EST_ENABLE)
+    {
+        return;
+    }
+
+    if (APP_TIMER_NodeIsActive(&s_zoneEstTimer))
+    {
+        //The timer may be waiting for a link with a long effective interval, the new link is due at once
+        (void)APP_TIMER_NodeStart(&s_zoneEstTimer, APP_ZONE_EST_SAMPLE_INTERVAL, false);
+        return;
+    }
+
+    //Expired with its message still queued: the pass re-arms it
+    if (s_zoneEstMsgPending)
+    {
+        return;
+    }
+
+    APP_TIMER_NodeInit(&s_zoneEstTimer, app_zone_est_TimerExpired, NULL);
+    (void)APP_TIMER_NodeStart(&s_zoneEstTimer, APP_ZONE_EST_SAMPLE_INTERVAL, false);
+}
+
+void APP_ZONE_EST_SampleLinks(void)
+{
+    APP_PXPM_Ctx_T *p_ctx;
+    uint32_t now = xTaskGetTickCount();
+    uint32_t slack = pdMS_TO_TICKS(APP_ZONE_EST_SAMPLE_INTERVAL / 4);
+    uint32_t nextDue = UINT32_MAX;
+    uint8_t monitored = 0;
+    uint8_t i;
+
+    s_zoneEstMsgPending = false;
+
+    for (i = 0; i < APP_PXPM_CTX_MAX_NUM; i++)
+    {
+        int8_t rssi;
+        int16_t txPower;
+        uint32_t period;
+        bool zoneChanged;
+
+        p_ctx = APP_PXPM_CTX_GetByIndex(i);
+        if ((p_ctx == NULL) || (p_ctx->state != APP_PXPM_CTX_STATE_MONITORING))
+        {
+            continue;
+        }
+
+        monitored++;
+
+        //Between two effective connection events the controller returns the same reading; feeding it again would
+        //count one measurement several times. A quarter timer period of slack absorbs the jitter of the sampling tick.
+        period = pdMS_TO_TICKS(((uint32_t)p_ctx->connInterval * (1U + p_ctx->connLatency) * 5U) / 4U);
+        if (((now - p_ctx->rssiTick) + slack) < period)
+        {
+            if ((period - (now - p_ctx->rssiTick)) < nextDue)
+            {
+                nextDue = period - (now - p_ctx->rssiTick);
+            }
+            continue;
+        }
+        p_ctx->rssiTick = now;
+        if (period < nextDue)
+        {
+            nextDue = period;
+        }
+
+        if (BLE_GAP_GetRssi(p_ctx->connHandle, &rssi) != MBA_RES_SUCCESS)
+        {
+            continue;
+        }
+
+        APP_LINK_OPT_Update(p_ctx->connHandle, rssi);
+
+        txPower = (p_ctx->txPowerLevel == APP_PXPM_CTX_TX_POWER_UNKNOWN) ? APP_ZONE_EST_DEFAULT_TX_POWER : p_ctx->txPowerLevel;
+
+        zoneChanged = APP_ZONE_EST_Update(&p_ctx->zoneEst, &p_ctx->pathLossParams, txPower - rssi);
+        if (zoneChanged)
+        {
+            APP_LOG3(APP_LOG_ID_ZONE_ESTIMATED, p_ctx->index, p_ctx->zoneEst.pathLoss >> 8, p_ctx->zoneEst.zone);
+            APP_PXPM_CTX_StampZoneEvt(p_ctx, RTC_Timer32CounterGet());
+            APP_PXPM_CTX_SetZone(p_ctx, p_ctx->zoneEst.zone);
+        }
+
+        APP_CONN_POLICY_Update(p_ctx->connHandle, zoneChanged);
+    }
+
+    if (monitored == 0)
+    {
+        APP_TIMER_NodeStop(&s_zoneEstTimer);
+        return;
+    }
+
+    //Wake up when the first link is due again, the tasks sleep in between
+    if (nextDue < pdMS_TO_TICKS(APP_ZONE_EST_SAMPLE_INTERVAL))
+    {
+        nextDue = pdMS_TO_TICKS(APP_ZONE_EST_SAMPLE_INTERVAL);
+    }
+    (void)APP_TIMER_NodeStart(&s_zoneEstTimer, nextDue * portTICK_PERIOD_MS, false);
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Zone Estimator Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_zone_est.h
+
+  Summary:
+    This file contains the RSSI based zone estimator of the Proximity Monitor.
+
+  Description:
+    The estimator samples the RSSI of every monitored link, subtracts the TX
+    power read from the TPS of the reporter to get the path loss, and filters
+    it with a fixed-point scalar Kalman filter. Zones are derived from the
+    filtered path loss with the thresholds and hysteresis of the path loss
+    reporting parameters of the link, plus a short dwell count, and reach the
+    IAS without waiting for the controller path loss mechanism.
+ *******************************************************************************/
+
+#ifndef APP_ZONE_EST_H
+#define APP_ZONE_EST_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Set true to let the estimator own the zone. Path loss threshold events of the controller are then only logged. */
+#define APP_ZONE_EST_ENABLE                    true
+
+/**@brief Shortest RSSI sampling timer period (unit: ms), the shortest connection interval the monitor requests.
+ *        Each link is sampled at most once per effective connection event, interval x (1 + latency),
+ *        since the controller only refreshes the RSSI of a link when it receives from the reporter.
+ *        The one-shot sampling timer is re-armed for the link due first. */
+#define APP_ZONE_EST_SAMPLE_INTERVAL           20
+
+/**@brief TX power assumed until the TPS of the reporter has been read (unit: dBm). */
+#define APP_ZONE_EST_DEFAULT_TX_POWER          0
+
+/**@defgroup APP_ZONE_EST_FILTER APP_ZONE_EST_FILTER
+ * @brief The definition of the filter tuning. Variances are in Q8 dB^2.
+ * @{ */
+#define APP_ZONE_EST_MEAS_VAR                  (16 << 8)    /**< RSSI measurement variance, (4dB)^2. */
+#define APP_ZONE_EST_PROC_VAR                  (64)         /**< Path loss change per sample, (0.5dB)^2. */
+#define APP_ZONE_EST_MAX_STEP                  20           /**< Innovation clamp against fades (unit: dB). */
+#define APP_ZONE_EST_DWELL                     3            /**< Samples a new zone must hold before it is reported. */
+/** @} */
+
+/**@defgroup APP_ZONE_EST_ZONE APP_ZONE_EST_ZONE
+ * @brief The definition of the zones, same values as the zoneEntered of the path loss threshold event.
+ * @{ */
+#define APP_ZONE_EST_ZONE_LOW                  0
+#define APP_ZONE_EST_ZONE_MIDDLE               1
+#define APP_ZONE_EST_ZONE_HIGH                 2
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Estimator state of one link. */
+typedef struct APP_ZONE_EST_State_T
+{
+    int32_t     pathLoss;                   /**< Filtered path loss (unit: Q8 dB). */
+    int32_t     variance;                   /**< Estimate variance (unit: Q8 dB^2). */
+    uint8_t     zone;                       /**< Zone last reported. */
+    uint8_t     candidate;                  /**< Zone waiting for its dwell count. */
+    uint8_t     dwell;                      /**< Consecutive samples in the candidate zone. */
+    bool        primed;                     /**< Set once the first sample has seeded the filter. */
+} APP_ZONE_EST_State_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to reset the estimator of a link. The next sample seeds the filter.
+ *@param[in] p_est                            Pointer to the estimator state.
+ *@param[in] zone                             Zone currently known for the link.
+ *
+ */
+void APP_ZONE_EST_Reset(APP_ZONE_EST_State_T *p_est, uint8_t zone);
+
+/**@brief The function is used to feed one path loss sample to the estimator.
+ *@param[in] p_est                            Pointer to the estimator state.
+ *@param[in] p_thr                            Thresholds and hysteresis of the link.
+ *@param[in] pathLoss                         TX power minus RSSI (unit: dB).
+ *
+ * @retval true                               The zone changed, the new zone is in p_est->zone.
+ * @retval false                              The zone is unchanged.
+ *
+ */
+bool APP_ZONE_EST_Update(APP_ZONE_EST_State_T *p_est, const BLE_GAP_SetPathLossReportingParams_T *p_thr, int16_t pathLoss);
+
+/**@brief The function is used to start sampling, or to sample soon when it is running. Called when a link enters monitoring;
+ *        sampling stops by itself when no link is monitored.
+ */
+void APP_ZONE_EST_StartSampling(void);
+
+/**@brief The function is used to sample every monitored link due for a sample. Called by the application task on APP_MSG_RSSI_EVT.
+ */
+void APP_ZONE_EST_SampleLinks(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_ZONE_EST_H */
+
+
+/*******************************************************************************
+ End of File
+ */
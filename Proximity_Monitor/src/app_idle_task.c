@@ -38,6 +38,8 @@
 // DOM-IGNORE-END
 
 #include "definitions.h"
+#include "app_log/app_log.h"
+#include "app_uart/app_uart.h"
 /*-----------------------------------------------------------*/
 
 /* Ensure the SysTick is clocked at the same frequency as the core. */
@@ -114,6 +116,9 @@ void app_idle_task( void )
     bool RF_Cal_Needed = RF_NeedCal(); // device_support library API
     uint8_t BT_RF_Suspended = 0;
 
+    /* Format and send the deferred logs while nothing else needs the CPU */
+    APP_LOG_Flush();
+
     if (PDS_Items_Pending || RF_Cal_Needed)
     {
         OSAL_CRITSECT_DATA_TYPE IntState;
@@ -308,6 +313,13 @@ void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
         return;
     }
 
+    /* SERCOM0 does not run in sleep mode, let the console output drain first,
+       including the last character still in the shift register */
+    if (!APP_UART_IsTxIdle())
+    {
+        return;
+    }
+
     /* Check if BT allow system to enter sleep mode */
     if (BT_SYS_AllowSystemSleep(RTC_Timer32FrequencyGet(), RTC_Timer32CounterGet()))
     {
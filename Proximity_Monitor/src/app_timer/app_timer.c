@@ -54,12 +54,25 @@
 #include "timers.h"
 
 
-// *****************************************************************************
 // *****************************************************************************
 // Section: Macros
 // *****************************************************************************
 // *****************************************************************************
+#define APP_TIMER_WHEEL_BITS                           (6U)
+#define APP_TIMER_WHEEL_SLOTS                          (1UL << APP_TIMER_WHEEL_BITS)
+#define APP_TIMER_WHEEL_MASK                           (APP_TIMER_WHEEL_SLOTS - 1UL)
+#define APP_TIMER_WHEEL_LEVELS                         (4U)
+
+/* Longest distance the wheel can hold without aliasing the current top level slot (unit: tick). */
+#define APP_TIMER_WHEEL_MAX_TICKS                      ((APP_TIMER_WHEEL_SLOTS - 1UL) << (APP_TIMER_WHEEL_BITS * (APP_TIMER_WHEEL_LEVELS - 1U)))
+
+#define APP_TIMER_NODE_IDLE                            (0xFFU)  /**< Node is not linked. */
+#define APP_TIMER_NODE_EXPIRED                         (0xFEU)  /**< Node is on the expired list waiting for its callback. */
 
+#define APP_TIMER_WHEEL_LEVEL_SHIFT(level)             (APP_TIMER_WHEEL_BITS * (level))
+#define APP_TIMER_WHEEL_SLOT(tick, level)              (((tick) >> APP_TIMER_WHEEL_LEVEL_SHIFT(level)) & APP_TIMER_WHEEL_MASK)
+
+#define APP_TIMER_MS_TO_TICKS(ms)                      ((uint32_t)((ms) / portTICK_PERIOD_MS))
 
 
 // *****************************************************************************
@@ -67,7 +80,18 @@
 // Section: Data Types
 // *****************************************************************************
 // *****************************************************************************
-
+typedef struct APP_TIMER_Wheel_T
+{
+    APP_TIMER_Node_T    *p_slot[APP_TIMER_WHEEL_LEVELS][APP_TIMER_WHEEL_SLOTS];
+    uint64_t            occupied[APP_TIMER_WHEEL_LEVELS];   /**< One bit per non-empty slot. */
+    APP_TIMER_Node_T    *p_expired;             /**< Expired nodes waiting for their callbacks. */
+    uint32_t            now;                    /**< Tick the wheel has been advanced to. */
+    uint32_t            deadline;               /**< Tick the driver timer is programmed for. */
+    uint32_t            programTick;            /**< Tick the last driver timer command was sent. */
+    uint32_t            programDelay;           /**< Period carried by the last driver timer command. */
+    bool                driverArmed;            /**< Set while the driver timer or its callback is running. */
+    TimerHandle_t       driver;                 /**< The only RTOS timer behind all logical timers. */
+} APP_TIMER_Wheel_T;
 
 
 // *****************************************************************************
@@ -75,7 +99,11 @@
 // Section: Local Variables
 // *****************************************************************************
 // *****************************************************************************
-static TimerHandle_t s_timerHandler[configTIMER_QUEUE_LENGTH]; // = {NULL};
+static APP_TIMER_Wheel_T s_timerWheel;
+static APP_TIMER_Node_T s_timerNode[APP_TIMER_TOTAL];
+static volatile uint32_t s_timerExpiredMask;
+static volatile bool s_timerNotifyPending;
+static APP_TIMER_Stats_T s_timerStats;
 
 
 void vApplicationDaemonTaskStartupHook( void )
@@ -88,204 +116,519 @@ void vApplicationDaemonTaskStartupHook( void )
 // Section: Functions
 // *****************************************************************************
 // *****************************************************************************
-static void APP_TIMER_OneShotTimerExpiredHandle(TimerHandle_t xTimer)
+static void app_timer_ListPush(APP_TIMER_Node_T **pp_head, APP_TIMER_Node_T *p_node)
 {
-    uint8_t *timerId;
-    uint8_t timerIdTemp;
-    APP_Msg_T appMsg;
-    uint16_t msgWaitTime = 0;
-
-    timerId = (uint8_t *)pvTimerGetTimerID(xTimer);
-    timerIdTemp = *timerId;
-
+    p_node->p_next = *pp_head;
+    if (p_node->p_next != NULL)
+    {
+        p_node->p_next->pp_prev = &p_node->p_next;
+    }
+    p_node->pp_prev = pp_head;
+    *pp_head = p_node;
+}
 
-    //Delete the timer first to avoid an issue: Start the timer with the same timer ID in this handler, 
-    //If we put the delete timer in the last of this handler, then the new started timer with the same timer ID will be delete immediately.
-    xTimerDelete(s_timerHandler[*timerId], 0);
-    s_timerHandler[*timerId] = NULL;
+static void app_timer_ListUnlink(APP_TIMER_Node_T *p_node)
+{
+    *p_node->pp_prev = p_node->p_next;
+    if (p_node->p_next != NULL)
+    {
+        p_node->p_next->pp_prev = p_node->pp_prev;
+    }
+    p_node->p_next = NULL;
+    p_node->pp_prev = NULL;
+}
 
-    //Free timer ID due to one shot timer is expired
-    OSAL_Free(timerId);
+/* Must be called with the wheel locked. */
+static void app_timer_WheelInsert(APP_TIMER_Node_T *p_node)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+    uint32_t delta = p_node->expires - p_wheel->now;
+    uint8_t level;
+    uint8_t slot;
+
+    //Callers never insert at or before the wheel time except cascades landing exactly on it, which are collected next.
+    //Arms are measured from a wheel time caught up to the tick, so this clamp only guards the wheel span.
+    if (delta > APP_TIMER_WHEEL_MAX_TICKS)
+    {
+        p_node->expires = p_wheel->now + APP_TIMER_WHEEL_MAX_TICKS;
+    }
 
-    switch (timerIdTemp)
+    //A node sits on the lowest level whose window also contains the wheel time, and is cascaded down when the wheel enters its window.
+    for (level = 0; level < (APP_TIMER_WHEEL_LEVELS - 1U); level++)
     {
-        case APP_TIMER_ID_0:
+        uint8_t shift = APP_TIMER_WHEEL_LEVEL_SHIFT(level + 1U);
+
+        if ((p_node->expires >> shift) == (p_wheel->now >> shift))
         {
-            //appMsg.msgId = APP_TIMER_ID_0_MSG;
+            break;
         }
-        break;   
-        
-        case APP_TIMER_ID_1:
+    }
+
+    slot = APP_TIMER_WHEEL_SLOT(p_node->expires, level);
+    app_timer_ListPush(&p_wheel->p_slot[level][slot], p_node);
+    p_wheel->occupied[level] |= (1ULL << slot);
+    p_node->level = level;
+    p_node->slot = slot;
+}
+
+/* Must be called with the wheel locked. */
+static void app_timer_WheelRemove(APP_TIMER_Node_T *p_node)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+
+    if (p_node->pp_prev == NULL)
+    {
+        return;
+    }
+
+    app_timer_ListUnlink(p_node);
+
+    if ((p_node->level < APP_TIMER_WHEEL_LEVELS) && (p_wheel->p_slot[p_node->level][p_node->slot] == NULL))
+    {
+        p_wheel->occupied[p_node->level] &= ~(1ULL << p_node->slot);
+    }
+
+    p_node->level = APP_TIMER_NODE_IDLE;
+}
+
+/* Must be called with the wheel locked. */
+static void app_timer_WheelCascade(uint8_t level, uint8_t slot)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+    APP_TIMER_Node_T *p_node = p_wheel->p_slot[level][slot];
+
+    p_wheel->p_slot[level][slot] = NULL;
+    p_wheel->occupied[level] &= ~(1ULL << slot);
+
+    while (p_node != NULL)
+    {
+        APP_TIMER_Node_T *p_next = p_node->p_next;
+
+        app_timer_WheelInsert(p_node);
+        p_node = p_next;
+    }
+}
+
+/* Must be called with the wheel locked. Returns false if no node is pending. */
+static bool app_timer_WheelNextDeadline(uint32_t *p_deadline)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+    uint8_t level;
+
+    //Level 0 gives an exact deadline; higher levels give the tick their window opens, where the cascade happens.
+    for (level = 0; level < APP_TIMER_WHEEL_LEVELS; level++)
+    {
+        uint8_t shift = APP_TIMER_WHEEL_LEVEL_SHIFT(level);
+        uint8_t idx = APP_TIMER_WHEEL_SLOT(p_wheel->now, level);
+        uint64_t occupied = p_wheel->occupied[level];
+        uint64_t after;
+        uint32_t base;
+
+        if (occupied == 0)
         {
-           //appMsg.msgId = APP_TIMER_ID_1_MSG;
+            continue;
         }
-        break;
-        case APP_TIMER_ID_2:
+
+        after = (idx == APP_TIMER_WHEEL_MASK) ? 0 : (occupied & (~0ULL << (idx + 1U)));
+        base = p_wheel->now & ~((APP_TIMER_WHEEL_SLOTS << shift) - 1UL);
+
+        if (after != 0)
         {
-           //appMsg.msgId = APP_TIMER_ID_2_MSG;
+            *p_deadline = base + ((uint32_t)__builtin_ctzll(after) << shift);
         }
-        break;
-        case APP_TIMER_ID_3:
+        else
         {
-           //appMsg.msgId = APP_TIMER_ID_3_MSG;
+            //Only the top level wraps: its lower slots belong to the next rotation.
+            *p_deadline = base + (APP_TIMER_WHEEL_SLOTS << shift) + ((uint32_t)__builtin_ctzll(occupied) << shift);
         }
-        break;
-        case APP_TIMER_ID_4:
+
+        return true;
+    }
+
+    return false;
+}
+
+/* Must be called with the wheel locked. Moves every node due at or before the target tick to the expired list. */
+static void app_timer_WheelAdvance(uint32_t target)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+    uint32_t next;
+
+    //Jump from one occupied deadline or cascade point to the next; empty windows in between are never visited.
+    while (app_timer_WheelNextDeadline(&next) && ((int32_t)(next - target) <= 0))
+    {
+        uint8_t level;
+        uint8_t idx;
+        APP_TIMER_Node_T *p_node;
+
+        p_wheel->now = next;
+
+        //Entering a new level 0 window: cascade from the highest level whose window also starts here.
+        if (APP_TIMER_WHEEL_SLOT(next, 0) == 0)
         {
-           //appMsg.msgId = APP_TIMER_ID_4_MSG;
+            for (level = 1; level < (APP_TIMER_WHEEL_LEVELS - 1U); level++)
+            {
+                if (APP_TIMER_WHEEL_SLOT(next, level) != 0)
+                {
+                    break;
+                }
+            }
+
+            for (; level >= 1U; level--)
+            {
+                app_timer_WheelCascade(level, APP_TIMER_WHEEL_SLOT(next, level));
+            }
         }
-        break;
-        case APP_TIMER_ID_5:
+
+        idx = APP_TIMER_WHEEL_SLOT(next, 0);
+        p_node = p_wheel->p_slot[0][idx];
+        p_wheel->p_slot[0][idx] = NULL;
+        p_wheel->occupied[0] &= ~(1ULL << idx);
+
+        while (p_node != NULL)
         {
-           //appMsg.msgId = APP_TIMER_ID_5_MSG;
+            APP_TIMER_Node_T *p_next = p_node->p_next;
+
+            app_timer_ListPush(&p_wheel->p_expired, p_node);
+            p_node->level = APP_TIMER_NODE_EXPIRED;
+            p_node = p_next;
         }
-        break;	
+    }
 
-        default:
-            break;
+    p_wheel->now = target;
+}
+
+/* Must be called with the wheel locked. Returns true if the driver timer has to be reprogrammed. */
+static bool app_timer_WheelUpdateDeadline(uint32_t *p_delay)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+    uint32_t deadline;
+    uint32_t now = xTaskGetTickCount();
+
+    if (p_wheel->p_expired != NULL)
+    {
+        //Nodes collected by an arm outside the driver callback are handed to the next driver run.
+        deadline = p_wheel->now;
+    }
+    else if (!app_timer_WheelNextDeadline(&deadline))
+    {
+        return false;
     }
 
-    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, msgWaitTime);
+    if (p_wheel->driverArmed && ((int32_t)(deadline - p_wheel->deadline) >= 0))
+    {
+        //The driver already wakes up early enough.
+        return false;
+    }
+
+    p_wheel->deadline = deadline;
+    p_wheel->driverArmed = true;
+    *p_delay = ((int32_t)(deadline - now) > 0) ? (deadline - now) : 1UL;
+
+    return true;
 }
 
-static void APP_TIMER_PeriodicTimerExpiredHandle(TimerHandle_t xTimer)
+static void app_timer_WheelProgram(uint32_t delay)
 {
-    uint8_t *timerId;
-    APP_Msg_T appMsg;
+    uint32_t prevTick, prevDelay;
 
-    timerId = (uint8_t *)pvTimerGetTimerID(xTimer);
+    //Recorded before the send: the daemon may apply the command and expire before the call returns.
+    taskENTER_CRITICAL();
+    prevTick = s_timerWheel.programTick;
+    prevDelay = s_timerWheel.programDelay;
+    s_timerWheel.programTick = xTaskGetTickCount();
+    s_timerWheel.programDelay = delay;
+    taskEXIT_CRITICAL();
 
-    switch (*timerId)
+    if (xTimerChangePeriod(s_timerWheel.driver, delay, 0) != pdPASS)
     {
-        case APP_TIMER_ID_0:
-        {
-            appMsg.msgId = APP_TIMER_ID_0_MSG;
-        }
-        break;   
-        
-        case APP_TIMER_ID_1:
-        {
-           //appMsg.msgId = APP_TIMER_ID_1_MSG;
-        }
-        break;
-        case APP_TIMER_ID_2:
+        taskENTER_CRITICAL();
+        s_timerWheel.driverArmed = false;
+        s_timerWheel.programTick = prevTick;
+        s_timerWheel.programDelay = prevDelay;
+        s_timerStats.cmdFailCnt++;
+        taskEXIT_CRITICAL();
+    }
+}
+
+static void app_timer_DriverExpiredHandle(TimerHandle_t xTimer)
+{
+    APP_TIMER_Wheel_T *p_wheel = &s_timerWheel;
+    uint32_t now;
+    uint32_t delay = 0;
+    uint32_t accept;
+    bool reprogram;
+
+    taskENTER_CRITICAL();
+    //Read under the lock: an arm from a higher priority task may have advanced the wheel meanwhile.
+    now = xTaskGetTickCount();
+    //The daemon starts the period when it applies the command, so the expiry tick tells when that happened.
+    accept = xTimerGetExpiryTime(xTimer) - p_wheel->programDelay - p_wheel->programTick;
+    if (((int32_t)accept >= 0) && (accept > s_timerStats.maxArmAcceptTicks))
+    {
+        s_timerStats.maxArmAcceptTicks = accept;
+    }
+    //The running callback stands for a driver armed at now: arms from the callbacks leave the reprogramming to it.
+    p_wheel->driverArmed = true;
+    p_wheel->deadline = now;
+    app_timer_WheelAdvance(now);
+    taskEXIT_CRITICAL();
+
+    //Callbacks run one node at a time outside the lock, so they may start or stop any timer.
+    for (;;)
+    {
+        APP_TIMER_Node_T *p_node;
+        APP_TIMER_NodeCb_T cb;
+        void *p_arg;
+        uint32_t late;
+
+        taskENTER_CRITICAL();
+        p_node = p_wheel->p_expired;
+        if (p_node == NULL)
         {
-           //appMsg.msgId = APP_TIMER_ID_2_MSG;
+            taskEXIT_CRITICAL();
+            break;
         }
-        break;
-        case APP_TIMER_ID_3:
+
+        app_timer_ListUnlink(p_node);
+        p_node->level = APP_TIMER_NODE_IDLE;
+        late = now - p_node->expires;
+        cb = p_node->cb;
+        p_arg = p_node->p_arg;
+
+        if (p_node->periodic)
         {
-           //appMsg.msgId = APP_TIMER_ID_3_MSG;
+            //Re-arm from the previous deadline so periodic timers do not drift, but never into the collected past.
+            p_node->expires += p_node->period;
+            if ((int32_t)(p_node->expires - p_wheel->now) <= 0)
+            {
+                p_node->expires = p_wheel->now + 1UL;
+            }
+            app_timer_WheelInsert(p_node);
         }
-        break;
-        case APP_TIMER_ID_4:
+
+        if (late > s_timerStats.maxExpiryLateTicks)
         {
-           //appMsg.msgId = APP_TIMER_ID_4_MSG;
+            s_timerStats.maxExpiryLateTicks = late;
         }
-        break;
-        case APP_TIMER_ID_5:
+        s_timerStats.expireCnt++;
+        taskEXIT_CRITICAL();
+
+        if (cb != NULL)
         {
-           //appMsg.msgId = APP_TIMER_ID_5_MSG;
+            cb(p_arg);
         }
-        break;
-        default:
-            break;
     }
 
-    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
-    //No need to free timer ID due to it's periodic timer
+    taskENTER_CRITICAL();
+    p_wheel->driverArmed = false;
+    reprogram = app_timer_WheelUpdateDeadline(&delay);
+    taskEXIT_CRITICAL();
+
+    if (reprogram)
+    {
+        app_timer_WheelProgram(delay);
+    }
 }
 
-bool APP_TIMER_IsTimerExisted(uint8_t timerId)
+void APP_TIMER_NodeInit(APP_TIMER_Node_T *p_node, APP_TIMER_NodeCb_T cb, void *p_arg)
 {
-    return (s_timerHandler[timerId] == NULL) ? false:true;
+    memset(p_node, 0, sizeof(APP_TIMER_Node_T));
+    p_node->cb = cb;
+    p_node->p_arg = p_arg;
+    p_node->level = APP_TIMER_NODE_IDLE;
 }
 
-uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTimer)
+uint16_t APP_TIMER_NodeStart(APP_TIMER_Node_T *p_node, uint32_t timeout, bool isPeriodicTimer)
 {
-    char timerName[] = "APP_Timer0";
-    uint8_t nameLen;
-    uint8_t *p_timerId;
+    uint32_t ticks = APP_TIMER_MS_TO_TICKS(timeout);
+    uint32_t delay = 0;
+    bool reprogram;
 
-    if (s_timerHandler[timerId])
+    if (p_node == NULL)
     {
-        uint8_t *existedTimerId;
-        
-        existedTimerId = (uint8_t *)pvTimerGetTimerID(s_timerHandler[timerId]);
+        return APP_RES_INVALID_PARA;
+    }
 
-        xTimerStop(s_timerHandler[timerId], 0);
-        xTimerDelete(s_timerHandler[timerId], 0);
-        s_timerHandler[timerId] = NULL;
+    if (s_timerWheel.driver == NULL)
+    {
+        return APP_RES_NO_RESOURCE;
+    }
 
-        p_timerId = existedTimerId;                 //Reuse the timer ID, no need to allocate again
+    if (ticks == 0)
+    {
+        ticks = 1;
     }
-    else
+    else if (ticks > APP_TIMER_WHEEL_MAX_TICKS)
     {
-        p_timerId = OSAL_Malloc(sizeof(timerId));
+        ticks = APP_TIMER_WHEEL_MAX_TICKS;
+    }
 
-        if (p_timerId == NULL)
-        {
-            return APP_RES_OOM;
-        }
+    taskENTER_CRITICAL();
+    app_timer_WheelRemove(p_node);
 
-        *p_timerId = timerId;
-    }
+    //The driver only advances the wheel at deadlines and cascade points, so its time may lag the tick by hours.
+    //Catch it up before measuring the new distance, or a long timeout would be clamped against the stale time.
+    app_timer_WheelAdvance(xTaskGetTickCount());
 
-    nameLen = sizeof(timerName) / sizeof(char) - 1;   //-1 means the end character
-    timerName[nameLen - 1] = '0' + timerId;           //switch to ASCII
+    p_node->period = ticks;
+    p_node->periodic = isPeriodicTimer;
+    p_node->expires = xTaskGetTickCount() + ticks;
+    app_timer_WheelInsert(p_node);
+    reprogram = app_timer_WheelUpdateDeadline(&delay);
+    s_timerStats.armCnt++;
+    taskEXIT_CRITICAL();
 
-    if (isPeriodicTimer)
+    if (reprogram)
     {
-        s_timerHandler[timerId] = xTimerCreate(timerName, (timeout / portTICK_PERIOD_MS), pdTRUE, (void *)p_timerId, APP_TIMER_PeriodicTimerExpiredHandle);
+        app_timer_WheelProgram(delay);
     }
-    else
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_TIMER_NodeStop(APP_TIMER_Node_T *p_node)
+{
+    if (p_node == NULL)
     {
-        s_timerHandler[timerId] = xTimerCreate(timerName, (timeout / portTICK_PERIOD_MS), pdFALSE, (void *)p_timerId, APP_TIMER_OneShotTimerExpiredHandle);
+        return;
     }
 
-    if (s_timerHandler[timerId])
+    //The driver timer is left running; a wakeup with nothing due is cheaper than a daemon command per cancel.
+    taskENTER_CRITICAL();
+    app_timer_WheelRemove(p_node);
+    taskEXIT_CRITICAL();
+}
+
+bool APP_TIMER_NodeIsActive(APP_TIMER_Node_T const *p_node)
+{
+    //A linked node always has a back link, so a zero-initialized node reads as stopped
+    return (p_node != NULL) && (p_node->pp_prev != NULL);
+}
+
+static void app_timer_IdExpiredHandle(void *p_arg)
+{
+    uint8_t timerId = (uint8_t)(uintptr_t)p_arg;
+
+    __atomic_fetch_or(&s_timerExpiredMask, (1UL << timerId), __ATOMIC_RELEASE);
+
+    //Only one message is in flight for any number of expiries; the application drains the mask with APP_TIMER_GetExpired.
+    if (!s_timerNotifyPending)
     {
-        if (pdFAIL == xTimerStart(s_timerHandler[timerId], 0))
+        APP_Msg_T appMsg;
+
+        appMsg.msgId = APP_MSG_TIMER_EVT;
+        appMsg.msgLen = 0;
+
+        if (OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0) == OSAL_RESULT_TRUE)
+        {
+            s_timerNotifyPending = true;
+            s_timerStats.notifyCnt++;
+        }
+        else
         {
-            OSAL_Free(p_timerId);
-            return APP_RES_FAIL;
+            s_timerStats.notifyFailCnt++;
         }
-        return APP_RES_SUCCESS;
+    }
+}
+
+uint16_t APP_TIMER_Init(void)
+{
+    uint8_t i;
+
+    memset(&s_timerWheel, 0, sizeof(s_timerWheel));
+    memset(&s_timerStats, 0, sizeof(s_timerStats));
+    s_timerExpiredMask = 0;
+    s_timerNotifyPending = false;
+    s_timerWheel.now = xTaskGetTickCount();
+
+    for (i = 0; i < APP_TIMER_TOTAL; i++)
+    {
+        APP_TIMER_NodeInit(&s_timerNode[i], app_timer_IdExpiredHandle, (void *)(uintptr_t)i);
     }
 
-    //The timer is not created successfully
-    OSAL_Free(p_timerId);
-    s_timerHandler[timerId] = NULL;
+    s_timerWheel.driver = xTimerCreate("APP_Timer", 1, pdFALSE, NULL, app_timer_DriverExpiredHandle);
 
-    return APP_RES_NO_RESOURCE;
+    if (s_timerWheel.driver == NULL)
+    {
+        return APP_RES_NO_RESOURCE;
+    }
+
+    return APP_RES_SUCCESS;
 }
 
-uint16_t APP_TIMER_StopTimer(uint8_t timerId)
+bool APP_TIMER_IsTimerExisted(uint8_t timerId)
+{
+    if (timerId >= APP_TIMER_TOTAL)
+    {
+        return false;
+    }
+
+    return APP_TIMER_NodeIsActive(&s_timerNode[timerId]);
+}
+
+uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTimer)
 {
-    if (s_timerHandler[timerId] == NULL)
+    if (timerId >= APP_TIMER_TOTAL)
     {
         return APP_RES_INVALID_PARA;
     }
 
-    if (xTimerStop(s_timerHandler[timerId], 0) != pdPASS)
+    //Drop a pending expiry of the previous arming so a re-armed timer does not fire early.
+    __atomic_fetch_and(&s_timerExpiredMask, ~(1UL << timerId), __ATOMIC_RELAXED);
+
+    return APP_TIMER_NodeStart(&s_timerNode[timerId], timeout, isPeriodicTimer);
+}
+
+uint16_t APP_TIMER_StopTimer(uint8_t timerId)
+{
+    if ((timerId >= APP_TIMER_TOTAL) || (!APP_TIMER_NodeIsActive(&s_timerNode[timerId])))
     {
-        return APP_RES_FAIL;
+        return APP_RES_INVALID_PARA;
     }
 
+    APP_TIMER_NodeStop(&s_timerNode[timerId]);
+    __atomic_fetch_and(&s_timerExpiredMask, ~(1UL << timerId), __ATOMIC_RELAXED);
+
     return APP_RES_SUCCESS;
 }
 
 uint16_t APP_TIMER_ResetTimer(uint8_t timerId)
 {
-    if (s_timerHandler[timerId] == NULL)
+    APP_TIMER_Node_T *p_node;
+
+    if ((timerId >= APP_TIMER_TOTAL) || (!APP_TIMER_NodeIsActive(&s_timerNode[timerId])))
     {
         return APP_RES_INVALID_PARA;
     }
 
-    if (xTimerReset(s_timerHandler[timerId], 0) != pdPASS)
+    p_node = &s_timerNode[timerId];
+
+    return APP_TIMER_NodeStart(p_node, p_node->period * portTICK_PERIOD_MS, p_node->periodic);
+}
+
+uint32_t APP_TIMER_GetExpired(void)
+{
+    //Clear the pending flag first: an expiry racing with the drain posts a fresh message rather than being lost.
+    s_timerNotifyPending = false;
+
+    return __atomic_exchange_n(&s_timerExpiredMask, 0, __ATOMIC_ACQUIRE);
+}
+
+void APP_TIMER_GetStats(APP_TIMER_Stats_T *p_stats)
+{
+    if (p_stats == NULL)
     {
-        return APP_RES_FAIL;
+        return;
     }
 
-    return APP_RES_SUCCESS;
+    taskENTER_CRITICAL();
+    p_stats->armCnt = s_timerStats.armCnt;
+    p_stats->expireCnt = s_timerStats.expireCnt;
+    p_stats->notifyCnt = s_timerStats.notifyCnt;
+    p_stats->notifyFailCnt = s_timerStats.notifyFailCnt;
+    p_stats->cmdFailCnt = s_timerStats.cmdFailCnt;
+    p_stats->maxArmAcceptTicks = s_timerStats.maxArmAcceptTicks;
+    p_stats->maxExpiryLateTicks = s_timerStats.maxExpiryLateTicks;
+    taskEXIT_CRITICAL();
 }
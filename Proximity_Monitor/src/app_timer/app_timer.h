@@ -93,6 +93,45 @@ typedef enum APP_TIMER_TimerId_T
 #define APP_TIMER_30S                                  0x7530   /**< 30s timer. */
 /** @} */
 
+#define APP_TIMER_MAX_TIMEOUT                          0xFC0000 /**< Longest timeout with the 1ms tick, about 4.5h (unit: ms). Longer timeouts are clamped. */
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Callback of a logical timer. Called from the timer daemon task, it must not block. */
+typedef void (*APP_TIMER_NodeCb_T)(void *p_arg);
+
+/**@brief Logical timer. Owned by the caller and only accessed through the APP_TIMER_Node* functions. */
+typedef struct APP_TIMER_Node_T
+{
+    struct APP_TIMER_Node_T     *p_next;        /**< Next node in the same wheel slot. */
+    struct APP_TIMER_Node_T     **pp_prev;      /**< Link pointing at this node, for O(1) unlink. */
+    uint32_t                    expires;        /**< Absolute expiry tick. */
+    uint32_t                    period;         /**< Armed timeout (unit: tick). */
+    APP_TIMER_NodeCb_T          cb;             /**< Expiry callback. */
+    void                        *p_arg;         /**< Argument passed to the callback. */
+    bool                        periodic;       /**< Re-armed automatically after expiry. */
+    uint8_t                     level;          /**< Wheel level the node is linked on. */
+    uint8_t                     slot;           /**< Wheel slot the node is linked on. */
+} APP_TIMER_Node_T;
+
+/**@brief Timer engine counters. See @ref APP_TIMER_GetStats. */
+typedef struct APP_TIMER_Stats_T
+{
+    uint32_t    armCnt;                       /**< Number of successful @ref APP_TIMER_SetTimer calls. */
+    uint32_t    expireCnt;                    /**< Number of timer expiries. */
+    uint32_t    notifyCnt;                    /**< Number of APP_MSG_TIMER_EVT messages posted. */
+    uint32_t    notifyFailCnt;                /**< Number of expiries that found the application queue full. */
+    uint32_t    cmdFailCnt;                   /**< Number of driver timer commands rejected because the timer daemon queue was full.
+                                                   FreeRTOS does not expose the depth of that queue, this is the overflow count of it. */
+    uint32_t    maxArmAcceptTicks;            /**< Worst delay from an arm call programming the driver timer to the timer daemon applying it (unit: tick). */
+    uint32_t    maxExpiryLateTicks;           /**< Worst expiry lateness against the armed deadline (unit: tick). */
+} APP_TIMER_Stats_T;
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -100,11 +139,54 @@ typedef enum APP_TIMER_TimerId_T
 // *****************************************************************************
 // *****************************************************************************
 
-/**@brief The function is used to check if a timer exists already.
+/**@brief The function is used to initialize the timer wheel. All logical timers share one RTOS timer programmed to the earliest deadline.
+ *
+ * @retval APP_RES_SUCCESS                    The timer wheel is initialized.
+ * @retval APP_RES_NO_RESOURCE                Failed to create the RTOS timer.
+ *
+ */
+uint16_t APP_TIMER_Init(void);
+
+/**@brief The function is used to initialize a logical timer before its first use.
+ *@param[in] p_node                           Pointer to the logical timer.
+ *@param[in] cb                               Expiry callback. See @ref APP_TIMER_NodeCb_T.
+ *@param[in] p_arg                            Argument passed to the callback.
+ *
+ */
+void APP_TIMER_NodeInit(APP_TIMER_Node_T *p_node, APP_TIMER_NodeCb_T cb, void *p_arg);
+
+/**@brief The function is used to start or re-start a logical timer in O(1). Not callable from an interrupt.
+ *@param[in] p_node                           Pointer to the logical timer.
+ *@param[in] timeout                          Timeout value (unit: ms), up to @ref APP_TIMER_MAX_TIMEOUT.
+ *@param[in] isPeriodicTimer                  Set as true to let the timer expire repeatedly.
+ *
+ * @retval APP_RES_SUCCESS                    The timer is started.
+ * @retval APP_RES_INVALID_PARA               p_node is NULL.
+ * @retval APP_RES_NO_RESOURCE                The timer wheel is not initialized.
+ *
+ */
+uint16_t APP_TIMER_NodeStart(APP_TIMER_Node_T *p_node, uint32_t timeout, bool isPeriodicTimer);
+
+/**@brief The function is used to cancel a logical timer in O(1). Not callable from an interrupt.
+ *@param[in] p_node                           Pointer to the logical timer.
+ *
+ */
+void APP_TIMER_NodeStop(APP_TIMER_Node_T *p_node);
+
+/**@brief The function is used to check if a logical timer is pending.
+ *@param[in] p_node                           Pointer to the logical timer.
+ *
+ * @retval true                               The timer is pending.
+ * @retval false                              The timer is stopped or has expired as one-shot.
+ *
+ */
+bool APP_TIMER_NodeIsActive(APP_TIMER_Node_T const *p_node);
+
+/**@brief The function is used to check if a timer is armed.
  *@param[in] timerId                          Timer ID. See @ref APP_TIMER_TimerId_T.
  *
- * @retval true                               This timer exites alread.
- * @retval false                              This timer doesn't exist.
+ * @retval true                               This timer is armed.
+ * @retval false                              This timer is not armed or has expired as one-shot.
  *
  */
 bool APP_TIMER_IsTimerExisted(uint8_t timerId);
@@ -117,8 +199,8 @@ bool APP_TIMER_IsTimerExisted(uint8_t timerId);
  *
  * @retval APP_RES_SUCCESS                    Set and start a timer successfully.
  * @retval APP_RES_FAIL                       Failed to start the timer.
- * @retval APP_RES_OOM                        No available memory.
- * @retval APP_RES_NO_RESOURCE                Failed to create a new timer.
+ * @retval APP_RES_INVALID_PARA               The timerId is out of range.
+ * @retval APP_RES_NO_RESOURCE                The timer wheel is not initialized.
  *
  */
 uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTimer);
@@ -128,7 +210,7 @@ uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTi
  *
  * @retval APP_RES_SUCCESS                    Stop a timer successfully.
  * @retval APP_RES_FAIL                       Failed to stop the timer.
- * @retval APP_RES_INVALID_PARA               The timerId doesn't exist.
+ * @retval APP_RES_INVALID_PARA               The timer is not armed.
  *
  */
 uint16_t APP_TIMER_StopTimer(uint8_t timerId);
@@ -138,9 +220,23 @@ uint16_t APP_TIMER_StopTimer(uint8_t timerId);
  *
  * @retval APP_RES_SUCCESS                    Reset a timer successfully.
  * @retval APP_RES_FAIL                       Failed to reset the timer.
- * @retval APP_RES_INVALID_PARA               The timerId doesn't exist.
+ * @retval APP_RES_INVALID_PARA               The timer is not armed.
  *
  */
 uint16_t APP_TIMER_ResetTimer(uint8_t timerId);
 
+/**@brief The function is used to fetch and clear the timers expired since the last call.
+ *        Call it on APP_MSG_TIMER_EVT; one message covers every expiry before the call.
+ *
+ * @retval Bit mask of expired timers, bit n is set for @ref APP_TIMER_TimerId_T n.
+ *
+ */
+uint32_t APP_TIMER_GetExpired(void);
+
+/**@brief The function is used to read the timer engine counters.
+ *@param[out] p_stats                         Pointer to the counters. See @ref APP_TIMER_Stats_T.
+ *
+ */
+void APP_TIMER_GetStats(APP_TIMER_Stats_T *p_stats);
+
 #endif
@@ -0,0 +1,202 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application UART Transmit Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_uart.c
+
+  Summary:
+    This file contains the Application console transmit path for this project.
+
+  Description:
+    This file contains the Application console transmit path for this project.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "app_uart.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_UART_TX_INDEX(idx)              ((idx) & (APP_UART_TX_BUFFER_SIZE - 1U))
+#define APP_UART_IRQ_PRIORITY               (7U)        /* Same as the other peripheral interrupts */
+
+#if ((APP_UART_TX_BUFFER_SIZE & (APP_UART_TX_BUFFER_SIZE - 1U)) != 0U)
+#error "APP_UART_TX_BUFFER_SIZE must be a power of 2"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+/* Indexes run free and are masked on access, so the buffer holds up to APP_UART_TX_BUFFER_SIZE bytes */
+static uint8_t              s_uartTxBuf[APP_UART_TX_BUFFER_SIZE];
+static volatile uint32_t    s_uartTxInIdx;
+static volatile uint32_t    s_uartTxOutIdx;
+static volatile bool        s_uartTxBusy;       /* A character went to the UART and TXC has not been seen since */
+static APP_UART_Stats_T     s_uartStats;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+/* Overrides the weak alias of interrupts.c, the SERCOM0 PLIB is generated without interrupt support */
+void SERCOM0_Handler(void);
+
+void SERCOM0_Handler(void)
+{
+    if (((SERCOM0_REGS->USART_INT.SERCOM_INTENSET & (uint8_t)SERCOM_USART_INT_INTENSET_DRE_Msk) == 0U)
+        || ((SERCOM0_REGS->USART_INT.SERCOM_INTFLAG & (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk) == 0U))
+    {
+        return;
+    }
+
+    if (s_uartTxOutIdx != s_uartTxInIdx)
+    {
+        //Writing DATA also clears TXC
+        SERCOM0_REGS->USART_INT.SERCOM_DATA = s_uartTxBuf[APP_UART_TX_INDEX(s_uartTxOutIdx)];
+        s_uartTxOutIdx++;
+        s_uartTxBusy = true;
+    }
+    else
+    {
+        SERCOM0_REGS->USART_INT.SERCOM_INTENCLR = (uint8_t)SERCOM_USART_INT_INTENCLR_DRE_Msk;
+    }
+}
+
+void APP_UART_Init(void)
+{
+    (void)memset(&s_uartStats, 0, sizeof(APP_UART_Stats_T));
+
+    NVIC_SetPriority(SERCOM0_IRQn, APP_UART_IRQ_PRIORITY);
+    NVIC_EnableIRQ(SERCOM0_IRQn);
+}
+
+size_t APP_UART_Write(const void *p_data, size_t len)
+{
+    const uint8_t *p_src = (const uint8_t *)p_data;
+    uint32_t nFree, nPending, drop;
+    size_t i;
+    bool interruptState;
+
+    if ((p_data == NULL) || (len == 0U))
+    {
+        return 0U;
+    }
+
+    //The interrupt moves the out index too
+    interruptState = NVIC_INT_Disable();
+
+    nFree = APP_UART_TX_BUFFER_SIZE - (s_uartTxInIdx - s_uartTxOutIdx);
+    if (len > nFree)
+    {
+        s_uartStats.overflowCnt++;
+
+        if (APP_UART_TX_POLICY == APP_UART_TX_POLICY_DROP_OLDEST)
+        {
+            if (len > APP_UART_TX_BUFFER_SIZE)
+            {
+                //Only the tail of the request fits at all
+                s_uartStats.droppedBytes += (uint32_t)(len - APP_UART_TX_BUFFER_SIZE);
+                p_src += (len - APP_UART_TX_BUFFER_SIZE);
+                len = APP_UART_TX_BUFFER_SIZE;
+            }
+
+            drop = (uint32_t)len - nFree;
+            s_uartStats.droppedBytes += drop;
+            s_uartTxOutIdx += drop;
+        }
+        else
+        {
+            s_uartStats.droppedBytes += ((uint32_t)len - nFree);
+            len = nFree;
+        }
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        s_uartTxBuf[APP_UART_TX_INDEX(s_uartTxInIdx + i)] = p_src[i];
+    }
+    s_uartTxInIdx += (uint32_t)len;
+
+    nPending = s_uartTxInIdx - s_uartTxOutIdx;
+    if (nPending > s_uartStats.highWater)
+    {
+        s_uartStats.highWater = nPending;
+    }
+
+    if (nPending != 0U)
+    {
+        SERCOM0_REGS->USART_INT.SERCOM_INTENSET = (uint8_t)SERCOM_USART_INT_INTENSET_DRE_Msk;
+    }
+
+    NVIC_INT_Restore(interruptState);
+
+    return len;
+}
+
+size_t APP_UART_GetPendingCnt(void)
+{
+    return (size_t)(s_uartTxInIdx - s_uartTxOutIdx);
+}
+
+bool APP_UART_IsTxIdle(void)
+{
+    if (s_uartTxInIdx != s_uartTxOutIdx)
+    {
+        return false;
+    }
+
+    //The ring buffer empties when the last character is loaded, not when it has been shifted out
+    if (s_uartTxBusy && SERCOM0_USART_TransmitComplete())
+    {
+        s_uartTxBusy = false;
+    }
+
+    return !s_uartTxBusy;
+}
+
+void APP_UART_GetStats(APP_UART_Stats_T *p_stats)
+{
+    bool interruptState;
+
+    interruptState = NVIC_INT_Disable();
+    (void)memcpy(p_stats, &s_uartStats, sizeof(APP_UART_Stats_T));
+    NVIC_INT_Restore(interruptState);
+}
@@ -0,0 +1,148 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application UART Transmit Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_uart.h
+
+  Summary:
+    This file contains the Application console transmit path for this project.
+
+  Description:
+    Console output is copied into a RAM ring buffer and sent by the SERCOM0
+    data register empty interrupt, so printf() and the deferred log never wait
+    for the UART. The SERCOM0 PLIB generated by MCC stays in blocking mode and
+    is only used for its initialization and status helpers.
+ *******************************************************************************/
+
+#ifndef APP_UART_H
+#define APP_UART_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_UART_TX_BUFFER_SIZE             (1024U)     /**< Size of the transmit ring buffer, in bytes. Must be a power of 2. */
+
+/**@brief Policy applied by @ref APP_UART_Write when the ring buffer is full. See @ref APP_UART_TxPolicy_T. */
+#ifndef APP_UART_TX_POLICY
+#define APP_UART_TX_POLICY                  APP_UART_TX_POLICY_DROP_NEWEST
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The definition of the overflow policies. */
+typedef enum APP_UART_TxPolicy_T
+{
+    APP_UART_TX_POLICY_DROP_NEWEST = 0x00,  /**< Bytes which do not fit are discarded, what is queued is sent intact. */
+    APP_UART_TX_POLICY_DROP_OLDEST          /**< The oldest queued bytes are discarded to make room, the latest output is kept. */
+} APP_UART_TxPolicy_T;
+
+/**@brief Statistics of the transmit path. */
+typedef struct APP_UART_Stats_T
+{
+    uint32_t    droppedBytes;       /**< Bytes discarded because the ring buffer was full. */
+    uint32_t    overflowCnt;        /**< Writes which discarded bytes. */
+    uint32_t    highWater;          /**< Highest number of bytes pending in the ring buffer. */
+} APP_UART_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the transmit path and enable the SERCOM0 interrupt.
+ *        Output written before is kept and sent once the interrupt is enabled.
+ */
+void APP_UART_Init(void);
+
+/**@brief The function is used to queue data for transmission. It never blocks and is safe to call from any task.
+ *@param[in] p_data                           Pointer to the data.
+ *@param[in] len                              Length of the data.
+ *
+ * @retval Number of bytes queued. Less than len if the ring buffer was full, see @ref APP_UART_TX_POLICY.
+ *
+ */
+size_t APP_UART_Write(const void *p_data, size_t len);
+
+/**@brief The function is used to get the number of bytes waiting in the ring buffer.
+ *
+ * @retval Number of pending bytes.
+ *
+ */
+size_t APP_UART_GetPendingCnt(void);
+
+/**@brief The function is used to check that all output has left the UART, including the last character
+ *        in the shift register. SERCOM0 does not run in sleep mode, so the device must not sleep before.
+ *
+ * @retval true                               Nothing is pending or being sent.
+ * @retval false                              Output is still in progress.
+ *
+ */
+bool APP_UART_IsTxIdle(void);
+
+/**@brief The function is used to get a snapshot of the transmit statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_UART_GetStats(APP_UART_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_UART_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -176,6 +176,21 @@ uint16_t BLE_DM_DeleteAllPairedDevice(void)
     return BLE_DM_DdsDeleteAllPairedDevice();
 }
 
+uint16_t BLE_DM_SetGattCache(uint8_t devId, uint8_t const *p_cache)
+{
+    return BLE_DM_DdsSetGattCache(devId, p_cache);
+}
+
+uint16_t BLE_DM_GetGattCache(uint8_t devId, uint8_t *p_cache)
+{
+    return BLE_DM_DdsGetGattCache(devId, p_cache);
+}
+
+uint16_t BLE_DM_DeleteGattCache(uint8_t devId)
+{
+    return BLE_DM_DdsDeleteGattCache(devId);
+}
+
 void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt)
 {
     uint8_t devId;
@@ -117,6 +117,24 @@ extern "C" {
 #define BLE_DM_MAX_RESOLVING_LIST_NUM           BLE_DM_MAX_PAIRED_DEVICE_NUM                /**< Maximum number of resolving list. */
 /** @} */
 
+/**@defgroup BLE_DM_GATT_CACHE_SIZE GATT cache size
+ * @brief The definition of the size of the GATT client cache stored in flash for each paired device.
+ * @{ */
+#define BLE_DM_GATT_CACHE_SIZE                  (24U)                              /**< Size of GATT client cache of a paired device. */
+/** @} */
+
+/**@defgroup BLE_DM_EVT_MASK Consumed stack events
+ * @brief The definition of the stack events handled by @ref BLE_DM_BleEventHandler, one bit per event ID of each group.
+ *        The stack event dispatcher of the application directs only these events to BLE_DM.
+ * @{ */
+#define BLE_DM_GAP_EVT_MASK                     ((1UL << BLE_GAP_EVT_CONNECTED) | (1UL << BLE_GAP_EVT_DISCONNECTED) \
+                                                | (1UL << BLE_GAP_EVT_CONN_PARAM_UPDATE) | (1UL << BLE_GAP_EVT_ENCRYPT_STATUS) \
+                                                | (1UL << BLE_GAP_EVT_ENC_INFO_REQUEST) | (1UL << BLE_GAP_EVT_REMOTE_CONN_PARAM_REQUEST))   /**< BLE GAP events. */
+#define BLE_DM_L2CAP_EVT_MASK                   ((1UL << BLE_L2CAP_EVT_CONN_PARA_UPDATE_REQ) | (1UL << BLE_L2CAP_EVT_CONN_PARA_UPDATE_RSP))  /**< BLE L2CAP events. */
+#define BLE_DM_SMP_EVT_MASK                     ((1UL << BLE_SMP_EVT_PAIRING_COMPLETE) | (1UL << BLE_SMP_EVT_SECURITY_REQUEST) \
+                                                | (1UL << BLE_SMP_EVT_NOTIFY_KEYS) | (1UL << BLE_SMP_EVT_PAIRING_REQUEST))                  /**< BLE SMP events. */
+/** @} */
+
 
 
 /**@} */ //BLE_DM_DEFINES
@@ -390,6 +408,39 @@ uint16_t BLE_DM_DeleteAllPairedDevice(void);
 */
 void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt);
 
+/**@brief Store the GATT client cache of a paired device in flash.
+ *        The content is opaque to BLE_DM. It is deleted together with the paired device information.
+ *
+ * @param[in] devId                  Paired device ID.
+ * @param[in] p_cache                Pointer to the cache buffer of @ref BLE_DM_GATT_CACHE_SIZE bytes.
+ *
+ * @retval MBA_RES_SUCCESS           Successfully requested to store the cache.
+ * @retval MBA_RES_INVALID_PARA      Invalid parameters, if device ID does not recognize a valid paired device.
+ * @retval MBA_RES_FAIL              The store operation failure.
+*/
+uint16_t BLE_DM_SetGattCache(uint8_t devId, uint8_t const *p_cache);
+
+/**@brief Get the GATT client cache of a paired device.
+ *
+ * @param[in] devId                  Paired device ID.
+ * @param[out] p_cache               Pointer to the cache buffer of @ref BLE_DM_GATT_CACHE_SIZE bytes.
+ *
+ * @retval MBA_RES_SUCCESS           Successfully get the cache.
+ * @retval MBA_RES_INVALID_PARA      Invalid parameters, or no cache stored for the device.
+ * @retval MBA_RES_FAIL              The get operation failure.
+*/
+uint16_t BLE_DM_GetGattCache(uint8_t devId, uint8_t *p_cache);
+
+/**@brief Delete the GATT client cache of a paired device.
+ *
+ * @param[in] devId                  Paired device ID.
+ *
+ * @retval MBA_RES_SUCCESS           Successfully deleted the cache.
+ * @retval MBA_RES_INVALID_PARA      Invalid parameters.
+ * @retval MBA_RES_FAIL              The delete operation failure.
+*/
+uint16_t BLE_DM_DeleteGattCache(uint8_t devId);
+
 /**@brief Change connection parameters of the specific connection.
  *
  * @param[in] connHandle            Connection handle associated with this connection.
@@ -402,6 +453,15 @@ void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt);
 */
 uint16_t BLE_DM_ConnectionParameterUpdate(uint16_t connHandle, BLE_DM_ConnParamUpdate_T *p_params);
 
+/**@brief Get the acceptable connection parameter range set by @ref BLE_DM_Config.
+ *
+ * @param[out] p_config             Pointer to the @ref BLE_DM_ConnConfig_T structure buffer.
+ *
+ * @retval MBA_RES_SUCCESS          Successfully get the range.
+ * @retval MBA_RES_FAIL             Automatic reply is disabled, no range has been set.
+*/
+uint16_t BLE_DM_GetConnConfig(BLE_DM_ConnConfig_T *p_config);
+
 /**@} */ //BLE_DM_FUNS
 
 //DOM-IGNORE-BEGIN
@@ -45,11 +45,13 @@
 // Section: Included Files
 // *****************************************************************************
 // *****************************************************************************
+#include <string.h>
 #include "osal/osal_freertos_extend.h"
 #include "ble_dm.h"
 #include "ble_dm_conn.h"
 #include "ble_dm_info.h"
 #include "ble_dm_internal.h"
+#include "ble_util/ble_conn_reg.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -102,33 +104,28 @@ static void ble_dm_ConnInitUpdateDb(BLE_DM_ConnUpdateDb_T *p_conn)
     (void)memset((uint8_t *)p_conn, 0, sizeof(BLE_DM_ConnUpdateDb_T));
 }
 
-static BLE_DM_ConnUpdateDb_T *ble_dm_GetFreeConn(void)
+static BLE_DM_ConnUpdateDb_T *ble_dm_GetFreeConn(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t i = BLE_CONN_REG_GetIndex(connHandle);
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    if ((i == BLE_CONN_REG_INDEX_INVALID) || (sp_dmConnCtrl->updateDb[i].state != BLE_DM_CONN_STATE_IDLE))
     {
-        if (sp_dmConnCtrl->updateDb[i].state == BLE_DM_CONN_STATE_IDLE)
-        {
-            sp_dmConnCtrl->updateDb[i].state = BLE_DM_CONN_STATE_CONNECTED;
-            return &sp_dmConnCtrl->updateDb[i];
-        }
+        return NULL;
     }
-    return NULL;
+
+    sp_dmConnCtrl->updateDb[i].state = BLE_DM_CONN_STATE_CONNECTED;
+    return &sp_dmConnCtrl->updateDb[i];
 }
 
 static BLE_DM_ConnUpdateDb_T *ble_dm_ConnFindConnByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t i = BLE_CONN_REG_GetIndex(connHandle);
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    if ((i == BLE_CONN_REG_INDEX_INVALID) || (sp_dmConnCtrl->updateDb[i].state != BLE_DM_CONN_STATE_CONNECTED))
     {
-        if ((sp_dmConnCtrl->updateDb[i].state == BLE_DM_CONN_STATE_CONNECTED) && (sp_dmConnCtrl->updateDb[i].connHandle == connHandle))
-        {
-            return &sp_dmConnCtrl->updateDb[i];
-        }
+        return NULL;
     }
-    return NULL;
+    return &sp_dmConnCtrl->updateDb[i];
 }
 
 bool BLE_DM_ConnInit(void)
@@ -162,7 +159,7 @@ static void ble_dm_ConnProcGapConnected(BLE_GAP_Event_T *p_event)
         BLE_DM_ConnUpdateDb_T *p_conn;
     
         /* Find free connection instance */
-        p_conn = ble_dm_GetFreeConn();
+        p_conn = ble_dm_GetFreeConn(p_event->eventField.evtConnect.connHandle);
 
         if (p_conn != NULL)
         {
@@ -466,3 +463,14 @@ uint16_t BLE_DM_ConnectionParameterUpdate(uint16_t connHandle, BLE_DM_ConnParamU
     return error;
 }
 
+uint16_t BLE_DM_GetConnConfig(BLE_DM_ConnConfig_T *p_config)
+{
+    if (!sp_dmConnCtrl->autoReplyUpdate)
+    {
+        return MBA_RES_FAIL;
+    }
+
+    (void)memcpy(p_config, &sp_dmConnCtrl->userConnConfig, sizeof(BLE_DM_ConnConfig_T));
+
+    return MBA_RES_SUCCESS;
+}
@@ -76,11 +76,31 @@ typedef enum BLE_DM_PdsBleItem_T{
     PDS_BLE_ITEM_EXT_ID_5,
     PDS_BLE_ITEM_EXT_ID_6,
     PDS_BLE_ITEM_EXT_ID_7,
-    PDS_BLE_ITEM_EXT_ID_8
+    PDS_BLE_ITEM_EXT_ID_8,
+
+
+    PDS_BLE_ITEM_GATT_ID_1,
+    PDS_BLE_ITEM_GATT_ID_2,
+    PDS_BLE_ITEM_GATT_ID_3,
+    PDS_BLE_ITEM_GATT_ID_4,
+    PDS_BLE_ITEM_GATT_ID_5,
+    PDS_BLE_ITEM_GATT_ID_6,
+    PDS_BLE_ITEM_GATT_ID_7,
+    PDS_BLE_ITEM_GATT_ID_8
 }BLE_DM_PdsBleItem_T;
 
 #define BLE_DM_DDS_FILE_MAIN_ITEM_START       PDS_BLE_ITEM_ID_1
 #define BLE_DM_DDS_FILE_EXT_ITEM_START        PDS_BLE_ITEM_EXT_ID_1
+#define BLE_DM_DDS_FILE_GATT_ITEM_START       PDS_BLE_ITEM_GATT_ID_1
+
+#define BLE_DM_DDS_ADDR_HASH_SIZE             (16U)     /* Power of 2, at least twice BLE_DM_MAX_PAIRED_DEVICE_NUM */
+#define BLE_DM_DDS_ADDR_HASH_EMPTY            (0xFFU)
+
+#if (BLE_DM_DDS_ADDR_HASH_SIZE < (2U * BLE_DM_MAX_PAIRED_DEVICE_NUM))
+#error "BLE_DM_DDS_ADDR_HASH_SIZE is too small for BLE_DM_MAX_PAIRED_DEVICE_NUM"
+#endif
+
+#define BLE_DM_DDS_RPA_CACHE_SIZE             (8U)      /* Recently resolved private addresses */
 
 // *****************************************************************************
 // *****************************************************************************
@@ -106,6 +126,24 @@ typedef struct BLE_DM_ExtPairedDevInfo_T
     uint8_t                         reserved[9];                   
 }BLE_DM_ExtPairedDevInfo_T;
 
+/* RAM copy of the identity of a paired device, kept coherent with the PDS files */
+typedef struct BLE_DM_DdsIndexEntry_T
+{
+    BLE_GAP_Addr_T                  remoteAddr;                    /**< Paired device bluetooth address. */
+    BLE_GAP_Addr_T                  localAddr;                     /**< Local device bluetooth address used for the bonding. */
+    uint8_t                         remoteIrk[16];                 /**< Paired device BLE identity resolving key. */
+    bool                            valid;                         /**< The device ID is in use. */
+    bool                            localAddrValid;                /**< The ext file is stored, localAddr is meaningful. */
+}BLE_DM_DdsIndexEntry_T;
+
+/* Bond of a recently seen resolvable private address, for the local address in s_ddsRpaCacheLocalAddr */
+typedef struct BLE_DM_DdsRpaCacheEntry_T
+{
+    uint32_t                        lastUse;                       /**< Tick of the last hit, 0 if the entry is free. */
+    uint8_t                         addr[GAP_MAX_BD_ADDRESS_LEN];  /**< Resolvable private address, prand and hash. */
+    uint8_t                         devId;                         /**< Result of the lookup, BLE_DM_MAX_PAIRED_DEVICE_NUM if none. */
+}BLE_DM_DdsRpaCacheEntry_T;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Local Variables
@@ -114,6 +152,7 @@ typedef struct BLE_DM_ExtPairedDevInfo_T
 
 static BLE_DM_MainPairedDevInfo_T s_mainPairedInfo;
 static BLE_DM_ExtPairedDevInfo_T s_extPairedInfo;
+static uint8_t s_gattCacheInfo[BLE_DM_GATT_CACHE_SIZE];
 
 
 PDS_DECLARE_FILE(PDS_BLE_ITEM_ID_1, sizeof(BLE_DM_MainPairedDevInfo_T), &s_mainPairedInfo,FILE_INTEGRITY_CONTROL_MARK);
@@ -134,20 +173,37 @@ PDS_DECLARE_FILE(PDS_BLE_ITEM_EXT_ID_6, sizeof(BLE_DM_ExtPairedDevInfo_T), &s_ex
 PDS_DECLARE_FILE(PDS_BLE_ITEM_EXT_ID_7, sizeof(BLE_DM_ExtPairedDevInfo_T), &s_extPairedInfo,FILE_INTEGRITY_CONTROL_MARK);
 PDS_DECLARE_FILE(PDS_BLE_ITEM_EXT_ID_8, sizeof(BLE_DM_ExtPairedDevInfo_T), &s_extPairedInfo,FILE_INTEGRITY_CONTROL_MARK);
 
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_1, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_2, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_3, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_4, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_5, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_6, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_7, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_GATT_ID_8, BLE_DM_GATT_CACHE_SIZE, s_gattCacheInfo,FILE_INTEGRITY_CONTROL_MARK);
+
 
 static BLE_DM_DdsWriteCompleteCb_T s_dmDdsCb;
 
+static BLE_DM_DdsIndexEntry_T s_ddsIndex[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+static uint8_t s_ddsAddrHash[BLE_DM_DDS_ADDR_HASH_SIZE];           /* Open addressing table of device IDs keyed by identity address */
+static uint8_t s_ddsIrkList[BLE_DM_MAX_PAIRED_DEVICE_NUM];         /* Device IDs with a non-zero IRK, candidates for RPA resolution */
+static uint8_t s_ddsIrkCnt;
+static MW_AES_Ctx_T s_ddsIrkCtx[BLE_DM_MAX_PAIRED_DEVICE_NUM];     /* Expanded AES key schedule of each IRK in s_ddsIrkList */
+static BLE_DM_DdsRpaCacheEntry_T s_ddsRpaCache[BLE_DM_DDS_RPA_CACHE_SIZE];
+static uint32_t s_ddsRpaCacheTick;
+static BLE_GAP_Addr_T s_ddsRpaCacheLocalAddr;                       /* Local address the cached results were found for */
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Functions
 // *****************************************************************************
 // *****************************************************************************
 
-static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remoteAddr)
+static bool ble_dm_DdsIrkKeySet(MW_AES_Ctx_T *p_ctx, uint8_t const *p_remoteIrk)
 {
-    uint8_t data[16], temp[16];
+    uint8_t temp[16];
     uint8_t i;
-    MW_AES_Ctx_T ctx;
 
     /* convert irk as aes key */
     for(i=0U; i<16U; i++)
@@ -155,10 +211,13 @@ static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remot
         temp[i]=p_remoteIrk[15U-i];
     }
 
-    if (MW_AES_EcbEncryptInit(&ctx, temp) != MBA_RES_SUCCESS)
-    {
-        return false;
-    }
+    return (MW_AES_EcbEncryptInit(p_ctx, temp) == MBA_RES_SUCCESS);
+}
+
+static bool ble_dm_DdsCheckResolveAddress(MW_AES_Ctx_T *p_ctx, uint8_t const *p_remoteAddr)
+{
+    uint8_t data[16], temp[16];
+    uint8_t i;
 
     /* get prand from address */
     (void)memset(&data[0], 0, 13);
@@ -168,7 +227,7 @@ static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remot
     }
 
     /* calculate localHash value */
-    if(MW_AES_AesEcbEncrypt(&ctx, 16, temp, data) != MBA_RES_SUCCESS)
+    if(MW_AES_AesEcbEncrypt(p_ctx, 16, temp, data) != MBA_RES_SUCCESS)
     {
         return false;
     }
@@ -183,6 +242,132 @@ static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remot
     return (memcmp(temp + 13, data, 3) == 0);
 }
 
+static uint8_t ble_dm_DdsAddrHash(uint8_t const *p_addr)
+{
+    uint8_t hash = 0;
+    uint8_t i;
+
+    for (i = 0U; i < GAP_MAX_BD_ADDRESS_LEN; i++)
+    {
+        hash = (uint8_t)((hash * 31U) ^ p_addr[i]);
+    }
+
+    return (hash & (BLE_DM_DDS_ADDR_HASH_SIZE - 1U));
+}
+
+static void ble_dm_DdsIndexRebuild(void)
+{
+    static const uint8_t zeroIrk[16] = {0};
+    uint8_t devId, slot;
+
+    (void)memset(s_ddsAddrHash, BLE_DM_DDS_ADDR_HASH_EMPTY, sizeof(s_ddsAddrHash));
+    s_ddsIrkCnt = 0;
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if (s_ddsIndex[devId].valid == false)
+        {
+            continue;
+        }
+
+        /* Devices are inserted in ID order, so probing returns the lowest matching ID first */
+        slot = ble_dm_DdsAddrHash(s_ddsIndex[devId].remoteAddr.addr);
+        while (s_ddsAddrHash[slot] != BLE_DM_DDS_ADDR_HASH_EMPTY)
+        {
+            slot = (slot + 1U) & (BLE_DM_DDS_ADDR_HASH_SIZE - 1U);
+        }
+        s_ddsAddrHash[slot] = devId;
+
+        /* The key schedule is expanded once here instead of on every resolution */
+        if ((memcmp(s_ddsIndex[devId].remoteIrk, zeroIrk, sizeof(zeroIrk)) != 0)
+            && ble_dm_DdsIrkKeySet(&s_ddsIrkCtx[s_ddsIrkCnt], s_ddsIndex[devId].remoteIrk))
+        {
+            s_ddsIrkList[s_ddsIrkCnt++] = devId;
+        }
+    }
+
+    /* Cached owners may have been deleted or replaced */
+    (void)memset(s_ddsRpaCache, 0, sizeof(s_ddsRpaCache));
+}
+
+static bool ble_dm_DdsRpaCacheGet(uint8_t const *p_addr, uint8_t *p_devId)
+{
+    uint8_t i;
+
+    for (i = 0; i < BLE_DM_DDS_RPA_CACHE_SIZE; i++)
+    {
+        if ((s_ddsRpaCache[i].lastUse != 0U)
+            && (memcmp(s_ddsRpaCache[i].addr, p_addr, GAP_MAX_BD_ADDRESS_LEN) == 0))
+        {
+            s_ddsRpaCache[i].lastUse = ++s_ddsRpaCacheTick;
+            *p_devId = s_ddsRpaCache[i].devId;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void ble_dm_DdsRpaCachePut(uint8_t const *p_addr, uint8_t devId)
+{
+    uint8_t i, victim = 0;
+
+    /* Replace a free entry, otherwise the least recently used one */
+    for (i = 0; i < BLE_DM_DDS_RPA_CACHE_SIZE; i++)
+    {
+        if (s_ddsRpaCache[i].lastUse < s_ddsRpaCache[victim].lastUse)
+        {
+            victim = i;
+        }
+    }
+
+    (void)memcpy(s_ddsRpaCache[victim].addr, p_addr, GAP_MAX_BD_ADDRESS_LEN);
+    s_ddsRpaCache[victim].devId = devId;
+    s_ddsRpaCache[victim].lastUse = ++s_ddsRpaCacheTick;
+}
+
+static void ble_dm_DdsIndexLoad(void)
+{
+    uint8_t devId;
+
+    (void)memset(s_ddsIndex, 0, sizeof(s_ddsIndex));
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if ((PDS_IsAbleToRestore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == false)
+            || (PDS_Restore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == false))
+        {
+            continue;
+        }
+
+        if (PDS_IsAbleToRestore(BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
+        {
+            if (PDS_Restore(BLE_DM_DDS_FILE_EXT_ITEM_START + devId) == false)
+            {
+                /* Same as a local address mismatch, the device can never be found */
+                continue;
+            }
+            s_ddsIndex[devId].localAddr = s_extPairedInfo.localAddr;
+            s_ddsIndex[devId].localAddrValid = true;
+        }
+
+        s_ddsIndex[devId].remoteAddr = s_mainPairedInfo.remoteAddr;
+        (void)memcpy(s_ddsIndex[devId].remoteIrk, s_mainPairedInfo.remoteIrk, 16);
+        s_ddsIndex[devId].valid = true;
+    }
+
+    ble_dm_DdsIndexRebuild();
+}
+
+static bool ble_dm_DdsIndexChkLocalAddr(uint8_t devId, BLE_GAP_Addr_T const *p_localAddr)
+{
+    if (s_ddsIndex[devId].localAddrValid == false)
+    {
+        return true;
+    }
+
+    return (memcmp(&s_ddsIndex[devId].localAddr, p_localAddr, sizeof(BLE_GAP_Addr_T)) == 0);
+}
 
 uint16_t BLE_DM_DdsGetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T * p_pairedDevInfo)
 {
@@ -235,6 +420,13 @@ uint16_t BLE_DM_DdsSetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T *p_pair
 
         if (PDS_Store(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
         {
+            s_ddsIndex[devId].remoteAddr = p_pairedDevInfo->remoteAddr;
+            s_ddsIndex[devId].localAddr = p_pairedDevInfo->localAddr;
+            (void)memcpy(s_ddsIndex[devId].remoteIrk, p_pairedDevInfo->remoteIrk, 16);
+            s_ddsIndex[devId].localAddrValid = true;
+            s_ddsIndex[devId].valid = true;
+            ble_dm_DdsIndexRebuild();
+
             return MBA_RES_SUCCESS;
         }
         else
@@ -254,7 +446,7 @@ uint8_t BLE_DM_DdsGetFreeDeviceId(void)
 
     for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
     {
-        if (!PDS_IsAbleToRestore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
+        if (s_ddsIndex[devId].valid == false)
         {
             break;
         }
@@ -263,9 +455,60 @@ uint8_t BLE_DM_DdsGetFreeDeviceId(void)
     return devId;
 }
 
+static uint8_t ble_dm_DdsLookupIdentityAddr(uint8_t const *p_addr, BLE_GAP_Addr_T const *p_localAddr)
+{
+    uint8_t devId, slot;
+
+    slot = ble_dm_DdsAddrHash(p_addr);
+    while (s_ddsAddrHash[slot] != BLE_DM_DDS_ADDR_HASH_EMPTY)
+    {
+        devId = s_ddsAddrHash[slot];
+        if ((memcmp(p_addr, s_ddsIndex[devId].remoteAddr.addr, GAP_MAX_BD_ADDRESS_LEN) == 0)
+            && ble_dm_DdsIndexChkLocalAddr(devId, p_localAddr))
+        {
+            return devId;
+        }
+        slot = (slot + 1U) & (BLE_DM_DDS_ADDR_HASH_SIZE - 1U);
+    }
+
+    return BLE_DM_MAX_PAIRED_DEVICE_NUM;
+}
+
+static uint8_t ble_dm_DdsResolveRpa(uint8_t const *p_addr, BLE_GAP_Addr_T const *p_localAddr)
+{
+    uint8_t devId, k;
+
+    if (memcmp(&s_ddsRpaCacheLocalAddr, p_localAddr, sizeof(BLE_GAP_Addr_T)) != 0)
+    {
+        (void)memset(s_ddsRpaCache, 0, sizeof(s_ddsRpaCache));
+        s_ddsRpaCacheLocalAddr = *p_localAddr;
+    }
+
+    if (ble_dm_DdsRpaCacheGet(p_addr, &devId))
+    {
+        return devId;
+    }
+
+    /* Same order as the flash scan: bonds of another local address are skipped before their IRK is tried */
+    devId = BLE_DM_MAX_PAIRED_DEVICE_NUM;
+    for (k = 0; k < s_ddsIrkCnt; k++)
+    {
+        if (ble_dm_DdsIndexChkLocalAddr(s_ddsIrkList[k], p_localAddr)
+            && ble_dm_DdsCheckResolveAddress(&s_ddsIrkCtx[k], p_addr))
+        {
+            devId = s_ddsIrkList[k];
+            break;
+        }
+    }
+
+    /* Misses are cached too, so unknown private devices are not resolved again */
+    ble_dm_DdsRpaCachePut(p_addr, devId);
+
+    return devId;
+}
+
 uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr)
 {
-    uint8_t devId;
     BLE_GAP_Addr_T addr;
     uint16_t result;
 
@@ -281,45 +524,13 @@ uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr)
     {
         return result;
     }
-    
-    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+
+    if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE)
     {
-        if (PDS_IsAbleToRestore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
-        {
-            if (PDS_Restore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
-            {
-                if (PDS_IsAbleToRestore(BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
-                {
-                    if (PDS_Restore(BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
-                    {
-                        if (memcmp(&s_extPairedInfo.localAddr, &addr, sizeof(addr)) != 0)
-                            continue;
-                    }
-                    else
-                    {
-                        continue;
-                    }
-                }
-
-                if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE)
-                {
-                    if (ble_dm_DdsCheckResolveAddress(s_mainPairedInfo.remoteIrk, p_bdAddr->addr)==true)
-                    {
-                        break;
-                    }
-                }
-                else
-                {
-                    if (memcmp(p_bdAddr->addr, s_mainPairedInfo.remoteAddr.addr, GAP_MAX_BD_ADDRESS_LEN) == 0)
-                    {
-                        break;
-                    }
-                }
-            }
-        }
+        return ble_dm_DdsResolveRpa(p_bdAddr->addr, &addr);
     }
 
-    return devId;
+    return ble_dm_DdsLookupIdentityAddr(p_bdAddr->addr, &addr);
 }
 
 uint16_t BLE_DM_DdsDeletePairedDevice(uint8_t devId)
@@ -331,6 +542,10 @@ uint16_t BLE_DM_DdsDeletePairedDevice(uint8_t devId)
 
     if (PDS_Delete(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == PDS_SUCCESS)
     {
+        /* The GATT cache belongs to the paired device */
+        (void)BLE_DM_DdsDeleteGattCache(devId);
+        (void)memset(&s_ddsIndex[devId], 0, sizeof(BLE_DM_DdsIndexEntry_T));
+        ble_dm_DdsIndexRebuild();
         return MBA_RES_SUCCESS;
     }
     else
@@ -347,16 +562,86 @@ uint16_t BLE_DM_DdsDeleteAllPairedDevice(void)
     {
         if (PDS_Delete(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) != PDS_SUCCESS)
 		{
+            ble_dm_DdsIndexRebuild();
             return MBA_RES_FAIL;
 		}
+        (void)BLE_DM_DdsDeleteGattCache(devId);
+        (void)memset(&s_ddsIndex[devId], 0, sizeof(BLE_DM_DdsIndexEntry_T));
     }
 
+    ble_dm_DdsIndexRebuild();
+
     return MBA_RES_SUCCESS;
 }
 
 bool BLE_DM_DdsChkDeviceId(uint8_t devId)
 {
-    return PDS_IsAbleToRestore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId);
+    if (devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM)
+    {
+        return false;
+    }
+
+    return s_ddsIndex[devId].valid;
+}
+
+uint16_t BLE_DM_DdsSetGattCache(uint8_t devId, uint8_t const *p_cache)
+{
+    if ((devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM) || (BLE_DM_DdsChkDeviceId(devId) == false))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    (void)memcpy(s_gattCacheInfo, p_cache, BLE_DM_GATT_CACHE_SIZE);
+
+    if (PDS_Store(BLE_DM_DDS_FILE_GATT_ITEM_START + devId))
+    {
+        return MBA_RES_SUCCESS;
+    }
+    else
+    {
+        return MBA_RES_FAIL;
+    }
+}
+
+uint16_t BLE_DM_DdsGetGattCache(uint8_t devId, uint8_t *p_cache)
+{
+    if (devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM
+        || PDS_IsAbleToRestore(BLE_DM_DDS_FILE_GATT_ITEM_START + devId) == false)
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    if (PDS_Restore(BLE_DM_DDS_FILE_GATT_ITEM_START + devId))
+    {
+        (void)memcpy(p_cache, s_gattCacheInfo, BLE_DM_GATT_CACHE_SIZE);
+        return MBA_RES_SUCCESS;
+    }
+    else
+    {
+        return MBA_RES_FAIL;
+    }
+}
+
+uint16_t BLE_DM_DdsDeleteGattCache(uint8_t devId)
+{
+    if (devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM)
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    if (PDS_IsAbleToRestore(BLE_DM_DDS_FILE_GATT_ITEM_START + devId) == false)
+    {
+        return MBA_RES_SUCCESS;
+    }
+
+    if (PDS_Delete(BLE_DM_DDS_FILE_GATT_ITEM_START + devId) == PDS_SUCCESS)
+    {
+        return MBA_RES_SUCCESS;
+    }
+    else
+    {
+        return MBA_RES_FAIL;
+    }
 }
 
 static void ble_dm_DdsWriteCompleteCallback(PDS_MemId_t memoryId)
@@ -374,4 +659,5 @@ void BLE_DM_DdsInit(BLE_DM_DdsWriteCompleteCb_T cb)
 {
     s_dmDdsCb=cb;
     PDS_RegisterWriteCompleteCallback(ble_dm_DdsWriteCompleteCallback);
+    ble_dm_DdsIndexLoad();
 }
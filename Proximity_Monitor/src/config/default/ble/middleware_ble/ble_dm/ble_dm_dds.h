@@ -74,6 +74,9 @@ uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr);
 uint16_t BLE_DM_DdsDeletePairedDevice(uint8_t devId);
 uint16_t BLE_DM_DdsDeleteAllPairedDevice(void);
 bool BLE_DM_DdsChkDeviceId(uint8_t devId);
+uint16_t BLE_DM_DdsSetGattCache(uint8_t devId, uint8_t const *p_cache);
+uint16_t BLE_DM_DdsGetGattCache(uint8_t devId, uint8_t *p_cache);
+uint16_t BLE_DM_DdsDeleteGattCache(uint8_t devId);
 void BLE_DM_DdsInit(BLE_DM_DdsWriteCompleteCb_T cb);
 
 #endif
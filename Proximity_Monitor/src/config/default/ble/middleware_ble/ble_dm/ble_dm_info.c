@@ -51,6 +51,7 @@
 #include "ble_dm_internal.h"
 #include "ble_dm_info.h"
 #include "ble_dm_dds.h"
+#include "ble_util/ble_conn_reg.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -76,39 +77,34 @@ static BLE_DM_InfoCtrl_T      *sp_dmInfoCtrl;
   Function
 **************************************************************************************************/
 
-static BLE_DM_InfoConn_T *ble_dm_InfoGetFreeConn(void)
+static BLE_DM_InfoConn_T *ble_dm_InfoGetFreeConn(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t i = BLE_CONN_REG_GetIndex(connHandle);
 
-    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    if ((i == BLE_CONN_REG_INDEX_INVALID) || (sp_dmInfoCtrl->conn[i] != NULL))
     {
-        if (sp_dmInfoCtrl->conn[i] == NULL)
-        {
-            sp_dmInfoCtrl->conn[i] = OSAL_Malloc(sizeof(BLE_DM_InfoConn_T));
+        return NULL;
+    }
 
-            if (sp_dmInfoCtrl->conn[i] != NULL)
-            {
-                (void)memset((uint8_t *)sp_dmInfoCtrl->conn[i], 0, sizeof(BLE_DM_InfoConn_T));
-            }
-            return sp_dmInfoCtrl->conn[i];
-        }
+    sp_dmInfoCtrl->conn[i] = OSAL_Malloc(sizeof(BLE_DM_InfoConn_T));
+
+    if (sp_dmInfoCtrl->conn[i] != NULL)
+    {
+        (void)memset((uint8_t *)sp_dmInfoCtrl->conn[i], 0, sizeof(BLE_DM_InfoConn_T));
     }
-    return NULL;
+    return sp_dmInfoCtrl->conn[i];
 }
 
 BLE_DM_InfoConn_T *BLE_DM_InfoGetConnByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t i = BLE_CONN_REG_GetIndex(connHandle);
 
-    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    if ((i == BLE_CONN_REG_INDEX_INVALID) || (sp_dmInfoCtrl->conn[i] == NULL)
+        || (sp_dmInfoCtrl->conn[i]->state != BLE_DM_INFO_STATE_CONNECTED))
     {
-        if ((sp_dmInfoCtrl->conn[i] != NULL) 
-            && (sp_dmInfoCtrl->conn[i]->state == BLE_DM_INFO_STATE_CONNECTED) && (sp_dmInfoCtrl->conn[i]->connHandle == connHandle))
-        {
-            return sp_dmInfoCtrl->conn[i];
-        }
+        return NULL;
     }
-    return NULL;
+    return sp_dmInfoCtrl->conn[i];
 }
 
 
@@ -175,7 +171,7 @@ void BLE_DM_Info(STACK_Event_T *p_stackEvent)
                 {
                     BLE_DM_Event_T          dmEvt;
 
-                    p_conn = ble_dm_InfoGetFreeConn();
+                    p_conn = ble_dm_InfoGetFreeConn(p_gapEvt->eventField.evtConnect.connHandle);
                     if (p_conn!= NULL)
                     {
                         p_conn->connHandle = p_gapEvt->eventField.evtConnect.connHandle;
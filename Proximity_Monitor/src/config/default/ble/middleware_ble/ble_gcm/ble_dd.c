@@ -50,6 +50,7 @@
 #include "mba_error_defs.h"
 #include "gatt.h"
 #include "ble_util/byte_stream.h"
+#include "ble_util/ble_conn_reg.h"
 #include "ble_dd.h"
 
 
@@ -79,6 +80,8 @@ typedef struct BLE_DD_DiscInstance_T
     uint16_t                svcStartHandle;                     /**< Internal used. Service start handle. */
     uint16_t                svcEndHandle;                       /**< Internal used. Service end handle. */
     bool                    isSvcFound;                         /**< Internal used. Service is found or not in primary service discovery step. */
+    uint16_t                svcFoundStart[BLE_DD_MAX_DISC_SVC_NUM]; /**< Internal used. Start handle of each registered service found by the primary service sweep. 0 if not found. */
+    uint16_t                svcFoundEnd[BLE_DD_MAX_DISC_SVC_NUM];   /**< Internal used. End handle of each registered service found by the primary service sweep. */
     uint8_t                 queuedReqByProtocol;                /**< Internal used. Queued request if ATT protocol is busy. */
     uint8_t                 queuedReqBySecurity;                /**< Internal used. Queued request if ATT is blocked by security. */
 } BLE_DD_DiscInstance_T;
@@ -94,6 +97,7 @@ typedef struct BLE_DD_Conn_T
     uint8_t                 discSvcIndex;                       /**< The index of service that the discovery is ongoing. */
     bool                    isDiscovering;                      /**< Internal used. Record if discovery is ongoing. */
     bool                    disableDiscovery;                   /**< Disable discovery of the connection. Application caches characteristic handles and no need to discover again. */
+    bool                    singlePassDisc;                     /**< Discover all registered services with one primary service sweep. See @ref BLE_DD_Config_T. */
     BLE_DD_State_T          state;                              /**< Connection state. */
 } BLE_DD_Conn_T;
 
@@ -120,58 +124,42 @@ static BLE_DD_Ctrl_T *             sp_ddCtrl;              /* DD module database
 // *****************************************************************************
 static void ble_dd_FreeConn(BLE_DD_Conn_T *p_conn)
 {
-    uint8_t i;
-
     if (p_conn->p_discInstance != NULL)
     {
         OSAL_Free(p_conn->p_discInstance);
     }
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
-    {
-        if (sp_ddCtrl->conn[i] == p_conn)
-        {
-            OSAL_Free(sp_ddCtrl->conn[i]);
-            sp_ddCtrl->conn[i] = NULL;
-        
-            break;
-        }
-    }
+    sp_ddCtrl->conn[p_conn->connIndex] = NULL;
+    OSAL_Free(p_conn);
 }
 
-static BLE_DD_Conn_T *ble_dd_GetFreeConn(void)
+static BLE_DD_Conn_T *ble_dd_GetFreeConn(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t i = BLE_CONN_REG_GetIndex(connHandle);
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    if ((i == BLE_CONN_REG_INDEX_INVALID) || (sp_ddCtrl->conn[i] != NULL))
     {
-        if (sp_ddCtrl->conn[i] == NULL)
-        {
-            sp_ddCtrl->conn[i] = OSAL_Malloc(sizeof(BLE_DD_Conn_T));
-            if (sp_ddCtrl->conn[i] != NULL)
-            {
-                (void)memset((uint8_t *)sp_ddCtrl->conn[i], 0, sizeof(BLE_DD_Conn_T));
-                sp_ddCtrl->conn[i]->connIndex = i;
-            }
-            return sp_ddCtrl->conn[i];
-        }
+        return NULL;
     }
-    return NULL;
+
+    sp_ddCtrl->conn[i] = OSAL_Malloc(sizeof(BLE_DD_Conn_T));
+    if (sp_ddCtrl->conn[i] != NULL)
+    {
+        (void)memset((uint8_t *)sp_ddCtrl->conn[i], 0, sizeof(BLE_DD_Conn_T));
+        sp_ddCtrl->conn[i]->connIndex = i;
+    }
+    return sp_ddCtrl->conn[i];
 }
 
 static BLE_DD_Conn_T *ble_dd_FindConnByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t i = BLE_CONN_REG_GetIndex(connHandle);
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    if (i == BLE_CONN_REG_INDEX_INVALID)
     {
-        if ((sp_ddCtrl->conn[i]!= NULL) && (sp_ddCtrl->conn[i]->connHandle == connHandle))
-        {
-            sp_ddCtrl->conn[i]->connIndex = i;
-            return sp_ddCtrl->conn[i];
-        }
+        return NULL;
     }
-    return NULL;
+    return sp_ddCtrl->conn[i];
 }
 
 static void ble_dd_SendDiscCompleteEvent(BLE_DD_Conn_T *p_conn)
@@ -186,10 +174,32 @@ static void ble_dd_SendDiscCompleteEvent(BLE_DD_Conn_T *p_conn)
     }
 }
 
+static void ble_dd_AllServicesDiscovery(BLE_DD_Conn_T *p_conn)
+{
+    uint8_t i;
+
+    for (i=0; i<sp_ddCtrl->numOfService; i++)
+    {
+        (void)memset((uint8_t *)sp_ddCtrl->services[i].p_charList[p_conn->connIndex].p_charInfo, 0, sizeof(BLE_DD_CharInfo_T)*sp_ddCtrl->services[i].discCharsNum);
+    }
+    (void)memset((uint8_t *)p_conn->p_discInstance, 0, sizeof(BLE_DD_DiscInstance_T));
+
+    if (GATTC_DiscoverAllPrimaryServices(p_conn->connHandle) == MBA_RES_BUSY)
+    {
+        p_conn->p_discInstance->queuedReqByProtocol = ATT_READ_BY_GROUP_TYPE_REQ;
+    }
+}
+
 static void ble_dd_ServiceDiscovery(BLE_DD_Conn_T *p_conn)
 {
     GATTC_DiscoverPrimaryServiceByUuidParams_T discParams;
 
+    if (p_conn->singlePassDisc)
+    {
+        ble_dd_AllServicesDiscovery(p_conn);
+        return;
+    }
+
     p_conn->p_charInfoList = sp_ddCtrl->services[p_conn->discSvcIndex].p_charList[p_conn->connIndex].p_charInfo;
     (void)memset((uint8_t *)p_conn->p_charInfoList, 0, sizeof(BLE_DD_CharInfo_T)*sp_ddCtrl->services[p_conn->discSvcIndex].discCharsNum);
     (void)memset((uint8_t *)p_conn->p_discInstance, 0, sizeof(BLE_DD_DiscInstance_T));
@@ -204,8 +214,61 @@ static void ble_dd_ServiceDiscovery(BLE_DD_Conn_T *p_conn)
     }
 }
 
+static void ble_dd_NextRangeDiscovery(BLE_DD_Conn_T *p_conn)
+{
+    BLE_DD_DiscInstance_T   *p_inst = p_conn->p_discInstance;
+    uint16_t                startHandle = 0, endHandle = 0;
+    bool                    isMerged;
+    uint8_t                 idx;
+
+    /* Pick the lowest found service above the range discovered last time. */
+    for (idx=0; idx<sp_ddCtrl->numOfService; idx++)
+    {
+        if ((p_inst->svcFoundStart[idx] > p_inst->svcEndHandle) && ((startHandle == 0U) || (p_inst->svcFoundStart[idx] < startHandle)))
+        {
+            startHandle = p_inst->svcFoundStart[idx];
+            endHandle = p_inst->svcFoundEnd[idx];
+        }
+    }
+
+    if (startHandle == 0U)
+    {
+        p_conn->isDiscovering = false;
+        ble_dd_SendDiscCompleteEvent(p_conn);
+        return;
+    }
+
+    /* Merge the found services which are contiguous in the remote database into one range. */
+    do
+    {
+        isMerged = false;
+        for (idx=0; idx<sp_ddCtrl->numOfService; idx++)
+        {
+            if ((p_inst->svcFoundStart[idx] > startHandle) && ((uint32_t)p_inst->svcFoundStart[idx] <= ((uint32_t)endHandle + 1U))
+                && (p_inst->svcFoundEnd[idx] > endHandle))
+            {
+                endHandle = p_inst->svcFoundEnd[idx];
+                isMerged = true;
+            }
+        }
+    } while (isMerged);
+
+    p_inst->svcStartHandle = startHandle;
+    p_inst->svcEndHandle = endHandle;
+    if (GATTC_DiscoverAllCharacteristics(p_conn->connHandle, startHandle, endHandle) == MBA_RES_BUSY)
+    {
+        p_inst->queuedReqByProtocol = ATT_READ_BY_TYPE_REQ;
+    }
+}
+
 static void ble_dd_NextServiceDiscovery(BLE_DD_Conn_T *p_conn)
 {
+    if (p_conn->singlePassDisc)
+    {
+        ble_dd_NextRangeDiscovery(p_conn);
+        return;
+    }
+
     p_conn->discSvcIndex++;
     if (p_conn->discSvcIndex < sp_ddCtrl->numOfService)
     {
@@ -218,38 +281,128 @@ static void ble_dd_NextServiceDiscovery(BLE_DD_Conn_T *p_conn)
     }
 }
 
-static uint16_t ble_dd_DescriptorDiscovery(BLE_DD_Conn_T *p_conn)
+static bool ble_dd_IsDescriptorRequired(uint8_t svcIndex)
 {
     BLE_DD_DiscChar_T   **p_discChar;
-    uint16_t            result = MBA_RES_SUCCESS;
     uint8_t             idx;
 
-    p_discChar = sp_ddCtrl->services[p_conn->discSvcIndex].p_discChars;
+    p_discChar = sp_ddCtrl->services[svcIndex].p_discChars;
 
-    for (idx=0; idx<sp_ddCtrl->services[p_conn->discSvcIndex].discCharsNum; idx++, p_discChar++)
+    for (idx=0; idx<sp_ddCtrl->services[svcIndex].discCharsNum; idx++, p_discChar++)
     {
-        /* Check if there's descriptor to discover */
         if (((*p_discChar)->settings & CHAR_SET_DESCRIPTOR)!= 0U)
         {
-            if (GATTC_DiscoverAllDescriptors(p_conn->connHandle, p_conn->p_discInstance->svcStartHandle , p_conn->p_discInstance->svcEndHandle) == MBA_RES_BUSY)
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint16_t ble_dd_DescriptorDiscovery(BLE_DD_Conn_T *p_conn)
+{
+    BLE_DD_DiscInstance_T   *p_inst = p_conn->p_discInstance;
+    bool                    isRequired = false;
+    uint8_t                 idx;
+
+    if (p_conn->singlePassDisc)
+    {
+        /* One descriptor discovery covers all the services merged into the current range. */
+        for (idx=0; idx<sp_ddCtrl->numOfService; idx++)
+        {
+            if ((p_inst->svcFoundStart[idx] >= p_inst->svcStartHandle) && (p_inst->svcFoundStart[idx] <= p_inst->svcEndHandle)
+                && ble_dd_IsDescriptorRequired(idx))
             {
-                p_conn->p_discInstance->queuedReqByProtocol = ATT_FIND_INFORMATION_REQ;
+                isRequired = true;
+                break;
             }
-            result = MBA_RES_FAIL;
-            break;
         }
     }
+    else
+    {
+        isRequired = ble_dd_IsDescriptorRequired(p_conn->discSvcIndex);
+    }
+
+    /* Check if there's descriptor to discover */
+    if (isRequired == false)
+    {
+        return MBA_RES_SUCCESS;
+    }
+
+    if (GATTC_DiscoverAllDescriptors(p_conn->connHandle, p_inst->svcStartHandle , p_inst->svcEndHandle) == MBA_RES_BUSY)
+    {
+        p_inst->queuedReqByProtocol = ATT_FIND_INFORMATION_REQ;
+    }
 
-    return result;
+    return MBA_RES_FAIL;
 }
 
-static void ble_dd_ProcCharDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event)
+static uint8_t ble_dd_FindSvcByHandle(BLE_DD_Conn_T *p_conn, uint16_t handle)
+{
+    uint8_t idx;
+
+    if (p_conn->singlePassDisc == false)
+    {
+        return p_conn->discSvcIndex;
+    }
+
+    for (idx=0; idx<sp_ddCtrl->numOfService; idx++)
+    {
+        if ((p_conn->p_discInstance->svcFoundStart[idx] != 0U) && (handle > p_conn->p_discInstance->svcFoundStart[idx])
+            && (handle <= p_conn->p_discInstance->svcFoundEnd[idx]))
+        {
+            return idx;
+        }
+    }
+
+    return BLE_DD_MAX_DISC_SVC_NUM;
+}
+
+static void ble_dd_ProcSvcDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event)
 {
-    BLE_DD_DiscChar_T   **p_discChar;
     uint16_t            procIdx = 0;
     uint8_t             uuidLength, idx;
     uint8_t             *p_uuid;
 
+    /* Each tuple is <start handle> <end group handle> <service UUID>. */
+    if (p_event->eventField.onDiscPrimServResp.attrPairLength <= 4U)
+    {
+        return;
+    }
+    uuidLength = p_event->eventField.onDiscPrimServResp.attrPairLength - 4U;
+
+    while (procIdx < p_event->eventField.onDiscPrimServResp.attrDataLength)
+    {
+        p_uuid = &p_event->eventField.onDiscPrimServResp.attrData[procIdx+4U];
+
+        for (idx=0; idx<sp_ddCtrl->numOfService; idx++)
+        {
+            if ((p_conn->p_discInstance->svcFoundStart[idx] == 0U) && (sp_ddCtrl->services[idx].svcUuid.uuidLength == uuidLength)
+                && (memcmp(sp_ddCtrl->services[idx].svcUuid.uuid, p_uuid, uuidLength) == 0))
+            {
+                /* Registered service found, record handle range. */
+                BUF_LE_TO_U16(&p_conn->p_discInstance->svcFoundStart[idx], &p_event->eventField.onDiscPrimServResp.attrData[procIdx]);
+                BUF_LE_TO_U16(&p_conn->p_discInstance->svcFoundEnd[idx], &p_event->eventField.onDiscPrimServResp.attrData[procIdx+2U]);
+                if (sp_ddCtrl->services[idx].p_discInfo != NULL)
+                {
+                    sp_ddCtrl->services[idx].p_discInfo->svcStartHandle = p_conn->p_discInstance->svcFoundStart[idx];
+                    sp_ddCtrl->services[idx].p_discInfo->svcEndHandle = p_conn->p_discInstance->svcFoundEnd[idx];
+                }
+                p_conn->p_discInstance->isSvcFound = true;
+            }
+        }
+        procIdx += p_event->eventField.onDiscPrimServResp.attrPairLength;
+    }
+}
+
+static void ble_dd_ProcCharDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event)
+{
+    BLE_DD_DiscChar_T   **p_discChar;
+    BLE_DD_CharInfo_T   *p_charInfo;
+    uint16_t            procIdx = 0, attrHandle;
+    uint8_t             uuidLength, idx, svcIdx;
+    uint8_t             *p_uuid;
+
     /* ATT has error checking. There should be only these 2 cases. */
     if (p_event->eventField.onDiscCharResp.attrPairLength == DISC_CHAR_UUID16_RSP_LENGTH)
     {
@@ -264,18 +417,28 @@ static void ble_dd_ProcCharDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event
     while (procIdx < p_event->eventField.onDiscCharResp.attrDataLength)
     {
         p_uuid = &p_event->eventField.onDiscCharResp.attrData[procIdx+5U];
+        BUF_LE_TO_U16(&attrHandle, &p_event->eventField.onDiscCharResp.attrData[procIdx]);
+
+        /* Find the service which the characteristic declaration belongs to. */
+        svcIdx = ble_dd_FindSvcByHandle(p_conn, attrHandle);
+        if (svcIdx >= sp_ddCtrl->numOfService)
+        {
+            procIdx += p_event->eventField.onDiscCharResp.attrPairLength;
+            continue;
+        }
+        p_charInfo = sp_ddCtrl->services[svcIdx].p_charList[p_conn->connIndex].p_charInfo;
 
         /* Process each discover characteristic with each characteristic declaration */
-        for (idx=0, p_discChar = sp_ddCtrl->services[p_conn->discSvcIndex].p_discChars; idx<sp_ddCtrl->services[p_conn->discSvcIndex].discCharsNum; idx++, p_discChar++)
+        for (idx=0, p_discChar = sp_ddCtrl->services[svcIdx].p_discChars; idx<sp_ddCtrl->services[svcIdx].discCharsNum; idx++, p_discChar++)
         {
             if (((*p_discChar)->settings & CHAR_SET_DESCRIPTOR) == 0U)
             {
                 if (((*p_discChar)->p_uuid->uuidLength == uuidLength) && (memcmp((*p_discChar)->p_uuid->uuid, p_uuid, uuidLength) == 0))
                 {
-                    BUF_LE_TO_U16(&p_conn->p_charInfoList[idx].attrHandle, &p_event->eventField.onDiscCharResp.attrData[procIdx]);
+                    p_charInfo[idx].attrHandle = attrHandle;
                     /* Characteristic found, record handle. */
-                    BUF_LE_TO_U16(&p_conn->p_charInfoList[idx].charHandle, &p_event->eventField.onDiscCharResp.attrData[procIdx+3U]);
-                    p_conn->p_charInfoList[idx].property = p_event->eventField.onDiscCharResp.attrData[procIdx+2U];
+                    BUF_LE_TO_U16(&p_charInfo[idx].charHandle, &p_event->eventField.onDiscCharResp.attrData[procIdx+3U]);
+                    p_charInfo[idx].property = p_event->eventField.onDiscCharResp.attrData[procIdx+2U];
                 }
             }
         }
@@ -286,8 +449,9 @@ static void ble_dd_ProcCharDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event
 static void ble_dd_ProcDescDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event)
 {
     BLE_DD_DiscChar_T   **p_discChar;
-    uint16_t            procIdx = 0;
-    uint8_t             uuidLength, idx;
+    BLE_DD_CharInfo_T   *p_charInfo;
+    uint16_t            procIdx = 0, descHandle;
+    uint8_t             uuidLength, idx, svcIdx;
     uint8_t             *p_uuid;
 
     /* GATT has filtering. The format of information data should only be 0x01 (16-bit UUID). */
@@ -297,16 +461,26 @@ static void ble_dd_ProcDescDiscResp(BLE_DD_Conn_T *p_conn, GATT_Event_T *p_event
     while (procIdx < p_event->eventField.onDiscDescResp.infoDataLength)
     {
         p_uuid = &p_event->eventField.onDiscDescResp.infoData[procIdx+2U];
+        BUF_LE_TO_U16(&descHandle, &p_event->eventField.onDiscDescResp.infoData[procIdx]);
+
+        /* Find the service which the descriptor belongs to. */
+        svcIdx = ble_dd_FindSvcByHandle(p_conn, descHandle);
+        if (svcIdx >= sp_ddCtrl->numOfService)
+        {
+            procIdx += (2+uuidLength);
+            continue;
+        }
+        p_charInfo = sp_ddCtrl->services[svcIdx].p_charList[p_conn->connIndex].p_charInfo;
 
         /* Process each discover characteristic with each characteristic declaration */
-        for (idx=0, p_discChar = sp_ddCtrl->services[p_conn->discSvcIndex].p_discChars; idx<sp_ddCtrl->services[p_conn->discSvcIndex].discCharsNum; idx++, p_discChar++)
+        for (idx=0, p_discChar = sp_ddCtrl->services[svcIdx].p_discChars; idx<sp_ddCtrl->services[svcIdx].discCharsNum; idx++, p_discChar++)
         {
-            if ((((*p_discChar)->settings & CHAR_SET_DESCRIPTOR) != 0U) && (p_conn->p_charInfoList[idx].charHandle == 0U))
+            if ((((*p_discChar)->settings & CHAR_SET_DESCRIPTOR) != 0U) && (p_charInfo[idx].charHandle == 0U))
             {
                 if (((*p_discChar)->p_uuid->uuidLength == uuidLength) && (memcmp((*p_discChar)->p_uuid->uuid, p_uuid, uuidLength) == 0))
                 {
                     /* Characteristic descriptor found, record handle. */
-                    BUF_LE_TO_U16(&p_conn->p_charInfoList[idx].charHandle, &p_event->eventField.onDiscDescResp.infoData[procIdx]);
+                    p_charInfo[idx].charHandle = descHandle;
                     break;
                 }
             }
@@ -327,7 +501,7 @@ static void ble_dd_StackEvtBleGapHandler(BLE_DD_Config_T *p_config, BLE_GAP_Even
                 uint8_t         i;
 
                 /* Find free connection instance */
-                p_conn = ble_dd_GetFreeConn();
+                p_conn = ble_dd_GetFreeConn(p_event->eventField.evtConnect.connHandle);
 
                 if (p_conn != NULL)
                 {
@@ -336,6 +510,7 @@ static void ble_dd_StackEvtBleGapHandler(BLE_DD_Config_T *p_config, BLE_GAP_Even
                     p_conn->connHandle = p_event->eventField.evtConnect.connHandle;
                     p_conn->discSvcIndex = 0;
                     p_conn->gapRole = p_event->eventField.evtConnect.role;
+                    p_conn->singlePassDisc = (p_config->singlePassDisc != 0U);
                     p_conn->p_discInstance = OSAL_Malloc(sizeof(BLE_DD_DiscInstance_T));
 
                     for (i=0; i<sp_ddCtrl->numOfService; i++)
@@ -405,7 +580,7 @@ static void ble_dd_StackEvtBleGapHandler(BLE_DD_Config_T *p_config, BLE_GAP_Even
                 {
                     if ((p_conn->p_discInstance != NULL) && (p_conn->p_discInstance->queuedReqBySecurity))
                     {
-                        if (p_conn->p_discInstance->queuedReqBySecurity == ATT_FIND_BY_TYPE_VALUE_REQ)
+                        if ((p_conn->p_discInstance->queuedReqBySecurity == ATT_FIND_BY_TYPE_VALUE_REQ) || (p_conn->p_discInstance->queuedReqBySecurity == ATT_READ_BY_GROUP_TYPE_REQ))
                         {
                             ble_dd_ServiceDiscovery(p_conn);
                         }
@@ -484,7 +659,12 @@ static void ble_dd_StackEvtBleGattcHandler(GATT_Event_T *p_event)
                     return;
                 }
 
-                if (p_event->eventField.onError.reqOpcode == ATT_FIND_BY_TYPE_VALUE_REQ)
+                if (p_event->eventField.onError.reqOpcode == ATT_READ_BY_GROUP_TYPE_REQ)
+                {
+                    /* Primary service sweep finished. Discover the found services range by range. */
+                    ble_dd_NextRangeDiscovery(p_conn);
+                }
+                else if (p_event->eventField.onError.reqOpcode == ATT_FIND_BY_TYPE_VALUE_REQ)
                 {
                     if (p_conn->p_discInstance->isSvcFound==true)
                     {
@@ -527,6 +707,28 @@ static void ble_dd_StackEvtBleGattcHandler(GATT_Event_T *p_event)
         }
         break;
 
+        case GATTC_EVT_DISC_PRIM_SERV_RESP:
+        {
+            BLE_DD_Conn_T *p_conn;
+
+            p_conn = ble_dd_FindConnByHandle(p_event->eventField.onDiscPrimServResp.connHandle);
+
+            /* Ignore responses when dd is not discovering */
+            if ((p_conn == NULL) || (p_conn->isDiscovering == false) || (p_conn->singlePassDisc == false))
+            {
+                return;
+            }
+
+            ble_dd_ProcSvcDiscResp(p_conn, p_event);
+
+            if (p_event->eventField.onDiscPrimServResp.procedureStatus == GATT_PROCEDURE_STATUS_FINISH)
+            {
+                /* Primary service sweep finished. Discover the found services range by range. */
+                ble_dd_NextRangeDiscovery(p_conn);
+            }
+        }
+        break;
+
         case GATTC_EVT_DISC_PRIM_SERV_BY_UUID_RESP:
         {
             BLE_DD_Conn_T *p_conn;
@@ -639,7 +841,7 @@ static void ble_dd_StackEvtBleGattcHandler(GATT_Event_T *p_event)
 
             if (p_conn != NULL)
             {
-                if (p_conn->p_discInstance->queuedReqByProtocol == ATT_FIND_BY_TYPE_VALUE_REQ)
+                if ((p_conn->p_discInstance->queuedReqByProtocol == ATT_FIND_BY_TYPE_VALUE_REQ) || (p_conn->p_discInstance->queuedReqByProtocol == ATT_READ_BY_GROUP_TYPE_REQ))
                 {
                     p_conn->p_discInstance->queuedReqByProtocol = 0;
                     ble_dd_ServiceDiscovery(p_conn);
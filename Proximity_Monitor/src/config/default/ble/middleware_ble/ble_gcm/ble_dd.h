@@ -61,6 +61,7 @@
 #include "stack_mgr.h"
 #include "att_uuid.h"
 #include "ble_gap.h"
+#include "gatt.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -93,6 +94,18 @@ extern "C" {
 /** @} */
 
 
+/**@defgroup BLE_DD_EVT_MASK Consumed stack events
+ * @brief The definition of the stack events handled by @ref BLE_DD_BleEventHandler, one bit per event ID of each group.
+ *        The stack event dispatcher of the application directs only these events to BLE_DD.
+ * @{ */
+#define BLE_DD_GAP_EVT_MASK                         ((1UL << BLE_GAP_EVT_CONNECTED) | (1UL << BLE_GAP_EVT_DISCONNECTED) \
+                                                    | (1UL << BLE_GAP_EVT_ENCRYPT_STATUS))                                  /**< BLE GAP events. */
+#define BLE_DD_GATT_EVT_MASK                        ((1UL << GATTC_EVT_ERROR_RESP) | (1UL << GATTC_EVT_DISC_PRIM_SERV_RESP) \
+                                                    | (1UL << GATTC_EVT_DISC_PRIM_SERV_BY_UUID_RESP) | (1UL << GATTC_EVT_DISC_CHAR_RESP) | (1UL << GATTC_EVT_DISC_DESC_RESP) \
+                                                    | (1UL << GATTC_EVT_PROTOCOL_AVAILABLE))                                /**< GATT events. */
+/** @} */
+
+
 /**@} */ //BLE_DD_DEFINES
 
 /**@addtogroup BLE_DD_ENUMS Enumerations
@@ -124,7 +137,8 @@ typedef struct BLE_DD_Config_T
     uint8_t                 initDiscInCentral:1;    /**< Configure discovery option when the gap role of connection is central. Set true to enable. */
     uint8_t                 initDiscInPeripheral:1; /**< Configure discovery option when the gap role of connection is peripheral. Set true to enable. */
     uint8_t                 disableConnectedDisc:1; /**< Configure discovery function when connection established. Discovery might be optional for bonded link. Note: This is one-time option. Disable unnecessary discovery when connected at each time. */
-    uint8_t                 reserved:4;             /**< Reserved for future used. */
+    uint8_t                 singlePassDisc:1;       /**< Configure discovery mode. Set true to find all registered services with one primary service sweep and discover characteristics/descriptors over merged handle ranges. Set false to discover the registered services one by one. */
+    uint8_t                 reserved:3;             /**< Reserved for future used. */
 } BLE_DD_Config_T;
 
 /**@brief Characteristic information. */
@@ -73,6 +73,10 @@
 #define HCI_ACL_PKT_PARAMETER_LENGTH_SIZE   0x02U                                            /**< Size of length parameter in HCI ACL packet. */
 /** @} */
 
+/**@brief Size of the log packet buffer. Fits the largest HCI command (3 + 255), HCI event (2 + 255) and
+ *        HCI ACL packet (4 + 251) the stack reports. */
+#define BLE_LOG_PACKET_BUF_SIZE             260U
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Data Types
@@ -182,6 +186,9 @@ static void ble_log_PackAuthenticatedPayloadTimeoutExpired(BT_SYS_LogEvent_T *p_
 // *****************************************************************************
 static BLE_LOG_EventCb_T                 s_logEventCb = NULL;
 
+/* Every log packet is encoded here and handed to s_logEventCb synchronously, so one buffer is enough */
+static uint32_t                          s_logPacketBuf[(BLE_LOG_PACKET_BUF_SIZE + 3U) / 4U];
+
 static const _BLE_LOG_FunTbl_T  s_hciCmdFun[] =
 {
     NULL,   // (0x00)
@@ -520,6 +527,16 @@ static const uint8_t s_hciLeMetaEvtSize[] =
 // *****************************************************************************
 // *****************************************************************************
 
+static uint8_t *ble_log_GetPacketBuffer(uint16_t logLength)
+{
+    if (logLength > BLE_LOG_PACKET_BUF_SIZE)
+    {
+        return NULL;
+    }
+
+    return (uint8_t *)s_logPacketBuf;
+}
+
 static void ble_log_Print(uint8_t logType, uint16_t logLength, uint8_t *p_logPacket)
 {
     if (s_logEventCb != NULL)
@@ -543,7 +560,7 @@ static void ble_log_GenerateHciCommandComplete(uint16_t logId, uint8_t result, u
     logLength = (HCI_EVENT_CODE_SIZE+HCI_EVENT_PARAMETER_LENGTH_SIZE+
                 HCI_EVENT_CC_PARAMETER_NUMBER_SIZE+HCI_EVENT_CC_PARAMETER_OPCODE_SIZE+
                 paramsLength);
-    p_logPacket = OSAL_Malloc(logLength);
+    p_logPacket = ble_log_GetPacketBuffer(logLength);
 
     if (p_logPacket == NULL)
     {
@@ -651,7 +668,6 @@ static void ble_log_GenerateHciCommandComplete(uint16_t logId, uint8_t result, u
     }
 
     ble_log_Print(BLE_LOG_TYPE_HCI_EVENT, logLength, p_logPacket);
-    OSAL_Free(p_logPacket);
 }
 
 static void ble_log_GenerateHciCommandStatus(uint16_t logId, uint8_t result)
@@ -664,7 +680,7 @@ static void ble_log_GenerateHciCommandStatus(uint16_t logId, uint8_t result)
 
     logLength = (HCI_EVENT_CODE_SIZE+HCI_EVENT_PARAMETER_LENGTH_SIZE+
                 HCI_EVENT_CS_PARAMETER_STATUS_SIZE+HCI_EVENT_CS_PARAMETER_NUMBER_SIZE+HCI_EVENT_CS_PARAMETER_OPCODE_SIZE);
-    p_logPacket = OSAL_Malloc(logLength);
+    p_logPacket = ble_log_GetPacketBuffer(logLength);
 
     if (p_logPacket == NULL)
     {
@@ -681,7 +697,6 @@ static void ble_log_GenerateHciCommandStatus(uint16_t logId, uint8_t result)
     U8_TO_STREAM(&p_buf, numberOfHciPacket);
     U16_TO_STREAM_LE(&p_buf, logId);
     ble_log_Print(BLE_LOG_TYPE_HCI_EVENT, logLength, p_logPacket);
-    OSAL_Free(p_logPacket);
 }
 
 static void ble_log_PackDisconnect(BT_SYS_LogEvent_T *p_log, uint8_t *p_logPacket, uint16_t logLength)
@@ -1557,7 +1572,7 @@ static void ble_log_ProcHciCommand(BT_SYS_LogEvent_T *p_log)
 
     /* Calculate log length */
     logLength = HCI_COMMAND_OPCODE_SIZE+HCI_COMMAND_PARAMETER_LENGTH_SIZE+cmdParamsSize;
-    p_logPacket = OSAL_Malloc(logLength);
+    p_logPacket = ble_log_GetPacketBuffer(logLength);
 
     if (p_logPacket == NULL)
     {
@@ -1570,7 +1585,6 @@ static void ble_log_ProcHciCommand(BT_SYS_LogEvent_T *p_log)
 
     /* Generate HCI event log */
     ble_log_GenerateHciCommand(p_log, p_logPacket, logLength, ogf, ocf);
-    OSAL_Free(p_logPacket);
 }
 
 static void ble_log_PackDiscComplete(BT_SYS_LogEvent_T *p_log, uint8_t *p_logPacket, uint16_t logLength)
@@ -1969,7 +1983,7 @@ static void ble_log_ProcHciEvent(BT_SYS_LogEvent_T *p_log)
 
     /* Calculate log length */
     logLength = HCI_EVENT_CODE_SIZE+HCI_EVENT_PARAMETER_LENGTH_SIZE+evtParamsSize;
-    p_logPacket = OSAL_Malloc(logLength);
+    p_logPacket = ble_log_GetPacketBuffer(logLength);
 
     if (p_logPacket == NULL)
     {
@@ -1995,7 +2009,6 @@ static void ble_log_ProcHciEvent(BT_SYS_LogEvent_T *p_log)
         ble_log_GenerateHciEvent(p_log, p_logPacket, logLength, evtCode);
     }
 
-    OSAL_Free(p_logPacket);
 }
 
 //void ble_log_ProcHciAcl(BLE_Log_T *p_log)
@@ -2006,7 +2019,7 @@ static void ble_log_ProcHciAcl(BT_SYS_LogEvent_T *p_log)
     uint16_t logLength;
 
     logLength = HCI_ACL_HEADER_SIZE+HCI_ACL_PKT_PARAMETER_LENGTH_SIZE+p_log->payloadLength;
-    p_logPacket = OSAL_Malloc(logLength);
+    p_logPacket = ble_log_GetPacketBuffer(logLength);
 
     if (p_logPacket == NULL)
     {
@@ -2026,7 +2039,6 @@ static void ble_log_ProcHciAcl(BT_SYS_LogEvent_T *p_log)
         ble_log_Print(BLE_LOG_TYPE_HCI_ACL_RX, logLength, p_logPacket);
     }
 
-    OSAL_Free(p_logPacket);
 }
 
 //void BLE_LOG_StackLogHandler(BLE_Log_T *p_log)
@@ -0,0 +1,192 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  BLE Connection Registry Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    ble_conn_reg.c
+
+  Summary:
+    This file contains the BLE connection registry functions for the middleware and profiles.
+
+  Description:
+    This file contains the BLE connection registry functions for the middleware and profiles.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "ble_gap.h"
+#include "ble_util/ble_conn_reg.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define BLE_CONN_REG_BUCKET_NUM             (8U)        /* Hash buckets, a power of 2 not less than BLE_GAP_MAX_LINK_NBR. */
+#define BLE_CONN_REG_BUCKET(connHandle)     ((connHandle) & (BLE_CONN_REG_BUCKET_NUM - 1U))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static uint16_t     s_connRegHandle[BLE_GAP_MAX_LINK_NBR];          /* Connection handle of each index. */
+static uint8_t      s_connRegNext[BLE_GAP_MAX_LINK_NBR];            /* Next index in the same bucket. */
+static uint8_t      s_connRegBucket[BLE_CONN_REG_BUCKET_NUM];       /* First index of each bucket. */
+static uint8_t      s_connRegInUse;                                 /* Bit mask of the indexes in use. */
+static uint16_t     s_connRegLastHandle;                            /* Last resolved handle, every module resolves the same one for an event. */
+static uint8_t      s_connRegLastIndex;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void ble_conn_reg_Add(uint16_t connHandle)
+{
+    uint8_t *p_bucket = &s_connRegBucket[BLE_CONN_REG_BUCKET(connHandle)];
+    uint8_t index;
+
+    if (BLE_CONN_REG_GetIndex(connHandle) != BLE_CONN_REG_INDEX_INVALID)
+    {
+        return;
+    }
+
+    for (index = 0; index < BLE_GAP_MAX_LINK_NBR; index++)
+    {
+        if ((s_connRegInUse & (1U << index)) == 0U)
+        {
+            break;
+        }
+    }
+
+    if (index == BLE_GAP_MAX_LINK_NBR)
+    {
+        return;
+    }
+
+    s_connRegInUse |= (uint8_t)(1U << index);
+    s_connRegHandle[index] = connHandle;
+    s_connRegNext[index] = *p_bucket;
+    *p_bucket = index;
+}
+
+static void ble_conn_reg_Remove(uint8_t index)
+{
+    uint8_t *p_link = &s_connRegBucket[BLE_CONN_REG_BUCKET(s_connRegHandle[index])];
+
+    while (*p_link != BLE_CONN_REG_INDEX_INVALID)
+    {
+        if (*p_link == index)
+        {
+            *p_link = s_connRegNext[index];
+            break;
+        }
+        p_link = &s_connRegNext[*p_link];
+    }
+
+    s_connRegInUse &= (uint8_t)~(1U << index);
+    if (s_connRegLastIndex == index)
+    {
+        s_connRegLastIndex = BLE_CONN_REG_INDEX_INVALID;
+    }
+}
+
+void BLE_CONN_REG_Init(void)
+{
+    memset(s_connRegBucket, BLE_CONN_REG_INDEX_INVALID, sizeof(s_connRegBucket));
+    s_connRegInUse = 0;
+    s_connRegLastIndex = BLE_CONN_REG_INDEX_INVALID;
+}
+
+void BLE_CONN_REG_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    BLE_GAP_Event_T *p_gapEvt;
+
+    if (p_stackEvent->groupId != STACK_GRP_BLE_GAP)
+    {
+        return;
+    }
+
+    p_gapEvt = (BLE_GAP_Event_T *)p_stackEvent->p_event;
+
+    if ((p_gapEvt->eventId == BLE_GAP_EVT_CONNECTED) && (p_gapEvt->eventField.evtConnect.status == GAP_STATUS_SUCCESS))
+    {
+        ble_conn_reg_Add(p_gapEvt->eventField.evtConnect.connHandle);
+    }
+}
+
+void BLE_CONN_REG_BleReleaseHandler(STACK_Event_T *p_stackEvent)
+{
+    BLE_GAP_Event_T *p_gapEvt;
+    uint8_t index;
+
+    if (p_stackEvent->groupId != STACK_GRP_BLE_GAP)
+    {
+        return;
+    }
+
+    p_gapEvt = (BLE_GAP_Event_T *)p_stackEvent->p_event;
+
+    //Every module has handled the disconnection by now
+    if (p_gapEvt->eventId == BLE_GAP_EVT_DISCONNECTED)
+    {
+        index = BLE_CONN_REG_GetIndex(p_gapEvt->eventField.evtDisconnect.connHandle);
+        if (index != BLE_CONN_REG_INDEX_INVALID)
+        {
+            ble_conn_reg_Remove(index);
+        }
+    }
+}
+
+uint8_t BLE_CONN_REG_GetIndex(uint16_t connHandle)
+{
+    uint8_t index;
+
+    if ((s_connRegLastIndex != BLE_CONN_REG_INDEX_INVALID) && (s_connRegLastHandle == connHandle))
+    {
+        return s_connRegLastIndex;
+    }
+
+    for (index = s_connRegBucket[BLE_CONN_REG_BUCKET(connHandle)]; index != BLE_CONN_REG_INDEX_INVALID; index = s_connRegNext[index])
+    {
+        if (s_connRegHandle[index] == connHandle)
+        {
+            s_connRegLastHandle = connHandle;
+            s_connRegLastIndex = index;
+            return index;
+        }
+    }
+
+    return BLE_CONN_REG_INDEX_INVALID;
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  BLE Connection Registry Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    ble_conn_reg.h
+
+  Summary:
+    This file contains the BLE connection registry functions for the middleware and profiles.
+
+  Description:
+    The registry maps a connection handle to a dense connection index once,
+    on BLE_GAP_EVT_CONNECTED. Middleware and profiles keep their per
+    connection state in arrays of BLE_GAP_MAX_LINK_NBR entries indexed by it
+    instead of each searching a connection table of its own.
+ *******************************************************************************/
+
+
+/**
+ * @addtogroup BLE_CONN_REG
+ * @{
+ * @brief Header file for the BLE connection registry.
+ */
+
+#ifndef BLE_CONN_REG_H
+#define BLE_CONN_REG_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include "stack_mgr.h"
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@addtogroup BLE_CONN_REG_DEFINES Defines
+ * @{ */
+#define BLE_CONN_REG_INDEX_INVALID          (0xFFU)     /**< Connection handle is not registered. */
+
+/**@brief BLE GAP events handled by @ref BLE_CONN_REG_BleEventHandler, one bit per event ID. */
+#define BLE_CONN_REG_GAP_EVT_MASK           (1UL << BLE_GAP_EVT_CONNECTED)
+
+/**@brief BLE GAP events handled by @ref BLE_CONN_REG_BleReleaseHandler, one bit per event ID. */
+#define BLE_CONN_REG_RELEASE_GAP_EVT_MASK   (1UL << BLE_GAP_EVT_DISCONNECTED)
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@addtogroup BLE_CONN_REG_FUNS Functions
+ * @{ */
+
+/**@brief Initialize the connection registry.
+ */
+void BLE_CONN_REG_Init(void);
+
+/**@brief Handle BLE_Stack related events, registers new connections.
+ *        This API must be called for the events of @ref BLE_CONN_REG_GAP_EVT_MASK before they are directed to the BLE middleware and profiles.
+ *
+ * @param[in] p_stackEvent          Pointer to BLE stack event data.
+ */
+void BLE_CONN_REG_BleEventHandler(STACK_Event_T *p_stackEvent);
+
+/**@brief Handle BLE_Stack related events, releases the index of a terminated connection.
+ *        This API must be called for the events of @ref BLE_CONN_REG_RELEASE_GAP_EVT_MASK after they are directed to the BLE middleware and profiles,
+ *        so that every module can still resolve the connection while handling its @ref BLE_GAP_EVT_DISCONNECTED.
+ *
+ * @param[in] p_stackEvent          Pointer to BLE stack event data.
+ */
+void BLE_CONN_REG_BleReleaseHandler(STACK_Event_T *p_stackEvent);
+
+/**@brief Get the connection index of a connection handle.
+ *
+ * @param[in] connHandle            Handle of the connection.
+ *
+ * @retval The connection index, less than BLE_GAP_MAX_LINK_NBR, or @ref BLE_CONN_REG_INDEX_INVALID if not connected.
+ */
+uint8_t BLE_CONN_REG_GetIndex(uint16_t connHandle);
+
+/**@} */ //BLE_CONN_REG_FUNS
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif
+
+/**
+  @}
+*/
@@ -49,6 +49,7 @@
 #include "ble_gap.h"
 #include "gatt.h"
 #include "ble_util/byte_stream.h"
+#include "ble_util/ble_conn_reg.h"
 #include "ble_pxpm/ble_pxpm.h"
 
 
@@ -88,14 +89,46 @@ typedef enum BLE_PXPM_CharTxPowerLevelIndex_T
     PXPM_CHARTXPWRLV_CHAR_NUM
 } BLE_PXPM_CharTxPowerLevelIndex_T;
 
+/* Outbound writes, in the order they are sent when several are pending. */
+typedef enum BLE_PXPM_WriteIndex_T
+{
+    #ifdef BLE_PXPM_IAS_ENABLE
+    PXPM_WRITE_IAS_ALERTLV = 0x00,
+    #endif
+    PXPM_WRITE_LLS_ALERTLV,
+    PXPM_WRITE_NUM
+} BLE_PXPM_WriteIndex_T;
+
+/* Stages of the connect bootstrap, see BLE_PXPM_StartBootstrap. */
+typedef enum BLE_PXPM_BootStage_T
+{
+    PXPM_BOOT_IDLE = 0x00,
+    PXPM_BOOT_LLS_READ,
+    PXPM_BOOT_LLS_WRITE,
+    PXPM_BOOT_TXPWR_READ
+} BLE_PXPM_BootStage_T;
+
 typedef struct BLE_PXPM_ConnList_T
 {
     int8_t      connIndex;
     uint16_t    connHandle;
+    uint8_t     writePending;                       /* Bit mask of BLE_PXPM_WriteIndex_T waiting for the ATT bearer. */
+    uint8_t     writeLevel[PXPM_WRITE_NUM];         /* Latest level of each write, older ones are overwritten. */
+    bool        writeReqInFlight;                   /* A Write Request is waiting for its response. */
+    uint8_t     bootStage;                          /* BLE_PXPM_BootStage_T of the connect bootstrap. */
+    uint8_t     bootLlsLevel;                       /* LLS Alert Level the bootstrap makes the reporter hold. */
+    bool        bootReadPending;                    /* The bootstrap read is waiting for the ATT bearer. */
+    uint32_t    connTick;                           /* Tick the connection was established. */
+    uint32_t    discTick;                           /* Tick the bootstrap was started, i.e. discovery completed. */
+    uint32_t    alertReadyTick;                     /* Tick the LLS Alert Level was confirmed on the reporter. */
 } BLE_PXPM_ConnList_T;
 
 static BLE_PXPM_EventCb_T       sp_pxpmCbRoutine;
 
+static GATTC_WriteParams_T      s_pxpmWriteParams;
+static BLE_PXPM_WriteStats_T    s_pxpmWriteStats;
+static BLE_PXPM_BootstrapStats_T s_pxpmBootStats;
+
 static BLE_PXPM_ConnList_T      s_pxpmConnList[BLE_PXPM_MAX_CONN_NBR];
 
 static BLE_DD_CharInfo_T        s_pxpmLlsCharInfoList[BLE_PXPM_MAX_CONN_NBR][PXPM_CHARALERTLV_CHAR_NUM];
@@ -163,31 +196,13 @@ static void ble_pxpm_InitConnList(uint8_t connIndex)
 
 static BLE_PXPM_ConnList_T *ble_pxpm_GetConnListByHandle(uint16_t connHandle)
 {
-    uint8_t i;
-
-    for(i=0; i<BLE_PXPM_MAX_CONN_NBR; i++)
-    {
-        if (s_pxpmConnList[i].connHandle == connHandle)
-        {
-            return &s_pxpmConnList[i];
-        }
-    }
-    return NULL;
-}
-
-static BLE_PXPM_ConnList_T *ble_pxpm_GetFreeConnList(void)
-{
-    uint8_t i;
+    uint8_t connIndex = BLE_CONN_REG_GetIndex(connHandle);
 
-    for(i=0; i<BLE_PXPM_MAX_CONN_NBR; i++)
+    if (connIndex == BLE_CONN_REG_INDEX_INVALID)
     {
-        if (s_pxpmConnList[i].connHandle == 0)
-        {
-            s_pxpmConnList[i].connIndex = i;
-            return &s_pxpmConnList[i];
-        }
+        return NULL;
     }
-    return NULL;
+    return &s_pxpmConnList[connIndex];
 }
 
 static void ble_pxpm_ConveyEvent(uint8_t eventId, uint8_t *p_eventField, uint8_t eventFieldLen)
@@ -253,6 +268,227 @@ static uint16_t ble_pxpm_InitTxPwrLvSvcDiscRegister(const uint8_t * p_uuid, BLE_
 }
 #endif
 
+static uint16_t ble_pxpm_GetWriteTarget(BLE_PXPM_ConnList_T *p_conn, uint8_t writeIndex, uint8_t *p_writeType)
+{
+    #ifdef BLE_PXPM_IAS_ENABLE
+    if (writeIndex == PXPM_WRITE_IAS_ALERTLV)
+    {
+        *p_writeType = ATT_WRITE_CMD;
+        return s_pxpmIasCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
+    }
+    #endif
+
+    *p_writeType = ATT_WRITE_REQ;
+    return s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
+}
+
+static uint16_t ble_pxpm_FlushWrites(BLE_PXPM_ConnList_T *p_conn)
+{
+    uint16_t result = MBA_RES_SUCCESS;
+    uint16_t writeResult;
+    uint8_t writeType;
+    uint8_t i;
+
+    for (i = 0; i < PXPM_WRITE_NUM; i++)
+    {
+        if ((p_conn->writePending & (1U << i)) == 0)
+        {
+            continue;
+        }
+
+        s_pxpmWriteParams.charHandle = ble_pxpm_GetWriteTarget(p_conn, i, &writeType);
+
+        //Only one request may be outstanding on the bearer, commands can still go
+        if ((writeType == ATT_WRITE_REQ) && p_conn->writeReqInFlight)
+        {
+            continue;
+        }
+
+        s_pxpmWriteParams.charLength = 1;
+        s_pxpmWriteParams.charValue[0] = p_conn->writeLevel[i];
+        s_pxpmWriteParams.writeType = writeType;
+        s_pxpmWriteParams.valueOffset = 0x0000;
+        s_pxpmWriteParams.flags = 0;
+        writeResult = GATTC_Write(p_conn->connHandle, &s_pxpmWriteParams);
+
+        if ((writeResult == MBA_RES_BUSY) || (writeResult == MBA_RES_NO_RESOURCE) || (writeResult == MBA_RES_OOM))
+        {
+            //Kept pending, retried when the bearer or a TX buffer is available again
+            s_pxpmWriteStats.retryCnt++;
+            continue;
+        }
+
+        p_conn->writePending &= (uint8_t)~(1U << i);
+        if (writeResult != MBA_RES_SUCCESS)
+        {
+            s_pxpmWriteStats.dropCnt++;
+            result = writeResult;
+            continue;
+        }
+
+        s_pxpmWriteStats.writeCnt++;
+        if (writeType == ATT_WRITE_REQ)
+        {
+            p_conn->writeReqInFlight = true;
+        }
+    }
+
+    return result;
+}
+
+static uint16_t ble_pxpm_QueueWrite(uint16_t connHandle, uint8_t writeIndex, BLE_PXPM_AlertLevel_T level)
+{
+    BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
+    uint8_t writeType;
+
+    if(p_conn == NULL || (ble_pxpm_GetWriteTarget(p_conn, writeIndex, &writeType)==0x0000))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    //Latest wins, a level still waiting for the bearer is replaced
+    if (p_conn->writePending & (1U << writeIndex))
+    {
+        s_pxpmWriteStats.coalesceCnt++;
+    }
+
+    p_conn->writeLevel[writeIndex] = level;
+    p_conn->writePending |= (uint8_t)(1U << writeIndex);
+
+    return ble_pxpm_FlushWrites(p_conn);
+}
+
+static void ble_pxpm_CheckWriteQueue(BLE_PXPM_ConnList_T *p_conn, bool wasBusy)
+{
+    BLE_PXPM_EvtWriteQueueEmpty_T evt;
+
+    //Only a queue that was busy reports it has emptied
+    if (!wasBusy || (p_conn->writePending != 0) || p_conn->writeReqInFlight)
+    {
+        return;
+    }
+
+    evt.connHandle = p_conn->connHandle;
+    ble_pxpm_ConveyEvent(BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND, (uint8_t *) &evt, sizeof(BLE_PXPM_EvtWriteQueueEmpty_T));
+}
+
+static void ble_pxpm_BootstrapFinish(BLE_PXPM_ConnList_T *p_conn)
+{
+    BLE_PXPM_EvtBootstrapComplete_T evt;
+
+    p_conn->bootStage = PXPM_BOOT_IDLE;
+
+    evt.connHandle = p_conn->connHandle;
+    evt.connToDiscMs = (p_conn->discTick - p_conn->connTick) * portTICK_PERIOD_MS;
+    evt.discToAlertReadyMs = (p_conn->alertReadyTick - p_conn->discTick) * portTICK_PERIOD_MS;
+    evt.alertReadyToDoneMs = (xTaskGetTickCount() - p_conn->alertReadyTick) * portTICK_PERIOD_MS;
+
+    s_pxpmBootStats.bootstrapCnt++;
+    memcpy(&s_pxpmBootStats.last, &evt, sizeof(BLE_PXPM_EvtBootstrapComplete_T));
+    ble_pxpm_ConveyEvent(BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND, (uint8_t *) &evt, sizeof(BLE_PXPM_EvtBootstrapComplete_T));
+}
+
+static void ble_pxpm_BootstrapRead(BLE_PXPM_ConnList_T *p_conn);
+
+static void ble_pxpm_BootstrapAlertReady(BLE_PXPM_ConnList_T *p_conn)
+{
+    uint32_t connToReadyMs;
+
+    p_conn->alertReadyTick = xTaskGetTickCount();
+    connToReadyMs = (p_conn->alertReadyTick - p_conn->connTick) * portTICK_PERIOD_MS;
+    if (connToReadyMs > s_pxpmBootStats.connToAlertReadyMaxMs)
+    {
+        s_pxpmBootStats.connToAlertReadyMaxMs = connToReadyMs;
+    }
+
+    #ifdef BLE_PXPM_TPS_ENABLE
+    p_conn->bootStage = PXPM_BOOT_TXPWR_READ;
+    ble_pxpm_BootstrapRead(p_conn);
+    #else
+    ble_pxpm_BootstrapFinish(p_conn);
+    #endif
+}
+
+static void ble_pxpm_BootstrapReadDone(BLE_PXPM_ConnList_T *p_conn, const uint8_t *p_value)
+{
+    if (p_conn->bootStage == PXPM_BOOT_LLS_READ)
+    {
+        if (p_value != NULL)
+        {
+            BLE_PXPM_EvtLlsAlertLvInd_T evt;
+
+            evt.connHandle = p_conn->connHandle;
+            evt.alertLevel = (BLE_PXPM_AlertLevel_T)p_value[0];
+            ble_pxpm_ConveyEvent(BLE_PXPM_EVT_LLS_ALERT_LEVEL_IND, (uint8_t *) &evt, sizeof(BLE_PXPM_EvtLlsAlertLvInd_T));
+        }
+
+        //The LLS level survives on the reporter between connections, only a different one is written
+        if ((p_value != NULL) && (p_value[0] == p_conn->bootLlsLevel))
+        {
+            s_pxpmBootStats.llsWriteSkipCnt++;
+            ble_pxpm_BootstrapAlertReady(p_conn);
+        }
+        else if (ble_pxpm_QueueWrite(p_conn->connHandle, PXPM_WRITE_LLS_ALERTLV, (BLE_PXPM_AlertLevel_T)p_conn->bootLlsLevel) == MBA_RES_SUCCESS)
+        {
+            p_conn->bootStage = PXPM_BOOT_LLS_WRITE;
+        }
+        else
+        {
+            ble_pxpm_BootstrapAlertReady(p_conn);
+        }
+    }
+    #ifdef BLE_PXPM_TPS_ENABLE
+    else if (p_conn->bootStage == PXPM_BOOT_TXPWR_READ)
+    {
+        if (p_value != NULL)
+        {
+            BLE_PXPM_EvtTpsTxPwrLvInd_T evt;
+
+            evt.connHandle = p_conn->connHandle;
+            evt.txPowerLevel = (int8_t)p_value[0];
+            ble_pxpm_ConveyEvent(BLE_PXPM_EVT_TPS_TX_POWER_LEVEL_IND, (uint8_t *) &evt, sizeof(BLE_PXPM_EvtTpsTxPwrLvInd_T));
+        }
+        ble_pxpm_BootstrapFinish(p_conn);
+    }
+    #endif
+}
+
+static void ble_pxpm_BootstrapRead(BLE_PXPM_ConnList_T *p_conn)
+{
+    GATTC_ReadByTypeParams_T readParams;
+    uint16_t result;
+
+    readParams.endHandle = 0xFFFF;
+    readParams.attrTypeLength = ATT_UUID_LENGTH_2;
+    #ifdef BLE_PXPM_TPS_ENABLE
+    if (p_conn->bootStage == PXPM_BOOT_TXPWR_READ)
+    {
+        //TX Power Level is unique in the database, the whole range is read
+        readParams.startHandle = 0x0001;
+        memcpy(readParams.attrType, pxpmDiscCharTxPwrLv.uuid, ATT_UUID_LENGTH_2);
+    }
+    else
+    #endif
+    {
+        //Start at the LLS value, an IAS Alert Level before it is not readable and would end the response
+        readParams.startHandle = s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
+        memcpy(readParams.attrType, pxpmDiscCharAlertLv.uuid, ATT_UUID_LENGTH_2);
+    }
+
+    p_conn->bootReadPending = false;
+    result = GATTC_ReadUsingUUID(p_conn->connHandle, &readParams);
+
+    if ((result == MBA_RES_BUSY) || (result == MBA_RES_NO_RESOURCE) || (result == MBA_RES_OOM))
+    {
+        //Retried when the bearer or a TX buffer is available again
+        p_conn->bootReadPending = true;
+    }
+    else if (result != MBA_RES_SUCCESS)
+    {
+        ble_pxpm_BootstrapReadDone(p_conn, NULL);
+    }
+}
+
 static void ble_pxpm_ProcDiscComplete(BLE_DD_Event_T * p_event)
 {
     BLE_PXPM_EvtDiscComplete_T evtDiscCmlt;
@@ -296,9 +532,36 @@ static void ble_pxpm_ProcReadResponse(GATT_Event_T *p_event)
     #endif
 }
 
+static void ble_pxpm_ProcReadUsingUuidResponse(GATT_Event_T *p_event)
+{
+    BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(p_event->eventField.onReadUsingUuidResp.connHandle);
+    uint8_t *p_value = NULL;
+    uint16_t attrHandle;
+
+    if ((p_conn == NULL) || ((p_conn->bootStage != PXPM_BOOT_LLS_READ) && (p_conn->bootStage != PXPM_BOOT_TXPWR_READ)))
+    {
+        return;
+    }
+
+    //The first handle-value pair is the one looked for, see ble_pxpm_BootstrapRead
+    if ((p_event->eventField.onReadUsingUuidResp.attrPairLength > 2U)
+        && (p_event->eventField.onReadUsingUuidResp.attrDataLength >= p_event->eventField.onReadUsingUuidResp.attrPairLength))
+    {
+        BUF_LE_TO_U16(&attrHandle, &p_event->eventField.onReadUsingUuidResp.attrData[0]);
+        if ((p_conn->bootStage != PXPM_BOOT_LLS_READ)
+            || (attrHandle == s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle))
+        {
+            p_value = &p_event->eventField.onReadUsingUuidResp.attrData[2];
+        }
+    }
+
+    ble_pxpm_BootstrapReadDone(p_conn, p_value);
+}
+
 static void ble_pxpm_ProcWriteResponse(GATT_Event_T *p_event)
 {
     BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(p_event->eventField.onWriteResp.connHandle);
+    bool wasBusy;
 
     if(p_conn == NULL)
     {
@@ -313,6 +576,18 @@ static void ble_pxpm_ProcWriteResponse(GATT_Event_T *p_event)
         evt.errCode = 0x00;
         ble_pxpm_ConveyEvent(BLE_PXPM_EVT_LLS_ALERT_LEVEL_WRITE_RSP_IND, (uint8_t *) &evt, sizeof(BLE_PXPM_EvtLlsAlertLvWriteRspInd_T));
     }
+
+    wasBusy = (p_conn->writePending != 0) || p_conn->writeReqInFlight;
+    p_conn->writeReqInFlight = false;
+    (void)ble_pxpm_FlushWrites(p_conn);
+    ble_pxpm_CheckWriteQueue(p_conn, wasBusy);
+
+    //Only the response to the LLS write ends the stage, an IAS write request may answer first
+    if ((p_conn->bootStage == PXPM_BOOT_LLS_WRITE)
+        && (p_event->eventField.onWriteResp.charHandle == s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle))
+    {
+        ble_pxpm_BootstrapAlertReady(p_conn);
+    }
 }
 
 static void ble_pxpm_ProcErrorResponse(GATT_Event_T *p_event)
@@ -325,7 +600,8 @@ static void ble_pxpm_ProcErrorResponse(GATT_Event_T *p_event)
         return;
     }
 
-    if(p_event->eventField.onError.attrHandle == s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle)
+    if((p_event->eventField.onError.reqOpcode == ATT_WRITE_REQ)
+        && (p_event->eventField.onError.attrHandle == s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle))
     {
         BLE_PXPM_EvtLlsAlertLvWriteRspInd_T evt;
 
@@ -333,12 +609,60 @@ static void ble_pxpm_ProcErrorResponse(GATT_Event_T *p_event)
         evt.errCode = p_event->eventField.onError.errCode;
         ble_pxpm_ConveyEvent(BLE_PXPM_EVT_LLS_ALERT_LEVEL_WRITE_RSP_IND, (uint8_t *) &evt, sizeof(BLE_PXPM_EvtLlsAlertLvWriteRspInd_T));
     }
+
+    if (p_event->eventField.onError.reqOpcode == ATT_WRITE_REQ)
+    {
+        bool wasBusy = (p_conn->writePending != 0) || p_conn->writeReqInFlight;
+
+        p_conn->writeReqInFlight = false;
+        (void)ble_pxpm_FlushWrites(p_conn);
+        ble_pxpm_CheckWriteQueue(p_conn, wasBusy);
+
+        if ((p_conn->bootStage == PXPM_BOOT_LLS_WRITE)
+            && (p_event->eventField.onError.attrHandle == s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle))
+        {
+            ble_pxpm_BootstrapAlertReady(p_conn);
+        }
+    }
+    else if ((p_event->eventField.onError.reqOpcode == ATT_READ_BY_TYPE_REQ)
+        && ((p_conn->bootStage == PXPM_BOOT_LLS_READ) || (p_conn->bootStage == PXPM_BOOT_TXPWR_READ)))
+    {
+        //Value not readable or not found, go on as if it is unknown
+        ble_pxpm_BootstrapReadDone(p_conn, NULL);
+    }
+}
+
+static void ble_pxpm_ProcProtocolAvailable(uint16_t connHandle)
+{
+    BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
+
+    if (p_conn == NULL)
+    {
+        return;
+    }
+
+    if (p_conn->writePending != 0)
+    {
+        (void)ble_pxpm_FlushWrites(p_conn);
+        ble_pxpm_CheckWriteQueue(p_conn, true);
+    }
+
+    if (p_conn->bootReadPending)
+    {
+        ble_pxpm_BootstrapRead(p_conn);
+    }
 }
 
 static void ble_pxpm_GattEventProcess(GATT_Event_T *p_event)
 {
     switch (p_event->eventId)
     {
+        case GATTC_EVT_READ_USING_UUID_RESP:
+        {
+            ble_pxpm_ProcReadUsingUuidResponse(p_event);
+        }
+        break;
+
         case GATTC_EVT_READ_RESP:
         {
             ble_pxpm_ProcReadResponse(p_event);
@@ -356,6 +680,12 @@ static void ble_pxpm_GattEventProcess(GATT_Event_T *p_event)
             ble_pxpm_ProcErrorResponse(p_event);
         }
         break;
+
+        case GATTC_EVT_PROTOCOL_AVAILABLE:
+        {
+            ble_pxpm_ProcProtocolAvailable(p_event->eventField.onClientProtocolAvailable.connHandle);
+        }
+        break;
         default:
         break;
     }
@@ -384,10 +714,12 @@ static void ble_pxpm_GapEventProcess(BLE_GAP_Event_T *p_event)
         {
             if ((p_event->eventField.evtConnect.status == GAP_STATUS_SUCCESS))
             {
-                p_conn = ble_pxpm_GetFreeConnList();
+                p_conn = ble_pxpm_GetConnListByHandle(p_event->eventField.evtConnect.connHandle);
                 if (p_conn != NULL)
                 {
+                    p_conn->connIndex = (int8_t)BLE_CONN_REG_GetIndex(p_event->eventField.evtConnect.connHandle);
                     p_conn->connHandle = p_event->eventField.evtConnect.connHandle;
+                    p_conn->connTick = xTaskGetTickCount();
                 }
             }
         }
@@ -403,6 +735,12 @@ static void ble_pxpm_GapEventProcess(BLE_GAP_Event_T *p_event)
         }
         break;
 
+        case BLE_GAP_EVT_TX_BUF_AVAILABLE:
+        {
+            ble_pxpm_ProcProtocolAvailable(p_event->eventField.evtTxBufAvailable.connHandle);
+        }
+        break;
+
         default:
         break;
     }
@@ -412,6 +750,8 @@ uint16_t BLE_PXPM_Init(void)
 {
     uint8_t i;
     sp_pxpmCbRoutine = NULL;
+    memset(&s_pxpmWriteStats, 0, sizeof(BLE_PXPM_WriteStats_T));
+    memset(&s_pxpmBootStats, 0, sizeof(BLE_PXPM_BootstrapStats_T));
 
     for(i = 0; i < BLE_PXPM_MAX_CONN_NBR; i++)
     {
@@ -437,64 +777,96 @@ void BLE_PXPM_EventRegister(BLE_PXPM_EventCb_T routine)
 }
 
 uint16_t BLE_PXPM_WriteLlsAlertLevel(uint16_t connHandle, BLE_PXPM_AlertLevel_T level)
+{
+    return ble_pxpm_QueueWrite(connHandle, PXPM_WRITE_LLS_ALERTLV, level);
+}
+
+#ifdef BLE_PXPM_IAS_ENABLE
+uint16_t BLE_PXPM_WriteIasAlertLevel(uint16_t connHandle, BLE_PXPM_AlertLevel_T level)
+{
+    return ble_pxpm_QueueWrite(connHandle, PXPM_WRITE_IAS_ALERTLV, level);
+}
+#endif
+
+void BLE_PXPM_GetWriteStats(BLE_PXPM_WriteStats_T *p_stats)
+{
+    memcpy(p_stats, &s_pxpmWriteStats, sizeof(BLE_PXPM_WriteStats_T));
+}
+
+bool BLE_PXPM_IsWriteQueueEmpty(uint16_t connHandle)
+{
+    BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
+
+    if (p_conn == NULL)
+    {
+        return true;
+    }
+
+    return ((p_conn->writePending == 0) && !p_conn->writeReqInFlight);
+}
+
+uint16_t BLE_PXPM_ReadLlsAlertLevel(uint16_t connHandle)
 {
     BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
-    uint16_t result;
-    GATTC_WriteParams_T *p_writeParams;
 
     if(p_conn == NULL || (s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle==0x0000))
     {
         return MBA_RES_INVALID_PARA;
     }
+    
+    return GATTC_Read(connHandle, s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle, 0);
+}
+
+#ifdef BLE_PXPM_TPS_ENABLE
+uint16_t BLE_PXPM_ReadTpsTxPowerLevel(uint16_t connHandle)
+{
+    BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams == NULL)
+    if(p_conn == NULL || (s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLV].charHandle==0x0000))
     {
-        return MBA_RES_OOM;
+        return MBA_RES_INVALID_PARA;
     }
 
-    p_writeParams->charHandle = s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
-    p_writeParams->charLength = 1;
-    p_writeParams->charValue[0] = level;
-    p_writeParams->writeType = ATT_WRITE_REQ;
-    p_writeParams->valueOffset = 0x0000;
-    result = GATTC_Write(connHandle, p_writeParams);
-    OSAL_Free(p_writeParams);
-
-    return result;
+    return GATTC_Read(connHandle, s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLV].charHandle, 0);
 }
+#endif
 
-#ifdef BLE_PXPM_IAS_ENABLE
-uint16_t BLE_PXPM_WriteIasAlertLevel(uint16_t connHandle, BLE_PXPM_AlertLevel_T level)
+uint16_t BLE_PXPM_StartBootstrap(uint16_t connHandle, BLE_PXPM_AlertLevel_T llsLevel, BLE_PXPM_AlertLevel_T iasLevel)
 {
     BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
-    uint16_t result;
-    GATTC_WriteParams_T *p_writeParams;
 
-    if(p_conn == NULL || (s_pxpmIasCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle==0x0000))
+    if(p_conn == NULL || (s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle==0x0000))
     {
         return MBA_RES_INVALID_PARA;
     }
 
-    p_writeParams = OSAL_Malloc(sizeof(GATTC_WriteParams_T));
-    if (p_writeParams == NULL)
+    if (p_conn->bootStage != PXPM_BOOT_IDLE)
     {
-        return MBA_RES_OOM;
+        return MBA_RES_BUSY;
     }
 
-    p_writeParams->charHandle = s_pxpmIasCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
-    p_writeParams->charLength = 1;
-    p_writeParams->charValue[0] = level;
-    p_writeParams->writeType = ATT_WRITE_CMD;
-    p_writeParams->valueOffset = 0x0000;
-    result = GATTC_Write(connHandle, p_writeParams);
-    OSAL_Free(p_writeParams);
+    p_conn->discTick = xTaskGetTickCount();
+    p_conn->bootLlsLevel = (uint8_t)llsLevel;
+    p_conn->bootStage = PXPM_BOOT_LLS_READ;
 
-    return result;
+    #ifdef BLE_PXPM_IAS_ENABLE
+    //Write Without Response, it goes out without holding the bearer
+    (void)ble_pxpm_QueueWrite(connHandle, PXPM_WRITE_IAS_ALERTLV, iasLevel);
+    #else
+    (void)iasLevel;
+    #endif
+
+    ble_pxpm_BootstrapRead(p_conn);
+
+    return MBA_RES_SUCCESS;
 }
-#endif
 
-uint16_t BLE_PXPM_ReadLlsAlertLevel(uint16_t connHandle)
+void BLE_PXPM_GetBootstrapStats(BLE_PXPM_BootstrapStats_T *p_stats)
+{
+    memcpy(p_stats, &s_pxpmBootStats, sizeof(BLE_PXPM_BootstrapStats_T));
+}
+
+uint16_t BLE_PXPM_GetHandleCache(uint16_t connHandle, BLE_PXPM_HandleCache_T *p_cache)
 {
     BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
 
@@ -502,23 +874,49 @@ uint16_t BLE_PXPM_ReadLlsAlertLevel(uint16_t connHandle)
     {
         return MBA_RES_INVALID_PARA;
     }
-    
-    return GATTC_Read(connHandle, s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle, 0);
+
+    memset(p_cache, 0, sizeof(BLE_PXPM_HandleCache_T));
+    p_cache->llsAlertLvHandle = s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
+    #ifdef BLE_PXPM_IAS_ENABLE
+    p_cache->iasAlertLvHandle = s_pxpmIasCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle;
+    #endif
+    #ifdef BLE_PXPM_TPS_ENABLE
+    p_cache->tpsTxPwrLvHandle = s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLV].charHandle;
+    p_cache->tpsTxPwrLvCccdHandle = s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLVCCCD].charHandle;
+    p_cache->tpsTxPwrLvCpfdHandle = s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLVCPFD].charHandle;
+    #endif
+
+    return MBA_RES_SUCCESS;
 }
 
-#ifdef BLE_PXPM_TPS_ENABLE
-uint16_t BLE_PXPM_ReadTpsTxPowerLevel(uint16_t connHandle)
+uint16_t BLE_PXPM_RestoreHandleCache(uint16_t connHandle, BLE_PXPM_HandleCache_T const *p_cache)
 {
     BLE_PXPM_ConnList_T *p_conn = ble_pxpm_GetConnListByHandle(connHandle);
+    BLE_PXPM_EvtDiscComplete_T evtDiscCmlt;
 
-    if(p_conn == NULL || (s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLV].charHandle==0x0000))
+    if(p_conn == NULL || (p_cache->llsAlertLvHandle==0x0000))
     {
         return MBA_RES_INVALID_PARA;
     }
 
-    return GATTC_Read(connHandle, s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLV].charHandle, 0);
+    s_pxpmLlsCharList[p_conn->connIndex].connHandle = connHandle;
+    s_pxpmLlsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle = p_cache->llsAlertLvHandle;
+    #ifdef BLE_PXPM_IAS_ENABLE
+    s_pxpmIasCharList[p_conn->connIndex].connHandle = connHandle;
+    s_pxpmIasCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARALERTLV].charHandle = p_cache->iasAlertLvHandle;
+    #endif
+    #ifdef BLE_PXPM_TPS_ENABLE
+    s_pxpmTpsCharList[p_conn->connIndex].connHandle = connHandle;
+    s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLV].charHandle = p_cache->tpsTxPwrLvHandle;
+    s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLVCCCD].charHandle = p_cache->tpsTxPwrLvCccdHandle;
+    s_pxpmTpsCharList[p_conn->connIndex].p_charInfo[PXPM_INDEX_CHARTXPWRLVCPFD].charHandle = p_cache->tpsTxPwrLvCpfdHandle;
+    #endif
+
+    evtDiscCmlt.connHandle = connHandle;
+    ble_pxpm_ConveyEvent(BLE_PXPM_EVT_DISC_COMPLETE_IND, (uint8_t *) &evtDiscCmlt, sizeof(BLE_PXPM_EvtDiscComplete_T));
+
+    return MBA_RES_SUCCESS;
 }
-#endif
 
 void BLE_PXPM_BleDdEventHandler(BLE_DD_Event_T *p_event)
 {
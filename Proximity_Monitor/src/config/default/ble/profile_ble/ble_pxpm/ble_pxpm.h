@@ -113,6 +113,18 @@ extern "C" {
 #define BLE_PXPM_UUID_ALERT_LEVEL            0x2A06     /**< Alert Level UUID. */
 #define BLE_PXPM_UUID_TXPOWER_LEVEL          0x2A07     /**< Tx Power Level UUID. */
 /** @} */
+
+
+/**@defgroup BLE_PXPM_EVT_MASK Consumed stack events
+ * @brief The definition of the stack events handled by @ref BLE_PXPM_BleEventHandler, one bit per event ID of each group.
+ *        The stack event dispatcher of the application directs only these events to BLE PXP Monitor.
+ * @{ */
+#define BLE_PXPM_GAP_EVT_MASK                ((1UL << BLE_GAP_EVT_CONNECTED) | (1UL << BLE_GAP_EVT_DISCONNECTED) \
+                                             | (1UL << BLE_GAP_EVT_TX_BUF_AVAILABLE))                               /**< BLE GAP events. */
+#define BLE_PXPM_GATT_EVT_MASK               ((1UL << GATTC_EVT_READ_USING_UUID_RESP) | (1UL << GATTC_EVT_READ_RESP) \
+                                             | (1UL << GATTC_EVT_WRITE_RESP) | (1UL << GATTC_EVT_ERROR_RESP) \
+                                             | (1UL << GATTC_EVT_PROTOCOL_AVAILABLE))                               /**< GATT events. */
+/** @} */
 /**@} */ //BLE_PXPM_DEFINES
 
 
@@ -135,7 +147,9 @@ typedef enum BLE_PXPM_EventId_T
     BLE_PXPM_EVT_LLS_ALERT_LEVEL_WRITE_RSP_IND,     /**< Event for receiving LLS Alert Level write response. See @ref BLE_PXPM_EvtLlsAlertLvWriteRspInd_T for event details.*/
     BLE_PXPM_EVT_LLS_ALERT_LEVEL_IND,               /**< Event for receiving LLS Alert Level read response. See @ref BLE_PXPM_EvtLlsAlertLvInd_T for event details.*/
     BLE_PXPM_EVT_TPS_TX_POWER_LEVEL_IND,            /**< Event for receiving TPS TX Power Level read response. See @ref BLE_PXPM_EvtTpsTxPwrLvInd_T for event details.*/
-    BLE_PXPM_EVT_ERR_UNSPECIFIED_IND                /**< Profile internal unspecified error occurs. */
+    BLE_PXPM_EVT_ERR_UNSPECIFIED_IND,               /**< Profile internal unspecified error occurs. */
+    BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND,            /**< Connect bootstrap started by @ref BLE_PXPM_StartBootstrap is finished. See @ref BLE_PXPM_EvtBootstrapComplete_T for event details.*/
+    BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND              /**< Alert Level writes that waited for the ATT bearer or a response have all gone out. See @ref BLE_PXPM_EvtWriteQueueEmpty_T for event details.*/
 }BLE_PXPM_EventId_T;
 
 /**@} */ //BLE_PXPM_ENUMS
@@ -189,6 +203,23 @@ typedef struct BLE_PXPM_EvtLlsAlertLvInd_T
 } BLE_PXPM_EvtLlsAlertLvInd_T;
 
 
+/**@brief Data structure for @ref BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND event. */
+typedef struct BLE_PXPM_EvtBootstrapComplete_T
+{
+    uint16_t        connHandle;         /**< Connection handle. */
+    uint32_t        connToDiscMs;       /**< Time from connection established to discovery completed or handle cache restored, in ms. */
+    uint32_t        discToAlertReadyMs; /**< Time from discovery completed to LLS Alert Level confirmed on the reporter, in ms. */
+    uint32_t        alertReadyToDoneMs; /**< Time from LLS Alert Level confirmed to TX Power Level fetched, in ms. */
+} BLE_PXPM_EvtBootstrapComplete_T;
+
+
+/**@brief Data structure for @ref BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND event. */
+typedef struct BLE_PXPM_EvtWriteQueueEmpty_T
+{
+    uint16_t        connHandle;         /**< Connection handle. */
+} BLE_PXPM_EvtWriteQueueEmpty_T;
+
+
 /**@brief Characteristic list. */
 typedef struct BLE_PXPM_CharList_T
 {
@@ -214,6 +245,38 @@ typedef struct BLE_PXPM_DescList_T
 } BLE_PXPM_DescList_T;
 
 
+/**@brief Attribute handles of a PXP Reporter, used to skip discovery when reconnecting to a bonded reporter.
+ *        Handles of optional services are 0 when the service is not supported. */
+typedef struct BLE_PXPM_HandleCache_T
+{
+    uint16_t            llsAlertLvHandle;               /**< Alert Level characteristic value handle of Link Loss Service.*/
+    uint16_t            iasAlertLvHandle;               /**< Alert Level characteristic value handle of Immediate Alert Service.*/
+    uint16_t            tpsTxPwrLvHandle;               /**< Tx Power Level characteristic value handle of Tx Power Service.*/
+    uint16_t            tpsTxPwrLvCccdHandle;           /**< Tx Power Level Client Characteristic Configuration Descriptor handle.*/
+    uint16_t            tpsTxPwrLvCpfdHandle;           /**< Tx Power Level Characteristic Presentation Format Descriptor handle.*/
+} BLE_PXPM_HandleCache_T;
+
+
+/**@brief Statistics of the outbound Alert Level writes of all connections. */
+typedef struct BLE_PXPM_WriteStats_T
+{
+    uint32_t            writeCnt;                       /**< Writes handed to GATT Client, i.e. sent on air.*/
+    uint32_t            coalesceCnt;                    /**< Pending writes replaced by a newer level before they were sent.*/
+    uint32_t            retryCnt;                       /**< Writes deferred because the ATT bearer or the TX buffers were busy.*/
+    uint32_t            dropCnt;                        /**< Writes dropped because GATT Client rejected them.*/
+} BLE_PXPM_WriteStats_T;
+
+
+/**@brief Statistics of the connect bootstrap of all connections. */
+typedef struct BLE_PXPM_BootstrapStats_T
+{
+    uint32_t            bootstrapCnt;                   /**< Finished bootstraps.*/
+    uint32_t            llsWriteSkipCnt;                /**< LLS Alert Level writes skipped because the reporter already held the level.*/
+    uint32_t            connToAlertReadyMaxMs;          /**< Worst time from connection established to LLS Alert Level confirmed, in ms.*/
+    BLE_PXPM_EvtBootstrapComplete_T last;               /**< Per-stage breakdown of the last finished bootstrap.*/
+} BLE_PXPM_BootstrapStats_T;
+
+
 /**@brief Union of BLE PXP Monitor callback event data types. */
 typedef union
 {
@@ -221,6 +284,8 @@ typedef union
     BLE_PXPM_EvtLlsAlertLvWriteRspInd_T evtLlsAlertLvWriteRspInd;   /**< Handle @ref BLE_PXPM_EVT_LLS_ALERT_LEVEL_WRITE_RSP_IND. */
     BLE_PXPM_EvtLlsAlertLvInd_T         evtLlsAlertLvInd;           /**< Handle @ref BLE_PXPM_EVT_LLS_ALERT_LEVEL_IND. */
     BLE_PXPM_EvtTpsTxPwrLvInd_T         evtTpsTxPwrLvInd;           /**< Handle @ref BLE_PXPM_EVT_TPS_TX_POWER_LEVEL_IND. */
+    BLE_PXPM_EvtBootstrapComplete_T     evtBootstrapComplete;       /**< Handle @ref BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND. */
+    BLE_PXPM_EvtWriteQueueEmpty_T       evtWriteQueueEmpty;         /**< Handle @ref BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND. */
 } BLE_PXPM_EventField_T;
 
 
@@ -266,26 +331,59 @@ void BLE_PXPM_EventRegister(BLE_PXPM_EventCb_T routine);
 
 /**
  * @brief Write Alert Level value to Link Loss Service table of peer PXP Reporter device.\n
- *       Application must call this API after starting BLE PXP Monitor procedure.
+ *       Application must call this API after starting BLE PXP Monitor procedure.\n
+ *       When the ATT bearer is busy the level is kept and written once it is available again.
+ *       A level not yet written is replaced by the level of a later call.
  *
  * @param[in] connHandle     The connection handle want to be set.
  * @param[in] level          The alert level want to set for the connHandle.
  *
+ * @retval MBA_RES_SUCCESS          The level is written or queued.
+ * @retval MBA_RES_INVALID_PARA     Connection handle is not valid or Link Loss Service is not discovered.
+ *
  */
 uint16_t BLE_PXPM_WriteLlsAlertLevel(uint16_t connHandle, BLE_PXPM_AlertLevel_T level);
 
 
 /**
  * @brief Write Alert Level value to Immediate Alert Service table of peer PXP Reporter device.\n
- *       Application must call this API after starting BLE PXP Monitor procedure.
+ *       Application must call this API after starting BLE PXP Monitor procedure.\n
+ *       When no TX buffer is available the level is kept and written once one is available again.
+ *       A level not yet written is replaced by the level of a later call.
  *
  * @param[in] connHandle     The connection handle want to be set.
  * @param[in] level          The alert level want to set for the connHandle.
  *
+ * @retval MBA_RES_SUCCESS          The level is written or queued.
+ * @retval MBA_RES_INVALID_PARA     Connection handle is not valid or Immediate Alert Service is not discovered.
+ *
  */
 uint16_t BLE_PXPM_WriteIasAlertLevel(uint16_t connHandle, BLE_PXPM_AlertLevel_T level);
 
 
+/**
+ * @brief Get a snapshot of the outbound Alert Level write statistics.
+ *
+ * @param[out] p_stats       Pointer to the @ref BLE_PXPM_WriteStats_T structure buffer.
+ *
+ */
+void BLE_PXPM_GetWriteStats(BLE_PXPM_WriteStats_T *p_stats);
+
+
+/**
+ * @brief Check whether every Alert Level write of a connection has gone out.\n
+ *       A write still waiting for the ATT bearer, a TX buffer or its Write Response keeps the queue busy.
+ *       @ref BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND is issued when a busy queue empties.
+ *
+ * @param[in] connHandle     The connection handle.
+ *
+ * @retval true              Nothing is waiting, or the connection handle is not valid.
+ * @retval false             A write is waiting.
+ *
+ */
+bool BLE_PXPM_IsWriteQueueEmpty(uint16_t connHandle);
+
+
 /**
  * @brief Read Alert Level value from Link Loss Service table of peer PXP Reporter device.\n
  *       Application must call this API after starting BLE PXP Monitor procedure.
@@ -305,6 +403,35 @@ uint16_t BLE_PXPM_ReadLlsAlertLevel(uint16_t connHandle);
  */
 uint16_t BLE_PXPM_ReadTpsTxPowerLevel(uint16_t connHandle);
 
+
+/**
+ * @brief Bring a connection to the monitoring state with as few ATT transactions as possible.\n
+ *       The LLS and TX Power Level values are fetched by Read Using Characteristic UUID. The LLS Alert Level
+ *       is written only when the reporter does not already hold llsLevel, and the IAS Alert Level is written
+ *       without response. @ref BLE_PXPM_EVT_LLS_ALERT_LEVEL_IND and @ref BLE_PXPM_EVT_TPS_TX_POWER_LEVEL_IND
+ *       report the values read, and @ref BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND reports the per-stage latency.\n
+ *       This API could be called only after @ref BLE_PXPM_EVT_DISC_COMPLETE_IND event is issued.
+ *
+ * @param[in] connHandle     Handle of the connection.
+ * @param[in] llsLevel       Alert Level the Link Loss Service of the reporter must hold.
+ * @param[in] iasLevel       Alert Level written to the Immediate Alert Service of the reporter.
+ *
+ * @retval MBA_RES_SUCCESS          Successfully started the bootstrap.
+ * @retval MBA_RES_INVALID_PARA     Connection handle is not valid or Link Loss Service is not discovered.
+ * @retval MBA_RES_BUSY             A bootstrap of the connection is ongoing.
+ *
+ */
+uint16_t BLE_PXPM_StartBootstrap(uint16_t connHandle, BLE_PXPM_AlertLevel_T llsLevel, BLE_PXPM_AlertLevel_T iasLevel);
+
+
+/**
+ * @brief Get a snapshot of the connect bootstrap statistics.
+ *
+ * @param[out] p_stats       Pointer to the @ref BLE_PXPM_BootstrapStats_T structure buffer.
+ *
+ */
+void BLE_PXPM_GetBootstrapStats(BLE_PXPM_BootstrapStats_T *p_stats);
+
 /**
  * @brief Get information about characteristic UUID of the Proximity service that has been discovered.
  *       This API could be called only after @ref BLE_PXPM_EVT_DISC_COMPLETE_IND event is issued.
@@ -335,6 +462,31 @@ uint16_t BLE_PXPM_GetCharList(uint16_t connHandle, uint16_t svcUuid, uint16_t ch
 
 uint16_t BLE_PXPM_GetDescList(uint16_t connHandle, BLE_PXPM_DescList_T *p_descList);
 
+/**
+ * @brief Get the discovered attribute handles of the connection so that the application can cache them.
+ *       This API could be called only after @ref BLE_PXPM_EVT_DISC_COMPLETE_IND event is issued.
+ *
+ * @param[in]  connHandle           Handle of the connection.
+ * @param[out] p_cache              Pointer to the @ref BLE_PXPM_HandleCache_T structure buffer.
+ *
+ * @retval MBA_RES_SUCCESS          Successfully get the handles.
+ * @retval MBA_RES_INVALID_PARA     Invalid parameters. Connection handle is not valid or Link Loss Service is not discovered.
+ */
+uint16_t BLE_PXPM_GetHandleCache(uint16_t connHandle, BLE_PXPM_HandleCache_T *p_cache);
+
+/**
+ * @brief Restore the attribute handles of a bonded PXP Reporter instead of discovering them.
+ *       @ref BLE_PXPM_EVT_DISC_COMPLETE_IND event is issued immediately.\n
+ *       Application must disable the connected discovery of BLE_DD for this connection (see @ref BLE_DD_Config_T).
+ *
+ * @param[in]  connHandle           Handle of the connection.
+ * @param[in]  p_cache              Pointer to the @ref BLE_PXPM_HandleCache_T structure buffer.
+ *
+ * @retval MBA_RES_SUCCESS          Successfully restore the handles.
+ * @retval MBA_RES_INVALID_PARA     Invalid parameters. Connection handle is not valid or Link Loss Service handle is 0.
+ */
+uint16_t BLE_PXPM_RestoreHandleCache(uint16_t connHandle, BLE_PXPM_HandleCache_T const *p_cache);
+
 /**@brief Handle BLE_Stack related events.
  *       This API should be called in the application while caching BLE_Stack events.
  *
@@ -40,7 +40,7 @@
 
 #define PDS_APP_MAX_ITEMS_AMOUNT        0
 #define PDS_APP_MAX_DIR_MEM_ID_AMOUNT   0
-#define PDS_BLE_MAX_ITEMS_AMOUNT        16
+#define PDS_BLE_MAX_ITEMS_AMOUNT        24
 
 
 #define MAX_PDS_ITEMS_COUNT         (PDS_APP_MAX_ITEMS_AMOUNT) + (PDS_BLE_MAX_ITEMS_AMOUNT)
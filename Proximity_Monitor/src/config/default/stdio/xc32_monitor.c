@@ -39,6 +39,7 @@
 *******************************************************************************/
 #include <stddef.h>
 #include "definitions.h"
+#include "app_uart/app_uart.h"
 
 extern int read(int handle, void *buffer, unsigned int len);
 extern int write(int handle, void * buffer, size_t count);
@@ -61,13 +62,11 @@ int read(int handle, void *buffer, unsigned int len)
 
 int write(int handle, void * buffer, size_t count)
 {
-   bool success = false;
    if (handle == 1)
    {
-       do
-       {
-           success = SERCOM0_USART_Write(buffer, count);
-       }while( !success);
+       /* Never blocks the caller, bytes which do not fit in the transmit
+          ring buffer are dropped and counted by app_uart */
+       (void)APP_UART_Write(buffer, count);
    }
    return (int)count;
 }
\ No newline at end of file
@@ -55,7 +55,11 @@
 #include "app.h"
 #include "definitions.h"
 #include "app_ble.h"
+#include "app_adv_sched.h"
+#include "app_peri_adv.h"
 #include "app_timer/app_timer.h"
+#include "app_log/app_log.h"
+#include "app_uart/app_uart.h"
 #include "ble_pxpr/ble_pxpr.h"
 #include "config/default/peripheral/gpio/plib_gpio.h"
 // *****************************************************************************
@@ -120,8 +124,10 @@ void APP_Initialize ( void )
     /* Place the App state machine in its initial state. */
     appData.state = APP_STATE_INIT;
 
+    APP_UART_Init();
+    APP_LOG_Init();
 
-    appData.appQueue = xQueueCreate( 64, sizeof(APP_Msg_T) );
+    appData.appQueue = xQueueCreate( APP_MSG_QUEUE_LEN, sizeof(APP_Msg_T) );
     /* TODO: Initialize your application's state machine and other
      * parameters.
      */
@@ -154,9 +160,13 @@ void APP_Tasks ( void )
             RTC_Timer32Start();
             USER_LED_Set();
             BLE_PXPR_SetTxPowerLevel(bletxPower);
-            printf("bletxPower: %d\r\n",bletxPower);
-            BLE_GAP_SetAdvEnable(0x01, 0);
-            printf("[BLE] Started Advertising!!!\r\n");
+            APP_LOG1(APP_LOG_ID_TX_POWER, bletxPower);
+            APP_ADV_SCHED_Init();
+            APP_ADV_SCHED_Start();
+            APP_LOG0(APP_LOG_ID_ADV_STARTED);
+#if APP_BLE_CONNECTIONLESS
+            (void)APP_PERI_ADV_Start();
+#endif
             if (appInitialized)
             {
 
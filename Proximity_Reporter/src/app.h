@@ -103,10 +103,20 @@ typedef enum APP_MsgId_T
     APP_MSG_STACK_END
 } APP_MsgId_T;
 
+/* Messages are queued by copy, so only a small descriptor travels through
+   appQueue. Payloads that do not fit in msgData are passed by reference,
+   e.g. the stack event buffer referenced by STACK_Event_T.p_event. */
+#define APP_MSG_DATA_SIZE       (8U + (2U * sizeof(void *)))    /* Fits BT_SYS_LogEvent_T, 16 bytes on the target */
+#define APP_MSG_QUEUE_LEN       64
+
+/* Fails the build when a payload type copied into msgData outgrows it */
+#define APP_MSG_DATA_FITS(type) _Static_assert(sizeof(type) <= APP_MSG_DATA_SIZE, #type " does not fit in APP_Msg_T.msgData")
+
 typedef struct APP_Msg_T
 {
     uint8_t msgId;
-    uint8_t msgData[256];
+    uint8_t msgLen;                     /* Valid bytes in msgData */
+    uint8_t msgData[APP_MSG_DATA_SIZE] __attribute__((aligned(sizeof(void *))));
 } APP_Msg_T;
 
 // *****************************************************************************
@@ -0,0 +1,343 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Advertising Scheduler Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_adv_sched.c
+
+  Summary:
+    This file contains the advertising phase scheduler of the Proximity Reporter.
+
+  Description:
+    This file contains the advertising phase scheduler of the Proximity Reporter.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mba_error_defs.h"
+#include "ble_dm/ble_dm.h"
+#include "app_ble.h"
+#include "app_adv_sched.h"
+#include "app_log/app_log.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_ADV_SCHED_Config_T   s_advConfig;
+static APP_ADV_SCHED_Phase_T    s_advPhase;
+static TickType_t               s_advPhaseTick;
+static uint8_t                  s_advPeerDevId;
+static APP_ADV_SCHED_Stats_T    s_advStats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_adv_sched_Account(void)
+{
+    if (s_advPhase == APP_ADV_SCHED_PHASE_IDLE)
+    {
+        return;
+    }
+
+    s_advStats.phaseMs[s_advPhase] += (xTaskGetTickCount() - s_advPhaseTick) * portTICK_PERIOD_MS;
+    s_advPhaseTick = xTaskGetTickCount();
+}
+
+static APP_ADV_SCHED_Phase_T app_adv_sched_NextPhase(APP_ADV_SCHED_Phase_T phase)
+{
+    switch (phase)
+    {
+        case APP_ADV_SCHED_PHASE_IDLE:
+        {
+            if (s_advConfig.directedEnable && (s_advPeerDevId < BLE_DM_MAX_PAIRED_DEVICE_NUM))
+            {
+                return APP_ADV_SCHED_PHASE_DIRECTED;
+            }
+        }
+        //fall through
+        case APP_ADV_SCHED_PHASE_DIRECTED:
+        {
+            if (s_advConfig.fastDuration != 0)
+            {
+                return APP_ADV_SCHED_PHASE_FAST;
+            }
+        }
+        //fall through
+        default:
+        break;
+    }
+
+    //The slow phase is re-armed as is
+    return APP_ADV_SCHED_PHASE_SLOW;
+}
+
+#if APP_BLE_EXT_API
+static uint16_t app_adv_sched_Enable(APP_ADV_SCHED_Phase_T phase)
+{
+    BLE_GAP_ExtAdvParams_T extAdvParam;
+    BLE_GAP_ExtAdvEnableParams_T enableParam;
+    int8_t selectedTxPower;
+
+    (void)memset(&extAdvParam, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    extAdvParam.advHandle = APP_BLE_EXT_ADV_HANDLE;
+    extAdvParam.evtProperies = BLE_GAP_EXT_ADV_EVT_PROP_CONNECTABLE_ADV;
+    extAdvParam.priChannelMap = BLE_GAP_ADV_CHANNEL_37 | BLE_GAP_ADV_CHANNEL_38 | BLE_GAP_ADV_CHANNEL_39;
+    extAdvParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;
+    extAdvParam.txPower = APP_BLE_EXT_ADV_TX_POWER;
+    extAdvParam.priPhy = APP_BLE_EXT_PHY;
+    extAdvParam.secPhy = APP_BLE_EXT_PHY;
+    extAdvParam.sid = APP_BLE_EXT_ADV_SID;
+
+    (void)memset(&enableParam, 0, sizeof(BLE_GAP_ExtAdvEnableParams_T));
+    enableParam.advHandle = APP_BLE_EXT_ADV_HANDLE;
+
+    if (phase == APP_ADV_SCHED_PHASE_DIRECTED)
+    {
+        BLE_DM_PairedDevInfo_T devInfo;
+
+        if (BLE_DM_GetPairedDevice(s_advPeerDevId, &devInfo) != MBA_RES_SUCCESS)
+        {
+            return MBA_RES_FAIL;
+        }
+
+        //High duty cycle directed advertising only exists with legacy PDUs, run low duty cycle directed for the same 1.28s
+        extAdvParam.evtProperies |= BLE_GAP_EXT_ADV_EVT_PROP_DIRECTED_ADV;
+        extAdvParam.priIntervalMin = s_advConfig.fastInterval;
+        extAdvParam.priIntervalMax = s_advConfig.fastInterval;
+        (void)memcpy(&extAdvParam.peerAddr, &devInfo.remoteAddr, sizeof(BLE_GAP_Addr_T));
+        enableParam.duration = APP_ADV_SCHED_DIRECTED_DURATION;
+    }
+    else if (phase == APP_ADV_SCHED_PHASE_FAST)
+    {
+        extAdvParam.priIntervalMin = s_advConfig.fastInterval;
+        extAdvParam.priIntervalMax = s_advConfig.fastInterval;
+        enableParam.duration = s_advConfig.fastDuration;
+    }
+    else
+    {
+        extAdvParam.priIntervalMin = s_advConfig.slowInterval;
+        extAdvParam.priIntervalMax = s_advConfig.slowInterval;
+        enableParam.duration = s_advConfig.slowDuration;
+    }
+
+    if (BLE_GAP_SetExtAdvParams(&extAdvParam, &selectedTxPower) != MBA_RES_SUCCESS)
+    {
+        return MBA_RES_FAIL;
+    }
+
+#if APP_BLE_LONG_RANGE
+    //The coding scheme is reset along with the parameters
+    if (BLE_GAP_SetExtAdvCodingScheme(APP_BLE_CODING_SCHEME) != MBA_RES_SUCCESS)
+    {
+        return MBA_RES_FAIL;
+    }
+#endif
+
+    return BLE_GAP_SetExtAdvEnable(true, 1, &enableParam);
+}
+
+static void app_adv_sched_Disable(void)
+{
+    BLE_GAP_ExtAdvEnableParams_T enableParam;
+
+    (void)memset(&enableParam, 0, sizeof(BLE_GAP_ExtAdvEnableParams_T));
+    enableParam.advHandle = APP_BLE_EXT_ADV_HANDLE;
+    (void)BLE_GAP_SetExtAdvEnable(false, 1, &enableParam);
+}
+#else
+static uint16_t app_adv_sched_Enable(APP_ADV_SCHED_Phase_T phase)
+{
+    BLE_GAP_AdvParams_T advParam;
+    uint16_t duration;
+
+    (void)memset(&advParam, 0, sizeof(BLE_GAP_AdvParams_T));
+    advParam.type = BLE_GAP_ADV_TYPE_ADV_IND;
+    advParam.advChannelMap = BLE_GAP_ADV_CHANNEL_ALL;
+    advParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;
+
+    if (phase == APP_ADV_SCHED_PHASE_DIRECTED)
+    {
+        BLE_DM_PairedDevInfo_T devInfo;
+
+        if (BLE_DM_GetPairedDevice(s_advPeerDevId, &devInfo) != MBA_RES_SUCCESS)
+        {
+            return MBA_RES_FAIL;
+        }
+
+        //High duty cycle directed advertising ignores the interval and is stopped by the controller after 1.28s
+        advParam.type = BLE_GAP_ADV_TYPE_ADV_DIRECT_IND;
+        advParam.intervalMin = s_advConfig.fastInterval;
+        advParam.intervalMax = s_advConfig.fastInterval;
+        (void)memcpy(&advParam.peerAddr, &devInfo.remoteAddr, sizeof(BLE_GAP_Addr_T));
+        duration = 0;
+    }
+    else if (phase == APP_ADV_SCHED_PHASE_FAST)
+    {
+        advParam.intervalMin = s_advConfig.fastInterval;
+        advParam.intervalMax = s_advConfig.fastInterval;
+        duration = s_advConfig.fastDuration;
+    }
+    else
+    {
+        advParam.intervalMin = s_advConfig.slowInterval;
+        advParam.intervalMax = s_advConfig.slowInterval;
+        duration = s_advConfig.slowDuration;
+    }
+
+    if (BLE_GAP_SetAdvParams(&advParam) != MBA_RES_SUCCESS)
+    {
+        return MBA_RES_FAIL;
+    }
+
+    return BLE_GAP_SetAdvEnable(true, duration);
+}
+
+static void app_adv_sched_Disable(void)
+{
+    (void)BLE_GAP_SetAdvEnable(false, 0);
+}
+#endif
+
+static void app_adv_sched_Apply(APP_ADV_SCHED_Phase_T phase)
+{
+    app_adv_sched_Account();
+
+    //Advertising parameters can only be changed while advertising is disabled
+    app_adv_sched_Disable();
+    s_advPhase = APP_ADV_SCHED_PHASE_IDLE;
+
+    //A phase which cannot be started hands over to the next one
+    while (app_adv_sched_Enable(phase) != MBA_RES_SUCCESS)
+    {
+        if (phase == APP_ADV_SCHED_PHASE_SLOW)
+        {
+            return;
+        }
+
+        phase = app_adv_sched_NextPhase(phase);
+    }
+
+    s_advPhase = phase;
+    s_advPhaseTick = xTaskGetTickCount();
+    s_advStats.phaseCnt[phase]++;
+    APP_LOG1(APP_LOG_ID_ADV_PHASE, phase);
+}
+
+void APP_ADV_SCHED_Init(void)
+{
+    uint8_t devId[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t devCnt = 0;
+
+    s_advConfig.directedEnable = APP_ADV_SCHED_DEFAULT_DIRECTED;
+    s_advConfig.fastInterval = APP_ADV_SCHED_DEFAULT_FAST_INTERVAL;
+    s_advConfig.fastDuration = APP_ADV_SCHED_DEFAULT_FAST_DURATION;
+    s_advConfig.slowInterval = APP_ADV_SCHED_DEFAULT_SLOW_INTERVAL;
+    s_advConfig.slowDuration = APP_ADV_SCHED_DEFAULT_SLOW_DURATION;
+
+    BLE_DM_GetPairedDeviceList(devId, &devCnt);
+    s_advPeerDevId = (devCnt != 0) ? devId[0] : BLE_DM_PEER_DEV_ID_INVALID;
+
+    s_advPhase = APP_ADV_SCHED_PHASE_IDLE;
+    (void)memset(&s_advStats, 0, sizeof(s_advStats));
+}
+
+uint16_t APP_ADV_SCHED_SetConfig(const APP_ADV_SCHED_Config_T *p_config)
+{
+    if ((p_config == NULL)
+        || (p_config->fastInterval < BLE_GAP_ADV_INTERVAL_MIN) || (p_config->fastInterval > BLE_GAP_ADV_INTERVAL_MAX)
+        || (p_config->slowInterval < BLE_GAP_ADV_INTERVAL_MIN) || (p_config->slowInterval > BLE_GAP_ADV_INTERVAL_MAX))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    (void)memcpy(&s_advConfig, p_config, sizeof(APP_ADV_SCHED_Config_T));
+
+    return MBA_RES_SUCCESS;
+}
+
+void APP_ADV_SCHED_SetDirectedPeer(uint8_t devId)
+{
+    s_advPeerDevId = devId;
+}
+
+void APP_ADV_SCHED_Start(void)
+{
+    app_adv_sched_Apply(app_adv_sched_NextPhase(APP_ADV_SCHED_PHASE_IDLE));
+}
+
+void APP_ADV_SCHED_Stop(void)
+{
+    app_adv_sched_Account();
+    s_advPhase = APP_ADV_SCHED_PHASE_IDLE;
+    app_adv_sched_Disable();
+}
+
+void APP_ADV_SCHED_TimeoutHandler(void)
+{
+    if (s_advPhase == APP_ADV_SCHED_PHASE_IDLE)
+    {
+        return;
+    }
+
+    app_adv_sched_Apply(app_adv_sched_NextPhase(s_advPhase));
+}
+
+void APP_ADV_SCHED_ConnectedHandler(void)
+{
+    if (s_advPhase == APP_ADV_SCHED_PHASE_IDLE)
+    {
+        return;
+    }
+
+    app_adv_sched_Account();
+    s_advStats.connCnt[s_advPhase]++;
+    s_advPhase = APP_ADV_SCHED_PHASE_IDLE;
+}
+
+APP_ADV_SCHED_Phase_T APP_ADV_SCHED_GetPhase(void)
+{
+    return s_advPhase;
+}
+
+void APP_ADV_SCHED_GetStats(APP_ADV_SCHED_Stats_T *p_stats)
+{
+    app_adv_sched_Account();
+    (void)memcpy(p_stats, &s_advStats, sizeof(APP_ADV_SCHED_Stats_T));
+}
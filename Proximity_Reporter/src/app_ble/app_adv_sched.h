@@ -0,0 +1,184 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Advertising Scheduler Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_adv_sched.h
+
+  Summary:
+    This file contains the advertising phase scheduler of the Proximity Reporter.
+
+  Description:
+    Advertising runs in phases. After a start-up or a link loss the reporter
+    optionally first sends high duty cycle directed advertising to the bonded
+    monitor, then advertises fast for a short while so a monitor in range
+    reconnects quickly, and then falls back to a slow interval which is
+    re-armed until a monitor connects. Each phase ends on
+    BLE_GAP_EVT_ADV_TIMEOUT, or on a failed BLE_GAP_EVT_CONNECTED for legacy
+    directed advertising.
+ *******************************************************************************/
+
+#ifndef APP_ADV_SCHED_H
+#define APP_ADV_SCHED_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@defgroup APP_ADV_SCHED_DEFAULT APP_ADV_SCHED_DEFAULT
+ * @brief The definition of the default advertising timings.
+ * @{ */
+/* Directed PDUs carry no advertising data, so the Service Data scanning filter of the monitor drops them and the
+   directed phase only delays the fast one by 1.28s. Turn it on for centrals which scan without such a filter. */
+#define APP_ADV_SCHED_DEFAULT_DIRECTED         false    /**< Try directed advertising to the bonded monitor first. */
+#define APP_ADV_SCHED_DEFAULT_FAST_INTERVAL    32       /**< Fast phase interval, 20ms (unit: 0.625ms). */
+#define APP_ADV_SCHED_DEFAULT_FAST_DURATION    3000     /**< Fast phase duration, 30s (unit: 10ms). */
+#define APP_ADV_SCHED_DEFAULT_SLOW_INTERVAL    1636     /**< Slow phase interval, 1022.5ms (unit: 0.625ms). */
+#define APP_ADV_SCHED_DEFAULT_SLOW_DURATION    60000    /**< Slow phase duration before it is re-armed, 600s (unit: 10ms). */
+/** @} */
+
+#define APP_ADV_SCHED_DIRECTED_DURATION        128      /**< Directed phase duration with extended advertising, as long as legacy high duty cycle directed advertising (unit: 10ms). */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The definition of the advertising phases. */
+typedef enum APP_ADV_SCHED_Phase_T
+{
+    APP_ADV_SCHED_PHASE_IDLE = 0x00,        /**< Not advertising. */
+    APP_ADV_SCHED_PHASE_DIRECTED,           /**< High duty cycle directed advertising to the bonded monitor, ends after 1.28s. */
+    APP_ADV_SCHED_PHASE_FAST,               /**< Undirected advertising at the fast interval. */
+    APP_ADV_SCHED_PHASE_SLOW,               /**< Undirected advertising at the slow interval. */
+    APP_ADV_SCHED_PHASE_TOTAL
+} APP_ADV_SCHED_Phase_T;
+
+/**@brief Advertising timings. */
+typedef struct APP_ADV_SCHED_Config_T
+{
+    bool        directedEnable;             /**< Set true to start with directed advertising when a monitor is bonded. */
+    uint16_t    fastInterval;               /**< Fast phase interval (unit: 0.625ms). */
+    uint16_t    fastDuration;               /**< Fast phase duration, 0 to skip the fast phase (unit: 10ms). */
+    uint16_t    slowInterval;               /**< Slow phase interval (unit: 0.625ms). */
+    uint16_t    slowDuration;               /**< Slow phase duration before it is re-armed, 0 to advertise continuously (unit: 10ms). */
+} APP_ADV_SCHED_Config_T;
+
+/**@brief Statistics of the advertising scheduler. */
+typedef struct APP_ADV_SCHED_Stats_T
+{
+    uint32_t    phaseMs[APP_ADV_SCHED_PHASE_TOTAL];     /**< Time spent in each phase (unit: ms). */
+    uint32_t    phaseCnt[APP_ADV_SCHED_PHASE_TOTAL];    /**< Phases started. */
+    uint32_t    connCnt[APP_ADV_SCHED_PHASE_TOTAL];     /**< Connections made in each phase. */
+} APP_ADV_SCHED_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the advertising scheduler with the default timings.
+ *        The first bonded device, if any, becomes the directed advertising target.
+ */
+void APP_ADV_SCHED_Init(void);
+
+/**@brief The function is used to set the advertising timings. Takes effect from the next phase.
+ *@param[in] p_config                         Pointer to the timings.
+ *
+ * @retval MBA_RES_SUCCESS                    The timings are set.
+ * @retval MBA_RES_INVALID_PARA               Invalid interval.
+ *
+ */
+uint16_t APP_ADV_SCHED_SetConfig(const APP_ADV_SCHED_Config_T *p_config);
+
+/**@brief The function is used to set the target of directed advertising. Called when a monitor has bonded.
+ *@param[in] devId                            Paired device ID, or BLE_DM_PEER_DEV_ID_INVALID to disable directed advertising.
+ *
+ */
+void APP_ADV_SCHED_SetDirectedPeer(uint8_t devId);
+
+/**@brief The function is used to start advertising from the first phase, on start-up or after a disconnection.
+ */
+void APP_ADV_SCHED_Start(void);
+
+/**@brief The function is used to stop advertising.
+ */
+void APP_ADV_SCHED_Stop(void);
+
+/**@brief The function is used to move to the next phase. Called on BLE_GAP_EVT_ADV_TIMEOUT.
+ */
+void APP_ADV_SCHED_TimeoutHandler(void);
+
+/**@brief The function is used to record a connection. Called on BLE_GAP_EVT_CONNECTED, the controller has stopped advertising.
+ */
+void APP_ADV_SCHED_ConnectedHandler(void);
+
+/**@brief The function is used to get the current phase.
+ *
+ * @retval The current phase. See @ref APP_ADV_SCHED_Phase_T.
+ *
+ */
+APP_ADV_SCHED_Phase_T APP_ADV_SCHED_GetPhase(void);
+
+/**@brief The function is used to get a snapshot of the advertising scheduler statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_ADV_SCHED_GetStats(APP_ADV_SCHED_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_ADV_SCHED_H */
+
+
+/*******************************************************************************
+ End of File
+ */
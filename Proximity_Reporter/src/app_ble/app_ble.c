@@ -63,6 +63,11 @@
 // *****************************************************************************
 
 #define GAP_DEV_NAME_VALUE          "Microchip"
+
+/* Queued by copy in APP_Msg_T.msgData */
+APP_MSG_DATA_FITS(STACK_Event_T);
+APP_MSG_DATA_FITS(BT_SYS_LogEvent_T);
+
 extern int8_t  bletxPower;
 // *****************************************************************************
 // *****************************************************************************
@@ -117,6 +122,7 @@ void APP_BleStackCb(STACK_Event_T *p_stack)
     }
 
     appMsg.msgId=APP_MSG_BLE_STACK_EVT;
+    appMsg.msgLen=sizeof(STACK_Event_T);
 
     ((STACK_Event_T *)appMsg.msgData)->groupId=p_stack->groupId;
     ((STACK_Event_T *)appMsg.msgData)->evtLen=p_stack->evtLen;
@@ -200,8 +206,37 @@ void APP_BleConfigBasic()
 {
     int8_t                          connTxPower;
     int8_t                          advTxPower;
-    BLE_GAP_AdvParams_T             advParam;
     uint8_t advData[]={0x02, 0x01, 0x04, 0x06, 0x09, 0x46, 0x4D, 0x50, 0x5F, 0x50, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x20};
+#if APP_BLE_EXT_API
+    BLE_GAP_ExtAdvParams_T          extAdvParam;
+    BLE_GAP_ExtAdvDataParams_T      appExtAdvData;
+
+    // Configure the extended advertising set, APP_ADV_SCHED re-applies it with the interval of each phase
+    memset(&extAdvParam, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    extAdvParam.advHandle = APP_BLE_EXT_ADV_HANDLE;
+    extAdvParam.evtProperies = BLE_GAP_EXT_ADV_EVT_PROP_CONNECTABLE_ADV;     /* Connectable, not scannable */
+    extAdvParam.priIntervalMin = 32;     /* Advertising Interval Min */
+    extAdvParam.priIntervalMax = 32;     /* Advertising Interval Max */
+    extAdvParam.priChannelMap = BLE_GAP_ADV_CHANNEL_37 | BLE_GAP_ADV_CHANNEL_38 | BLE_GAP_ADV_CHANNEL_39;
+    extAdvParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;     /* Advertising Filter Policy */
+    extAdvParam.txPower = APP_BLE_EXT_ADV_TX_POWER;     /* Advertising TX Power */
+    extAdvParam.priPhy = APP_BLE_EXT_PHY;
+    extAdvParam.secPhy = APP_BLE_EXT_PHY;
+    extAdvParam.sid = APP_BLE_EXT_ADV_SID;
+    BLE_GAP_SetExtAdvParams(&extAdvParam, &advTxPower);
+#if APP_BLE_LONG_RANGE
+    BLE_GAP_SetExtAdvCodingScheme(APP_BLE_CODING_SCHEME);
+#endif
+
+    // Configure advertising data, there is no scan response for a connectable extended advertising set
+    appExtAdvData.advHandle = APP_BLE_EXT_ADV_HANDLE;
+    appExtAdvData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    appExtAdvData.fragPreference = BLE_GAP_EXT_ADV_DATA_FRAG_PREF_MIN;
+    appExtAdvData.advLen = sizeof(advData);
+    appExtAdvData.p_advData = advData;     /* Advertising Data */
+    BLE_GAP_SetExtAdvData(&appExtAdvData);
+#else
+    BLE_GAP_AdvParams_T             advParam;
     BLE_GAP_AdvDataParams_T         appAdvData;
     uint8_t scanRspData[]={0x06, 0x09, 0x46, 0x4D, 0x50, 0x5F, 0x50, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x01};
     BLE_GAP_AdvDataParams_T         appScanRspData;
@@ -226,6 +261,7 @@ void APP_BleConfigBasic()
     appScanRspData.advLen=sizeof(scanRspData);
     memcpy(appScanRspData.advData, scanRspData, appScanRspData.advLen);     /* Scan Response Data */
     BLE_GAP_SetScanRspData(&appScanRspData);
+#endif
 
     BLE_GAP_SetConnTxPowerLevel(-50, &connTxPower);      /* Connection TX Power */
     bletxPower=connTxPower;
@@ -283,6 +319,12 @@ void APP_BleStackInitBasic()
     BLE_GAP_Init();
 
     BLE_GAP_AdvInit();  /* Advertising */
+#if APP_BLE_EXT_API
+    BLE_GAP_ExtAdvInit();   /* Extended Advertising */
+#endif
+#if APP_BLE_CONNECTIONLESS
+    BLE_GAP_PeriodicAdvInit();  /* Periodic Advertising */
+#endif
 
     BLE_GAP_ConnPeripheralInit();   /* Peripheral */
 }
@@ -62,6 +62,40 @@
 #include "gatt.h"
 
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/* Long-range mode. When set, the reporter advertises from an extended
+   advertising set on the LE Coded PHY instead of legacy advertising on LE 1M.
+   Monitors must be built alike to find it. */
+#ifndef APP_BLE_LONG_RANGE
+#define APP_BLE_LONG_RANGE                 0
+#endif
+
+/* Connectionless proximity mode. When set, the reporter also broadcasts its
+   TX power and alert level in periodic advertising, so a monitor can follow
+   it without a link. See app_peri_adv.h. Monitors must be built alike. */
+#ifndef APP_BLE_CONNECTIONLESS
+#define APP_BLE_CONNECTIONLESS             0
+#endif
+
+/* Both modes need the extended advertising APIs; long-range moves them to LE Coded. */
+#define APP_BLE_EXT_API                    (APP_BLE_LONG_RANGE || APP_BLE_CONNECTIONLESS)
+#if APP_BLE_LONG_RANGE
+#define APP_BLE_EXT_PHY                    BLE_GAP_PHY_TYPE_LE_CODED
+#else
+#define APP_BLE_EXT_PHY                    BLE_GAP_PHY_TYPE_LE_1M
+#endif
+
+#define APP_BLE_EXT_ADV_HANDLE             0x00     /**< Handle of the connectable extended advertising set. */
+#define APP_BLE_EXT_ADV_SID                0x00     /**< Advertising SID of the connectable extended advertising set. */
+#define APP_BLE_EXT_ADV_TX_POWER           9        /**< Advertising TX power of the extended advertising sets (unit: dBm). */
+#define APP_BLE_CODING_SCHEME_S8           0x00     /**< LE Coded S=8, about 4x the range of LE 1M. */
+#define APP_BLE_CODING_SCHEME_S2           0x01     /**< LE Coded S=2, about 2x the range of LE 1M at a quarter of the airtime of S=8. */
+#define APP_BLE_CODING_SCHEME              APP_BLE_CODING_SCHEME_S8
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -48,8 +48,11 @@
 #include <stdio.h>
 #include "app.h"
 #include "osal/osal_freertos_extend.h"
+#include "app_ble.h"
 #include "app_ble_handler.h"
+#include "app_adv_sched.h"
 #include "app_timer/app_timer.h"
+#include "app_log/app_log.h"
 #include "peripheral/sercom/usart/plib_sercom0_usart.h"
 #include "config/default/peripheral/gpio/plib_gpio.h"
 // *****************************************************************************
@@ -79,9 +82,17 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
     {
         case BLE_GAP_EVT_CONNECTED:
         {
-            /* TODO: implement your application code.*/
-            printf("[BLE] Connected\r\n");
+            //High duty cycle directed advertising ends with a failed connection (GAP_STATUS_ADVERTISING_TIMEOUT)
+            //instead of BLE_GAP_EVT_ADV_TIMEOUT; no link exists then
+            if (p_event->eventField.evtConnect.status != GAP_STATUS_SUCCESS)
+            {
+                APP_ADV_SCHED_TimeoutHandler();
+                break;
+            }
+
+            APP_LOG0(APP_LOG_ID_CONNECTED);
             conn_hdl = p_event->eventField.evtConnect.connHandle;
+            APP_ADV_SCHED_ConnectedHandler();
             APP_TIMER_StopTimer(APP_TIMER_ID_0);
             APP_TIMER_StopTimer(APP_TIMER_ID_1);
             clear_led();
@@ -91,14 +102,15 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
         case BLE_GAP_EVT_DISCONNECTED:
         {
             /* TODO: implement your application code.*/
-            printf("[BLE] Disconnected 0x%x \r\n", p_event->eventField.evtDisconnect.reason);
+            APP_LOG1(APP_LOG_ID_DISCONNECTED, p_event->eventField.evtDisconnect.reason);
             if(p_event->eventField.evtDisconnect.reason == GAP_STATUS_CONNECTION_TIMEOUT)
             {
                 appMsg.msgId = APP_MSG_BLE_LLS_ALERT;
+                appMsg.msgLen = 0;
                 OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
             }
             conn_hdl = 0xFFFF;
-            BLE_GAP_SetAdvEnable(0x01, 0);
+            APP_ADV_SCHED_Start();
             
         }
         break;
@@ -141,7 +153,7 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_ADV_TIMEOUT:
         {
-            /* TODO: implement your application code.*/
+            APP_ADV_SCHED_TimeoutHandler();
         }
         break;
 
@@ -201,7 +213,12 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_ADV_SET_TERMINATED:
         {
-            /* TODO: implement your application code.*/
+            //The connectable set also terminates on connection, which BLE_GAP_EVT_CONNECTED handles
+            if ((p_event->eventField.evtAdvSetTerminated.advHandle == APP_BLE_EXT_ADV_HANDLE)
+                && (p_event->eventField.evtAdvSetTerminated.status != GAP_STATUS_SUCCESS))
+            {
+                APP_ADV_SCHED_TimeoutHandler();
+            }
         }
         break;
 
@@ -515,7 +532,11 @@ void APP_DmEvtHandler(BLE_DM_Event_T *p_event)
 
         case BLE_DM_EVT_SECURITY_SUCCESS:
         {
-            /* TODO: implement your application code.*/
+            //Covers both a new bond and the re-encryption of an existing one
+            if (p_event->peerDevId < BLE_DM_MAX_PAIRED_DEVICE_NUM)
+            {
+                APP_ADV_SCHED_SetDirectedPeer(p_event->peerDevId);
+            }
         }
         break;
 
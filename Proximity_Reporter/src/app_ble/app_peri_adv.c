@@ -0,0 +1,178 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Periodic Advertising Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_peri_adv.c
+
+  Summary:
+    This file contains the periodic advertising of the connectionless proximity mode.
+
+  Description:
+    This file contains the periodic advertising of the connectionless proximity mode.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "mba_error_defs.h"
+#include "app_ble.h"
+#include "app_peri_adv.h"
+#include "app_log/app_log.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static uint8_t  s_periAdvFrame[APP_PERI_ADV_FRAME_LEN];
+static uint16_t s_periAdvSeq;
+static bool     s_periAdvRunning;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint16_t app_peri_adv_Publish(void)
+{
+    BLE_GAP_PeriAdvDataParams_T periAdvData;
+
+    s_periAdvFrame[APP_PERI_ADV_FRAME_POS_SEQ] = (uint8_t)(s_periAdvSeq & 0xFF);
+    s_periAdvFrame[APP_PERI_ADV_FRAME_POS_SEQ + 1] = (uint8_t)(s_periAdvSeq >> 8);
+
+    periAdvData.advHandle = APP_PERI_ADV_HANDLE;
+    periAdvData.operation = BLE_GAP_PERIODIC_ADV_DATA_OP_COMPLETE;
+    periAdvData.advLen = APP_PERI_ADV_FRAME_LEN;
+    periAdvData.p_advData = s_periAdvFrame;
+
+    return BLE_GAP_SetPeriAdvData(&periAdvData);
+}
+
+uint16_t APP_PERI_ADV_Start(void)
+{
+    //Same service data as the connectable set, so the scan filter of the monitor accepts the set
+    uint8_t advData[]={0x06, 0x09, 0x46, 0x4D, 0x50, 0x5F, 0x50, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x20};
+    BLE_GAP_ExtAdvParams_T extAdvParam;
+    BLE_GAP_ExtAdvDataParams_T extAdvData;
+    BLE_GAP_PeriAdvParams_T periAdvParam;
+    BLE_GAP_ExtAdvEnableParams_T enableParam;
+    int8_t selectedTxPower;
+    uint16_t result;
+
+    (void)memset(&extAdvParam, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    extAdvParam.advHandle = APP_PERI_ADV_HANDLE;
+    extAdvParam.evtProperies = 0;   //Periodic advertising needs a non-connectable, non-scannable set
+    extAdvParam.priIntervalMin = APP_PERI_ADV_EXT_INTERVAL;
+    extAdvParam.priIntervalMax = APP_PERI_ADV_EXT_INTERVAL;
+    extAdvParam.priChannelMap = BLE_GAP_ADV_CHANNEL_37 | BLE_GAP_ADV_CHANNEL_38 | BLE_GAP_ADV_CHANNEL_39;
+    extAdvParam.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;
+    extAdvParam.txPower = APP_BLE_EXT_ADV_TX_POWER;
+    extAdvParam.priPhy = APP_BLE_EXT_PHY;
+    extAdvParam.secPhy = APP_BLE_EXT_PHY;
+    extAdvParam.sid = APP_PERI_ADV_SID;
+
+    result = BLE_GAP_SetExtAdvParams(&extAdvParam, &selectedTxPower);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    extAdvData.advHandle = APP_PERI_ADV_HANDLE;
+    extAdvData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    extAdvData.fragPreference = BLE_GAP_EXT_ADV_DATA_FRAG_PREF_MIN;
+    extAdvData.advLen = sizeof(advData);
+    extAdvData.p_advData = advData;
+
+    result = BLE_GAP_SetExtAdvData(&extAdvData);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    periAdvParam.advHandle = APP_PERI_ADV_HANDLE;
+    periAdvParam.intervalMin = APP_PERI_ADV_INTERVAL;
+    periAdvParam.intervalMax = APP_PERI_ADV_INTERVAL;
+    periAdvParam.properties = 0;
+
+    result = BLE_GAP_SetPeriAdvParams(&periAdvParam);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    s_periAdvFrame[0] = APP_PERI_ADV_FRAME_LEN - 1;
+    s_periAdvFrame[1] = 0x16;
+    s_periAdvFrame[2] = 0xDA;
+    s_periAdvFrame[3] = 0xFE;
+    s_periAdvFrame[4] = (uint8_t)(APP_PERI_ADV_FRAME_ID >> 8);
+    s_periAdvFrame[5] = (uint8_t)(APP_PERI_ADV_FRAME_ID & 0xFF);
+    //The selected level is what the monitor subtracts the RSSI from
+    s_periAdvFrame[APP_PERI_ADV_FRAME_POS_TX_POWER] = (uint8_t)selectedTxPower;
+    s_periAdvFrame[APP_PERI_ADV_FRAME_POS_ALERT_LEVEL] = 0;
+    s_periAdvSeq = 0;
+
+    result = app_peri_adv_Publish();
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    result = BLE_GAP_SetPeriAdvEnable(true, APP_PERI_ADV_HANDLE);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    //The set runs until it is disabled; connections are made on the set of APP_ADV_SCHED
+    (void)memset(&enableParam, 0, sizeof(BLE_GAP_ExtAdvEnableParams_T));
+    enableParam.advHandle = APP_PERI_ADV_HANDLE;
+    result = BLE_GAP_SetExtAdvEnable(true, 1, &enableParam);
+
+    s_periAdvRunning = (result == MBA_RES_SUCCESS);
+    APP_LOG2(APP_LOG_ID_PERI_ADV, selectedTxPower, result);
+
+    return result;
+}
+
+void APP_PERI_ADV_SetAlertLevel(uint8_t alertLevel)
+{
+    if (!s_periAdvRunning || (s_periAdvFrame[APP_PERI_ADV_FRAME_POS_ALERT_LEVEL] == alertLevel))
+    {
+        return;
+    }
+
+    s_periAdvFrame[APP_PERI_ADV_FRAME_POS_ALERT_LEVEL] = alertLevel;
+    s_periAdvSeq++;
+    (void)app_peri_adv_Publish();
+}
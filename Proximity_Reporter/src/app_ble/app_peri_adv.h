@@ -0,0 +1,117 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Periodic Advertising Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_peri_adv.h
+
+  Summary:
+    This file contains the periodic advertising of the connectionless proximity mode.
+
+  Description:
+    In the connectionless proximity mode the reporter runs a second,
+    non-connectable extended advertising set next to the connectable one of
+    APP_ADV_SCHED. It carries a periodic advertising train with the TX power,
+    the current IAS alert level and a sequence number, which a monitor
+    synchronizes to in order to estimate the path loss without a link. The
+    sequence number is bumped whenever the payload changes.
+ *******************************************************************************/
+
+#ifndef APP_PERI_ADV_H
+#define APP_PERI_ADV_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_PERI_ADV_HANDLE                    0x01     /**< Handle of the non-connectable extended advertising set. */
+#define APP_PERI_ADV_SID                       0x01     /**< Advertising SID the monitor synchronizes to. */
+#define APP_PERI_ADV_EXT_INTERVAL              1600     /**< Extended advertising interval, 1s (unit: 0.625ms). Only needed to establish a sync. */
+#define APP_PERI_ADV_INTERVAL                  400      /**< Periodic advertising interval, 500ms (unit: 1.25ms). */
+
+/**@defgroup APP_PERI_ADV_FRAME APP_PERI_ADV_FRAME
+ * @brief The definition of the periodic advertising payload, one Service Data AD structure. Must match the monitor.
+ * @{ */
+#define APP_PERI_ADV_FRAME_LEN                 10       /**< Payload length, including the AD length byte. */
+#define APP_PERI_ADV_FRAME_ID                  0xFF21   /**< Service data identifying the frame, big endian as advertised. */
+#define APP_PERI_ADV_FRAME_POS_TX_POWER        6        /**< TX power of the train (unit: dBm). */
+#define APP_PERI_ADV_FRAME_POS_ALERT_LEVEL     7        /**< Alert level last written to the IAS. */
+#define APP_PERI_ADV_FRAME_POS_SEQ             8        /**< Sequence number, little endian. */
+/** @} */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to configure and start the periodic advertising train.
+ *        Must be called after the BLE stack is initialized.
+ *
+ * @retval MBA_RES_SUCCESS                    The train is running.
+ * @retval Others                             See @ref BLE_GAP_SetExtAdvParams, @ref BLE_GAP_SetPeriAdvParams and the enable APIs.
+ *
+ */
+uint16_t APP_PERI_ADV_Start(void);
+
+/**@brief The function is used to publish a new alert level. The payload is only updated when the level changes.
+ *@param[in] alertLevel                       Alert level written to the IAS.
+ *
+ */
+void APP_PERI_ADV_SetAlertLevel(uint8_t alertLevel);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_PERI_ADV_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -47,6 +47,9 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "ble_pxpr/ble_pxpr.h"
+#include "app_ble.h"
+#include "app_peri_adv.h"
+#include "app_log/app_log.h"
 #include "config/default/peripheral/gpio/plib_gpio.h"
 
 // *****************************************************************************
@@ -70,14 +73,18 @@ void APP_PxprEvtHandler(BLE_PXPR_Event_T *p_event)
         {
             /* TODO: implement your application code.*/
             lls_alert_lvl=p_event->eventField.evtLlsAlertLevelWriteInd.alertLevel;
-            printf("LLS_ALERT_LEVEL: %d\r\n",lls_alert_lvl);
+            APP_LOG1(APP_LOG_ID_LLS_ALERT_LEVEL, lls_alert_lvl);
         }
         break;
         case BLE_PXPR_EVT_IAS_ALERT_LEVEL_WRITE_IND:
         {
             /* TODO: implement your application code.*/
             uint8_t alert_lvl=p_event->eventField.evtIasAlertLevelWriteInd.alertLevel;
-            printf("IAS_ALERT_LEVEL: %d\r\n",alert_lvl);
+            APP_LOG1(APP_LOG_ID_IAS_ALERT_LEVEL, alert_lvl);
+#if APP_BLE_CONNECTIONLESS
+            //Lets the monitor see the alert has arrived, so it does not connect again to deliver it
+            APP_PERI_ADV_SetAlertLevel(alert_lvl);
+#endif
             RED_LED_Clear();
             BLUE_LED_Clear();
             GREEN_LED_Clear();
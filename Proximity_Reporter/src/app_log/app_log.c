@@ -0,0 +1,220 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Deferred Log Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_log.c
+
+  Summary:
+    This file contains the Application deferred log for this project.
+
+  Description:
+    This file contains the Application deferred log for this project.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "app_log.h"
+#include "app_uart/app_uart.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LOG_HEADER_SIZE                 (3U)        /* Sync, format ID, argument count */
+#define APP_LOG_RECORD_MAX_SIZE             (APP_LOG_HEADER_SIZE + (APP_LOG_MAX_ARGS * sizeof(int32_t)))
+#define APP_LOG_TEXT_MAX_SIZE               (96U)
+#define APP_LOG_INDEX(idx)                  ((idx) & (APP_LOG_BUFFER_SIZE - 1U))
+
+#if ((APP_LOG_BUFFER_SIZE & (APP_LOG_BUFFER_SIZE - 1U)) != 0U)
+#error "APP_LOG_BUFFER_SIZE must be a power of 2"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static uint8_t              s_logBuf[APP_LOG_BUFFER_SIZE];
+static volatile uint32_t    s_logInIdx;
+static volatile uint32_t    s_logOutIdx;
+static APP_LOG_Stats_T      s_logStats;
+
+#if (!APP_LOG_BINARY_OUTPUT)
+static const char * const   s_logFmt[APP_LOG_ID_TOTAL] =
+{
+#define APP_LOG_FMT(id, fmt)    fmt,
+    APP_LOG_FMT_TABLE
+#undef APP_LOG_FMT
+};
+
+static char                 s_logText[APP_LOG_TEXT_MAX_SIZE];
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_log_Peek(uint32_t idx, uint8_t *p_dst, uint8_t len)
+{
+    uint8_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        p_dst[i] = s_logBuf[APP_LOG_INDEX(idx + i)];
+    }
+}
+
+#if (!APP_LOG_BINARY_OUTPUT)
+static int32_t app_log_GetArg(uint8_t const *p_record, uint8_t argIdx)
+{
+    uint8_t const *p_arg = &p_record[APP_LOG_HEADER_SIZE + (argIdx * sizeof(int32_t))];
+
+    return (int32_t)((uint32_t)p_arg[0] | ((uint32_t)p_arg[1] << 8) | ((uint32_t)p_arg[2] << 16) | ((uint32_t)p_arg[3] << 24));
+}
+#endif
+
+void APP_LOG_Init(void)
+{
+    s_logInIdx = 0;
+    s_logOutIdx = 0;
+    (void)memset(&s_logStats, 0, sizeof(APP_LOG_Stats_T));
+}
+
+void APP_LOG_Write(APP_LOG_Id_T id, uint8_t argc, int32_t arg0, int32_t arg1, int32_t arg2)
+{
+    int32_t args[APP_LOG_MAX_ARGS];
+    uint32_t len, used;
+    uint8_t i, j;
+    bool interruptState;
+
+    if ((id >= APP_LOG_ID_TOTAL) || (argc > APP_LOG_MAX_ARGS))
+    {
+        return;
+    }
+
+    args[0] = arg0;
+    args[1] = arg1;
+    args[2] = arg2;
+    len = APP_LOG_HEADER_SIZE + ((uint32_t)argc * sizeof(int32_t));
+
+    interruptState = NVIC_INT_Disable();
+
+    used = s_logInIdx - s_logOutIdx;
+    if ((APP_LOG_BUFFER_SIZE - used) < len)
+    {
+        s_logStats.dropCnt++;
+        NVIC_INT_Restore(interruptState);
+        return;
+    }
+
+    s_logBuf[APP_LOG_INDEX(s_logInIdx)] = APP_LOG_FRAME_SYNC;
+    s_logBuf[APP_LOG_INDEX(s_logInIdx + 1U)] = (uint8_t)id;
+    s_logBuf[APP_LOG_INDEX(s_logInIdx + 2U)] = argc;
+    for (i = 0; i < argc; i++)
+    {
+        for (j = 0; j < sizeof(int32_t); j++)
+        {
+            s_logBuf[APP_LOG_INDEX(s_logInIdx + APP_LOG_HEADER_SIZE + (i * sizeof(int32_t)) + j)] = (uint8_t)((uint32_t)args[i] >> (8U * j));
+        }
+    }
+
+    //Publish the record only once it is complete
+    s_logInIdx += len;
+    s_logStats.recordCnt++;
+    if ((used + len) > s_logStats.highWater)
+    {
+        s_logStats.highWater = (uint16_t)(used + len);
+    }
+
+    NVIC_INT_Restore(interruptState);
+}
+
+void APP_LOG_Flush(void)
+{
+    uint8_t record[APP_LOG_RECORD_MAX_SIZE];
+    uint32_t len;
+#if (!APP_LOG_BINARY_OUTPUT)
+    int textLen;
+#endif
+
+    while (s_logOutIdx != s_logInIdx)
+    {
+        app_log_Peek(s_logOutIdx, record, APP_LOG_HEADER_SIZE);
+        len = APP_LOG_HEADER_SIZE + ((uint32_t)record[2] * sizeof(int32_t));
+        app_log_Peek(s_logOutIdx, record, (uint8_t)len);
+
+#if (APP_LOG_BINARY_OUTPUT)
+        //Keep the record until the UART can take the whole frame
+        if ((APP_UART_TX_BUFFER_SIZE - APP_UART_GetPendingCnt()) < len)
+        {
+            return;
+        }
+        (void)APP_UART_Write(record, len);
+#else
+        textLen = snprintf(s_logText, sizeof(s_logText), s_logFmt[record[1]],
+            (record[2] > 0U) ? app_log_GetArg(record, 0) : 0,
+            (record[2] > 1U) ? app_log_GetArg(record, 1) : 0,
+            (record[2] > 2U) ? app_log_GetArg(record, 2) : 0);
+        if (textLen < 0)
+        {
+            textLen = 0;
+        }
+        else if ((uint32_t)textLen >= sizeof(s_logText))
+        {
+            textLen = (int)(sizeof(s_logText) - 1U);
+        }
+
+        if ((APP_UART_TX_BUFFER_SIZE - APP_UART_GetPendingCnt()) < (uint32_t)textLen)
+        {
+            return;
+        }
+        (void)APP_UART_Write(s_logText, (size_t)textLen);
+#endif
+
+        s_logOutIdx += len;
+    }
+}
+
+void APP_LOG_GetStats(APP_LOG_Stats_T *p_stats)
+{
+    bool interruptState;
+
+    interruptState = NVIC_INT_Disable();
+    (void)memcpy(p_stats, &s_logStats, sizeof(APP_LOG_Stats_T));
+    NVIC_INT_Restore(interruptState);
+}
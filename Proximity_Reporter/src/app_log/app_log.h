@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Copyright (C) 2022 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Deferred Log Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_log.h
+
+  Summary:
+    This file contains the Application deferred log for this project.
+
+  Description:
+    Call sites record a format ID and up to APP_LOG_MAX_ARGS integer arguments
+    into a RAM ring buffer. Nothing is formatted on the calling task: the
+    records are rendered as text, or sent as binary frames for the host
+    decoder (tools/app_log_decode.py), from the idle task.
+
+    Binary frame: APP_LOG_FRAME_SYNC, format ID, argument count, then each
+    argument as a 32-bit little endian signed integer.
+ *******************************************************************************/
+
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**@brief Set true to send binary frames instead of text. The host decoder turns them back into text. */
+#define APP_LOG_BINARY_OUTPUT               false
+
+#define APP_LOG_BUFFER_SIZE                 (512U)      /**< Size of the record ring buffer, in bytes. Must be a power of 2. */
+#define APP_LOG_MAX_ARGS                    (3U)        /**< Maximum number of arguments of a record. */
+#define APP_LOG_FRAME_SYNC                  (0xA5U)     /**< First byte of a binary frame. */
+
+/**@brief Format table. The host decoder parses the APP_LOG_FMT lines of this file, keep one entry per line
+ *        and only append new entries so the IDs of the logs already captured stay valid. */
+#define APP_LOG_FMT_TABLE \
+    APP_LOG_FMT(APP_LOG_ID_TX_POWER,                "bletxPower: %d\r\n") \
+    APP_LOG_FMT(APP_LOG_ID_ADV_STARTED,             "[BLE] Started Advertising!!!\r\n") \
+    APP_LOG_FMT(APP_LOG_ID_CONNECTED,               "[BLE] Connected\r\n") \
+    APP_LOG_FMT(APP_LOG_ID_DISCONNECTED,            "[BLE] Disconnected 0x%x \r\n") \
+    APP_LOG_FMT(APP_LOG_ID_LLS_ALERT_LEVEL,         "LLS_ALERT_LEVEL: %d\r\n") \
+    APP_LOG_FMT(APP_LOG_ID_IAS_ALERT_LEVEL,         "IAS_ALERT_LEVEL: %d\r\n") \
+    APP_LOG_FMT(APP_LOG_ID_ADV_PHASE,               "[BLE] Advertising phase %d\r\n") \
+    APP_LOG_FMT(APP_LOG_ID_PERI_ADV,                "[BLE] Periodic advertising tx power:%d result:0x%x\r\n")
+
+/**@brief Record a log without argument. */
+#define APP_LOG0(id)                        APP_LOG_Write((id), 0U, 0, 0, 0)
+/**@brief Record a log with one argument. */
+#define APP_LOG1(id, a0)                    APP_LOG_Write((id), 1U, (int32_t)(a0), 0, 0)
+/**@brief Record a log with two arguments. */
+#define APP_LOG2(id, a0, a1)                APP_LOG_Write((id), 2U, (int32_t)(a0), (int32_t)(a1), 0)
+/**@brief Record a log with three arguments. */
+#define APP_LOG3(id, a0, a1, a2)            APP_LOG_Write((id), 3U, (int32_t)(a0), (int32_t)(a1), (int32_t)(a2))
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The definition of the log format IDs. */
+typedef enum APP_LOG_Id_T
+{
+#define APP_LOG_FMT(id, fmt)    id,
+    APP_LOG_FMT_TABLE
+#undef APP_LOG_FMT
+    APP_LOG_ID_TOTAL
+} APP_LOG_Id_T;
+
+/**@brief Statistics of the deferred log. */
+typedef struct APP_LOG_Stats_T
+{
+    uint32_t    recordCnt;          /**< Records written into the ring buffer. */
+    uint32_t    dropCnt;            /**< Records dropped because the ring buffer was full. */
+    uint16_t    highWater;          /**< Highest number of bytes pending in the ring buffer. */
+} APP_LOG_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**@brief The function is used to initialize the deferred log.
+ */
+void APP_LOG_Init(void);
+
+/**@brief The function is used to record a log. Use the APP_LOG0 ~ APP_LOG3 macros instead of calling it directly.
+ *        It never blocks and is safe to call from any task or interrupt.
+ *@param[in] id                               Format ID. See @ref APP_LOG_Id_T.
+ *@param[in] argc                             Number of valid arguments.
+ *@param[in] arg0                             First argument.
+ *@param[in] arg1                             Second argument.
+ *@param[in] arg2                             Third argument.
+ *
+ */
+void APP_LOG_Write(APP_LOG_Id_T id, uint8_t argc, int32_t arg0, int32_t arg1, int32_t arg2);
+
+/**@brief The function is used to move the pending records to the UART. Called from the idle task.
+ */
+void APP_LOG_Flush(void);
+
+/**@brief The function is used to get a snapshot of the deferred log statistics.
+ *@param[out] p_stats                         Pointer to the statistics buffer.
+ *
+ */
+void APP_LOG_GetStats(APP_LOG_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_LOG_H */
+
+
+/*******************************************************************************
+ End of File
+ */
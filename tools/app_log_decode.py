@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Decode the binary deferred log stream of the Proximity Monitor/Reporter.
+
+The firmware sends binary frames when APP_LOG_BINARY_OUTPUT is true in
+src/app_log/app_log.h. Each frame is:
+
+    0xA5 | format ID | argument count | argument * count (int32, little endian)
+
+The format strings are read from the APP_LOG_FMT_TABLE of the app_log.h the
+firmware was built with.
+
+Usage:
+    stty -F /dev/ttyUSB0 115200 raw
+    app_log_decode.py Proximity_Monitor/src/app_log/app_log.h /dev/ttyUSB0
+    app_log_decode.py Proximity_Reporter/src/app_log/app_log.h capture.bin
+"""
+
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+MAX_ARGS = 3
+
+FMT_RE = re.compile(r'APP_LOG_FMT\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+
+
+def load_formats(header_path):
+    with open(header_path, encoding='utf-8') as f:
+        text = f.read()
+    formats = []
+    for name, fmt in FMT_RE.findall(text):
+        formats.append((name, fmt.encode('latin-1').decode('unicode_escape')))
+    if not formats:
+        sys.exit('no APP_LOG_FMT entries found in %s' % header_path)
+    return formats
+
+
+def render(fmt, args):
+    # The firmware only logs integers: map the C conversions onto Python ones
+    py_fmt = re.sub(r'%([-+ 0#]*\d*)(?:l|h|hh)?([diuxXc])',
+                    lambda m: '%' + m.group(1) + ('d' if m.group(2) in 'iu' else m.group(2)), fmt)
+    values = []
+    for conv, arg in zip(re.findall(r'%[-+ 0#]*\d*([dxXc])', py_fmt), args):
+        values.append(arg & 0xFFFFFFFF if conv in 'xX' else arg)
+    try:
+        return py_fmt % tuple(values)
+    except (TypeError, ValueError):
+        return '%s %r\n' % (fmt.strip(), args)
+
+
+def decode(stream, formats, out):
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf += chunk
+        while True:
+            start = buf.find(bytes([FRAME_SYNC]))
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) < 3:
+                break
+            fmt_id, argc = buf[1], buf[2]
+            if fmt_id >= len(formats) or argc > MAX_ARGS:
+                # Not a frame header, resynchronize on the next sync byte
+                del buf[:1]
+                continue
+            size = 3 + 4 * argc
+            if len(buf) < size:
+                break
+            args = struct.unpack_from('<%di' % argc, buf, 3)
+            del buf[:size]
+            out.write(render(formats[fmt_id][1], args))
+            out.flush()
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    formats = load_formats(sys.argv[1])
+    source = sys.stdin.buffer if sys.argv[2] == '-' else open(sys.argv[2], 'rb', buffering=0)
+    try:
+        decode(source, formats, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
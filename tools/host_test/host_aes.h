@@ -0,0 +1,143 @@
+/*
+ * Software AES-128 behind the crypto.h entry points mw_aes.c uses.
+ *
+ * Like the device library, the key schedule is expanded once in
+ * CRYPT_AES_KeySet and stored in the caller's CRYPT_AES_CTX, so the host
+ * cost split between key setup and block encryption follows the target.
+ * Include once per test binary that builds mw_aes.c.
+ */
+
+#ifndef HOST_AES_H
+#define HOST_AES_H
+
+#include <stdint.h>
+#include <string.h>
+#include "crypto/crypto.h"
+
+typedef struct
+{
+    uint8_t roundKey[176];
+} HT_AesSchedule_T;
+
+typedef char ht_AesCtxSizeCheck[(sizeof(HT_AesSchedule_T) <= sizeof(CRYPT_AES_CTX)) ? 1 : -1];
+
+static const uint8_t s_htAesSbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static inline uint8_t ht_AesXtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ (((x >> 7) & 1U) * 0x1bU));
+}
+
+int CRYPT_AES_KeySet(CRYPT_AES_CTX *aes, const unsigned char *key, unsigned int keyLen, const unsigned char *iv, int dir)
+{
+    HT_AesSchedule_T *p_sched = (HT_AesSchedule_T *)aes;
+    uint8_t rcon = 0x01;
+    uint8_t t[4], tmp;
+    unsigned i;
+
+    (void)iv;
+    if ((keyLen != 16U) || (dir != CRYPT_AES_ENCRYPTION))
+    {
+        return -1;
+    }
+
+    memcpy(p_sched->roundKey, key, 16);
+    for (i = 16; i < 176U; i += 4U)
+    {
+        memcpy(t, &p_sched->roundKey[i - 4U], 4);
+        if ((i % 16U) == 0U)
+        {
+            tmp = t[0];
+            t[0] = (uint8_t)(s_htAesSbox[t[1]] ^ rcon);
+            t[1] = s_htAesSbox[t[2]];
+            t[2] = s_htAesSbox[t[3]];
+            t[3] = s_htAesSbox[tmp];
+            rcon = ht_AesXtime(rcon);
+        }
+        p_sched->roundKey[i + 0U] = p_sched->roundKey[i - 16U] ^ t[0];
+        p_sched->roundKey[i + 1U] = p_sched->roundKey[i - 15U] ^ t[1];
+        p_sched->roundKey[i + 2U] = p_sched->roundKey[i - 14U] ^ t[2];
+        p_sched->roundKey[i + 3U] = p_sched->roundKey[i - 13U] ^ t[3];
+    }
+
+    return 0;
+}
+
+int CRYPT_AES_DIRECT_Encrypt(CRYPT_AES_CTX *aes, unsigned char *out, const unsigned char *in)
+{
+    const HT_AesSchedule_T *p_sched = (const HT_AesSchedule_T *)aes;
+    uint8_t s[16], a0, a1, a2, a3, all;
+    unsigned round, i, c;
+
+    for (i = 0; i < 16U; i++)
+    {
+        s[i] = in[i] ^ p_sched->roundKey[i];
+    }
+
+    for (round = 1; round <= 10U; round++)
+    {
+        //SubBytes and ShiftRows, the state is column major
+        uint8_t r[16];
+
+        for (c = 0; c < 4U; c++)
+        {
+            for (i = 0; i < 4U; i++)
+            {
+                r[c * 4U + i] = s_htAesSbox[s[((c + i) % 4U) * 4U + i]];
+            }
+        }
+
+        if (round != 10U)
+        {
+            for (c = 0; c < 4U; c++)
+            {
+                a0 = r[c * 4U];
+                a1 = r[c * 4U + 1U];
+                a2 = r[c * 4U + 2U];
+                a3 = r[c * 4U + 3U];
+                all = a0 ^ a1 ^ a2 ^ a3;
+                r[c * 4U]      ^= all ^ ht_AesXtime(a0 ^ a1);
+                r[c * 4U + 1U] ^= all ^ ht_AesXtime(a1 ^ a2);
+                r[c * 4U + 2U] ^= all ^ ht_AesXtime(a2 ^ a3);
+                r[c * 4U + 3U] ^= all ^ ht_AesXtime(a3 ^ a0);
+            }
+        }
+
+        for (i = 0; i < 16U; i++)
+        {
+            s[i] = r[i] ^ p_sched->roundKey[round * 16U + i];
+        }
+    }
+
+    memcpy(out, s, 16);
+    return 0;
+}
+
+int CRYPT_AES_CBC_Decrypt(CRYPT_AES_CTX *aes, unsigned char *out, const unsigned char *in, unsigned int inSz)
+{
+    (void)aes;
+    (void)out;
+    (void)in;
+    (void)inSz;
+    return -1;
+}
+
+#endif /* HOST_AES_H */
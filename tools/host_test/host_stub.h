@@ -0,0 +1,81 @@
+/*
+ * RTOS, OSAL and logging stand-ins for the host tests.
+ *
+ * Include once per test binary, after app.h. Queued application messages are
+ * captured in g_htMsg; the FreeRTOS tick is whatever the test sets g_htTick to.
+ * Define HT_NO_LOG_STUB when the test builds app_log.c itself.
+ */
+
+#ifndef HOST_STUB_H
+#define HOST_STUB_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HT_MSG_MAX      256
+
+/* The reporter OSAL takes the queue timeout as uint16_t */
+#ifndef HT_OSAL_WAIT_T
+#define HT_OSAL_WAIT_T  uint32_t
+#endif
+
+APP_DATA        appData;
+APP_Msg_T       g_htMsg[HT_MSG_MAX];
+unsigned        g_htMsgCnt;
+bool            g_htQueueFull;
+TickType_t      g_htTick;
+unsigned        g_htMallocCnt;
+
+void *OSAL_Malloc(size_t size)
+{
+    g_htMallocCnt++;
+    return malloc(size);
+}
+
+void OSAL_Free(void *pData)
+{
+    free(pData);
+}
+
+OSAL_RESULT OSAL_QUEUE_Send(OSAL_QUEUE_HANDLE_TYPE *queID, void *itemToQueue, HT_OSAL_WAIT_T waitMS)
+{
+    (void)queID;
+    (void)waitMS;
+
+    if (g_htQueueFull || (g_htMsgCnt >= HT_MSG_MAX))
+    {
+        return OSAL_RESULT_FALSE;
+    }
+    memcpy(&g_htMsg[g_htMsgCnt++], itemToQueue, sizeof(APP_Msg_T));
+    return OSAL_RESULT_TRUE;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return g_htTick;
+}
+
+static inline void ht_ClearMsg(void)
+{
+    g_htMsgCnt = 0;
+}
+
+#ifndef HT_NO_LOG_STUB
+#include "app_log/app_log.h"
+
+unsigned        g_htLogCnt;
+int             g_htLogLastId = -1;
+
+void APP_LOG_Write(APP_LOG_Id_T id, uint8_t argc, int32_t arg0, int32_t arg1, int32_t arg2)
+{
+    (void)argc;
+    (void)arg0;
+    (void)arg1;
+    (void)arg2;
+    g_htLogCnt++;
+    g_htLogLastId = (int)id;
+}
+#endif
+
+#endif /* HOST_STUB_H */
@@ -0,0 +1,72 @@
+/*
+ * Check and timing helpers shared by the host tests.
+ *
+ * A test binary includes the firmware sources it covers, provides the stack
+ * and RTOS functions they call, and returns ht_Finish() from main().
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static unsigned s_htCheckCnt;
+static unsigned s_htFailCnt;
+
+#define HT_CHECK(cond)                                                              \
+    do {                                                                            \
+        s_htCheckCnt++;                                                             \
+        if (!(cond)) {                                                              \
+            s_htFailCnt++;                                                          \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+        }                                                                           \
+    } while (0)
+
+#define HT_CHECK_EQ(actual, expected)                                               \
+    do {                                                                            \
+        long long ht_a = (long long)(actual);                                       \
+        long long ht_e = (long long)(expected);                                     \
+        s_htCheckCnt++;                                                             \
+        if (ht_a != ht_e) {                                                         \
+            s_htFailCnt++;                                                          \
+            printf("%s:%d: %s is %lld, expected %lld\n",                            \
+                   __FILE__, __LINE__, #actual, ht_a, ht_e);                        \
+        }                                                                           \
+    } while (0)
+
+static inline uint64_t ht_NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Deterministic xorshift32, so failures reproduce from the printed seed. */
+static uint32_t s_htRandState = 0x2545F491U;
+
+static inline void ht_Seed(uint32_t seed)
+{
+    s_htRandState = (seed != 0U) ? seed : 0x2545F491U;
+}
+
+static inline uint32_t ht_Rand(void)
+{
+    uint32_t x = s_htRandState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_htRandState = x;
+    return x;
+}
+
+static inline int ht_Finish(const char *name)
+{
+    printf("%s: %u checks, %u failed\n", name, s_htCheckCnt, s_htFailCnt);
+    return (s_htFailCnt == 0U) ? 0 : 1;
+}
+
+#endif /* HOST_TEST_H */
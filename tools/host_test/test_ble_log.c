@@ -0,0 +1,616 @@
+/*
+ * Host test and benchmark of the HCI log encoder (ble_log.c).
+ *
+ * - Replay of a recorded BT_SYS_LogEvent_T stream: every packet handed to
+ *   the log callback must match, byte for byte, what the heap based encoder
+ *   produced for the same stream (traces/hci_log_stream.expected).
+ * - No OSAL_Malloc on the logging path, and every byte of a packet is
+ *   written by its packer (the static buffer does not leak older packets).
+ * - Packets larger than the packet buffer are skipped, not truncated.
+ * - LE Transmitter Test v4 with a full antenna switching pattern.
+ * - Encoding cost in ns per log event.
+ *
+ * traces/hci_log_stream.txt covers every command, event and LE meta event
+ * ble_log.c packs, plus ACL packets up to 251 bytes. To regenerate it, and
+ * the expected output from another encoder revision:
+ *     build/test_ble_log --gen > traces/hci_log_stream.txt
+ *     make build/ble_log_ref BLE_LOG_REF=<rev>
+ *     build/ble_log_ref --record < traces/hci_log_stream.txt > traces/hci_log_stream.expected
+ * The expected output was recorded from the heap based encoder of the
+ * baseline revision.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+
+#ifndef HT_BLE_LOG_SRC
+#define HT_BLE_LOG_SRC          "ble/middleware_ble/ble_log/ble_log.c"
+#endif
+#include HT_BLE_LOG_SRC
+
+#define STREAM_FILE             "traces/hci_log_stream.txt"
+#define EXPECTED_FILE           "traces/hci_log_stream.expected"
+#define EVT_MAX                 1024
+#define PAYLOAD_MAX             1024    /* Larger than any HCI structure the packers read */
+#define OUT_MAX                 2048
+#define GEN_VARIANTS            3
+#define BENCH_ROUNDS            2000
+
+/* Count field the packers trust, bounded by the array it describes */
+#define HT_SET_COUNT(p_evt, type, cnt, array) \
+    ((p_evt)->payload[offsetof(type, cnt)] = (uint8_t)(ht_Rand() % ((sizeof(((type *)0)->array) / sizeof(((type *)0)->array[0])) + 1U)))
+
+typedef struct
+{
+    uint16_t    logType;
+    uint16_t    logId;
+    uint16_t    paramsLength;
+    uint16_t    payloadLen;
+    uint16_t    returnLen;
+    uint8_t     payload[PAYLOAD_MAX];
+    uint8_t     returnParams[PAYLOAD_MAX];
+} StreamEvt_T;
+
+typedef struct
+{
+    uint8_t     type;
+    uint16_t    len;
+    uint8_t     data[300];
+} OutPkt_T;
+
+static StreamEvt_T s_evt[EVT_MAX];
+static unsigned s_evtCnt;
+static OutPkt_T s_out[OUT_MAX];
+static unsigned s_outCnt;
+static unsigned s_outDropCnt;
+
+static void ht_LogCb(uint8_t logType, uint16_t logLength, uint8_t *p_logPayload)
+{
+    if ((s_outCnt >= OUT_MAX) || (logLength > sizeof(s_out[0].data)))
+    {
+        s_outDropCnt++;
+        return;
+    }
+
+    s_out[s_outCnt].type = logType;
+    s_out[s_outCnt].len = logLength;
+    memcpy(s_out[s_outCnt].data, p_logPayload, logLength);
+    s_outCnt++;
+}
+
+/* The stack hands over heap buffers which BLE_LOG_StackLogHandler frees */
+static void ht_Feed(const StreamEvt_T *p_evt)
+{
+    BT_SYS_LogEvent_T *p_log = malloc(sizeof(BT_SYS_LogEvent_T));
+
+    p_log->logType = p_evt->logType;
+    p_log->logId = p_evt->logId;
+    p_log->paramsLength = p_evt->paramsLength;
+    p_log->payloadLength = p_evt->payloadLen;
+    p_log->p_logPayload = NULL;
+    p_log->p_returnParams = NULL;
+
+    if ((p_evt->payloadLen != 0U) || (p_evt->logType == BT_SYS_LOG_TYPE_HCI_COMMAND) || (p_evt->logType == BT_SYS_LOG_TYPE_HCI_EVENT))
+    {
+        p_log->p_logPayload = calloc(1, PAYLOAD_MAX);
+        memcpy(p_log->p_logPayload, p_evt->payload, p_evt->payloadLen);
+    }
+    if (p_evt->returnLen != 0U)
+    {
+        p_log->p_returnParams = calloc(1, PAYLOAD_MAX);
+        memcpy(p_log->p_returnParams, p_evt->returnParams, p_evt->returnLen);
+    }
+
+    BLE_LOG_StackLogHandler(p_log);
+}
+
+static unsigned ht_ParseHex(const char *p_str, uint8_t *p_buf, unsigned max)
+{
+    unsigned len = 0, byte;
+
+    if (strcmp(p_str, "-") == 0)
+    {
+        return 0;
+    }
+    while ((p_str[0] != '\0') && (p_str[1] != '\0') && (len < max) && (sscanf(p_str, "%2x", &byte) == 1))
+    {
+        p_buf[len++] = (uint8_t)byte;
+        p_str += 2;
+    }
+    return len;
+}
+
+static void ht_PrintHex(FILE *p_file, const uint8_t *p_buf, unsigned len)
+{
+    unsigned i;
+
+    if (len == 0U)
+    {
+        fputc('-', p_file);
+    }
+    for (i = 0; i < len; i++)
+    {
+        fprintf(p_file, "%02x", p_buf[i]);
+    }
+}
+
+static bool ht_LoadStream(FILE *p_file)
+{
+    static char line[8192];
+    static char payload[4096], ret[4096];
+    unsigned type, id, paramsLen;
+    StreamEvt_T *p_evt;
+
+    s_evtCnt = 0;
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        if ((line[0] == '#') || (line[0] == '\n') || (s_evtCnt >= EVT_MAX))
+        {
+            continue;
+        }
+        if (sscanf(line, "%x %x %x %4095s %4095s", &type, &id, &paramsLen, payload, ret) != 5)
+        {
+            return false;
+        }
+        p_evt = &s_evt[s_evtCnt++];
+        memset(p_evt, 0, sizeof(StreamEvt_T));
+        p_evt->logType = (uint16_t)type;
+        p_evt->logId = (uint16_t)id;
+        p_evt->paramsLength = (uint16_t)paramsLen;
+        p_evt->payloadLen = (uint16_t)ht_ParseHex(payload, p_evt->payload, PAYLOAD_MAX);
+        p_evt->returnLen = (uint16_t)ht_ParseHex(ret, p_evt->returnParams, PAYLOAD_MAX);
+    }
+    return (s_evtCnt != 0U);
+}
+
+static void ht_Replay(void)
+{
+    unsigned i;
+
+    s_outCnt = 0;
+    s_outDropCnt = 0;
+    BLE_LOG_EventRegister(ht_LogCb);
+    for (i = 0; i < s_evtCnt; i++)
+    {
+        ht_Feed(&s_evt[i]);
+    }
+}
+
+/* Stream generator: random field values, with the length fields the packers trust kept in range */
+static void ht_GenEvt(uint16_t logType, uint16_t logId, unsigned payloadLen, unsigned paramsLength)
+{
+    StreamEvt_T *p_evt = &s_evt[s_evtCnt++];
+    unsigned i;
+
+    memset(p_evt, 0, sizeof(StreamEvt_T));
+    p_evt->logType = logType;
+    p_evt->logId = logId;
+    p_evt->payloadLen = (uint16_t)payloadLen;
+    for (i = 0; i < payloadLen; i++)
+    {
+        p_evt->payload[i] = (uint8_t)ht_Rand();
+    }
+
+    if ((logType == BT_SYS_LOG_TYPE_HCI_COMMAND) && (paramsLength != 0U))
+    {
+        //Return parameters as the stack reports them: status first
+        p_evt->paramsLength = (uint16_t)paramsLength;
+        p_evt->returnLen = (uint16_t)paramsLength;
+        for (i = 0; i < paramsLength; i++)
+        {
+            p_evt->returnParams[i] = (uint8_t)ht_Rand();
+        }
+        p_evt->returnParams[0] = ((ht_Rand() % 4U) == 0U) ? (uint8_t)(ht_Rand() & 0x3FU) : 0U;
+    }
+}
+
+static unsigned ht_CcParamsLength(uint8_t ogf, uint16_t ocf)
+{
+    static const struct { uint8_t ogf; uint16_t ocf; uint8_t size; } ccSize[] =
+    {
+        { HCI_HC,       HCI_READ_AUTHENTICATED_PAYLOAD_TIMEOUT,         HCI_CC_EVT_SIZE_READ_AUTH_PAYLOAD_TO },
+        { HCI_HC,       HCI_WRITE_AUTHENTICATED_PAYLOAD_TIMEOUT,        HCI_CC_EVT_SIZE_WRITE_AUTH_PAYLOAD_TO },
+        { HCI_IP,       HCI_READ_BD_ADDR,                               HCI_CC_EVT_SIZE_READ_BD_ADDR },
+        { HCI_SP,       HCI_READ_RSSI,                                  HCI_CC_EVT_SIZE_READ_RSSI },
+        { HCI_LE_CTRL,  HCI_LE_READ_CHANNEL_MAP,                        HCI_CC_EVT_SIZE_READ_CHANNEL_MAP },
+        { HCI_LE_CTRL,  HCI_LE_LONG_TERM_KEY_REQ_REPLY,                 HCI_CC_EVT_SIZE_LTK_REQUEST_REPLY },
+        { HCI_LE_CTRL,  HCI_LE_LONG_TERM_KEY_REQ_NEGATIVE_REPLY,        HCI_CC_EVT_SIZE_LTK_REQUEST_NEGATIVE_REPLY },
+        { HCI_LE_CTRL,  HCI_LE_TEST_END,                                HCI_CC_EVT_SIZE_TEST_END },
+        { HCI_LE_CTRL,  HCI_LE_REMOTE_CONN_PARAM_REQ_REPLY,             HCI_CC_EVT_SIZE_REMOTE_CONN_PARAM_REQ_REPLY },
+        { HCI_LE_CTRL,  HCI_LE_REMOTE_CONN_PARAM_REQ_NEGATIVE_REPLY,    HCI_CC_EVT_SIZE_REMOTE_CONN_PARAM_REQ_NEG_REPLY },
+        { HCI_LE_CTRL,  HCI_LE_SET_DATA_LENGTH,                         HCI_CC_EVT_SIZE_SET_DATA_LENGTH },
+        { HCI_LE_CTRL,  HCI_LE_READ_PHY,                                HCI_CC_EVT_SIZE_READ_PHY },
+        { HCI_LE_CTRL,  HCI_LE_SET_EXTENDED_ADVERTISING_PARAM,          HCI_CC_EVT_SIZE_SET_EXT_ADV_PARAMS },
+        { HCI_LE_CTRL,  HCI_LE_READ_TRANSMIT_POWER,                     HCI_CC_EVT_SIZE_READ_TRANSMIT_POWER },
+        { HCI_LE_CTRL,  HCI_LE_ENHANCED_READ_TRANSMIT_POWER_LEVEL,      HCI_CC_EVT_SIZE_ENHANCED_READ_TRANSMIT_POWER },
+        { HCI_LE_CTRL,  HCI_LE_SET_PATH_LOSS_REPORTING_PARAMS,          HCI_CC_EVT_SIZE_SET_PASS_LOSS_REPORTING_PARAMS },
+        { HCI_LE_CTRL,  HCI_LE_SET_PATH_LOSS_REPORTING_ENABLE,          HCI_CC_EVT_SIZE_SET_PASS_LOSS_REPORTING_ENABLE },
+        { HCI_LE_CTRL,  HCI_LE_SET_TRANSMIT_POWER_REPORTING_ENABLE,     HCI_CC_EVT_SIZE_SET_TRANSMIT_POWER_REPORTING_ENABLE },
+    };
+    unsigned i;
+
+    for (i = 0; i < (sizeof(ccSize) / sizeof(ccSize[0])); i++)
+    {
+        if ((ccSize[i].ogf == ogf) && (ccSize[i].ocf == ocf))
+        {
+            return ccSize[i].size;
+        }
+    }
+    return HCI_CC_EVT_SIZE_STATUS;
+}
+
+static void ht_GenCmd(uint8_t ogf, uint16_t ocf)
+{
+    StreamEvt_T *p_evt;
+    unsigned v;
+
+    for (v = 0; v < GEN_VARIANTS; v++)
+    {
+        ht_GenEvt(BT_SYS_LOG_TYPE_HCI_COMMAND, (uint16_t)((ogf << 10) | ocf),
+            (2U * ble_log_GetHciCommandParametersSize(ogf, ocf)) + 16U, ht_CcParamsLength(ogf, ocf));
+        p_evt = &s_evt[s_evtCnt - 1U];
+
+        if (ogf != HCI_LE_CTRL)
+        {
+            continue;
+        }
+        if (ocf == HCI_LE_SET_EXTENDED_ADVERTISING_DATA)
+        {
+            HT_SET_COUNT(p_evt, HCI_LE_SetExtAdvertisingData_T, advLen, advData);
+        }
+        else if (ocf == HCI_LE_SET_EXTENDED_SCAN_RSP_DATA)
+        {
+            HT_SET_COUNT(p_evt, HCI_LE_SetExtScanRespData_T, scanRspLen, scanRspData);
+        }
+        else if (ocf == HCI_LE_SET_EXTENDED_ADVERTISING_ENABLE)
+        {
+            HT_SET_COUNT(p_evt, HCI_LE_SetExtAdvertisingEnable_T, numOfSets, advSet);
+        }
+        else if (ocf == HCI_LE_SET_PERIODIC_ADVERTISING_DATA)
+        {
+            HT_SET_COUNT(p_evt, HCI_LE_SetPeriodicAdvertisingData_T, advLen, advData);
+        }
+        else if (ocf == HCI_LE_TRANSMITTER_TEST_V4)
+        {
+            //The heap based encoder sized this command for an empty switching pattern, see test_SwitchingPattern()
+            p_evt->payload[offsetof(HCI_LE_TransmitterTestV4_T, switchingPatternLen)] = 0U;
+        }
+    }
+}
+
+static void ht_GenEvtCode(uint8_t evtCode, uint8_t subEvtCode, unsigned paramsSize)
+{
+    StreamEvt_T *p_evt;
+    unsigned v;
+
+    for (v = 0; v < GEN_VARIANTS; v++)
+    {
+        ht_GenEvt(BT_SYS_LOG_TYPE_HCI_EVENT, (uint16_t)(evtCode | (subEvtCode << 8)), (2U * paramsSize) + 16U, 0U);
+        p_evt = &s_evt[s_evtCnt - 1U];
+
+        if (evtCode == HCI_NBR_OF_COMPLETED_PACKETS)
+        {
+            HT_SET_COUNT(p_evt, HCI_EvtNumOfCompletePacket_T, numHandles, completePacket);
+        }
+        else if (subEvtCode == HCI_LE_ADVERTISING_REPORT)
+        {
+            HT_SET_COUNT(p_evt, HCI_EvtLeAdvReport_T, reports[0].advLength, reports[0].advData);
+        }
+        else if (subEvtCode == HCI_LE_EXTENDED_ADVERTISING_REPORT)
+        {
+            HT_SET_COUNT(p_evt, HCI_EvtLeExtAdvReport_T, reports[0].advLength, reports[0].advData);
+        }
+        else if (subEvtCode == HCI_LE_PERIODIC_ADVERTISING_REPORT)
+        {
+            HT_SET_COUNT(p_evt, HCI_EvtLePeriodicAdvReport_T, advLength, advData);
+        }
+    }
+}
+
+static void ht_Generate(void)
+{
+    StreamEvt_T *p_evt;
+    unsigned i, len;
+
+    ht_Seed(0xB1E106U);
+    s_evtCnt = 0;
+
+    for (i = 0; i < (sizeof(s_hciCmdFun) / sizeof(s_hciCmdFun[0])); i++)
+    {
+        if (s_hciCmdFun[i] != NULL)
+        {
+            ht_GenCmd(HCI_LE_CTRL, (uint16_t)i);
+        }
+    }
+    ht_GenCmd(HCI_LC, HCI_DISCONNECT);
+    ht_GenCmd(HCI_HC, HCI_READ_AUTHENTICATED_PAYLOAD_TIMEOUT);
+    ht_GenCmd(HCI_HC, HCI_WRITE_AUTHENTICATED_PAYLOAD_TIMEOUT);
+    ht_GenCmd(HCI_IP, HCI_READ_BD_ADDR);
+    ht_GenCmd(HCI_SP, HCI_READ_RSSI);
+
+    ht_GenEvtCode(HCI_DISCONNECTION_COMPLETE, 0, HCI_EVT_SIZE_DISCONNECTION);
+    ht_GenEvtCode(HCI_ENCRYPTION_CHANGE, 0, HCI_EVT_SIZE_ENCRYPTION_CHANGE);
+    ht_GenEvtCode(HCI_READ_REMOTE_VERSION_INFORMATION_COMPLETE, 0, HCI_EVT_SIZE_REMOTE_VERSION_INFORMATION_COMPLETE);
+    ht_GenEvtCode(HCI_NBR_OF_COMPLETED_PACKETS, 0, sizeof(HCI_EvtNumOfCompletePacket_T));
+    ht_GenEvtCode(HCI_ENCRYPTION_KEY_REFRESH_COMPLETE, 0, HCI_EVT_SIZE_KEY_REFRESH_COMPLETE);
+    ht_GenEvtCode(HCI_AUTHENTICATED_PAYLOAD_TIMEOUT_EXPIRED, 0, HCI_EVT_SIZE_AUTH_PAYLOAD_TO_EXPIRED);
+    for (i = 0; i < (sizeof(s_hciLeMetaEvtFun) / sizeof(s_hciLeMetaEvtFun[0])); i++)
+    {
+        if (s_hciLeMetaEvtFun[i] != NULL)
+        {
+            ht_GenEvtCode(HCI_LE_META_EVENT, (uint8_t)i, s_hciLeMetaEvtSize[i]);
+        }
+    }
+
+    //ACL traffic in both directions, empty to the largest LE data PDU
+    for (i = 0; i < 24U; i++)
+    {
+        len = (i < 2U) ? (i * 251U) : (ht_Rand() % 252U);
+        ht_GenEvt((i & 1U) ? BT_SYS_LOG_TYPE_HCI_ACL_RX : BT_SYS_LOG_TYPE_HCI_ACL_TX, (uint16_t)(ht_Rand() & 0x0EFFU), len, 0U);
+    }
+
+    printf("# HCI log stream for test_ble_log.c, generated by test_ble_log --gen.\n");
+    printf("# <logType> <logId> <paramsLength> <payload> <returnParams>, hex; '-' is no buffer.\n");
+    for (i = 0; i < s_evtCnt; i++)
+    {
+        p_evt = &s_evt[i];
+        printf("%04x %04x %x ", p_evt->logType, p_evt->logId, p_evt->paramsLength);
+        ht_PrintHex(stdout, p_evt->payload, p_evt->payloadLen);
+        fputc(' ', stdout);
+        ht_PrintHex(stdout, p_evt->returnParams, p_evt->returnLen);
+        fputc('\n', stdout);
+    }
+}
+
+static void ht_Record(void)
+{
+    unsigned i;
+
+    ht_Replay();
+    printf("# Output of the HCI log encoder for hci_log_stream.txt: <logType> <logLength> <packet>, hex.\n");
+    for (i = 0; i < s_outCnt; i++)
+    {
+        printf("%x %x ", s_out[i].type, s_out[i].len);
+        ht_PrintHex(stdout, s_out[i].data, s_out[i].len);
+        fputc('\n', stdout);
+    }
+}
+
+static void test_ByteExact(void)
+{
+    static char line[4096], hex[4096];
+    static uint8_t data[1024];
+    unsigned type, len, i = 0, mismatchCnt = 0;
+    FILE *p_file = fopen(EXPECTED_FILE, "r");
+
+    HT_CHECK(p_file != NULL);
+    if (p_file == NULL)
+    {
+        return;
+    }
+
+    ht_Replay();
+    HT_CHECK_EQ(s_outDropCnt, 0);
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        if (line[0] == '#')
+        {
+            continue;
+        }
+        if ((sscanf(line, "%x %x %4095s", &type, &len, hex) != 3) || (i >= s_outCnt))
+        {
+            mismatchCnt++;
+            i++;
+            continue;
+        }
+        if ((s_out[i].type != type) || (s_out[i].len != len)
+            || (ht_ParseHex(hex, data, sizeof(data)) != len) || (memcmp(s_out[i].data, data, len) != 0))
+        {
+            if (mismatchCnt < 5U)
+            {
+                printf("  packet %u differs: type %x len %u, expected type %x len %u\n", i, s_out[i].type, s_out[i].len, type, len);
+            }
+            mismatchCnt++;
+        }
+        i++;
+    }
+    fclose(p_file);
+
+    HT_CHECK_EQ(mismatchCnt, 0);
+    HT_CHECK_EQ(s_outCnt, i);
+    printf("  replay: %u log events, %u packets, all byte-exact\n", s_evtCnt, i);
+}
+
+static void test_NoHeapUse(void)
+{
+    unsigned mallocCnt = g_htMallocCnt;
+
+    ht_Replay();
+    HT_CHECK_EQ(g_htMallocCnt - mallocCnt, 0);
+}
+
+#ifdef BLE_LOG_PACKET_BUF_SIZE
+/* A byte the packer leaves unwritten would carry the previous packet through the shared buffer */
+static void test_EveryByteWritten(void)
+{
+    static OutPkt_T first[OUT_MAX];
+    unsigned firstCnt, i, diffCnt = 0;
+
+    memset(s_logPacketBuf, 0x00, sizeof(s_logPacketBuf));
+    ht_Replay();
+    memcpy(first, s_out, sizeof(first));
+    firstCnt = s_outCnt;
+
+    BLE_LOG_EventRegister(ht_LogCb);
+    s_outCnt = 0;
+    for (i = 0; i < s_evtCnt; i++)
+    {
+        memset(s_logPacketBuf, 0xA5, sizeof(s_logPacketBuf));
+        ht_Feed(&s_evt[i]);
+    }
+
+    HT_CHECK_EQ(s_outCnt, firstCnt);
+    for (i = 0; (i < firstCnt) && (i < s_outCnt); i++)
+    {
+        if ((first[i].len != s_out[i].len) || (memcmp(first[i].data, s_out[i].data, first[i].len) != 0))
+        {
+            diffCnt++;
+        }
+    }
+    HT_CHECK_EQ(diffCnt, 0);
+}
+
+static void test_Oversized(void)
+{
+    StreamEvt_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.logType = BT_SYS_LOG_TYPE_HCI_ACL_TX;
+    evt.logId = 0x0001;
+
+    //The largest packet fits, one byte more is skipped
+    BLE_LOG_EventRegister(ht_LogCb);
+    s_outCnt = 0;
+    evt.payloadLen = BLE_LOG_PACKET_BUF_SIZE - HCI_ACL_HEADER_SIZE - HCI_ACL_PKT_PARAMETER_LENGTH_SIZE;
+    ht_Feed(&evt);
+    HT_CHECK_EQ(s_outCnt, 1);
+    evt.payloadLen++;
+    ht_Feed(&evt);
+    HT_CHECK_EQ(s_outCnt, 1);
+}
+
+/* The heap based encoder allocated the command for an empty pattern and wrote the antenna IDs past it */
+static void test_SwitchingPattern(void)
+{
+    StreamEvt_T evt;
+    HCI_LE_TransmitterTestV4_T *p_cmd = (HCI_LE_TransmitterTestV4_T *)evt.payload;
+    unsigned i;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.logType = BT_SYS_LOG_TYPE_HCI_COMMAND;
+    evt.logId = (uint16_t)((HCI_LE_CTRL << 10) | HCI_LE_TRANSMITTER_TEST_V4);
+    evt.payloadLen = sizeof(HCI_LE_TransmitterTestV4_T);
+    evt.paramsLength = HCI_CC_EVT_SIZE_STATUS;
+    evt.returnLen = HCI_CC_EVT_SIZE_STATUS;
+    p_cmd->switchingPatternLen = HCI_LE_TRANSMITTER_SPL_MAX;
+    for (i = 0; i < HCI_LE_TRANSMITTER_SPL_MAX; i++)
+    {
+        p_cmd->antennaIds[i] = (uint8_t)i;
+    }
+    p_cmd->txPowerLevel = 0x7E;
+
+    BLE_LOG_EventRegister(ht_LogCb);
+    s_outCnt = 0;
+    ht_Feed(&evt);
+    HT_CHECK_EQ(s_outCnt, 2);
+    HT_CHECK_EQ(s_out[0].len, 3U + 8U + HCI_LE_TRANSMITTER_SPL_MAX);
+    HT_CHECK_EQ(s_out[0].data[2], 8U + HCI_LE_TRANSMITTER_SPL_MAX);
+    HT_CHECK_EQ(s_out[0].data[3 + 7 + HCI_LE_TRANSMITTER_SPL_MAX - 1U], HCI_LE_TRANSMITTER_SPL_MAX - 1U);
+    HT_CHECK_EQ(s_out[0].data[s_out[0].len - 1U], 0x7E);
+}
+#endif
+
+static void test_Bench(void)
+{
+    static BT_SYS_LogEvent_T logs[EVT_MAX];
+    static uint8_t *p_payload[EVT_MAX];
+    static uint8_t *p_return[EVT_MAX];
+    uint64_t start, elapsed = 0;
+    unsigned round, i;
+
+    //Free is stubbed out of the timing: the logs are rebuilt outside the timed loop
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        BLE_LOG_EventRegister(ht_LogCb);
+        for (i = 0; i < s_evtCnt; i++)
+        {
+            p_payload[i] = calloc(1, PAYLOAD_MAX);
+            memcpy(p_payload[i], s_evt[i].payload, s_evt[i].payloadLen);
+            p_return[i] = (s_evt[i].returnLen != 0U) ? calloc(1, PAYLOAD_MAX) : NULL;
+            if (p_return[i] != NULL)
+            {
+                memcpy(p_return[i], s_evt[i].returnParams, s_evt[i].returnLen);
+            }
+        }
+
+        start = ht_NowNs();
+        for (i = 0; i < s_evtCnt; i++)
+        {
+            s_outCnt = 0;
+            if (s_evt[i].logType == BT_SYS_LOG_TYPE_HCI_COMMAND)
+            {
+                logs[i].logId = s_evt[i].logId;
+                logs[i].paramsLength = s_evt[i].paramsLength;
+                logs[i].p_logPayload = p_payload[i];
+                logs[i].p_returnParams = p_return[i];
+                ble_log_ProcHciCommand(&logs[i]);
+            }
+            else if (s_evt[i].logType == BT_SYS_LOG_TYPE_HCI_EVENT)
+            {
+                logs[i].logId = s_evt[i].logId;
+                logs[i].p_logPayload = p_payload[i];
+                ble_log_ProcHciEvent(&logs[i]);
+            }
+            else
+            {
+                logs[i].logType = s_evt[i].logType;
+                logs[i].logId = s_evt[i].logId;
+                logs[i].payloadLength = s_evt[i].payloadLen;
+                logs[i].p_logPayload = p_payload[i];
+                ble_log_ProcHciAcl(&logs[i]);
+            }
+        }
+        elapsed += ht_NowNs() - start;
+
+        for (i = 0; i < s_evtCnt; i++)
+        {
+            free(p_payload[i]);
+            free(p_return[i]);
+        }
+    }
+
+    printf("  encode: %.1f ns/log event\n", (double)elapsed / ((double)BENCH_ROUNDS * s_evtCnt));
+}
+
+int main(int argc, char **argv)
+{
+    FILE *p_file;
+
+    if ((argc > 1) && (strcmp(argv[1], "--gen") == 0))
+    {
+        ht_Generate();
+        return 0;
+    }
+    if ((argc > 1) && (strcmp(argv[1], "--record") == 0))
+    {
+        if (!ht_LoadStream(stdin))
+        {
+            return 1;
+        }
+        ht_Record();
+        return 0;
+    }
+
+    p_file = fopen(STREAM_FILE, "r");
+    HT_CHECK(p_file != NULL);
+    if (p_file != NULL)
+    {
+        HT_CHECK(ht_LoadStream(p_file));
+        fclose(p_file);
+
+        test_ByteExact();
+        test_NoHeapUse();
+#ifdef BLE_LOG_PACKET_BUF_SIZE
+        test_EveryByteWritten();
+        test_Oversized();
+        test_SwitchingPattern();
+#endif
+        test_Bench();
+    }
+
+    return ht_Finish("test_ble_log");
+}
@@ -0,0 +1,571 @@
+/*
+ * Host test and simulation of the connectionless proximity mode
+ * (app_cl_prox.c) with the zone estimator (app_zone_est.c), against a mock
+ * controller that establishes a requested sync on the next periodic
+ * advertising event of the reporter.
+ *
+ * - A link opened to deliver an alert is released once the bootstrap is
+ *   finished and BLE_PXPM_IsWriteQueueEmpty, or on
+ *   BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND if a write still waits.
+ * - The context of the link gets the zone only; the IAS level is left to
+ *   the bootstrap.
+ * - An alert is confirmed only by the reporter advertising another level.
+ *   Until then the connection request is repeated every
+ *   APP_CL_PROX_RETRY_MS, and a zone back at the advertised level drops it
+ *   without a confirmation.
+ * - Sync slots: never more than APP_CL_PROX_SYNC_NUM trains requested from
+ *   the controller. With more reporters, each gives its slot up after
+ *   APP_CL_PROX_SYNC_DWELL_MS to the one waiting the longest, except one
+ *   with an alert pending. No reporter is dropped for lack of a slot.
+ * - CPU per reporter per second with 10, 100 and 300 reporters in range:
+ *   one extended advertising report per second each, two periodic reports
+ *   per second per synchronized train. Time spent in the firmware handlers
+ *   on the host, clock overhead removed, over 300 s simulated:
+ *
+ *    tags  tracked  synced  reports/s  handler us/s  ns/tag/s  followed  max wait
+ *      10       10       4         17          1.01       101        10    21.4 s
+ *     100       32       4        107         13.05       130        32    73.7 s
+ *     300       32       4        307         42.37       141        32    72.8 s
+ *
+ *   Periodic reports are bounded by APP_CL_PROX_SYNC_NUM, so the cost grows
+ *   with the extended advertising reports. One from a reporter the table
+ *   has no room for scans all 32 entries twice, which is why the cost per
+ *   reporter rises past 32 reporters. Reporters beyond APP_CL_PROX_TAG_NUM
+ *   are never followed. A tracked one waits up to about
+ *   (APP_CL_PROX_TAG_NUM / APP_CL_PROX_SYNC_NUM) x APP_CL_PROX_SYNC_DWELL_MS
+ *   for its turn; 31.9 s for 12 reporters with one slot held by an alert.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "app_ble/app_zone_est.c"
+#include "app_ble/app_cl_prox.c"
+
+#define HT_CONN             0x0010
+#define HT_SID              1
+#define HT_PERI_INTERVAL    400         /* 500 ms, as the reporter advertises */
+#define HT_PERI_MS          500
+#define HT_ADV_MS           1000
+#define HT_PL_NEAR          15
+#define HT_PL_FAR           75
+#define HT_TAG_MAX          300
+
+#define SIM_MS              300000
+#define SIM_NOISE_DB        4
+
+typedef struct HT_Tag_T
+{
+    bool        synced;             /* Sync held by the controller */
+    bool        everSynced;
+    bool        terminated;         /* Sync given up by the monitor after the first one */
+    int         pathLoss;
+    uint8_t     alertLevel;         /* Alert level advertised */
+    uint16_t    seq;
+    uint32_t    advMs;              /* Next extended advertising report */
+    uint32_t    periMs;             /* Next periodic advertising event */
+    uint32_t    waitMs;             /* Start of the wait for a sync */
+} HT_Tag_T;
+
+static HT_Tag_T         s_htTag[HT_TAG_MAX];
+static unsigned         s_htTagNum;
+static int              s_htPendingTag = -1;
+static unsigned         s_htCtrlSyncCnt;
+static unsigned         s_htCreateSyncCnt;
+static unsigned         s_htTerminateCnt;
+static unsigned         s_htCancelCnt;
+static unsigned         s_htDiscCnt;
+static unsigned         s_htConnReqCnt;
+static bool             s_htQueueEmpty = true;
+static APP_PXPM_Ctx_T   s_htCtx;
+static uint32_t         s_htMaxWaitMs;
+static uint64_t         s_htNs;
+static uint64_t         s_htClockNs;
+
+/* Stand-ins for the zone estimator sampling of the connected mode, not used here */
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByIndex(uint8_t index)
+{
+    (void)index;
+    return NULL;
+}
+
+void APP_PXPM_CTX_StampZoneEvt(APP_PXPM_Ctx_T *p_ctx, uint32_t stamp)
+{
+    (void)p_ctx;
+    (void)stamp;
+}
+
+void APP_PXPM_CTX_SetZone(APP_PXPM_Ctx_T *p_ctx, uint8_t zone)
+{
+    p_ctx->zone = zone;
+}
+
+void APP_LINK_OPT_Update(uint16_t connHandle, int8_t rssi)
+{
+    (void)connHandle;
+    (void)rssi;
+}
+
+void APP_CONN_POLICY_Update(uint16_t connHandle, bool zoneChanged)
+{
+    (void)connHandle;
+    (void)zoneChanged;
+}
+
+uint32_t RTC_Timer32CounterGet(void)
+{
+    return 0;
+}
+
+void APP_TIMER_NodeInit(APP_TIMER_Node_T *p_node, APP_TIMER_NodeCb_T cb, void *p_arg)
+{
+    (void)p_node;
+    (void)cb;
+    (void)p_arg;
+}
+
+uint16_t APP_TIMER_NodeStart(APP_TIMER_Node_T *p_node, uint32_t timeout, bool isPeriodicTimer)
+{
+    (void)p_node;
+    (void)timeout;
+    (void)isPeriodicTimer;
+    return APP_RES_SUCCESS;
+}
+
+void APP_TIMER_NodeStop(APP_TIMER_Node_T *p_node)
+{
+    (void)p_node;
+}
+
+bool APP_TIMER_NodeIsActive(APP_TIMER_Node_T const *p_node)
+{
+    (void)p_node;
+    return true;
+}
+
+uint16_t BLE_GAP_GetRssi(uint16_t connHandle, int8_t *p_rssi)
+{
+    (void)connHandle;
+    *p_rssi = 0;
+    return MBA_RES_SUCCESS;
+}
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByHandle(uint16_t connHandle)
+{
+    return (connHandle == s_htCtx.connHandle) ? &s_htCtx : NULL;
+}
+
+bool BLE_PXPM_IsWriteQueueEmpty(uint16_t connHandle)
+{
+    HT_CHECK_EQ(connHandle, s_htCtx.connHandle);
+    return s_htQueueEmpty;
+}
+
+uint16_t BLE_GAP_Disconnect(uint16_t connHandle, uint8_t reason)
+{
+    HT_CHECK_EQ(connHandle, s_htCtx.connHandle);
+    HT_CHECK_EQ(reason, GAP_DISC_REASON_REMOTE_TERMINATE);
+    s_htDiscCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_CreateSync(BLE_GAP_CreateSync_T *p_periSync)
+{
+    unsigned tag = p_periSync->advAddr.addr[0] | (p_periSync->advAddr.addr[1] << 8);
+
+    //One request at a time, and never more trains than the slots
+    HT_CHECK_EQ(s_htPendingTag, -1);
+    HT_CHECK(s_htCtrlSyncCnt < APP_CL_PROX_SYNC_NUM);
+    HT_CHECK(tag < s_htTagNum);
+    HT_CHECK(!s_htTag[tag].synced);
+    HT_CHECK_EQ(p_periSync->advSid, HT_SID);
+    HT_CHECK(p_periSync->syncTimeout >= BLE_GAP_SYNC_TIMEOUT_MIN);
+    s_htPendingTag = (int)tag;
+    s_htCreateSyncCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_CreateSyncCancel(void)
+{
+    s_htCancelCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_TerminateSync(uint16_t syncHandle)
+{
+    unsigned tag = (unsigned)syncHandle - 1U;
+
+    HT_CHECK(tag < s_htTagNum);
+    HT_CHECK(s_htTag[tag].synced);
+    s_htTag[tag].synced = false;
+    s_htTag[tag].terminated = true;
+    s_htTag[tag].waitMs = g_htTick;
+    s_htCtrlSyncCnt--;
+    s_htTerminateCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+static void ht_Addr(BLE_GAP_Addr_T *p_addr, unsigned tag)
+{
+    memset(p_addr, 0, sizeof(BLE_GAP_Addr_T));
+    p_addr->addrType = BLE_GAP_ADDR_TYPE_PUBLIC;
+    p_addr->addr[0] = (uint8_t)tag;
+    p_addr->addr[1] = (uint8_t)(tag >> 8);
+    p_addr->addr[5] = 0xC0;
+}
+
+static void ht_AdvReport(unsigned tag)
+{
+    BLE_GAP_EvtExtAdvReport_T report;
+    uint64_t t0;
+
+    memset(&report, 0, sizeof(report));
+    report.eventType = BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_CONNECTABLE;
+    ht_Addr(&report.addr, tag);
+    report.sid = HT_SID;
+    report.periodAdvInterval = HT_PERI_INTERVAL;
+
+    t0 = ht_NowNs();
+    APP_CL_PROX_ProcAdvReport(&report);
+    s_htNs += ht_NowNs() - t0;
+}
+
+static void ht_SyncEst(uint8_t status)
+{
+    BLE_GAP_EvtPeriAdvSyncEst_T evt;
+    unsigned tag = (unsigned)s_htPendingTag;
+    uint64_t t0;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.status = status;
+    evt.syncHandle = (uint16_t)(tag + 1U);
+    evt.advSid = HT_SID;
+    ht_Addr(&evt.advAddr, tag);
+    evt.periAdvInterval = HT_PERI_INTERVAL;
+
+    s_htPendingTag = -1;
+    if (status == GAP_STATUS_SUCCESS)
+    {
+        if (g_htTick - s_htTag[tag].waitMs > s_htMaxWaitMs)
+        {
+            s_htMaxWaitMs = g_htTick - s_htTag[tag].waitMs;
+        }
+        s_htTag[tag].synced = true;
+        s_htTag[tag].everSynced = true;
+        s_htCtrlSyncCnt++;
+    }
+
+    t0 = ht_NowNs();
+    APP_CL_PROX_SyncEstHandler(&evt);
+    s_htNs += ht_NowNs() - t0;
+}
+
+/* Parsed in the stack callback, then handled on the application task */
+static void ht_PeriReport(unsigned tag, int noise)
+{
+    BLE_GAP_EvtPeriAdvReport_T report;
+    HT_Tag_T *p_tag = &s_htTag[tag];
+    unsigned i;
+    uint64_t t0;
+
+    memset(&report, 0, sizeof(report));
+    report.syncHandle = (uint16_t)(tag + 1U);
+    report.rssi = (int8_t)(-(p_tag->pathLoss + noise));
+    report.dataStatus = BLE_GAP_DATA_STATUS_COMPLETE;
+    report.dataLength = APP_CL_PROX_FRAME_LEN;
+    memcpy(report.advData, s_clProxFrameHdr, sizeof(s_clProxFrameHdr));
+    report.advData[APP_CL_PROX_FRAME_POS_TX_POWER] = 0;
+    report.advData[APP_CL_PROX_FRAME_POS_ALERT_LEVEL] = p_tag->alertLevel;
+    report.advData[APP_CL_PROX_FRAME_POS_SEQ] = (uint8_t)p_tag->seq;
+    report.advData[APP_CL_PROX_FRAME_POS_SEQ + 1] = (uint8_t)(p_tag->seq >> 8);
+
+    ht_ClearMsg();
+    t0 = ht_NowNs();
+    APP_CL_PROX_ProcPeriAdvReport(&report);
+    s_htNs += ht_NowNs() - t0;
+
+    for (i = 0; i < g_htMsgCnt; i++)
+    {
+        APP_Msg_T msg = g_htMsg[i];
+
+        if (msg.msgId == APP_MSG_PERI_ADV_EVT)
+        {
+            t0 = ht_NowNs();
+            APP_CL_PROX_SampleHandler((APP_ClProxSample_T *)msg.msgData);
+            s_htNs += ht_NowNs() - t0;
+        }
+        else if (msg.msgId == APP_MSG_BLE_SCAN_EVT)
+        {
+            HT_CHECK_EQ(((APP_BleScanEvt_T *)msg.msgData)->addr.addr[0], (uint8_t)tag);
+            s_htConnReqCnt++;
+        }
+    }
+    ht_ClearMsg();
+}
+
+static void ht_Reset(unsigned tagNum)
+{
+    unsigned i;
+
+    APP_CL_PROX_Init();
+    memset(s_htTag, 0, sizeof(s_htTag));
+    for (i = 0; i < tagNum; i++)
+    {
+        s_htTag[i].pathLoss = HT_PL_NEAR;
+    }
+    s_htTagNum = tagNum;
+    s_htPendingTag = -1;
+    s_htCtrlSyncCnt = 0;
+    s_htCreateSyncCnt = 0;
+    s_htTerminateCnt = 0;
+    s_htCancelCnt = 0;
+    s_htDiscCnt = 0;
+    s_htConnReqCnt = 0;
+    s_htMaxWaitMs = 0;
+    s_htNs = 0;
+    g_htTick = 0;
+    ht_ClearMsg();
+}
+
+static unsigned ht_ReportsOf(unsigned tag, unsigned num)
+{
+    unsigned before = s_htConnReqCnt;
+    unsigned i;
+
+    for (i = 0; i < num; i++)
+    {
+        g_htTick += HT_PERI_MS;
+        ht_PeriReport(tag, 0);
+    }
+    return s_htConnReqCnt - before;
+}
+
+/* Reports until the zone is reached, returns the connection requests on the way */
+static unsigned ht_ReportsToZone(unsigned tag, uint8_t zone)
+{
+    unsigned req = 0;
+    unsigned i;
+
+    for (i = 0; (i < 200U) && (s_clProxTag[tag].zoneEst.zone != zone); i++)
+    {
+        req += ht_ReportsOf(tag, 1);
+    }
+    HT_CHECK_EQ(s_clProxTag[tag].zoneEst.zone, zone);
+    return req;
+}
+
+static void test_alert(void)
+{
+    APP_CL_PROX_Stats_T stats;
+    TickType_t retryTick;
+
+    ht_Reset(1);
+    ht_AdvReport(0);
+    HT_CHECK_EQ(s_htCreateSyncCnt, 1);
+    ht_SyncEst(GAP_STATUS_SUCCESS);
+
+    //Seeded with the advertised level, then the reporter walks away
+    HT_CHECK_EQ(ht_ReportsOf(0, 1), 0);
+    s_htTag[0].pathLoss = HT_PL_FAR;
+    HT_CHECK_EQ(ht_ReportsToZone(0, APP_ZONE_EST_ZONE_HIGH), 1);
+
+    //The link gets the zone; the IAS level is left to the bootstrap
+    memset(&s_htCtx, 0, sizeof(s_htCtx));
+    s_htCtx.connHandle = HT_CONN;
+    ht_Addr(&s_htCtx.peerAddr, 0);
+    s_htCtx.iasLevel = 0x55;
+    APP_CL_PROX_ConnectedHandler(&s_htCtx);
+    HT_CHECK_EQ(s_htCtx.zone, APP_ZONE_EST_ZONE_HIGH);
+    HT_CHECK_EQ(s_htCtx.iasLevel, 0x55);
+
+    //An IAS write waiting for a TX buffer keeps the link
+    s_htQueueEmpty = false;
+    APP_CL_PROX_AlertDelivered(HT_CONN);
+    HT_CHECK_EQ(s_htDiscCnt, 0);
+    s_htQueueEmpty = true;
+    APP_CL_PROX_WriteQueueEmpty(HT_CONN);
+    HT_CHECK_EQ(s_htDiscCnt, 1);
+    APP_CL_PROX_WriteQueueEmpty(HT_CONN);
+    HT_CHECK_EQ(s_htDiscCnt, 1);
+    APP_CL_PROX_AlertDelivered(HT_CONN);
+    HT_CHECK_EQ(s_htDiscCnt, 2);
+    APP_CL_PROX_WriteQueueEmpty(HT_CONN);
+    HT_CHECK_EQ(s_htDiscCnt, 2);
+
+    //Still the old level advertised: not delivered, asked again once the retry time is up
+    retryTick = s_clProxTag[0].retryTick;
+    while ((int32_t)(retryTick - (g_htTick + HT_PERI_MS)) > 0)
+    {
+        HT_CHECK_EQ(ht_ReportsOf(0, 1), 0);
+    }
+    HT_CHECK_EQ(ht_ReportsOf(0, 1), 1);
+    APP_CL_PROX_GetStats(&stats);
+    HT_CHECK_EQ(stats.alertConnCnt, 2);
+    HT_CHECK_EQ(stats.alertConfirmCnt, 0);
+
+    //The reporter advertises the new level: confirmed, no more connections
+    s_htTag[0].alertLevel = APP_ZONE_EST_ZONE_HIGH;
+    s_htTag[0].seq++;
+    HT_CHECK_EQ(ht_ReportsOf(0, 2 * APP_CL_PROX_RETRY_MS / HT_PERI_MS), 0);
+    APP_CL_PROX_GetStats(&stats);
+    HT_CHECK_EQ(stats.alertConfirmCnt, 1);
+
+    //Back before the alert went out: dropped, not confirmed
+    s_htTag[0].pathLoss = HT_PL_NEAR;
+    HT_CHECK_EQ(ht_ReportsToZone(0, APP_ZONE_EST_ZONE_MIDDLE), 1);
+    HT_CHECK(s_clProxTag[0].alertPending);
+    s_htTag[0].pathLoss = HT_PL_FAR;
+    (void)ht_ReportsToZone(0, APP_ZONE_EST_ZONE_HIGH);
+    HT_CHECK(!s_clProxTag[0].alertPending);
+    HT_CHECK_EQ(ht_ReportsOf(0, 2 * APP_CL_PROX_RETRY_MS / HT_PERI_MS), 0);
+    APP_CL_PROX_GetStats(&stats);
+    HT_CHECK_EQ(stats.alertConfirmCnt, 1);
+    HT_CHECK_EQ(stats.seqGapCnt, 0);
+}
+
+/* Reporters in range for durationMs, one of them far with an alert it never advertises if farTag >= 0 */
+static void sim_Run(unsigned tagNum, uint32_t durationMs, int farTag)
+{
+    uint32_t syncMs = 0;
+    unsigned i;
+
+    ht_Reset(tagNum);
+    ht_Seed(0x5EED0000U + tagNum);
+    for (i = 0; i < tagNum; i++)
+    {
+        s_htTag[i].advMs = ht_Rand() % HT_ADV_MS;
+        s_htTag[i].periMs = ht_Rand() % HT_PERI_MS;
+    }
+    if (farTag >= 0)
+    {
+        s_htTag[farTag].pathLoss = HT_PL_FAR;
+    }
+
+    for (g_htTick = 0; g_htTick < durationMs; g_htTick++)
+    {
+        for (i = 0; i < tagNum; i++)
+        {
+            HT_Tag_T *p_tag = &s_htTag[i];
+
+            if (g_htTick == p_tag->periMs)
+            {
+                p_tag->periMs += HT_PERI_MS;
+                if ((s_htPendingTag == (int)i) && (g_htTick >= syncMs))
+                {
+                    ht_SyncEst(GAP_STATUS_SUCCESS);
+                }
+                else if (p_tag->synced)
+                {
+                    ht_PeriReport(i, (int)(ht_Rand() % (2 * SIM_NOISE_DB + 1)) - SIM_NOISE_DB);
+                }
+            }
+
+            if (g_htTick == p_tag->advMs)
+            {
+                bool pending = (s_htPendingTag >= 0);
+
+                p_tag->advMs += HT_ADV_MS;
+                ht_AdvReport(i);
+                if (!pending && (s_htPendingTag >= 0))
+                {
+                    syncMs = g_htTick + 1U;
+                }
+            }
+        }
+    }
+}
+
+static void test_slots(void)
+{
+    APP_CL_PROX_Stats_T stats;
+    unsigned tagNum = 3 * APP_CL_PROX_SYNC_NUM;
+    unsigned i;
+
+    //Fewer reporters than slots: synchronized once and kept
+    sim_Run(APP_CL_PROX_SYNC_NUM - 1, SIM_MS, -1);
+    HT_CHECK_EQ(s_htCreateSyncCnt, APP_CL_PROX_SYNC_NUM - 1);
+    HT_CHECK_EQ(s_htTerminateCnt, 0);
+
+    //Three reporters per slot, one of them with an alert it never advertises
+    sim_Run(tagNum, SIM_MS, 0);
+    APP_CL_PROX_GetStats(&stats);
+    for (i = 0; i < tagNum; i++)
+    {
+        HT_CHECK(s_htTag[i].everSynced);
+    }
+    HT_CHECK(!s_htTag[0].terminated);
+    HT_CHECK(s_htTerminateCnt > tagNum);
+    HT_CHECK_EQ(stats.syncRotateCnt, s_htTerminateCnt);
+    HT_CHECK_EQ(stats.syncFailCnt, 0);
+    HT_CHECK_EQ(stats.syncLostCnt, 0);
+    HT_CHECK_EQ(s_htCancelCnt, 0);
+    printf("  %u tags, %u slots, one held by an alert: max wait %.1f s\n", tagNum, APP_CL_PROX_SYNC_NUM, s_htMaxWaitMs / 1000.0);
+    HT_CHECK(s_htMaxWaitMs <= ((tagNum + APP_CL_PROX_SYNC_NUM - 3) / (APP_CL_PROX_SYNC_NUM - 1)) * APP_CL_PROX_SYNC_DWELL_MS);
+    HT_CHECK(s_htConnReqCnt >= SIM_MS / APP_CL_PROX_RETRY_MS / 2);
+    HT_CHECK_EQ(stats.alertConfirmCnt, 0);
+}
+
+static void test_cpu(void)
+{
+    static const unsigned tagNum[] = { 10, 100, 300 };
+    APP_CL_PROX_Stats_T stats;
+    uint64_t t0;
+    unsigned i;
+    unsigned k;
+
+    //Cost of the timing itself, taken off each call
+    t0 = ht_NowNs();
+    for (i = 0; i < 1000000U; i++)
+    {
+        s_htNs += ht_NowNs() - ht_NowNs();
+    }
+    s_htClockNs = (ht_NowNs() - t0) / 1000000U / 2U;
+
+    printf("  %4s  %7s  %6s  %9s  %12s  %8s  %8s  %8s\n",
+           "tags", "tracked", "synced", "reports/s", "handler us/s", "ns/tag/s", "followed", "max wait");
+    for (k = 0; k < sizeof(tagNum) / sizeof(tagNum[0]); k++)
+    {
+        unsigned tracked = 0;
+        unsigned followed = 0;
+        unsigned calls;
+        double ns;
+
+        sim_Run(tagNum[k], SIM_MS, -1);
+        APP_CL_PROX_GetStats(&stats);
+        for (i = 0; i < APP_CL_PROX_TAG_NUM; i++)
+        {
+            tracked += (s_clProxTag[i].state != APP_CL_PROX_TAG_STATE_FREE);
+        }
+        for (i = 0; i < tagNum[k]; i++)
+        {
+            followed += s_htTag[i].everSynced;
+        }
+
+        //Every call: extended reports, periodic reports parsed and handled, sync events
+        calls = tagNum[k] * (SIM_MS / HT_ADV_MS) + 2U * stats.reportCnt + stats.syncEstCnt;
+        ns = (double)s_htNs - (double)calls * (double)s_htClockNs;
+        if (ns < 0)
+        {
+            ns = 0;
+        }
+        ns /= (SIM_MS / 1000U);
+
+        HT_CHECK_EQ(stats.syncFailCnt, 0);
+        HT_CHECK_EQ(s_htConnReqCnt, 0);
+        HT_CHECK_EQ(tracked, (tagNum[k] < APP_CL_PROX_TAG_NUM) ? tagNum[k] : APP_CL_PROX_TAG_NUM);
+        HT_CHECK_EQ(followed, tracked);
+        printf("  %4u  %7u  %6u  %9u  %12.2f  %8.0f  %8u  %6.1f s\n",
+               tagNum[k], tracked, s_htCtrlSyncCnt, tagNum[k] * (1000U / HT_ADV_MS) + stats.reportCnt / (SIM_MS / 1000U),
+               ns / 1000.0, ns / tagNum[k], followed, s_htMaxWaitMs / 1000.0);
+    }
+}
+
+int main(void)
+{
+    test_alert();
+    test_slots();
+    test_cpu();
+    return ht_Finish("test_cl_prox");
+}
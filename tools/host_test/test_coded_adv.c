@@ -0,0 +1,361 @@
+/*
+ * Host test of the long-range scan path of the monitor: LE Coded extended
+ * advertising reports through the stack callback (app_ble.c), the scan
+ * filter (app_ble_scan_filter.c) and the event pool (app_ble_evt_pool.c).
+ * Built with APP_BLE_LONG_RANGE set.
+ *
+ * - The reporter's AUX_ADV_IND on LE Coded, its advertising data as
+ *   app_ble.c of the reporter sets it, is accepted and queued once as
+ *   APP_MSG_BLE_STACK_EVT; the pooled copy keeps the address, RSSI and
+ *   PHYs the scan handler and BLE_GAP_ExtCreateConnection use.
+ * - Service Data found behind other AD structures anywhere in the
+ *   BLE_GAP_EXT_SCAN_DATA_LEN_MIN bytes the scanner is set up for.
+ * - Dropped before a pool block is claimed: non-connectable, scannable and
+ *   scan response PDUs, partial (more to come) and truncated data, foreign
+ *   devices on LE Coded, and reports with no or malformed data.
+ * - Queue full: the claimed block is returned and the drop is counted
+ *   after allocation.
+ * - Random reports never read past their length and are accepted exactly
+ *   when a complete, connectable report carries the reporter's Service Data.
+ */
+
+#define APP_BLE_LONG_RANGE  1
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_ble/app_ble_evt_pool.c"
+#include "app_ble/app_ble_scan_filter.c"
+#include "app_ble/app_ble.c"
+
+#define FUZZ_REPORTS        200000
+
+/* Advertising data of the reporter: Flags, Complete Local Name, Service Data */
+static const uint8_t s_htReporterAdv[] = { 0x02, 0x01, 0x04, 0x06, 0x09, 0x46, 0x4D, 0x50, 0x5F, 0x50,
+                                           0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x20 };
+
+static const BLE_GAP_Addr_T s_htReporterAddr = { BLE_GAP_ADDR_TYPE_RANDOM_STATIC, { 0x11, 0x22, 0x33, 0x44, 0x55, 0xC6 } };
+
+uint16_t BLE_GAP_SetScanningFilter(BLE_GAP_ScanFilterConfig_T *p_param)
+{
+    (void)p_param;
+    return MBA_RES_SUCCESS;
+}
+
+void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt)
+{
+    (void)p_devId;
+    *p_devCnt = 0;
+}
+
+uint16_t BLE_DM_SetFilterAcceptList(uint8_t devCnt, uint8_t const *p_devId)
+{
+    (void)devCnt;
+    (void)p_devId;
+    return MBA_RES_SUCCESS;
+}
+
+/* Called by the other functions of app_ble.c only */
+void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event) { (void)p_event; }
+void APP_BleL2capEvtHandler(BLE_L2CAP_Event_T *p_event) { (void)p_event; }
+void APP_BleSmpEvtHandler(BLE_SMP_Event_T *p_event) { (void)p_event; }
+void APP_GattEvtHandler(GATT_Event_T *p_event) { (void)p_event; }
+void APP_GATT_CACHE_ConfigDd(BLE_DD_Config_T *p_ddConfig, STACK_Event_T *p_stackEvent) { (void)p_ddConfig; (void)p_stackEvent; }
+void APP_GATT_CACHE_BleEventHandler(STACK_Event_T *p_stackEvent) { (void)p_stackEvent; }
+void APP_GATT_CACHE_DdEventHandler(BLE_DD_Event_T *p_event) { (void)p_event; }
+void APP_GATT_CACHE_Init(void) {}
+void APP_LINK_OPT_Init(void) {}
+void APP_PXPM_CTX_ProcPathLossEvt(const BLE_GAP_EvtPathLossThreshold_T *p_evt) { (void)p_evt; }
+void APP_SCAN_SCHED_Init(void) {}
+void APP_DmEvtHandler(BLE_DM_Event_T *p_event) { (void)p_event; }
+void APP_PxpmEvtHandler(BLE_PXPM_Event_T *p_event) { (void)p_event; }
+void BLE_CONN_REG_Init(void) {}
+void BLE_CONN_REG_BleEventHandler(STACK_Event_T *p_stackEvent) { (void)p_stackEvent; }
+void BLE_CONN_REG_BleReleaseHandler(STACK_Event_T *p_stackEvent) { (void)p_stackEvent; }
+void BLE_DM_BleEventHandler(STACK_Event_T *p_stackEvent) { (void)p_stackEvent; }
+void BLE_DD_BleEventHandler(BLE_DD_Config_T *p_config, STACK_Event_T *p_stackEvent) { (void)p_config; (void)p_stackEvent; }
+void BLE_PXPM_BleEventHandler(STACK_Event_T *p_stackEvent) { (void)p_stackEvent; }
+void BLE_DD_EventRegister(BLE_DD_EventCb_T bleDdHandler) { (void)bleDdHandler; }
+bool BLE_DD_Init(void) { return true; }
+uint16_t BLE_DM_Config(BLE_DM_Config_T *p_config) { (void)p_config; return MBA_RES_SUCCESS; }
+uint16_t BLE_DM_EventRegister(BLE_DM_EventCb_T eventCb) { (void)eventCb; return MBA_RES_SUCCESS; }
+bool BLE_DM_Init(void) { return true; }
+void STACK_EventRegister(STACK_EventCb_T eventCb) { (void)eventCb; }
+uint16_t BLE_GAP_Init(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ScanInit(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ExtScanInit(uint16_t maxAdvDataLen, uint8_t maxAdvReportNum) { (void)maxAdvDataLen; (void)maxAdvReportNum; return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ConnCentralInit(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ExtConnCentralInit(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_SetDeviceName(uint8_t len, uint8_t *p_deviceName) { (void)len; (void)p_deviceName; return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_SetConnTxPowerLevel(int8_t connTxPower, int8_t *p_selectedTxPower) { (void)connTxPower; (void)p_selectedTxPower; return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ConfigureBuildInService(BLE_GAP_ServiceOption_T *p_serviceOptions) { (void)p_serviceOptions; return MBA_RES_SUCCESS; }
+uint16_t BLE_L2CAP_Init(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_SMP_Init(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_SMP_Config(BLE_SMP_Config_T *p_config) { (void)p_config; return MBA_RES_SUCCESS; }
+uint16_t GATTC_Init(uint16_t configuration) { (void)configuration; return MBA_RES_SUCCESS; }
+uint16_t GATTS_Init(uint16_t configuration) { (void)configuration; return MBA_RES_SUCCESS; }
+void BLE_PXPM_BleDdEventHandler(BLE_DD_Event_T *p_event) { (void)p_event; }
+void BLE_PXPM_EventRegister(BLE_PXPM_EventCb_T bleProxMonitorHandler) { (void)bleProxMonitorHandler; }
+uint16_t BLE_PXPM_Init(void) { return MBA_RES_SUCCESS; }
+
+static void ht_Reset(void)
+{
+    APP_EVT_POOL_Init();
+    APP_SCAN_FILTER_Init();
+    ht_ClearMsg();
+    g_htQueueFull = false;
+}
+
+/* AUX_ADV_IND of a connectable extended set on LE Coded, as the reporter advertises it */
+static void ht_CodedReport(BLE_GAP_Event_T *p_evt, const uint8_t *p_adv, uint8_t len)
+{
+    BLE_GAP_EvtExtAdvReport_T *p_report = &p_evt->eventField.evtExtAdvReport;
+
+    memset(p_evt, 0, sizeof(BLE_GAP_Event_T));
+    p_evt->eventId = BLE_GAP_EVT_EXT_ADV_REPORT;
+    p_report->eventType = BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_CONNECTABLE;
+    p_report->dataStatus = BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE;
+    memcpy(&p_report->addr, &s_htReporterAddr, sizeof(BLE_GAP_Addr_T));
+    p_report->priPhy = BLE_GAP_EXT_ADV_REPORT_PHY_CODED;
+    p_report->secPhy = BLE_GAP_EXT_ADV_REPORT_PHY_CODED;
+    p_report->sid = 0;
+    p_report->txPower = 127;
+    p_report->rssi = -97;
+    p_report->length = len;
+    memcpy(p_report->advData, p_adv, len);
+}
+
+/* The stack callback, as the stack calls it for one report */
+static void ht_Deliver(BLE_GAP_Event_T *p_evt)
+{
+    STACK_Event_T stackEvt;
+
+    stackEvt.groupId = STACK_GRP_BLE_GAP;
+    stackEvt.evtLen = sizeof(BLE_GAP_Event_T);
+    stackEvt.p_event = (uint8_t *)p_evt;
+    APP_BleStackCb(&stackEvt);
+}
+
+static unsigned ht_InUse(void)
+{
+    APP_EVT_POOL_Stats_T stats;
+
+    APP_EVT_POOL_GetStats(&stats);
+    return stats.inUse[APP_EVT_POOL_CLASS_SMALL] + stats.inUse[APP_EVT_POOL_CLASS_LARGE];
+}
+
+static void test_reporter(void)
+{
+    BLE_GAP_Event_T evt;
+    const STACK_Event_T *p_stackEvt;
+    const BLE_GAP_EvtExtAdvReport_T *p_copy;
+    APP_SCAN_FILTER_Stats_T stats;
+
+    ht_Reset();
+    ht_CodedReport(&evt, s_htReporterAdv, sizeof(s_htReporterAdv));
+    ht_Deliver(&evt);
+
+    HT_CHECK_EQ(g_htMsgCnt, 1);
+    HT_CHECK_EQ(g_htMsg[0].msgId, APP_MSG_BLE_STACK_EVT);
+    p_stackEvt = (const STACK_Event_T *)g_htMsg[0].msgData;
+    HT_CHECK_EQ(p_stackEvt->groupId, STACK_GRP_BLE_GAP);
+    HT_CHECK(p_stackEvt->p_event != (uint8_t *)&evt);
+    HT_CHECK_EQ(((BLE_GAP_Event_T *)p_stackEvt->p_event)->eventId, BLE_GAP_EVT_EXT_ADV_REPORT);
+
+    //What the scan handler and the connection request read from the copy
+    p_copy = &((BLE_GAP_Event_T *)p_stackEvt->p_event)->eventField.evtExtAdvReport;
+    HT_CHECK_EQ(p_copy->addr.addrType, s_htReporterAddr.addrType);
+    HT_CHECK(memcmp(p_copy->addr.addr, s_htReporterAddr.addr, GAP_MAX_BD_ADDRESS_LEN) == 0);
+    HT_CHECK_EQ(p_copy->rssi, -97);
+    HT_CHECK_EQ(p_copy->priPhy, BLE_GAP_EXT_ADV_REPORT_PHY_CODED);
+    HT_CHECK_EQ(p_copy->secPhy, BLE_GAP_EXT_ADV_REPORT_PHY_CODED);
+    HT_CHECK_EQ(ht_InUse(), 1);
+    APP_EVT_POOL_Free(p_stackEvt->p_event);
+    HT_CHECK_EQ(ht_InUse(), 0);
+
+    //Service Data behind other structures, at the end of the scanner's data length
+    {
+        uint8_t adv[BLE_GAP_EXT_SCAN_DATA_LEN_MIN];
+        uint8_t mfgLen = (uint8_t)(sizeof(adv) - sizeof(s_htReporterAdv) - 2U);
+
+        adv[0] = (uint8_t)(mfgLen + 1U);
+        adv[1] = 0xFF;
+        memset(&adv[2], 0xA5, mfgLen);
+        memcpy(&adv[2U + mfgLen], s_htReporterAdv, sizeof(s_htReporterAdv));
+        ht_CodedReport(&evt, adv, sizeof(adv));
+        ht_Deliver(&evt);
+        HT_CHECK_EQ(g_htMsgCnt, 2);
+    }
+
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.rxCnt, 2);
+    HT_CHECK_EQ(stats.acceptCnt, 2);
+    HT_CHECK_EQ(stats.dropPreAllocCnt, 0);
+}
+
+static void test_dropped(void)
+{
+    static const uint8_t foreign[] = { 0x02, 0x01, 0x06, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x21,
+                                       0x07, 0xFF, 0x4C, 0x00, 0x10, 0x02, 0x0B, 0x00 };
+    static const uint8_t malformed[] = { 0x02, 0x01, 0x04, 0x12, 0x16, 0xDA, 0xFE, 0xFF, 0x20 };
+    static const uint8_t padded[] = { 0x00, 0x02, 0x01, 0x04, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x20 };
+    static const uint8_t eventType[] = { 0, BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_SCANNABLE,
+                                         BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_SCANNABLE | BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_SCAN_RSP };
+    static const uint8_t dataStatus[] = { BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_MORE, BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_TRUNCATED };
+    BLE_GAP_Event_T evt;
+    APP_EVT_POOL_Stats_T poolStats;
+    APP_SCAN_FILTER_Stats_T stats;
+    unsigned rxCnt = 0;
+    uint8_t i;
+
+    ht_Reset();
+
+    for (i = 0; i < sizeof(eventType); i++)
+    {
+        ht_CodedReport(&evt, s_htReporterAdv, sizeof(s_htReporterAdv));
+        evt.eventField.evtExtAdvReport.eventType = eventType[i];
+        ht_Deliver(&evt);
+        rxCnt++;
+    }
+
+    //A chain the scanner could not take whole, the Service Data may be in the part not seen
+    for (i = 0; i < sizeof(dataStatus); i++)
+    {
+        ht_CodedReport(&evt, s_htReporterAdv, sizeof(s_htReporterAdv));
+        evt.eventField.evtExtAdvReport.dataStatus = dataStatus[i];
+        ht_Deliver(&evt);
+        rxCnt++;
+    }
+
+    ht_CodedReport(&evt, foreign, sizeof(foreign));
+    ht_Deliver(&evt);
+    ht_CodedReport(&evt, malformed, sizeof(malformed));
+    ht_Deliver(&evt);
+    ht_CodedReport(&evt, padded, sizeof(padded));
+    ht_Deliver(&evt);
+    ht_CodedReport(&evt, s_htReporterAdv, 0);
+    ht_Deliver(&evt);
+    ht_CodedReport(&evt, s_htReporterAdv, sizeof(s_htReporterAdv) - 1U);
+    ht_Deliver(&evt);
+    rxCnt += 5U;
+
+    HT_CHECK_EQ(g_htMsgCnt, 0);
+    APP_EVT_POOL_GetStats(&poolStats);
+    HT_CHECK_EQ(poolStats.claimCnt[APP_EVT_POOL_CLASS_SMALL] + poolStats.claimCnt[APP_EVT_POOL_CLASS_LARGE], 0);
+    HT_CHECK_EQ(poolStats.heapFallbackCnt, 0);
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.rxCnt, rxCnt);
+    HT_CHECK_EQ(stats.dropPreAllocCnt, rxCnt);
+    HT_CHECK_EQ(stats.acceptCnt, 0);
+}
+
+static void test_queue_full(void)
+{
+    BLE_GAP_Event_T evt;
+    APP_SCAN_FILTER_Stats_T stats;
+
+    ht_Reset();
+    g_htQueueFull = true;
+    ht_CodedReport(&evt, s_htReporterAdv, sizeof(s_htReporterAdv));
+    ht_Deliver(&evt);
+    g_htQueueFull = false;
+
+    HT_CHECK_EQ(g_htMsgCnt, 0);
+    HT_CHECK_EQ(ht_InUse(), 0);
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.acceptCnt, 1);
+    HT_CHECK_EQ(stats.dropPostAllocCnt, 1);
+}
+
+/* Reference for the fuzz: a plain walk of the AD structures */
+static bool ht_RefMatch(const uint8_t *p_adv, uint8_t len)
+{
+    unsigned pos = 0;
+
+    while ((pos + 1U) < len)
+    {
+        unsigned adLen = p_adv[pos];
+
+        if ((adLen == 0U) || ((pos + 1U + adLen) > len))
+        {
+            return false;
+        }
+        if ((adLen >= 5U) && (p_adv[pos + 1U] == 0x16) && (p_adv[pos + 2U] == 0xDA) && (p_adv[pos + 3U] == 0xFE)
+            && (p_adv[pos + 4U] == 0xFF) && (p_adv[pos + 5U] == 0x20))
+        {
+            return true;
+        }
+        pos += adLen + 1U;
+    }
+    return false;
+}
+
+static void test_fuzz(void)
+{
+    BLE_GAP_Event_T evt;
+    uint8_t adv[BLE_GAP_EXT_ADV_FRAGMENT_MAX_LENGTH];
+    unsigned accepted = 0;
+    unsigned expected = 0;
+    unsigned n;
+
+    ht_Reset();
+    ht_Seed(24);
+
+    for (n = 0; n < FUZZ_REPORTS; n++)
+    {
+        uint8_t len = (uint8_t)(ht_Rand() % (BLE_GAP_EXT_SCAN_DATA_LEN_MIN + 1U));
+        uint8_t pos = 0;
+        bool connectable = (ht_Rand() % 4U) != 0U;
+        bool complete = (ht_Rand() % 8U) != 0U;
+
+        //AD structures of random length and type, sometimes the reporter's Service Data
+        while (pos < len)
+        {
+            uint8_t adLen = (uint8_t)(1U + (ht_Rand() % 12U));
+            uint8_t j;
+
+            adv[pos] = adLen;
+            for (j = 1; (j <= adLen) && ((pos + j) < len); j++)
+            {
+                adv[pos + j] = (uint8_t)ht_Rand();
+            }
+            if ((ht_Rand() % 16U) == 0U)
+            {
+                adv[pos] = 5;
+                memcpy(&adv[pos + 1U], &s_htReporterAdv[11], ((len - pos - 1U) < 5U) ? (len - pos - 1U) : 5U);
+            }
+            pos = (uint8_t)(pos + adv[pos] + 1U);
+        }
+
+        //Bytes past the report length are never the reason for a match
+        memset(&adv[len], 0x05, sizeof(adv) - len);
+        ht_CodedReport(&evt, adv, len);
+        memcpy(&evt.eventField.evtExtAdvReport.advData[len], &adv[len], sizeof(adv) - len);
+        evt.eventField.evtExtAdvReport.eventType = connectable ? BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_CONNECTABLE : 0U;
+        evt.eventField.evtExtAdvReport.dataStatus = complete ? BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE
+            : BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_TRUNCATED;
+
+        ht_Deliver(&evt);
+        expected += (connectable && complete && ht_RefMatch(adv, len)) ? 1U : 0U;
+        if (g_htMsgCnt != 0U)
+        {
+            accepted++;
+            APP_EVT_POOL_Free(((STACK_Event_T *)g_htMsg[0].msgData)->p_event);
+            ht_ClearMsg();
+        }
+        HT_CHECK_EQ(accepted, expected);
+    }
+
+    HT_CHECK(expected > FUZZ_REPORTS / 100U);
+    HT_CHECK_EQ(ht_InUse(), 0);
+}
+
+int main(void)
+{
+    test_reporter();
+    test_dropped();
+    test_queue_full();
+    test_fuzz();
+    return ht_Finish("test_coded_adv");
+}
@@ -0,0 +1,653 @@
+/*
+ * Host test and simulation of the connection parameter policy
+ * (app_conn_policy.c) on top of the RSSI zone estimator (app_zone_est.c).
+ *
+ * - Relax steps every APP_CONN_POLICY_STABLE_TIME, snap back on a zone change
+ *   or near a boundary, one procedure in flight, a failed relax step dropped
+ *   and a failed snap back retried.
+ * - Requests stay within the BLE_DM_Config bounds and the supervision timeout
+ *   covers twice the effective interval.
+ * - Day-long simulation of one tag: it rests in the low, middle or high zone
+ *   for 1 to 20 minutes, then walks to another at 10 dB/s. The controller
+ *   refreshes the RSSI once per effective connection event (4 dB Gaussian
+ *   noise), an update takes effect 6 events after the request. An alert
+ *   reaches the reporter at its next listening event after the zone change.
+ *   The policy is run against each of its levels held fixed; reported are
+ *   connection events per hour, central and peripheral, and the delay from
+ *   the path loss crossing into a zone to the alert reaching the reporter.
+ *   The policy halves the reporter events of the 20 ms connection for a
+ *   90th percentile alert delay of about 0.5 s instead of 0.35 s.
+ */
+
+#include <math.h>
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "app_ble/app_zone_est.c"
+#include "app_ble/app_conn_policy.c"
+
+#define SIM_HOURS               24
+#define SIM_NOISE_DB            4.0
+#define SIM_WALK_DB_PER_S       10
+#define SIM_REST_MIN_S          60
+#define SIM_REST_MAX_S          1200
+#define SIM_TICK_JITTER_MS      3           /* Ticks the application task may take to handle APP_MSG_RSSI_EVT */
+#define SIM_UPDATE_EVENTS       6           /* Connection events from the update request to its instant */
+#define SIM_SEG_MAX             2048
+#define SIM_ALERT_MAX           1024
+#define SIM_MODE_NUM            (APP_CONN_POLICY_LEVEL_MAX + 2)
+
+static APP_PXPM_Ctx_T   s_htCtx;
+static uint64_t         s_htNowUs;
+
+/* Link as the controller runs it */
+static uint64_t         s_htAnchorUs;           /* First event with the parameters in use */
+static uint64_t         s_htRssiEvtUs = ~0ULL;  /* Listening event the current RSSI comes from */
+static int8_t           s_htRssi;
+
+/* Update procedure in flight */
+static bool             s_htUpdPending;
+static uint64_t         s_htUpdInstantUs;
+static BLE_DM_ConnParamUpdate_T s_htUpdParams;
+static BLE_DM_ConnParamUpdate_T s_htUpdLast;
+static unsigned         s_htUpdCnt;
+static uint16_t         s_htUpdResult = MBA_RES_SUCCESS;
+static bool             s_htUpdFail;            /* Fail the procedure at its instant */
+static BLE_DM_ConnConfig_T s_htBounds = { 6, 3200, 0, 499, true };
+static uint16_t         s_htBoundsResult = MBA_RES_SUCCESS;
+
+static uint8_t          s_htZoneChangeCnt;
+static uint64_t         s_htZoneUs;
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByIndex(uint8_t index)
+{
+    return (index == 0U) ? &s_htCtx : NULL;
+}
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByHandle(uint16_t connHandle)
+{
+    return (connHandle == s_htCtx.connHandle) ? &s_htCtx : NULL;
+}
+
+void APP_PXPM_CTX_StampZoneEvt(APP_PXPM_Ctx_T *p_ctx, uint32_t stamp)
+{
+    (void)p_ctx;
+    (void)stamp;
+}
+
+void APP_PXPM_CTX_SetZone(APP_PXPM_Ctx_T *p_ctx, uint8_t zone)
+{
+    p_ctx->zone = zone;
+    s_htZoneChangeCnt++;
+    s_htZoneUs = s_htNowUs;
+}
+
+void APP_LINK_OPT_Update(uint16_t connHandle, int8_t rssi)
+{
+    (void)connHandle;
+    (void)rssi;
+}
+
+uint32_t RTC_Timer32CounterGet(void)
+{
+    return 0;
+}
+
+void APP_TIMER_NodeInit(APP_TIMER_Node_T *p_node, APP_TIMER_NodeCb_T cb, void *p_arg)
+{
+    (void)p_node;
+    (void)cb;
+    (void)p_arg;
+}
+
+uint16_t APP_TIMER_NodeStart(APP_TIMER_Node_T *p_node, uint32_t timeout, bool isPeriodicTimer)
+{
+    (void)p_node;
+    (void)timeout;
+    (void)isPeriodicTimer;
+    return APP_RES_SUCCESS;
+}
+
+void APP_TIMER_NodeStop(APP_TIMER_Node_T *p_node)
+{
+    (void)p_node;
+}
+
+bool APP_TIMER_NodeIsActive(APP_TIMER_Node_T const *p_node)
+{
+    (void)p_node;
+    return true;
+}
+
+uint16_t BLE_DM_GetConnConfig(BLE_DM_ConnConfig_T *p_config)
+{
+    *p_config = s_htBounds;
+    return s_htBoundsResult;
+}
+
+static uint64_t ht_EffIntervalUs(void)
+{
+    return (uint64_t)s_htCtx.connInterval * 1250U * (1U + s_htCtx.connLatency);
+}
+
+uint16_t BLE_DM_ConnectionParameterUpdate(uint16_t connHandle, BLE_DM_ConnParamUpdate_T *p_params)
+{
+    HT_CHECK_EQ(connHandle, s_htCtx.connHandle);
+    //One procedure per link at a time
+    HT_CHECK(!s_htUpdPending);
+
+    if (s_htUpdResult != MBA_RES_SUCCESS)
+    {
+        return s_htUpdResult;
+    }
+
+    s_htUpdParams = *p_params;
+    s_htUpdLast = *p_params;
+    s_htUpdCnt++;
+    s_htUpdPending = true;
+    //The instant is a few central events out; the peripheral has to listen to one of them first
+    s_htUpdInstantUs = s_htNowUs + ht_EffIntervalUs() + (uint64_t)SIM_UPDATE_EVENTS * s_htCtx.connInterval * 1250U;
+    return MBA_RES_SUCCESS;
+}
+
+/* What the stack reports once the instant has passed, as app_ble_handler.c handles it */
+static void ht_UpdateInstant(void)
+{
+    bool success = !s_htUpdFail;
+
+    s_htUpdPending = false;
+    if (success)
+    {
+        s_htCtx.connInterval = s_htUpdParams.intervalMax;
+        s_htCtx.connLatency = s_htUpdParams.latency;
+        s_htAnchorUs = s_htUpdInstantUs;
+    }
+    APP_CONN_POLICY_UpdateCompleted(s_htCtx.connHandle, success);
+}
+
+/* Latest listening event of the peripheral at or before us */
+static uint64_t ht_LastListenUs(uint64_t us)
+{
+    uint64_t eff = ht_EffIntervalUs();
+
+    return s_htAnchorUs + ((us - s_htAnchorUs) / eff) * eff;
+}
+
+static void ht_SetNow(uint64_t us)
+{
+    s_htNowUs = us;
+    g_htTick = (TickType_t)(us / 1000U);
+    if (s_htUpdPending && (s_htUpdInstantUs <= us))
+    {
+        uint64_t keep = s_htNowUs;
+
+        s_htNowUs = s_htUpdInstantUs;
+        ht_UpdateInstant();
+        s_htNowUs = keep;
+    }
+}
+
+static void ht_InitLink(uint16_t interval, uint16_t latency)
+{
+    memset(&s_htCtx, 0, sizeof(s_htCtx));
+    s_htCtx.connHandle = 0x41;
+    s_htCtx.state = APP_PXPM_CTX_STATE_MONITORING;
+    s_htCtx.pathLossParams.highThreshold = APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD;
+    s_htCtx.pathLossParams.highHysteresis = APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS;
+    s_htCtx.pathLossParams.lowThreshold = APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD;
+    s_htCtx.pathLossParams.lowHysteresis = APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS;
+    s_htCtx.connInterval = interval;
+    s_htCtx.connLatency = latency;
+    s_htCtx.zone = APP_ZONE_EST_ZONE_MIDDLE;
+    APP_ZONE_EST_Reset(&s_htCtx.zoneEst, APP_ZONE_EST_ZONE_MIDDLE);
+    s_htAnchorUs = s_htNowUs;
+    s_htRssiEvtUs = ~0ULL;
+    s_htUpdPending = false;
+    s_htUpdFail = false;
+    s_htUpdResult = MBA_RES_SUCCESS;
+    s_htUpdCnt = 0;
+    APP_CONN_POLICY_Reset(&s_htCtx.connPolicy);
+}
+
+// *****************************************************************************
+// Policy checks with a noiseless link
+// *****************************************************************************
+static int      s_htPathLoss;
+
+uint16_t BLE_GAP_GetRssi(uint16_t connHandle, int8_t *p_rssi);
+
+/* Runs the link for ms at a fixed path loss, sampled every 20 ms */
+static void ht_Run(unsigned ms, int pathLoss)
+{
+    unsigned t;
+
+    s_htPathLoss = pathLoss;
+    for (t = 0; t < ms; t += APP_ZONE_EST_SAMPLE_INTERVAL)
+    {
+        ht_SetNow(s_htNowUs + APP_ZONE_EST_SAMPLE_INTERVAL * 1000U);
+        APP_ZONE_EST_SampleLinks();
+    }
+}
+
+static void test_levels(void)
+{
+    static const uint16_t expInterval[] = { 16, 40, 40, 40 };
+    static const uint16_t expLatency[] = { 0, 0, 1, 2 };
+    APP_CONN_POLICY_Stats_T stats;
+    APP_CONN_POLICY_Stats_T before;
+    uint8_t level;
+
+    ht_SetNow(1000000);
+    APP_CONN_POLICY_GetStats(&before);
+    ht_InitLink(16, 0);
+
+    //Far from every boundary, one level per stable period, then nothing more
+    ht_Run(APP_CONN_POLICY_STABLE_TIME - 100U, 10);
+    HT_CHECK_EQ(s_htUpdCnt, 0);
+    for (level = 1; level <= APP_CONN_POLICY_LEVEL_MAX; level++)
+    {
+        ht_Run(APP_CONN_POLICY_STABLE_TIME, 10);
+        HT_CHECK_EQ(s_htUpdCnt, level);
+        HT_CHECK_EQ(s_htCtx.connPolicy.applied, level);
+        HT_CHECK_EQ(s_htCtx.connInterval, expInterval[level]);
+        HT_CHECK_EQ(s_htCtx.connLatency, expLatency[level]);
+        //Supervision timeout above twice the effective interval
+        HT_CHECK((uint32_t)s_htUpdLast.timeout * 40U > (uint32_t)s_htUpdLast.intervalMax * 5U * (1U + s_htUpdLast.latency));
+    }
+    ht_Run(3U * APP_CONN_POLICY_STABLE_TIME, 10);
+    HT_CHECK_EQ(s_htUpdCnt, APP_CONN_POLICY_LEVEL_MAX);
+
+    //Coming within the margin of the low zone leave point snaps back straight to level 0
+    ht_Run(5000, APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD + APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS - APP_CONN_POLICY_MARGIN + 2);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, 0);
+    HT_CHECK_EQ(s_htCtx.connInterval, 16);
+    HT_CHECK_EQ(s_htCtx.zone, APP_ZONE_EST_ZONE_LOW);
+
+    APP_CONN_POLICY_GetStats(&stats);
+    HT_CHECK_EQ(stats.requestCnt - before.requestCnt, APP_CONN_POLICY_LEVEL_MAX + 1U);
+    HT_CHECK_EQ(stats.successCnt - before.successCnt, APP_CONN_POLICY_LEVEL_MAX + 1U);
+    HT_CHECK_EQ(stats.snapCnt - before.snapCnt, 1);
+}
+
+static void test_bounds(void)
+{
+    ht_SetNow(s_htNowUs + 1000000U);
+    ht_InitLink(16, 0);
+
+    //Intervals and latency are clamped to what BLE_DM accepts
+    s_htBounds.maxAcceptConnInterval = 32;
+    s_htBounds.maxAcceptPeripheralLatency = 1;
+    ht_Run(4U * APP_CONN_POLICY_STABLE_TIME, 10);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, APP_CONN_POLICY_LEVEL_MAX);
+    HT_CHECK_EQ(s_htUpdLast.intervalMin, 32);
+    HT_CHECK_EQ(s_htUpdLast.intervalMax, 32);
+    HT_CHECK_EQ(s_htUpdLast.latency, 1);
+
+    //A snap back below the minimum interval asks for the minimum
+    s_htBounds.minAcceptConnInterval = 24;
+    ht_Run(5000, 33);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, 0);
+    HT_CHECK_EQ(s_htUpdLast.intervalMax, 24);
+    HT_CHECK_EQ(s_htUpdLast.latency, 0);
+    s_htBounds.minAcceptConnInterval = 6;
+
+    //Without a configuration, the spec range
+    ht_InitLink(16, 0);
+    s_htBoundsResult = MBA_RES_FAIL;
+    ht_Run(4U * APP_CONN_POLICY_STABLE_TIME, 10);
+    HT_CHECK_EQ(s_htUpdLast.intervalMax, 40);
+    HT_CHECK_EQ(s_htUpdLast.latency, 2);
+    s_htBoundsResult = MBA_RES_SUCCESS;
+    s_htBounds.maxAcceptConnInterval = 3200;
+    s_htBounds.maxAcceptPeripheralLatency = 499;
+}
+
+static void test_failures(void)
+{
+    unsigned cnt;
+
+    ht_SetNow(s_htNowUs + 1000000U);
+    ht_InitLink(16, 0);
+
+    //A relax step failing at its instant is dropped, the next comes a stable period later
+    s_htUpdFail = true;
+    ht_Run(APP_CONN_POLICY_STABLE_TIME + 500U, 10);
+    HT_CHECK_EQ(s_htUpdCnt, 1);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, 0);
+    HT_CHECK_EQ(s_htCtx.connPolicy.desired, 0);
+    ht_Run(APP_CONN_POLICY_STABLE_TIME - 1000U, 10);
+    HT_CHECK_EQ(s_htUpdCnt, 1);
+    s_htUpdFail = false;
+    ht_Run(3U * APP_CONN_POLICY_STABLE_TIME, 10);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, APP_CONN_POLICY_LEVEL_MAX);
+
+    //A rejected snap back is retried every APP_CONN_POLICY_RETRY_TIME until it goes through
+    s_htUpdResult = MBA_RES_FAIL;
+    cnt = s_htUpdCnt;
+    ht_Run(3000, 48);
+    HT_CHECK_EQ(s_htCtx.connPolicy.desired, 0);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, APP_CONN_POLICY_LEVEL_MAX);
+    s_htUpdResult = MBA_RES_SUCCESS;
+    ht_Run(APP_CONN_POLICY_RETRY_TIME + 1000U, 48);
+    HT_CHECK_EQ(s_htUpdCnt, cnt + 1U);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, 0);
+
+    //A snap back failing at its instant is retried too
+    ht_InitLink(40, 2);
+    s_htCtx.connPolicy.applied = APP_CONN_POLICY_LEVEL_MAX;
+    s_htCtx.connPolicy.desired = APP_CONN_POLICY_LEVEL_MAX;
+    s_htUpdFail = true;
+    ht_Run(2000, 48);
+    HT_CHECK(s_htUpdCnt >= 1U);
+    HT_CHECK_EQ(s_htCtx.connPolicy.desired, 0);
+    s_htUpdFail = false;
+    ht_Run(APP_CONN_POLICY_RETRY_TIME + 2000U, 48);
+    HT_CHECK_EQ(s_htCtx.connPolicy.applied, 0);
+    HT_CHECK_EQ(s_htCtx.connInterval, 16);
+}
+
+// *****************************************************************************
+// Day-long simulation
+// *****************************************************************************
+typedef struct HT_Seg_T
+{
+    uint64_t    startUs;
+    uint64_t    endUs;
+    double      fromPl;
+    double      toPl;
+} HT_Seg_T;
+
+typedef struct HT_Mode_T
+{
+    const char  *label;
+    int         fixedLevel;             /* -1 for the policy */
+    double      centralEvts;
+    double      periEvts;
+    uint32_t    alertUs[SIM_ALERT_MAX];
+    unsigned    alertNum;
+    unsigned    missCnt;                /* Walks whose zone change never came */
+    unsigned    falseCnt;               /* Zone changes during rests */
+    unsigned    updCnt;
+} HT_Mode_T;
+
+static HT_Seg_T         s_simSeg[SIM_SEG_MAX];
+static unsigned         s_simSegNum;
+static unsigned         s_simSegCur;
+static bool             s_simNoisy;
+
+static const APP_CONN_POLICY_Level_T *s_simLevel = s_connPolicyLevel;
+
+static double sim_Gauss(void)
+{
+    double u1 = ((double)(ht_Rand() % 1000000U) + 0.5) / 1000000.0;
+    double u2 = ((double)(ht_Rand() % 1000000U) + 0.5) / 1000000.0;
+
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double sim_PathLoss(uint64_t us)
+{
+    const HT_Seg_T *p_seg;
+
+    if (!s_simNoisy)
+    {
+        return (double)s_htPathLoss;
+    }
+
+    while ((s_simSegCur > 0U) && (us < s_simSeg[s_simSegCur].startUs))
+    {
+        s_simSegCur--;
+    }
+    while ((s_simSegCur + 1U < s_simSegNum) && (us >= s_simSeg[s_simSegCur].endUs))
+    {
+        s_simSegCur++;
+    }
+    p_seg = &s_simSeg[s_simSegCur];
+    if (p_seg->endUs == p_seg->startUs)
+    {
+        return p_seg->toPl;
+    }
+    return p_seg->fromPl + (p_seg->toPl - p_seg->fromPl) * (double)(us - p_seg->startUs) / (double)(p_seg->endUs - p_seg->startUs);
+}
+
+uint16_t BLE_GAP_GetRssi(uint16_t connHandle, int8_t *p_rssi)
+{
+    uint64_t evtUs = ht_LastListenUs(s_htNowUs);
+
+    (void)connHandle;
+
+    //The reading of the last event the peripheral attended
+    if (evtUs != s_htRssiEvtUs)
+    {
+        double pl = sim_PathLoss(evtUs) + (s_simNoisy ? SIM_NOISE_DB * sim_Gauss() : 0.0);
+        long rssi = -lround(pl);
+
+        s_htRssi = (int8_t)((rssi < -127) ? -127 : rssi);
+        s_htRssiEvtUs = evtUs;
+    }
+    *p_rssi = s_htRssi;
+    return MBA_RES_SUCCESS;
+}
+
+static double sim_RestPathLoss(uint8_t zone)
+{
+    switch (zone)
+    {
+        case APP_ZONE_EST_ZONE_LOW:    return 14.0 + (ht_Rand() % 7U);
+        case APP_ZONE_EST_ZONE_MIDDLE: return 40.0 + (ht_Rand() % 6U);
+        default:                       return 68.0 + (ht_Rand() % 11U);
+    }
+}
+
+/* The same day for every mode: rests and walks */
+static void sim_Scenario(uint64_t startUs)
+{
+    uint64_t us = startUs;
+    uint8_t zone = APP_ZONE_EST_ZONE_MIDDLE;
+    double pl = sim_RestPathLoss(zone);
+
+    s_simSegNum = 0;
+    while ((us < startUs + (uint64_t)SIM_HOURS * 3600000000ULL) && (s_simSegNum + 2U <= SIM_SEG_MAX))
+    {
+        uint64_t restUs = (uint64_t)(SIM_REST_MIN_S + (ht_Rand() % (SIM_REST_MAX_S - SIM_REST_MIN_S))) * 1000000U;
+        uint8_t next = (uint8_t)((zone + 1U + (ht_Rand() % 2U)) % 3U);
+        double nextPl = sim_RestPathLoss(next);
+        uint64_t walkUs = (uint64_t)(fabs(nextPl - pl) * 1000000.0 / SIM_WALK_DB_PER_S);
+
+        s_simSeg[s_simSegNum++] = (HT_Seg_T){ us, us + restUs, pl, pl };
+        us += restUs;
+        s_simSeg[s_simSegNum++] = (HT_Seg_T){ us, us + walkUs, pl, nextPl };
+        us += walkUs;
+        zone = next;
+        pl = nextPl;
+    }
+}
+
+static uint8_t ht_ZoneOfPl(double pl)
+{
+    if (pl > (APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD + APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS))
+    {
+        return APP_ZONE_EST_ZONE_HIGH;
+    }
+    if (pl < (APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD - APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS))
+    {
+        return APP_ZONE_EST_ZONE_LOW;
+    }
+    return APP_ZONE_EST_ZONE_MIDDLE;
+}
+
+/* Path loss the estimator must cross to report the zone a walk ends in */
+static double sim_EnterPoint(double fromPl, double toPl)
+{
+    const BLE_GAP_SetPathLossReportingParams_T *p_thr = &s_htCtx.pathLossParams;
+    uint8_t from = ht_ZoneOfPl(fromPl);
+    uint8_t to = ht_ZoneOfPl(toPl);
+
+    if (to == APP_ZONE_EST_ZONE_HIGH)
+    {
+        return p_thr->highThreshold + p_thr->highHysteresis;
+    }
+    if (to == APP_ZONE_EST_ZONE_LOW)
+    {
+        return p_thr->lowThreshold - p_thr->lowHysteresis;
+    }
+    return (from == APP_ZONE_EST_ZONE_HIGH) ? (p_thr->highThreshold - p_thr->highHysteresis) : (p_thr->lowThreshold + p_thr->lowHysteresis);
+}
+
+static uint64_t sim_NextListenUs(uint64_t us)
+{
+    uint64_t eff = ht_EffIntervalUs();
+
+    return s_htAnchorUs + ((us - s_htAnchorUs + eff - 1U) / eff) * eff;
+}
+
+static void sim_Run(HT_Mode_T *p_mode, uint64_t startUs)
+{
+    uint64_t endUs = s_simSeg[s_simSegNum - 1U].endUs;
+    uint64_t nominalUs = startUs;
+    uint64_t lastUs = startUs;
+    unsigned walk = 0;                  /* Segment index of the last walk started, 0 before the first */
+    bool alerted = true;
+    uint8_t dest = APP_ZONE_EST_ZONE_MIDDLE;
+    double crossUs = 0.0;
+    uint8_t zoneCnt;
+
+    ht_SetNow(startUs);
+    if (p_mode->fixedLevel < 0)
+    {
+        ht_InitLink(s_simLevel[0].interval, s_simLevel[0].latency);
+    }
+    else
+    {
+        //The link is created at the level and every update is refused
+        ht_InitLink(s_simLevel[p_mode->fixedLevel].interval, s_simLevel[p_mode->fixedLevel].latency);
+        s_htUpdResult = MBA_RES_FAIL;
+    }
+    s_simSegCur = 0;
+    zoneCnt = s_htZoneChangeCnt;
+
+    while (nominalUs < endUs)
+    {
+        uint64_t us = nominalUs + (uint64_t)(ht_Rand() % (SIM_TICK_JITTER_MS + 1U)) * 1000U;
+        double dt = (double)(us - lastUs);
+
+        p_mode->centralEvts += dt / ((double)s_htCtx.connInterval * 1250.0);
+        p_mode->periEvts += dt / (double)ht_EffIntervalUs();
+        lastUs = us;
+
+        //A new walk starts
+        while ((walk + 2U < s_simSegNum) && (s_simSeg[walk + 1U].startUs <= us) && ((walk == 0U) || (s_simSeg[walk + 2U].startUs <= us)))
+        {
+            const HT_Seg_T *p_seg;
+
+            walk = (walk == 0U) ? 1U : (walk + 2U);
+            p_seg = &s_simSeg[walk];
+            if (!alerted)
+            {
+                p_mode->missCnt++;
+            }
+            dest = ht_ZoneOfPl(p_seg->toPl);
+            crossUs = (double)p_seg->startUs + (sim_EnterPoint(p_seg->fromPl, p_seg->toPl) - p_seg->fromPl)
+                      / (p_seg->toPl - p_seg->fromPl) * (double)(p_seg->endUs - p_seg->startUs);
+            alerted = false;
+        }
+
+        ht_SetNow(us);
+        APP_ZONE_EST_SampleLinks();
+
+        if (s_htZoneChangeCnt != zoneCnt)
+        {
+            zoneCnt = s_htZoneChangeCnt;
+            if (!alerted && (s_htCtx.zone == dest) && (walk != 0U))
+            {
+                //The alert goes out at the next event the reporter listens to, with the parameters in use
+                double delay = (double)sim_NextListenUs(s_htZoneUs) - crossUs;
+
+                if (p_mode->alertNum < SIM_ALERT_MAX)
+                {
+                    p_mode->alertUs[p_mode->alertNum++] = (delay > 0.0) ? (uint32_t)delay : 0U;
+                }
+                alerted = true;
+            }
+            else if ((walk == 0U) || alerted || (us >= s_simSeg[walk].endUs))
+            {
+                p_mode->falseCnt++;
+            }
+        }
+
+        nominalUs += APP_ZONE_EST_SAMPLE_INTERVAL * 1000U;
+    }
+    p_mode->updCnt = s_htUpdCnt;
+}
+
+static int sim_CmpU32(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+static void test_simulation(void)
+{
+    static HT_Mode_T modes[SIM_MODE_NUM];
+    uint64_t startUs = s_htNowUs + 1000000U;
+    double hours;
+    unsigned m;
+
+    modes[0].label = "policy";
+    modes[0].fixedLevel = -1;
+    for (m = 1; m < SIM_MODE_NUM; m++)
+    {
+        modes[m].fixedLevel = (int)m - 1;
+    }
+
+    ht_Seed(16);
+    sim_Scenario(startUs);
+    hours = (double)(s_simSeg[s_simSegNum - 1U].endUs - startUs) / 3600000000.0;
+    s_simNoisy = true;
+
+    printf("  %u walks in %.1f h\n", s_simSegNum / 2U, hours);
+    printf("  %-22s %12s %12s %8s %22s %6s %6s\n", "", "central/h", "reporter/h", "updates", "alert med/p90/max ms", "missed", "false");
+    for (m = 0; m < SIM_MODE_NUM; m++)
+    {
+        HT_Mode_T *p_mode = &modes[m];
+        char label[32];
+
+        ht_Seed(0x16000 + m);
+        sim_Run(p_mode, startUs);
+        qsort(p_mode->alertUs, p_mode->alertNum, sizeof(uint32_t), sim_CmpU32);
+
+        if (p_mode->fixedLevel < 0)
+        {
+            snprintf(label, sizeof(label), "policy");
+        }
+        else
+        {
+            snprintf(label, sizeof(label), "fixed %3.0fms lat %u", s_simLevel[p_mode->fixedLevel].interval * 1.25,
+                     s_simLevel[p_mode->fixedLevel].latency);
+        }
+        printf("  %-22s %12.0f %12.0f %8u %6u/%6u/%-8u %6u %6u\n", label, p_mode->centralEvts / hours, p_mode->periEvts / hours,
+               p_mode->updCnt, p_mode->alertUs[p_mode->alertNum / 2U] / 1000U, p_mode->alertUs[(p_mode->alertNum * 9U) / 10U] / 1000U,
+               p_mode->alertUs[p_mode->alertNum - 1U] / 1000U, p_mode->missCnt, p_mode->falseCnt);
+        HT_CHECK_EQ(p_mode->missCnt, 0);
+    }
+
+    //Against the connection the monitor creates: less than half the reporter events for alerts a few
+    //connection events later, and sooner than with the first relaxed level held for good
+    HT_CHECK(modes[0].periEvts * 2.0 < modes[1].periEvts);
+    HT_CHECK(modes[0].alertUs[(modes[0].alertNum * 9U) / 10U] < modes[2].alertUs[(modes[2].alertNum * 9U) / 10U]);
+    HT_CHECK(modes[0].alertUs[modes[0].alertNum - 1U] < 1000000U);
+    HT_CHECK_EQ(modes[0].falseCnt, 0);
+}
+
+int main(void)
+{
+    test_levels();
+    test_bounds();
+    test_failures();
+    test_simulation();
+    return ht_Finish("test_conn_policy");
+}
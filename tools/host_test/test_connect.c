@@ -0,0 +1,224 @@
+/*
+ * Host test of the connect timeout of the monitor (app_pxpm_ctx.c).
+ *
+ * A connection creation whose reporter never answers stays pending in the
+ * controller. Every scenario below starts one with SetConnecting(true) as
+ * app.c does after a successful BLE_GAP_CreateConnection, and delivers the
+ * stack events the BLE_GAP_EVT_CONNECTED handler turns into
+ * SetConnecting(false), whatever their status.
+ *
+ * - A connect that never completes: the periodic node is armed for
+ *   APP_PXPM_CTX_CONNECT_TIMEOUT, its expiry queues APP_MSG_CONNECT_TIMEOUT,
+ *   the handler cancels once, and the failed BLE_GAP_EVT_CONNECTED the
+ *   cancel completes with stops the timer and allows the next connect.
+ * - A rejected cancel, and an expiry message dropped on a full queue, are
+ *   retried at the next expiry; the flag is never cleared without the event.
+ * - A connect that completes stops the timer; an expiry already queued then
+ *   cancels nothing.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "app_ble/app_pxpm_ctx.c"
+
+static APP_TIMER_Node_T *s_htNode;
+static uint32_t         s_htTimeout;
+static bool             s_htPeriodic;
+static bool             s_htActive;
+static unsigned         s_htCancelCnt;
+static uint16_t         s_htCancelRes = MBA_RES_SUCCESS;
+static bool             s_htCancelPending;     /* Cancel issued, its failed BLE_GAP_EVT_CONNECTED not delivered yet */
+
+void IAS_update(uint16_t conn_handle, uint8_t alert_level)
+{
+    (void)conn_handle;
+    (void)alert_level;
+}
+
+uint32_t RTC_Timer32CounterGet(void)
+{
+    return 0;
+}
+
+uint32_t RTC_Timer32FrequencyGet(void)
+{
+    return 32768U;
+}
+
+bool APP_TIMER_IsTimerExisted(uint8_t timerId)
+{
+    (void)timerId;
+    return false;
+}
+
+uint16_t APP_TIMER_StopTimer(uint8_t timerId)
+{
+    (void)timerId;
+    return APP_RES_SUCCESS;
+}
+
+void APP_TIMER_NodeInit(APP_TIMER_Node_T *p_node, APP_TIMER_NodeCb_T cb, void *p_arg)
+{
+    memset(p_node, 0, sizeof(APP_TIMER_Node_T));
+    p_node->cb = cb;
+    p_node->p_arg = p_arg;
+    s_htNode = p_node;
+    s_htActive = false;
+}
+
+uint16_t APP_TIMER_NodeStart(APP_TIMER_Node_T *p_node, uint32_t timeout, bool isPeriodicTimer)
+{
+    HT_CHECK(p_node == s_htNode);
+    s_htTimeout = timeout;
+    s_htPeriodic = isPeriodicTimer;
+    s_htActive = true;
+    return APP_RES_SUCCESS;
+}
+
+void APP_TIMER_NodeStop(APP_TIMER_Node_T *p_node)
+{
+    HT_CHECK(p_node == s_htNode);
+    s_htActive = false;
+}
+
+uint16_t BLE_GAP_CreateConnectionCancel(void)
+{
+    s_htCancelCnt++;
+    if (s_htCancelRes == MBA_RES_SUCCESS)
+    {
+        s_htCancelPending = true;
+    }
+    return s_htCancelRes;
+}
+
+/* Expiry of the connect timer, from the timer daemon task */
+static void ht_Expire(void)
+{
+    HT_CHECK(s_htActive);
+    s_htNode->cb(s_htNode->p_arg);
+    if (!s_htPeriodic)
+    {
+        s_htActive = false;
+    }
+}
+
+/* The application task draining its queue */
+static void ht_RunApp(void)
+{
+    unsigned i;
+
+    for (i = 0; i < g_htMsgCnt; i++)
+    {
+        if (g_htMsg[i].msgId == APP_MSG_CONNECT_TIMEOUT)
+        {
+            HT_CHECK_EQ(g_htMsg[i].msgLen, 0);
+            (void)APP_PXPM_CTX_ConnectTimeoutHandler();
+        }
+    }
+    ht_ClearMsg();
+}
+
+/* BLE_GAP_EVT_CONNECTED, failed when it completes a cancel */
+static void ht_Connected(void)
+{
+    s_htCancelPending = false;
+    APP_PXPM_CTX_SetConnecting(false);
+}
+
+static void ht_Connect(void)
+{
+    HT_CHECK(APP_PXPM_CTX_CanConnect());
+    APP_PXPM_CTX_SetConnecting(true);
+    HT_CHECK(!APP_PXPM_CTX_CanConnect());
+    HT_CHECK(s_htActive);
+    HT_CHECK_EQ(s_htTimeout, APP_PXPM_CTX_CONNECT_TIMEOUT);
+}
+
+static void ht_TestNeverCompletes(void)
+{
+    unsigned round;
+
+    //Several initiations in a row, each to a reporter that never answers
+    for (round = 0; round < 3; round++)
+    {
+        s_htCancelCnt = 0;
+        ht_Connect();
+
+        ht_Expire();
+        HT_CHECK_EQ(g_htMsgCnt, 1);
+        HT_CHECK_EQ(s_htCancelCnt, 0);
+        ht_RunApp();
+        HT_CHECK_EQ(s_htCancelCnt, 1);
+        HT_CHECK(s_htCancelPending);
+
+        //Cancelled, but not done until the stack reports it
+        HT_CHECK(!APP_PXPM_CTX_CanConnect());
+
+        ht_Connected();
+        HT_CHECK(APP_PXPM_CTX_CanConnect());
+        HT_CHECK(!s_htActive);
+    }
+}
+
+static void ht_TestRetry(void)
+{
+    s_htCancelCnt = 0;
+    ht_Connect();
+
+    //The expiry message is lost on a full queue
+    g_htQueueFull = true;
+    ht_Expire();
+    g_htQueueFull = false;
+    HT_CHECK_EQ(g_htMsgCnt, 0);
+    HT_CHECK(s_htActive);
+
+    //The cancel is rejected
+    s_htCancelRes = MBA_RES_FAIL;
+    ht_Expire();
+    ht_RunApp();
+    HT_CHECK_EQ(s_htCancelCnt, 1);
+    HT_CHECK(!APP_PXPM_CTX_CanConnect());
+    HT_CHECK(s_htActive);
+
+    s_htCancelRes = MBA_RES_SUCCESS;
+    ht_Expire();
+    ht_RunApp();
+    HT_CHECK_EQ(s_htCancelCnt, 2);
+    HT_CHECK(s_htCancelPending);
+    ht_Connected();
+    HT_CHECK(APP_PXPM_CTX_CanConnect());
+    HT_CHECK(!s_htActive);
+}
+
+static void ht_TestCompletes(void)
+{
+    s_htCancelCnt = 0;
+    ht_Connect();
+    ht_Connected();
+    HT_CHECK(!s_htActive);
+    HT_CHECK(APP_PXPM_CTX_CanConnect());
+
+    //Expired just before the connection completed
+    ht_Connect();
+    ht_Expire();
+    ht_Connected();
+    ht_RunApp();
+    HT_CHECK_EQ(s_htCancelCnt, 0);
+    HT_CHECK(APP_PXPM_CTX_CanConnect());
+}
+
+int main(void)
+{
+    APP_PXPM_CTX_Init();
+    HT_CHECK(s_htNode != NULL);
+    HT_CHECK(!s_htActive);
+
+    ht_TestNeverCompletes();
+    ht_TestRetry();
+    ht_TestCompletes();
+
+    return ht_Finish("test_connect");
+}
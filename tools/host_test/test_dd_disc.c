@@ -0,0 +1,791 @@
+/*
+ * Host test and simulation of the BLE_DD service discovery (ble_dd.c)
+ * against a mock GATT server, in the per-service mode and in the
+ * single-pass mode the monitor uses.
+ *
+ * The mock answers the GATTC discovery procedures from an attribute table
+ * the way the stack runs them: one ATT request per connection event, a
+ * response event per PDU, GATT_PROCEDURE_STATUS_FINISH when the last handle
+ * reaches the end of the range and an Attribute Not Found error response
+ * otherwise. The services registered are those of the monitor: LLS, IAS
+ * and TPS (TX Power Level, its CCCD and presentation format) of BLE_PXPM,
+ * Service Changed and its CCCD of the GATT cache.
+ *
+ * - Both modes find the same characteristic, descriptor and service
+ *   handles, on the reporter database and on a denser one where the
+ *   registered services are contiguous, and leave missing services at 0.
+ * - BLE_DD_EVT_DISC_COMPLETE is sent once, with the procedure idle.
+ * - Requests refused with MBA_RES_BUSY are sent on
+ *   GATTC_EVT_PROTOCOL_AVAILABLE, and a restarted discovery finds the same.
+ * - ATT round trips and simulated time from the connection to
+ *   BLE_DD_EVT_DISC_COMPLETE, 20 ms connection interval, per database and
+ *   MTU. At MTU 23 the single pass takes 10 round trips against 15 on the
+ *   reporter (200 against 300 ms) and 11 against 16 on the dense database:
+ *   one sweep replaces a search and its closing error response per
+ *   service, and the contiguous GATT, LLS, IAS and TPS are one range with
+ *   one characteristic and one descriptor sweep. At MTU 247 the sweep and
+ *   the range fit one response each, 6 round trips against 16; the search
+ *   per service gains nothing from the larger MTU.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "ble_util/ble_conn_reg.c"
+#include "ble_gcm/ble_dd.c"
+
+#define HT_CONN                 0x0031
+#define HT_ATTR_MAX             96
+#define HT_SVC_CHAR_MAX         4
+
+#define SIM_CONN_INTERVAL_MS    20      /* Connection interval of the monitor, one ATT round trip per event */
+
+/* Registered services, as BLE_PXPM and the GATT cache register them */
+#define HT_SVC_LLS              0
+#define HT_SVC_IAS              1
+#define HT_SVC_TPS              2
+#define HT_SVC_GATT             3
+#define HT_SVC_NUM              4
+
+typedef struct HT_Char_T
+{
+    uint16_t    uuid;
+    bool        uuid128;
+    uint8_t     descNum;
+    uint16_t    desc[3];
+} HT_Char_T;
+
+typedef struct HT_Svc_T
+{
+    uint16_t    uuid;
+    bool        uuid128;
+    uint16_t    start;              /* 0: right after the previous service */
+    uint8_t     charNum;
+    HT_Char_T   ch[HT_SVC_CHAR_MAX];
+} HT_Svc_T;
+
+typedef struct HT_Attr_T
+{
+    uint16_t    handle;
+    uint16_t    type;
+    bool        type128;
+    uint16_t    endGroup;           /* Service declarations */
+    uint8_t     valueLen;
+    uint8_t     value[19];
+} HT_Attr_T;
+
+typedef enum HT_Proc_T
+{
+    HT_PROC_IDLE = 0,
+    HT_PROC_PRIM_ALL,
+    HT_PROC_PRIM_UUID,
+    HT_PROC_CHAR,
+    HT_PROC_DESC
+} HT_Proc_T;
+
+static HT_Attr_T    s_htAttr[HT_ATTR_MAX];
+static unsigned     s_htAttrNum;
+static uint16_t     s_htMtu;
+
+static HT_Proc_T    s_htProc;
+static uint16_t     s_htCursor;
+static uint16_t     s_htEnd;
+static uint8_t      s_htUuid[ATT_UUID_LENGTH_16];
+static uint8_t      s_htUuidLen;
+
+static unsigned     s_htRtt;
+static unsigned     s_htNowMs;
+static unsigned     s_htCompleteCnt;
+static unsigned     s_htCompleteMs;
+static unsigned     s_htBusyMask;       /* One bit per HT_Proc_T: refuse the next request of that procedure once */
+static unsigned     s_htBusyCnt;
+
+static BLE_DD_Config_T      s_htConfig;
+
+/* Registration of the monitor */
+static const ATT_Uuid_T     s_htAlertLv =       { { UINT16_TO_BYTES(0x2A06) }, ATT_UUID_LENGTH_2 };
+static const ATT_Uuid_T     s_htTxPwrLv =       { { UINT16_TO_BYTES(0x2A07) }, ATT_UUID_LENGTH_2 };
+static const ATT_Uuid_T     s_htSvcChanged =    { { UINT16_TO_BYTES(0x2A05) }, ATT_UUID_LENGTH_2 };
+static const ATT_Uuid_T     s_htCccd =          { { UINT16_TO_BYTES(UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG) }, ATT_UUID_LENGTH_2 };
+static const ATT_Uuid_T     s_htCpfd =          { { UINT16_TO_BYTES(UUID_DESCRIPTOR_CHAR_PRE_FORMAT) }, ATT_UUID_LENGTH_2 };
+
+static BLE_DD_DiscChar_T    s_htDiscAlertLv =       { &s_htAlertLv, 0 };
+static BLE_DD_DiscChar_T    s_htDiscTxPwrLv =       { &s_htTxPwrLv, 0 };
+static BLE_DD_DiscChar_T    s_htDiscTxPwrCccd =     { &s_htCccd, CHAR_SET_DESCRIPTOR };
+static BLE_DD_DiscChar_T    s_htDiscTxPwrCpfd =     { &s_htCpfd, CHAR_SET_DESCRIPTOR };
+static BLE_DD_DiscChar_T    s_htDiscSvcChanged =    { &s_htSvcChanged, 0 };
+static BLE_DD_DiscChar_T    s_htDiscSvcChangedCccd = { &s_htCccd, CHAR_SET_DESCRIPTOR };
+
+static BLE_DD_DiscChar_T    *s_htAlertLvList[] = { &s_htDiscAlertLv };
+static BLE_DD_DiscChar_T    *s_htTxPwrList[] = { &s_htDiscTxPwrLv, &s_htDiscTxPwrCccd, &s_htDiscTxPwrCpfd };
+static BLE_DD_DiscChar_T    *s_htGattList[] = { &s_htDiscSvcChanged, &s_htDiscSvcChangedCccd };
+
+static const uint16_t       s_htSvcUuid[HT_SVC_NUM] = { 0x1803, 0x1802, 0x1804, 0x1801 };
+static BLE_DD_DiscChar_T    **s_htSvcList[HT_SVC_NUM] = { s_htAlertLvList, s_htAlertLvList, s_htTxPwrList, s_htGattList };
+static const uint8_t        s_htSvcCharNum[HT_SVC_NUM] = { 1, 1, 3, 2 };
+
+static BLE_DD_CharInfo_T    s_htCharInfo[HT_SVC_NUM][BLE_GAP_MAX_LINK_NBR][3];
+static BLE_DD_CharList_T    s_htCharList[HT_SVC_NUM][BLE_GAP_MAX_LINK_NBR];
+static BLE_DD_DiscInfo_T    s_htDiscInfo[HT_SVC_NUM];
+
+/* The reporter: GAP and GATT of the stack, the services at their fixed handles */
+static const HT_Svc_T s_htDbReporter[] =
+{
+    { 0x1800, false, 0x0001, 2, { { 0x2A00 }, { 0x2A01 } } },
+    { 0x1801, false, 0,      1, { { 0x2A05, false, 1, { UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG } } } },
+    { 0x1803, false, 0x00F0, 1, { { 0x2A06 } } },
+    { 0x1802, false, 0x00FA, 1, { { 0x2A06 } } },
+    { 0x1804, false, 0x0139, 1, { { 0x2A07 } } },
+};
+
+/* Registered services back to back, a TPS with its descriptors, services nobody registers around them */
+static const HT_Svc_T s_htDbDense[] =
+{
+    { 0x1800, false, 0x0001, 3, { { 0x2A00 }, { 0x2A01 }, { 0x2A04 } } },
+    { 0x1801, false, 0,      1, { { 0x2A05, false, 1, { UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG } } } },
+    { 0x1803, false, 0,      1, { { 0x2A06 } } },
+    { 0x1802, false, 0,      1, { { 0x2A06 } } },
+    { 0x1804, false, 0,      1, { { 0x2A07, false, 2, { UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG, UUID_DESCRIPTOR_CHAR_PRE_FORMAT } } } },
+    { 0x180A, false, 0,      4, { { 0x2A29 }, { 0x2A24 }, { 0x2A26 }, { 0x2A28 } } },
+    { 0x180F, false, 0,      1, { { 0x2A19, false, 1, { UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG } } } },
+    { 0xFE01, true,  0,      2, { { 0x0001, true, 1, { UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG } }, { 0x0002, true } } },
+};
+
+/* Only the alert services, the IAS before the LLS */
+static const HT_Svc_T s_htDbPartial[] =
+{
+    { 0x1800, false, 0x0001, 2, { { 0x2A00 }, { 0x2A01 } } },
+    { 0x1802, false, 0x0010, 1, { { 0x2A06 } } },
+    { 0x1803, false, 0x0020, 1, { { 0x2A06 } } },
+};
+
+static void ht_PutUuid(uint8_t *p_buf, uint16_t uuid, bool uuid128)
+{
+    if (uuid128)
+    {
+        uint8_t i;
+
+        //Vendor base, the 16-bit alias in bytes 12-13
+        for (i = 0; i < ATT_UUID_LENGTH_16; i++)
+        {
+            p_buf[i] = (uint8_t)(0xA0U + i);
+        }
+        p_buf[12] = (uint8_t)uuid;
+        p_buf[13] = (uint8_t)(uuid >> 8);
+    }
+    else
+    {
+        p_buf[0] = (uint8_t)uuid;
+        p_buf[1] = (uint8_t)(uuid >> 8);
+    }
+}
+
+static HT_Attr_T *ht_AddAttr(uint16_t handle, uint16_t type, bool type128)
+{
+    HT_Attr_T *p_attr = &s_htAttr[s_htAttrNum++];
+
+    memset(p_attr, 0, sizeof(HT_Attr_T));
+    p_attr->handle = handle;
+    p_attr->type = type;
+    p_attr->type128 = type128;
+    return p_attr;
+}
+
+static void ht_BuildDb(const HT_Svc_T *p_svc, unsigned svcNum)
+{
+    uint16_t handle = 1;
+    unsigned s, c, d;
+
+    s_htAttrNum = 0;
+    for (s = 0; s < svcNum; s++)
+    {
+        HT_Attr_T *p_svcAttr;
+
+        if (p_svc[s].start != 0U)
+        {
+            handle = p_svc[s].start;
+        }
+        p_svcAttr = ht_AddAttr(handle++, UUID_PRIMARY_SERVICE, false);
+        p_svcAttr->valueLen = p_svc[s].uuid128 ? ATT_UUID_LENGTH_16 : ATT_UUID_LENGTH_2;
+        ht_PutUuid(p_svcAttr->value, p_svc[s].uuid, p_svc[s].uuid128);
+
+        for (c = 0; c < p_svc[s].charNum; c++)
+        {
+            const HT_Char_T *p_ch = &p_svc[s].ch[c];
+            HT_Attr_T *p_decl = ht_AddAttr(handle++, UUID_CHARACTERISTIC, false);
+
+            p_decl->value[0] = ATT_PROP_READ;
+            p_decl->value[1] = (uint8_t)handle;
+            p_decl->value[2] = (uint8_t)(handle >> 8);
+            p_decl->valueLen = (uint8_t)(3U + (p_ch->uuid128 ? ATT_UUID_LENGTH_16 : ATT_UUID_LENGTH_2));
+            ht_PutUuid(&p_decl->value[3], p_ch->uuid, p_ch->uuid128);
+            (void)ht_AddAttr(handle++, p_ch->uuid, p_ch->uuid128);
+            for (d = 0; d < p_ch->descNum; d++)
+            {
+                (void)ht_AddAttr(handle++, p_ch->desc[d], false);
+            }
+        }
+        p_svcAttr->endGroup = (uint16_t)(handle - 1U);
+    }
+    HT_CHECK(s_htAttrNum <= HT_ATTR_MAX);
+}
+
+/* Handles the database holds for a registered service: declaration and value of each characteristic, or the descriptor */
+static void ht_Expected(uint8_t svc, BLE_DD_CharInfo_T *p_info, BLE_DD_DiscInfo_T *p_range)
+{
+    uint8_t uuid[ATT_UUID_LENGTH_2];
+    unsigned i, k;
+    uint16_t end = 0;
+
+    memset(p_info, 0, sizeof(BLE_DD_CharInfo_T) * 3U);
+    memset(p_range, 0, sizeof(BLE_DD_DiscInfo_T));
+    ht_PutUuid(uuid, s_htSvcUuid[svc], false);
+
+    for (i = 0; i < s_htAttrNum; i++)
+    {
+        if ((s_htAttr[i].type == UUID_PRIMARY_SERVICE) && (s_htAttr[i].valueLen == ATT_UUID_LENGTH_2)
+            && (memcmp(s_htAttr[i].value, uuid, ATT_UUID_LENGTH_2) == 0))
+        {
+            p_range->svcStartHandle = s_htAttr[i].handle;
+            p_range->svcEndHandle = end = s_htAttr[i].endGroup;
+            break;
+        }
+    }
+    if (end == 0U)
+    {
+        return;
+    }
+
+    for (i++; (i < s_htAttrNum) && (s_htAttr[i].handle <= end); i++)
+    {
+        for (k = 0; k < s_htSvcCharNum[svc]; k++)
+        {
+            const BLE_DD_DiscChar_T *p_disc = s_htSvcList[svc][k];
+            uint16_t type = (uint16_t)(p_disc->p_uuid->uuid[0] | (p_disc->p_uuid->uuid[1] << 8));
+
+            if ((p_disc->settings & CHAR_SET_DESCRIPTOR) != 0U)
+            {
+                if ((s_htAttr[i].type == type) && (p_info[k].charHandle == 0U))
+                {
+                    p_info[k].charHandle = s_htAttr[i].handle;
+                }
+            }
+            else if ((s_htAttr[i].type == UUID_CHARACTERISTIC)
+                && (memcmp(&s_htAttr[i].value[3], p_disc->p_uuid->uuid, ATT_UUID_LENGTH_2) == 0))
+            {
+                p_info[k].attrHandle = s_htAttr[i].handle;
+                p_info[k].charHandle = (uint16_t)(s_htAttr[i].value[1] | (s_htAttr[i].value[2] << 8));
+                p_info[k].property = s_htAttr[i].value[0];
+            }
+        }
+    }
+}
+
+/* Mock GATT client: requests are answered one connection event later */
+static uint16_t ht_Start(HT_Proc_T proc, uint16_t start, uint16_t end)
+{
+    HT_CHECK_EQ(s_htProc, HT_PROC_IDLE);
+    if (s_htBusyMask & (1U << proc))
+    {
+        s_htBusyMask &= ~(1U << proc);
+        s_htBusyCnt++;
+        return MBA_RES_BUSY;
+    }
+    s_htProc = proc;
+    s_htCursor = start;
+    s_htEnd = end;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t GATTC_DiscoverAllPrimaryServices(uint16_t connHandle)
+{
+    HT_CHECK_EQ(connHandle, HT_CONN);
+    return ht_Start(HT_PROC_PRIM_ALL, 0x0001, 0xFFFF);
+}
+
+uint16_t GATTC_DiscoverPrimaryServiceByUUID(uint16_t connHandle, GATTC_DiscoverPrimaryServiceByUuidParams_T *p_discParams)
+{
+    HT_CHECK_EQ(connHandle, HT_CONN);
+    memcpy(s_htUuid, p_discParams->value, p_discParams->valueLength);
+    s_htUuidLen = (uint8_t)p_discParams->valueLength;
+    return ht_Start(HT_PROC_PRIM_UUID, p_discParams->startHandle, p_discParams->endHandle);
+}
+
+uint16_t GATTC_DiscoverAllCharacteristics(uint16_t connHandle, uint16_t startHandle, uint16_t endHandle)
+{
+    HT_CHECK_EQ(connHandle, HT_CONN);
+    HT_CHECK(startHandle <= endHandle);
+    return ht_Start(HT_PROC_CHAR, startHandle, endHandle);
+}
+
+uint16_t GATTC_DiscoverAllDescriptors(uint16_t connHandle, uint16_t startHandle, uint16_t endHandle)
+{
+    HT_CHECK_EQ(connHandle, HT_CONN);
+    HT_CHECK(startHandle <= endHandle);
+    return ht_Start(HT_PROC_DESC, startHandle, endHandle);
+}
+
+static void ht_Deliver(GATT_Event_T *p_evt)
+{
+    STACK_Event_T stackEvt;
+
+    stackEvt.groupId = STACK_GRP_GATT;
+    stackEvt.evtLen = sizeof(GATT_Event_T);
+    stackEvt.p_event = (uint8_t *)p_evt;
+    BLE_DD_BleEventHandler(&s_htConfig, &stackEvt);
+}
+
+static void ht_DeliverError(uint8_t reqOpcode)
+{
+    GATT_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = GATTC_EVT_ERROR_RESP;
+    evt.eventField.onError.connHandle = HT_CONN;
+    evt.eventField.onError.reqOpcode = reqOpcode;
+    evt.eventField.onError.attrHandle = s_htCursor;
+    evt.eventField.onError.errCode = ATT_ERRCODE_ATTRIBUTE_NOT_FOUND;
+    s_htProc = HT_PROC_IDLE;
+    ht_Deliver(&evt);
+}
+
+/* One ATT round trip of the procedure in progress */
+static void ht_RoundTrip(void)
+{
+    GATT_Event_T evt;
+    uint16_t last = 0, lastEnd = 0, len = 0;
+    uint8_t pairLen = 0, n = 0, max;
+    unsigned i;
+
+    s_htRtt++;
+    s_htNowMs += SIM_CONN_INTERVAL_MS;
+    memset(&evt, 0, sizeof(evt));
+
+    switch (s_htProc)
+    {
+        case HT_PROC_PRIM_ALL:
+            for (i = 0; i < s_htAttrNum; i++)
+            {
+                HT_Attr_T *p_attr = &s_htAttr[i];
+
+                if ((p_attr->handle < s_htCursor) || (p_attr->type != UUID_PRIMARY_SERVICE))
+                {
+                    continue;
+                }
+                if (n == 0U)
+                {
+                    pairLen = (uint8_t)(4U + p_attr->valueLen);
+                }
+                max = (uint8_t)((s_htMtu - 2U) / pairLen);
+                if (((uint8_t)(4U + p_attr->valueLen) != pairLen) || (n == max))
+                {
+                    break;
+                }
+                U16_TO_BUF_LE(&evt.eventField.onDiscPrimServResp.attrData[len], p_attr->handle);
+                U16_TO_BUF_LE(&evt.eventField.onDiscPrimServResp.attrData[len + 2U], p_attr->endGroup);
+                memcpy(&evt.eventField.onDiscPrimServResp.attrData[len + 4U], p_attr->value, p_attr->valueLen);
+                len += pairLen;
+                lastEnd = p_attr->endGroup;
+                n++;
+            }
+            if (n == 0U)
+            {
+                ht_DeliverError(ATT_READ_BY_GROUP_TYPE_REQ);
+                return;
+            }
+            evt.eventId = GATTC_EVT_DISC_PRIM_SERV_RESP;
+            evt.eventField.onDiscPrimServResp.connHandle = HT_CONN;
+            evt.eventField.onDiscPrimServResp.attrPairLength = pairLen;
+            evt.eventField.onDiscPrimServResp.attrDataLength = len;
+            last = lastEnd;
+            break;
+
+        case HT_PROC_PRIM_UUID:
+            for (i = 0; i < s_htAttrNum; i++)
+            {
+                HT_Attr_T *p_attr = &s_htAttr[i];
+
+                if ((p_attr->handle < s_htCursor) || (p_attr->handle > s_htEnd) || (p_attr->type != UUID_PRIMARY_SERVICE)
+                    || (p_attr->valueLen != s_htUuidLen) || (memcmp(p_attr->value, s_htUuid, s_htUuidLen) != 0))
+                {
+                    continue;
+                }
+                if (n == (uint8_t)((s_htMtu - 1U) / 4U))
+                {
+                    break;
+                }
+                U16_TO_BUF_LE(&evt.eventField.onDiscPrimServByUuidResp.handleInfo[len], p_attr->handle);
+                U16_TO_BUF_LE(&evt.eventField.onDiscPrimServByUuidResp.handleInfo[len + 2U], p_attr->endGroup);
+                len += 4U;
+                lastEnd = p_attr->endGroup;
+                n++;
+            }
+            if (n == 0U)
+            {
+                ht_DeliverError(ATT_FIND_BY_TYPE_VALUE_REQ);
+                return;
+            }
+            evt.eventId = GATTC_EVT_DISC_PRIM_SERV_BY_UUID_RESP;
+            evt.eventField.onDiscPrimServByUuidResp.connHandle = HT_CONN;
+            evt.eventField.onDiscPrimServByUuidResp.handleInfoLength = len;
+            last = lastEnd;
+            break;
+
+        case HT_PROC_CHAR:
+            for (i = 0; i < s_htAttrNum; i++)
+            {
+                HT_Attr_T *p_attr = &s_htAttr[i];
+
+                if ((p_attr->handle < s_htCursor) || (p_attr->handle > s_htEnd) || (p_attr->type != UUID_CHARACTERISTIC))
+                {
+                    continue;
+                }
+                if (n == 0U)
+                {
+                    pairLen = (uint8_t)(2U + p_attr->valueLen);
+                }
+                max = (uint8_t)((s_htMtu - 2U) / pairLen);
+                if (((uint8_t)(2U + p_attr->valueLen) != pairLen) || (n == max))
+                {
+                    break;
+                }
+                U16_TO_BUF_LE(&evt.eventField.onDiscCharResp.attrData[len], p_attr->handle);
+                memcpy(&evt.eventField.onDiscCharResp.attrData[len + 2U], p_attr->value, p_attr->valueLen);
+                len += pairLen;
+                last = p_attr->handle;
+                lastEnd = (uint16_t)(p_attr->value[1] | (p_attr->value[2] << 8));
+                n++;
+            }
+            if (n == 0U)
+            {
+                ht_DeliverError(ATT_READ_BY_TYPE_REQ);
+                return;
+            }
+            evt.eventId = GATTC_EVT_DISC_CHAR_RESP;
+            evt.eventField.onDiscCharResp.connHandle = HT_CONN;
+            evt.eventField.onDiscCharResp.attrPairLength = pairLen;
+            evt.eventField.onDiscCharResp.attrDataLength = len;
+            //The stack resumes after the declaration, finishes on the value handle
+            s_htCursor = last;
+            last = lastEnd;
+            break;
+
+        case HT_PROC_DESC:
+            for (i = 0; i < s_htAttrNum; i++)
+            {
+                HT_Attr_T *p_attr = &s_htAttr[i];
+
+                if ((p_attr->handle < s_htCursor) || (p_attr->handle > s_htEnd))
+                {
+                    continue;
+                }
+                //The ranges BLE_DD asks for hold 16-bit types only
+                HT_CHECK(!p_attr->type128);
+                if (n == (uint8_t)((s_htMtu - 2U) / 4U))
+                {
+                    break;
+                }
+                U16_TO_BUF_LE(&evt.eventField.onDiscDescResp.infoData[len], p_attr->handle);
+                U16_TO_BUF_LE(&evt.eventField.onDiscDescResp.infoData[len + 2U], p_attr->type);
+                len += 4U;
+                last = p_attr->handle;
+                n++;
+            }
+            if (n == 0U)
+            {
+                ht_DeliverError(ATT_FIND_INFORMATION_REQ);
+                return;
+            }
+            evt.eventId = GATTC_EVT_DISC_DESC_RESP;
+            evt.eventField.onDiscDescResp.connHandle = HT_CONN;
+            evt.eventField.onDiscDescResp.infoDataFormat = 1;
+            evt.eventField.onDiscDescResp.infoDataLength = len;
+            break;
+
+        default:
+            return;
+    }
+
+    if (last >= s_htEnd)
+    {
+        switch (s_htProc)
+        {
+            case HT_PROC_PRIM_ALL:
+                evt.eventField.onDiscPrimServResp.procedureStatus = GATT_PROCEDURE_STATUS_FINISH;
+                break;
+            case HT_PROC_PRIM_UUID:
+                evt.eventField.onDiscPrimServByUuidResp.procedureStatus = GATT_PROCEDURE_STATUS_FINISH;
+                break;
+            case HT_PROC_CHAR:
+                evt.eventField.onDiscCharResp.procedureStatus = GATT_PROCEDURE_STATUS_FINISH;
+                break;
+            default:
+                evt.eventField.onDiscDescResp.procedureStatus = GATT_PROCEDURE_STATUS_FINISH;
+                break;
+        }
+        s_htProc = HT_PROC_IDLE;
+    }
+    else
+    {
+        s_htCursor = (uint16_t)((s_htProc == HT_PROC_CHAR) ? (s_htCursor + 1U) : (last + 1U));
+    }
+    ht_Deliver(&evt);
+}
+
+static void ht_DdEvt(BLE_DD_Event_T *p_event)
+{
+    if (p_event->eventId == BLE_DD_EVT_DISC_COMPLETE)
+    {
+        HT_CHECK_EQ(p_event->eventField.evtDiscResult.connHandle, HT_CONN);
+        s_htCompleteCnt++;
+        s_htCompleteMs = s_htNowMs;
+    }
+}
+
+static void ht_GapEvt(uint8_t eventId)
+{
+    BLE_GAP_Event_T evt;
+    STACK_Event_T stackEvt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = eventId;
+    evt.eventField.evtConnect.status = GAP_STATUS_SUCCESS;
+    evt.eventField.evtConnect.connHandle = HT_CONN;
+    evt.eventField.evtConnect.role = BLE_GAP_ROLE_CENTRAL;
+    if (eventId == BLE_GAP_EVT_DISCONNECTED)
+    {
+        evt.eventField.evtDisconnect.connHandle = HT_CONN;
+    }
+    stackEvt.groupId = STACK_GRP_BLE_GAP;
+    stackEvt.evtLen = sizeof(evt);
+    stackEvt.p_event = (uint8_t *)&evt;
+
+    //In dispatch order
+    if (BLE_CONN_REG_GAP_EVT_MASK & (1UL << eventId))
+    {
+        BLE_CONN_REG_BleEventHandler(&stackEvt);
+    }
+    BLE_DD_BleEventHandler(&s_htConfig, &stackEvt);
+    if (BLE_CONN_REG_RELEASE_GAP_EVT_MASK & (1UL << eventId))
+    {
+        BLE_CONN_REG_BleReleaseHandler(&stackEvt);
+    }
+}
+
+static void ht_ProtocolAvailable(void)
+{
+    GATT_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = GATTC_EVT_PROTOCOL_AVAILABLE;
+    evt.eventField.onClientProtocolAvailable.connHandle = HT_CONN;
+    ht_Deliver(&evt);
+}
+
+static void ht_Init(void)
+{
+    BLE_DD_DiscSvc_T disc;
+    uint8_t s, c;
+
+    BLE_CONN_REG_Init();
+    HT_CHECK(BLE_DD_Init());
+    BLE_DD_EventRegister(ht_DdEvt);
+
+    for (s = 0; s < HT_SVC_NUM; s++)
+    {
+        for (c = 0; c < BLE_GAP_MAX_LINK_NBR; c++)
+        {
+            s_htCharList[s][c].p_charInfo = s_htCharInfo[s][c];
+        }
+        memset(&disc, 0, sizeof(disc));
+        disc.svcUuid.uuidLength = ATT_UUID_LENGTH_2;
+        ht_PutUuid(disc.svcUuid.uuid, s_htSvcUuid[s], false);
+        disc.p_discInfo = &s_htDiscInfo[s];
+        disc.p_discChars = s_htSvcList[s];
+        disc.p_charList = s_htCharList[s];
+        disc.discCharsNum = s_htSvcCharNum[s];
+        HT_CHECK_EQ(BLE_DD_ServiceDiscoveryRegister(&disc), MBA_RES_SUCCESS);
+    }
+}
+
+/* Connect, run the discovery to its end and check what it found */
+static void ht_Discover(bool singlePass, unsigned *p_rtt, unsigned *p_ms)
+{
+    BLE_DD_CharInfo_T info[3];
+    BLE_DD_DiscInfo_T range;
+    unsigned guard = 0;
+    uint8_t s, c, idx;
+
+    ht_Init();
+    memset(&s_htConfig, 0, sizeof(s_htConfig));
+    s_htConfig.initDiscInCentral = true;
+    s_htConfig.singlePassDisc = singlePass;
+    memset(s_htDiscInfo, 0, sizeof(s_htDiscInfo));
+    s_htProc = HT_PROC_IDLE;
+    s_htRtt = 0;
+    s_htNowMs = 0;
+    s_htCompleteCnt = 0;
+    s_htBusyCnt = 0;
+
+    ht_GapEvt(BLE_GAP_EVT_CONNECTED);
+    idx = BLE_CONN_REG_GetIndex(HT_CONN);
+    while ((s_htCompleteCnt == 0U) && (guard++ < 200U))
+    {
+        if (s_htProc != HT_PROC_IDLE)
+        {
+            ht_RoundTrip();
+        }
+        else
+        {
+            //A request refused as busy goes out on the next protocol available
+            s_htNowMs += SIM_CONN_INTERVAL_MS;
+            ht_ProtocolAvailable();
+        }
+    }
+    HT_CHECK_EQ(s_htCompleteCnt, 1);
+    HT_CHECK_EQ(s_htProc, HT_PROC_IDLE);
+
+    for (s = 0; s < HT_SVC_NUM; s++)
+    {
+        ht_Expected(s, info, &range);
+        HT_CHECK_EQ(s_htDiscInfo[s].svcStartHandle, range.svcStartHandle);
+        HT_CHECK_EQ(s_htDiscInfo[s].svcEndHandle, range.svcEndHandle);
+        for (c = 0; c < s_htSvcCharNum[s]; c++)
+        {
+            HT_CHECK_EQ(s_htCharInfo[s][idx][c].charHandle, info[c].charHandle);
+            if ((s_htSvcList[s][c]->settings & CHAR_SET_DESCRIPTOR) == 0U)
+            {
+                HT_CHECK_EQ(s_htCharInfo[s][idx][c].attrHandle, info[c].attrHandle);
+                HT_CHECK_EQ(s_htCharInfo[s][idx][c].property, info[c].property);
+            }
+        }
+    }
+
+    //Late events of the finished discovery change nothing
+    ht_ProtocolAvailable();
+    HT_CHECK_EQ(s_htCompleteCnt, 1);
+    HT_CHECK_EQ(s_htProc, HT_PROC_IDLE);
+
+    if (p_rtt != NULL)
+    {
+        *p_rtt = s_htRtt;
+        *p_ms = s_htCompleteMs;
+    }
+    ht_GapEvt(BLE_GAP_EVT_DISCONNECTED);
+}
+
+static void test_databases(void)
+{
+    uint8_t mode;
+
+    for (mode = 0; mode < 2U; mode++)
+    {
+        s_htMtu = BLE_ATT_DEFAULT_MTU_LEN;
+        ht_BuildDb(s_htDbReporter, sizeof(s_htDbReporter) / sizeof(s_htDbReporter[0]));
+        ht_Discover(mode != 0U, NULL, NULL);
+        ht_BuildDb(s_htDbDense, sizeof(s_htDbDense) / sizeof(s_htDbDense[0]));
+        ht_Discover(mode != 0U, NULL, NULL);
+        ht_BuildDb(s_htDbPartial, sizeof(s_htDbPartial) / sizeof(s_htDbPartial[0]));
+        ht_Discover(mode != 0U, NULL, NULL);
+        HT_CHECK_EQ(s_htDiscInfo[HT_SVC_TPS].svcStartHandle, 0);
+        HT_CHECK_EQ(s_htCharInfo[HT_SVC_IAS][0][0].charHandle, 0x0012);
+
+        s_htMtu = BLE_ATT_MAX_MTU_LEN;
+        ht_BuildDb(s_htDbDense, sizeof(s_htDbDense) / sizeof(s_htDbDense[0]));
+        ht_Discover(mode != 0U, NULL, NULL);
+    }
+}
+
+static void test_busy(void)
+{
+    unsigned rtt, ms;
+    uint8_t mode;
+
+    s_htMtu = BLE_ATT_DEFAULT_MTU_LEN;
+    ht_BuildDb(s_htDbDense, sizeof(s_htDbDense) / sizeof(s_htDbDense[0]));
+    for (mode = 0; mode < 2U; mode++)
+    {
+        s_htBusyMask = (1U << HT_PROC_PRIM_ALL) | (1U << HT_PROC_PRIM_UUID) | (1U << HT_PROC_CHAR) | (1U << HT_PROC_DESC);
+        ht_Discover(mode != 0U, &rtt, &ms);
+        HT_CHECK_EQ(s_htBusyCnt, 3);
+        s_htBusyMask = 0;
+    }
+}
+
+static void test_restart(void)
+{
+    uint8_t mode, idx;
+    unsigned guard = 0;
+
+    s_htMtu = BLE_ATT_DEFAULT_MTU_LEN;
+    ht_BuildDb(s_htDbDense, sizeof(s_htDbDense) / sizeof(s_htDbDense[0]));
+    for (mode = 0; mode < 2U; mode++)
+    {
+        ht_Init();
+        memset(&s_htConfig, 0, sizeof(s_htConfig));
+        s_htConfig.initDiscInCentral = true;
+        s_htConfig.singlePassDisc = (mode != 0U);
+        s_htCompleteCnt = 0;
+        ht_GapEvt(BLE_GAP_EVT_CONNECTED);
+        idx = BLE_CONN_REG_GetIndex(HT_CONN);
+        while ((s_htProc != HT_PROC_IDLE) && (guard++ < 200U))
+        {
+            ht_RoundTrip();
+        }
+        HT_CHECK_EQ(s_htCompleteCnt, 1);
+
+        //Rediscovery, as on a Service Changed indication, finds the handles again
+        s_htCharInfo[HT_SVC_LLS][idx][0].charHandle = 0;
+        HT_CHECK_EQ(BLE_DD_RestartServicesDiscovery(HT_CONN), MBA_RES_SUCCESS);
+        while ((s_htProc != HT_PROC_IDLE) && (guard++ < 400U))
+        {
+            ht_RoundTrip();
+        }
+        HT_CHECK_EQ(s_htCompleteCnt, 2);
+        HT_CHECK_EQ(s_htCharInfo[HT_SVC_LLS][idx][0].charHandle, s_htDiscInfo[HT_SVC_LLS].svcStartHandle + 2U);
+        HT_CHECK_EQ(BLE_DD_RestartServicesDiscovery(0x0777), MBA_RES_INVALID_PARA);
+        ht_GapEvt(BLE_GAP_EVT_DISCONNECTED);
+    }
+}
+
+static void test_sim(void)
+{
+    static const struct
+    {
+        const char      *name;
+        const HT_Svc_T  *p_db;
+        unsigned        svcNum;
+        uint16_t        mtu;
+    } run[] =
+    {
+        { "reporter, MTU 23",   s_htDbReporter, sizeof(s_htDbReporter) / sizeof(s_htDbReporter[0]), BLE_ATT_DEFAULT_MTU_LEN },
+        { "reporter, MTU 247",  s_htDbReporter, sizeof(s_htDbReporter) / sizeof(s_htDbReporter[0]), BLE_ATT_MAX_MTU_LEN },
+        { "dense, MTU 23",      s_htDbDense,    sizeof(s_htDbDense) / sizeof(s_htDbDense[0]),       BLE_ATT_DEFAULT_MTU_LEN },
+        { "dense, MTU 247",     s_htDbDense,    sizeof(s_htDbDense) / sizeof(s_htDbDense[0]),       BLE_ATT_MAX_MTU_LEN },
+    };
+    unsigned rtt[2], ms[2];
+    uint8_t i, mode;
+
+    printf("  %-20s %22s %22s\n", "database", "per service", "single pass");
+    for (i = 0; i < sizeof(run) / sizeof(run[0]); i++)
+    {
+        s_htMtu = run[i].mtu;
+        ht_BuildDb(run[i].p_db, run[i].svcNum);
+        for (mode = 0; mode < 2U; mode++)
+        {
+            ht_Discover(mode != 0U, &rtt[mode], &ms[mode]);
+        }
+        printf("  %-20s %6u ATT, %6u ms %6u ATT, %6u ms\n", run[i].name, rtt[0], ms[0], rtt[1], ms[1]);
+        HT_CHECK(rtt[1] < rtt[0]);
+    }
+}
+
+int main(void)
+{
+    test_databases();
+    test_busy();
+    test_restart();
+    test_sim();
+    return ht_Finish("test_dd_disc");
+}
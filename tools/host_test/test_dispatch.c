@@ -0,0 +1,553 @@
+/*
+ * Host test and benchmark of the stack event dispatcher (app_ble.c).
+ *
+ * - Every event ID of every group reaches exactly the subscribers whose
+ *   published mask holds it, in APP_BLE_DISPATCH_TABLE order: the registry
+ *   first, its release handler last, the application always. Event IDs
+ *   past the 32-bit masks reach every subscriber, an unknown group none.
+ * - The masks cover the modules: each stub below runs the group and event
+ *   switch of the module it replaces, and no event that switch acts on may
+ *   be filtered out by the dispatcher.
+ * - The event pool buffer is freed once per event, whoever consumed it.
+ * - Dispatch cost per event type with the switches of the subscribers as
+ *   their only work: the mask dispatch against the broadcast it replaced,
+ *   where every module got every event and switched it away itself.
+ *   Advertising reports and notifications, which only the application
+ *   consumes, take a third of the time (8 against 25 ns per event on the
+ *   build host), GATT responses and SMP events about half. A connection
+ *   event, consumed by six of the seven subscribers, costs about the same
+ *   either way (30 against 28 ns).
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_ble/app_ble.c"
+
+#define BENCH_EVENTS        4000000
+#define HT_CALL_MAX         16
+
+/* Room for an event of any group */
+#define HT_EVT_SIZE         (sizeof(BLE_GAP_Event_T) + sizeof(GATT_Event_T) + sizeof(BLE_L2CAP_Event_T) + sizeof(BLE_SMP_Event_T))
+
+/* Subscribers as the stubs record them, in the expected dispatch order */
+typedef enum HT_Sub_T
+{
+    HT_SUB_REG = 0,
+    HT_SUB_APP,
+    HT_SUB_DM,
+    HT_SUB_DD,
+    HT_SUB_PXPM,
+    HT_SUB_CACHE,
+    HT_SUB_RELEASE,
+    HT_SUB_NUM
+} HT_Sub_T;
+
+static const char * const s_htSubName[HT_SUB_NUM] = { "reg", "app", "dm", "dd", "pxpm", "cache", "release" };
+
+/* The masks each module publishes, independently of the dispatch table */
+static const uint32_t s_htSubMask[HT_SUB_NUM][STACK_GRP_END] =
+{
+    [HT_SUB_REG]     = { [STACK_GRP_BLE_GAP] = BLE_CONN_REG_GAP_EVT_MASK },
+    [HT_SUB_APP]     = { [STACK_GRP_BLE_GAP] = 0xFFFFFFFFUL, [STACK_GRP_BLE_L2CAP] = 0xFFFFFFFFUL,
+                         [STACK_GRP_BLE_SMP] = 0xFFFFFFFFUL, [STACK_GRP_GATT] = 0xFFFFFFFFUL },
+    [HT_SUB_DM]      = { [STACK_GRP_BLE_GAP] = BLE_DM_GAP_EVT_MASK, [STACK_GRP_BLE_L2CAP] = BLE_DM_L2CAP_EVT_MASK,
+                         [STACK_GRP_BLE_SMP] = BLE_DM_SMP_EVT_MASK },
+    [HT_SUB_DD]      = { [STACK_GRP_BLE_GAP] = BLE_DD_GAP_EVT_MASK | APP_GATT_CACHE_GAP_EVT_MASK,
+                         [STACK_GRP_GATT] = BLE_DD_GATT_EVT_MASK },
+    [HT_SUB_PXPM]    = { [STACK_GRP_BLE_GAP] = BLE_PXPM_GAP_EVT_MASK, [STACK_GRP_GATT] = BLE_PXPM_GATT_EVT_MASK },
+    [HT_SUB_CACHE]   = { [STACK_GRP_BLE_GAP] = APP_GATT_CACHE_GAP_EVT_MASK, [STACK_GRP_GATT] = APP_GATT_CACHE_GATT_EVT_MASK },
+    [HT_SUB_RELEASE] = { [STACK_GRP_BLE_GAP] = BLE_CONN_REG_RELEASE_GAP_EVT_MASK },
+};
+
+static uint8_t      s_htCall[HT_CALL_MAX];
+static unsigned     s_htCallCnt;
+static unsigned     s_htActCnt[HT_SUB_NUM];
+static bool         s_htActed[HT_SUB_NUM];
+static unsigned     s_htFreeCnt;
+static void         *s_htFreed;
+static bool         s_htRecord = true;
+
+static void ht_Called(HT_Sub_T sub, bool acts)
+{
+    if (acts)
+    {
+        s_htActCnt[sub]++;
+        s_htActed[sub] = true;
+    }
+    if (s_htRecord && (s_htCallCnt < HT_CALL_MAX))
+    {
+        s_htCall[s_htCallCnt++] = (uint8_t)sub;
+    }
+}
+
+static uint8_t ht_GapId(STACK_Event_T *p_stackEvent)
+{
+    return (uint8_t)((BLE_GAP_Event_T *)p_stackEvent->p_event)->eventId;
+}
+
+static uint8_t ht_GattId(STACK_Event_T *p_stackEvent)
+{
+    return (uint8_t)((GATT_Event_T *)p_stackEvent->p_event)->eventId;
+}
+
+/* Subscriber stubs. The switches are those of the module functions they
+ * replace; a new case there needs its bit in the mask of the module. */
+__attribute__((noinline)) void BLE_CONN_REG_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    ht_Called(HT_SUB_REG, (p_stackEvent->groupId == STACK_GRP_BLE_GAP) && (ht_GapId(p_stackEvent) == BLE_GAP_EVT_CONNECTED));
+}
+
+__attribute__((noinline)) void BLE_CONN_REG_BleReleaseHandler(STACK_Event_T *p_stackEvent)
+{
+    ht_Called(HT_SUB_RELEASE, (p_stackEvent->groupId == STACK_GRP_BLE_GAP) && (ht_GapId(p_stackEvent) == BLE_GAP_EVT_DISCONNECTED));
+}
+
+__attribute__((noinline)) void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    (void)p_event;
+    ht_Called(HT_SUB_APP, true);
+}
+
+__attribute__((noinline)) void APP_BleL2capEvtHandler(BLE_L2CAP_Event_T *p_event)
+{
+    (void)p_event;
+    ht_Called(HT_SUB_APP, true);
+}
+
+__attribute__((noinline)) void APP_BleSmpEvtHandler(BLE_SMP_Event_T *p_event)
+{
+    (void)p_event;
+    ht_Called(HT_SUB_APP, true);
+}
+
+__attribute__((noinline)) void APP_GattEvtHandler(GATT_Event_T *p_event)
+{
+    (void)p_event;
+    ht_Called(HT_SUB_APP, true);
+}
+
+/* BLE_DM_Info, BLE_DM_Sm and BLE_DM_Conn */
+__attribute__((noinline)) void BLE_DM_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    bool acts = false;
+
+    switch (p_stackEvent->groupId)
+    {
+        case STACK_GRP_BLE_GAP:
+            switch (ht_GapId(p_stackEvent))
+            {
+                case BLE_GAP_EVT_CONNECTED:
+                case BLE_GAP_EVT_DISCONNECTED:
+                case BLE_GAP_EVT_ENC_INFO_REQUEST:
+                case BLE_GAP_EVT_ENCRYPT_STATUS:
+                case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+                case BLE_GAP_EVT_REMOTE_CONN_PARAM_REQUEST:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case STACK_GRP_BLE_L2CAP:
+            switch (((BLE_L2CAP_Event_T *)p_stackEvent->p_event)->eventId)
+            {
+                case BLE_L2CAP_EVT_CONN_PARA_UPDATE_REQ:
+                case BLE_L2CAP_EVT_CONN_PARA_UPDATE_RSP:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case STACK_GRP_BLE_SMP:
+            switch (((BLE_SMP_Event_T *)p_stackEvent->p_event)->eventId)
+            {
+                case BLE_SMP_EVT_PAIRING_COMPLETE:
+                case BLE_SMP_EVT_SECURITY_REQUEST:
+                case BLE_SMP_EVT_NOTIFY_KEYS:
+                case BLE_SMP_EVT_PAIRING_REQUEST:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+    ht_Called(HT_SUB_DM, acts);
+}
+
+/* APP_GATT_CACHE_ConfigDd is called right before, it only looks at CONNECTED */
+__attribute__((noinline)) void APP_GATT_CACHE_ConfigDd(BLE_DD_Config_T *p_ddConfig, STACK_Event_T *p_stackEvent)
+{
+    (void)p_ddConfig;
+    (void)p_stackEvent;
+}
+
+__attribute__((noinline)) void BLE_DD_BleEventHandler(BLE_DD_Config_T *p_config, STACK_Event_T *p_stackEvent)
+{
+    bool acts = false;
+
+    (void)p_config;
+    switch (p_stackEvent->groupId)
+    {
+        case STACK_GRP_BLE_GAP:
+            switch (ht_GapId(p_stackEvent))
+            {
+                case BLE_GAP_EVT_CONNECTED:
+                case BLE_GAP_EVT_DISCONNECTED:
+                case BLE_GAP_EVT_ENCRYPT_STATUS:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case STACK_GRP_GATT:
+            switch (ht_GattId(p_stackEvent))
+            {
+                case GATTC_EVT_ERROR_RESP:
+                case GATTC_EVT_DISC_PRIM_SERV_RESP:
+                case GATTC_EVT_DISC_PRIM_SERV_BY_UUID_RESP:
+                case GATTC_EVT_DISC_CHAR_RESP:
+                case GATTC_EVT_DISC_DESC_RESP:
+                case GATTC_EVT_PROTOCOL_AVAILABLE:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+    ht_Called(HT_SUB_DD, acts);
+}
+
+__attribute__((noinline)) void BLE_PXPM_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    bool acts = false;
+
+    switch (p_stackEvent->groupId)
+    {
+        case STACK_GRP_BLE_GAP:
+            switch (ht_GapId(p_stackEvent))
+            {
+                case BLE_GAP_EVT_CONNECTED:
+                case BLE_GAP_EVT_DISCONNECTED:
+                case BLE_GAP_EVT_TX_BUF_AVAILABLE:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        case STACK_GRP_GATT:
+            switch (ht_GattId(p_stackEvent))
+            {
+                case GATTC_EVT_READ_USING_UUID_RESP:
+                case GATTC_EVT_READ_RESP:
+                case GATTC_EVT_WRITE_RESP:
+                case GATTC_EVT_ERROR_RESP:
+                case GATTC_EVT_PROTOCOL_AVAILABLE:
+                    acts = true;
+                    break;
+                default:
+                    break;
+            }
+            break;
+
+        default:
+            break;
+    }
+    ht_Called(HT_SUB_PXPM, acts);
+}
+
+__attribute__((noinline)) void APP_GATT_CACHE_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    bool acts = false;
+
+    if (p_stackEvent->groupId == STACK_GRP_BLE_GAP)
+    {
+        acts = (ht_GapId(p_stackEvent) == BLE_GAP_EVT_CONNECTED) || (ht_GapId(p_stackEvent) == BLE_GAP_EVT_DISCONNECTED);
+    }
+    else if (p_stackEvent->groupId == STACK_GRP_GATT)
+    {
+        acts = (ht_GattId(p_stackEvent) == GATTC_EVT_HV_INDICATE) || (ht_GattId(p_stackEvent) == GATTC_EVT_PROTOCOL_AVAILABLE);
+    }
+    ht_Called(HT_SUB_CACHE, acts);
+}
+
+void APP_EVT_POOL_Free(void *p_buf)
+{
+    s_htFreeCnt++;
+    s_htFreed = p_buf;
+}
+
+/* Called by the other functions of app_ble.c only */
+void *APP_EVT_POOL_Alloc(uint16_t size) { (void)size; return NULL; }
+void APP_EVT_POOL_Init(void) {}
+void APP_GATT_CACHE_DdEventHandler(BLE_DD_Event_T *p_event) { (void)p_event; }
+void APP_GATT_CACHE_Init(void) {}
+void APP_LINK_OPT_Init(void) {}
+void APP_PXPM_CTX_ProcPathLossEvt(const BLE_GAP_EvtPathLossThreshold_T *p_evt) { (void)p_evt; }
+void APP_SCAN_FILTER_CountPostAllocDrop(void) {}
+uint8_t APP_SCAN_FILTER_GetScanFilterPolicy(void) { return 0; }
+void APP_SCAN_FILTER_Init(void) {}
+bool APP_SCAN_FILTER_ProcAdvReport(const BLE_GAP_EvtAdvReport_T *p_evt) { (void)p_evt; return true; }
+bool APP_SCAN_FILTER_ProcExtAdvReport(const BLE_GAP_EvtExtAdvReport_T *p_evt) { (void)p_evt; return true; }
+void APP_SCAN_SCHED_Init(void) {}
+void APP_DmEvtHandler(BLE_DM_Event_T *p_event) { (void)p_event; }
+void APP_PxpmEvtHandler(BLE_PXPM_Event_T *p_event) { (void)p_event; }
+void BLE_CONN_REG_Init(void) {}
+void BLE_DD_EventRegister(BLE_DD_EventCb_T bleDdHandler) { (void)bleDdHandler; }
+bool BLE_DD_Init(void) { return true; }
+uint16_t BLE_DM_Config(BLE_DM_Config_T *p_config) { (void)p_config; return MBA_RES_SUCCESS; }
+uint16_t BLE_DM_EventRegister(BLE_DM_EventCb_T eventCb) { (void)eventCb; return MBA_RES_SUCCESS; }
+bool BLE_DM_Init(void) { return true; }
+void STACK_EventRegister(STACK_EventCb_T eventCb) { (void)eventCb; }
+uint16_t BLE_GAP_Init(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ScanInit(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ConnCentralInit(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_SetDeviceName(uint8_t len, uint8_t *p_deviceName) { (void)len; (void)p_deviceName; return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_SetScanningParam(BLE_GAP_ScanningParams_T *p_scanParams) { (void)p_scanParams; return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_SetConnTxPowerLevel(int8_t connTxPower, int8_t *p_selectedTxPower) { (void)connTxPower; (void)p_selectedTxPower; return MBA_RES_SUCCESS; }
+uint16_t BLE_GAP_ConfigureBuildInService(BLE_GAP_ServiceOption_T *p_serviceOptions) { (void)p_serviceOptions; return MBA_RES_SUCCESS; }
+uint16_t BLE_L2CAP_Init(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_SMP_Init(void) { return MBA_RES_SUCCESS; }
+uint16_t BLE_SMP_Config(BLE_SMP_Config_T *p_config) { (void)p_config; return MBA_RES_SUCCESS; }
+uint16_t GATTC_Init(uint16_t configuration) { (void)configuration; return MBA_RES_SUCCESS; }
+uint16_t GATTS_Init(uint16_t configuration) { (void)configuration; return MBA_RES_SUCCESS; }
+void BLE_PXPM_BleDdEventHandler(BLE_DD_Event_T *p_event) { (void)p_event; }
+void BLE_PXPM_EventRegister(BLE_PXPM_EventCb_T bleProxMonitorHandler) { (void)bleProxMonitorHandler; }
+uint16_t BLE_PXPM_Init(void) { return MBA_RES_SUCCESS; }
+
+static void ht_MakeEvt(STACK_Event_T *p_stackEvt, uint8_t *p_buf, uint8_t grp, uint8_t evtId)
+{
+    memset(p_buf, 0, HT_EVT_SIZE);
+    switch (grp)
+    {
+        case STACK_GRP_BLE_GAP:
+            ((BLE_GAP_Event_T *)p_buf)->eventId = evtId;
+            break;
+        case STACK_GRP_BLE_L2CAP:
+            ((BLE_L2CAP_Event_T *)p_buf)->eventId = evtId;
+            break;
+        case STACK_GRP_BLE_SMP:
+            ((BLE_SMP_Event_T *)p_buf)->eventId = evtId;
+            break;
+        case STACK_GRP_GATT:
+            ((GATT_Event_T *)p_buf)->eventId = evtId;
+            break;
+        default:
+            break;
+    }
+    p_stackEvt->groupId = grp;
+    p_stackEvt->evtLen = HT_EVT_SIZE;
+    p_stackEvt->p_event = p_buf;
+}
+
+static void ht_Dispatch(uint8_t grp, uint8_t evtId)
+{
+    static uint8_t buf[HT_EVT_SIZE];
+    STACK_Event_T stackEvt;
+
+    ht_MakeEvt(&stackEvt, buf, grp, evtId);
+    s_htCallCnt = 0;
+    s_htFreeCnt = 0;
+    s_htFreed = NULL;
+    memset(s_htActed, 0, sizeof(s_htActed));
+    APP_BleStackEvtHandler(&stackEvt);
+    HT_CHECK_EQ(s_htFreeCnt, 1);
+    HT_CHECK(s_htFreed == buf);
+}
+
+/* The module switches that would act on an event filtered out by its mask */
+static void ht_CheckUncovered(uint8_t grp, uint8_t evtId, const bool *p_called)
+{
+    static uint8_t buf[HT_EVT_SIZE];
+    STACK_Event_T stackEvt;
+    uint8_t sub;
+
+    ht_MakeEvt(&stackEvt, buf, grp, evtId);
+    memset(s_htActed, 0, sizeof(s_htActed));
+    s_htRecord = false;
+    BLE_CONN_REG_BleEventHandler(&stackEvt);
+    app_ble_AppEvtHandler(&stackEvt);
+    BLE_DM_BleEventHandler(&stackEvt);
+    app_ble_DdEvtHandler(&stackEvt);
+    BLE_PXPM_BleEventHandler(&stackEvt);
+    APP_GATT_CACHE_BleEventHandler(&stackEvt);
+    BLE_CONN_REG_BleReleaseHandler(&stackEvt);
+    s_htRecord = true;
+
+    for (sub = 0; sub < HT_SUB_NUM; sub++)
+    {
+        if (s_htActed[sub] && !p_called[sub])
+        {
+            printf("  group %u event %u: %s acts on it but does not receive it\n", grp, evtId, s_htSubName[sub]);
+            HT_CHECK(false);
+        }
+    }
+}
+
+static void test_masks(void)
+{
+    static const uint8_t evtEnd[STACK_GRP_END] =
+    {
+        [STACK_GRP_BLE_GAP] = BLE_GAP_EVT_END,
+        [STACK_GRP_BLE_L2CAP] = BLE_L2CAP_EVT_CB_DISC_IND + 1U,
+        [STACK_GRP_BLE_SMP] = BLE_SMP_EVT_KEYPRESS + 1U,
+        [STACK_GRP_GATT] = GATTC_EVT_PROTOCOL_AVAILABLE + 1U,
+    };
+    bool called[HT_SUB_NUM];
+    uint8_t grp, evtId, sub, n;
+
+    app_ble_DispatchInit();
+
+    for (grp = STACK_GRP_BLE_GAP; grp < STACK_GRP_END; grp++)
+    {
+        HT_CHECK(evtEnd[grp] <= APP_BLE_DISPATCH_EVT_NUM);
+        for (evtId = 0; evtId < APP_BLE_DISPATCH_EVT_NUM; evtId++)
+        {
+            ht_Dispatch(grp, evtId);
+
+            //Expected subscribers, in order, each once
+            n = 0;
+            memset(called, 0, sizeof(called));
+            for (sub = 0; sub < HT_SUB_NUM; sub++)
+            {
+                if (s_htSubMask[sub][grp] & (1UL << evtId))
+                {
+                    HT_CHECK((n < s_htCallCnt) && (s_htCall[n] == sub));
+                    n++;
+                    called[sub] = true;
+                }
+            }
+            HT_CHECK_EQ(s_htCallCnt, n);
+            HT_CHECK(called[HT_SUB_APP]);
+
+            if (evtId < evtEnd[grp])
+            {
+                ht_CheckUncovered(grp, evtId, called);
+            }
+        }
+    }
+
+    //The registry resolves a new link before anyone else, and drops it after everyone
+    ht_Dispatch(STACK_GRP_BLE_GAP, BLE_GAP_EVT_CONNECTED);
+    HT_CHECK_EQ(s_htCall[0], HT_SUB_REG);
+    HT_CHECK_EQ(s_htCallCnt, 6);
+    ht_Dispatch(STACK_GRP_BLE_GAP, BLE_GAP_EVT_DISCONNECTED);
+    HT_CHECK_EQ(s_htCall[s_htCallCnt - 1U], HT_SUB_RELEASE);
+    HT_CHECK_EQ(s_htCallCnt, 6);
+    ht_Dispatch(STACK_GRP_BLE_GAP, BLE_GAP_EVT_ADV_REPORT);
+    HT_CHECK_EQ(s_htCallCnt, 1);
+    ht_Dispatch(STACK_GRP_GATT, GATTC_EVT_HV_NOTIFY);
+    HT_CHECK_EQ(s_htCallCnt, 1);
+}
+
+static void test_out_of_range(void)
+{
+    uint8_t sub;
+
+    app_ble_DispatchInit();
+
+    //Event IDs past the masks go to every subscriber
+    ht_Dispatch(STACK_GRP_BLE_GAP, APP_BLE_DISPATCH_EVT_NUM);
+    HT_CHECK_EQ(s_htCallCnt, HT_SUB_NUM);
+    for (sub = 0; sub < HT_SUB_NUM; sub++)
+    {
+        HT_CHECK_EQ(s_htCall[sub], sub);
+    }
+    ht_Dispatch(STACK_GRP_GATT, 0xFF);
+    HT_CHECK_EQ(s_htCallCnt, HT_SUB_NUM);
+
+    //An unknown group to none, the buffer is still freed
+    ht_Dispatch(STACK_GRP_END, BLE_GAP_EVT_CONNECTED);
+    HT_CHECK_EQ(s_htCallCnt, 0);
+    ht_Dispatch(0xFF, 0);
+    HT_CHECK_EQ(s_htCallCnt, 0);
+}
+
+/* APP_BleStackEvtHandler before the subscriber masks */
+static void ht_BroadcastDispatch(STACK_Event_T *p_stackEvt)
+{
+    BLE_CONN_REG_BleEventHandler(p_stackEvt);
+    app_ble_AppEvtHandler(p_stackEvt);
+    BLE_DM_BleEventHandler(p_stackEvt);
+    APP_GATT_CACHE_ConfigDd(&ddConfig, p_stackEvt);
+    BLE_DD_BleEventHandler(&ddConfig, p_stackEvt);
+    BLE_PXPM_BleEventHandler(p_stackEvt);
+    APP_GATT_CACHE_BleEventHandler(p_stackEvt);
+    BLE_CONN_REG_BleReleaseHandler(p_stackEvt);
+    APP_EVT_POOL_Free(p_stackEvt->p_event);
+}
+
+static void test_bench(void)
+{
+    static const struct
+    {
+        const char  *name;
+        uint8_t     grp;
+        uint8_t     evtId;
+    } type[] =
+    {
+        { "GAP adv report",         STACK_GRP_BLE_GAP,  BLE_GAP_EVT_ADV_REPORT },
+        { "GAP ext adv report",     STACK_GRP_BLE_GAP,  BLE_GAP_EVT_EXT_ADV_REPORT },
+        { "GATTC notification",     STACK_GRP_GATT,     GATTC_EVT_HV_NOTIFY },
+        { "GATTC write response",   STACK_GRP_GATT,     GATTC_EVT_WRITE_RESP },
+        { "GAP TX buf available",   STACK_GRP_BLE_GAP,  BLE_GAP_EVT_TX_BUF_AVAILABLE },
+        { "SMP pairing complete",   STACK_GRP_BLE_SMP,  BLE_SMP_EVT_PAIRING_COMPLETE },
+        { "GAP connected",          STACK_GRP_BLE_GAP,  BLE_GAP_EVT_CONNECTED },
+    };
+    static uint8_t buf[HT_EVT_SIZE];
+    STACK_Event_T stackEvt;
+    uint64_t t0, broadcastNs, maskNs;
+    uint32_t e;
+    uint8_t i;
+
+    app_ble_DispatchInit();
+    s_htRecord = false;
+
+    printf("  %-24s %12s %12s\n", "event", "broadcast", "mask");
+    for (i = 0; i < sizeof(type) / sizeof(type[0]); i++)
+    {
+        ht_MakeEvt(&stackEvt, buf, type[i].grp, type[i].evtId);
+
+        t0 = ht_NowNs();
+        for (e = 0; e < BENCH_EVENTS; e++)
+        {
+            ht_BroadcastDispatch(&stackEvt);
+        }
+        broadcastNs = ht_NowNs() - t0;
+
+        t0 = ht_NowNs();
+        for (e = 0; e < BENCH_EVENTS; e++)
+        {
+            APP_BleStackEvtHandler(&stackEvt);
+        }
+        maskNs = ht_NowNs() - t0;
+
+        printf("  %-24s %9.1f ns %9.1f ns\n", type[i].name,
+               (double)broadcastNs / BENCH_EVENTS, (double)maskNs / BENCH_EVENTS);
+    }
+    s_htRecord = true;
+}
+
+int main(void)
+{
+    test_masks();
+    test_out_of_range();
+    test_bench();
+    return ht_Finish("test_dispatch");
+}
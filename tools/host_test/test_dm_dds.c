@@ -0,0 +1,517 @@
+/*
+ * Host test and benchmark of the bonded device index (ble_dm_dds.c).
+ *
+ * - Identity and resolvable addresses find their bond; unknown and
+ *   non-resolvable ones do not.
+ * - The index follows set, delete, delete-all and a reload from flash.
+ * - Lookups read no PDS item.
+ * - Lookup cost against bond count, compared with the flash scan the
+ *   index replaced (restore each bond, expand its IRK, compare).
+ * - A peer bonded under two local addresses resolves to the bond of the
+ *   current one, as with the flash scan, also through the address cache.
+ * - Private address resolutions per second: flash scan, IRK expanded per
+ *   call, expanded schedules, and schedules plus the recent address cache
+ *   on a stream of reports from a few phones.
+ */
+
+#include "host_test.h"
+#include "host_aes.h"
+#include "ble_util/mw_aes.c"
+#include "ble_dm/ble_dm_dds.c"
+
+#define BENCH_LOOKUPS       20000
+#define STREAM_PHONES       12          /* Private devices around the scanner */
+#define PDS_ITEM_NUM        (3U * BLE_DM_MAX_PAIRED_DEVICE_NUM)
+
+/* Flash behind the PDS files the module declares. */
+static uint8_t  s_pdsFlash[PDS_ITEM_NUM][sizeof(BLE_DM_MainPairedDevInfo_T) + BLE_DM_GATT_CACHE_SIZE];
+static bool     s_pdsValid[PDS_ITEM_NUM];
+static unsigned s_pdsRestoreCnt;
+static BLE_GAP_Addr_T s_localAddr;
+
+static bool test_PdsItem(PDS_MemId_t memoryId, void **pp_ram, uint16_t *p_size, unsigned *p_idx)
+{
+    unsigned idx = memoryId - BLE_DM_DDS_FILE_MAIN_ITEM_START;
+
+    if (idx >= PDS_ITEM_NUM)
+    {
+        return false;
+    }
+    if (idx < BLE_DM_MAX_PAIRED_DEVICE_NUM)
+    {
+        *pp_ram = &s_mainPairedInfo;
+        *p_size = sizeof(s_mainPairedInfo);
+    }
+    else if (idx < 2U * BLE_DM_MAX_PAIRED_DEVICE_NUM)
+    {
+        *pp_ram = &s_extPairedInfo;
+        *p_size = sizeof(s_extPairedInfo);
+    }
+    else
+    {
+        *pp_ram = s_gattCacheInfo;
+        *p_size = sizeof(s_gattCacheInfo);
+    }
+    *p_idx = idx;
+    return true;
+}
+
+bool PDS_IsAbleToRestore(PDS_MemId_t memoryId)
+{
+    void *p_ram;
+    uint16_t size;
+    unsigned idx;
+
+    return test_PdsItem(memoryId, &p_ram, &size, &idx) && s_pdsValid[idx];
+}
+
+bool PDS_Restore(PDS_MemId_t memoryId)
+{
+    void *p_ram;
+    uint16_t size;
+    unsigned idx;
+
+    if (!test_PdsItem(memoryId, &p_ram, &size, &idx) || !s_pdsValid[idx])
+    {
+        return false;
+    }
+    s_pdsRestoreCnt++;
+    memcpy(p_ram, s_pdsFlash[idx], size);
+    return true;
+}
+
+bool PDS_Store(PDS_MemId_t memoryId)
+{
+    void *p_ram;
+    uint16_t size;
+    unsigned idx;
+
+    if (!test_PdsItem(memoryId, &p_ram, &size, &idx))
+    {
+        return false;
+    }
+    memcpy(s_pdsFlash[idx], p_ram, size);
+    s_pdsValid[idx] = true;
+    return true;
+}
+
+PDS_DataServerState_t PDS_Delete(PDS_MemId_t memoryId)
+{
+    void *p_ram;
+    uint16_t size;
+    unsigned idx;
+
+    if (test_PdsItem(memoryId, &p_ram, &size, &idx))
+    {
+        s_pdsValid[idx] = false;
+    }
+    return PDS_SUCCESS;
+}
+
+void PDS_RegisterWriteCompleteCallback(void (*callbackFn)(PDS_MemId_t))
+{
+    (void)callbackFn;
+}
+
+uint16_t BLE_GAP_GetDeviceAddr(BLE_GAP_Addr_T *p_addr)
+{
+    *p_addr = s_localAddr;
+    return MBA_RES_SUCCESS;
+}
+
+static void test_RandomBytes(uint8_t *p_buf, unsigned len)
+{
+    unsigned i;
+
+    for (i = 0; i < len; i++)
+    {
+        p_buf[i] = (uint8_t)ht_Rand();
+    }
+}
+
+/* Bond n: static random identity, IRK distributed, bonded under s_localAddr. */
+static void test_MakeBond(uint8_t n, BLE_DM_PairedDevInfo_T *p_info)
+{
+    memset(p_info, 0, sizeof(*p_info));
+    p_info->remoteAddr.addrType = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+    test_RandomBytes(p_info->remoteAddr.addr, GAP_MAX_BD_ADDRESS_LEN);
+    p_info->remoteAddr.addr[5] |= 0xC0U;
+    p_info->remoteAddr.addr[0] = n;
+    test_RandomBytes(p_info->remoteIrk, sizeof(p_info->remoteIrk));
+    p_info->localAddr = s_localAddr;
+    test_RandomBytes(p_info->ltk, sizeof(p_info->ltk));
+}
+
+/* Resolvable private address generated from an IRK, as the peer would (ah() of Core Vol 3 Part H 2.2.2). */
+static void test_MakeRpa(uint8_t const *p_irk, BLE_GAP_Addr_T *p_rpa)
+{
+    MW_AES_Ctx_T ctx;
+    uint8_t data[16], hash[16];
+    uint8_t i;
+
+    p_rpa->addrType = BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE;
+    test_RandomBytes(&p_rpa->addr[3], 3);
+    p_rpa->addr[5] = (uint8_t)((p_rpa->addr[5] & 0x3FU) | 0x40U);
+
+    (void)ble_dm_DdsIrkKeySet(&ctx, p_irk);
+    memset(data, 0, sizeof(data));
+    for (i = 0; i < 3U; i++)
+    {
+        data[13U + i] = p_rpa->addr[5U - i];
+    }
+    (void)MW_AES_AesEcbEncrypt(&ctx, 16, hash, data);
+    for (i = 0; i < 3U; i++)
+    {
+        p_rpa->addr[2U - i] = hash[13U + i];
+    }
+}
+
+/* The lookup the index replaced: restore every bond, expand its IRK, compare. */
+static uint8_t test_FlashScanGetDeviceId(BLE_GAP_Addr_T *p_bdAddr)
+{
+    MW_AES_Ctx_T ctx;
+    uint8_t devId;
+
+    if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_NON_RESOLVABLE)
+    {
+        return BLE_DM_MAX_PAIRED_DEVICE_NUM;
+    }
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if (!PDS_IsAbleToRestore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId)
+            || !PDS_Restore(BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
+        {
+            continue;
+        }
+        if (PDS_IsAbleToRestore(BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
+        {
+            if (!PDS_Restore(BLE_DM_DDS_FILE_EXT_ITEM_START + devId)
+                || (memcmp(&s_extPairedInfo.localAddr, &s_localAddr, sizeof(s_localAddr)) != 0))
+            {
+                continue;
+            }
+        }
+
+        if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE)
+        {
+            if (ble_dm_DdsIrkKeySet(&ctx, s_mainPairedInfo.remoteIrk)
+                && ble_dm_DdsCheckResolveAddress(&ctx, p_bdAddr->addr))
+            {
+                break;
+            }
+        }
+        else if (memcmp(p_bdAddr->addr, s_mainPairedInfo.remoteAddr.addr, GAP_MAX_BD_ADDRESS_LEN) == 0)
+        {
+            break;
+        }
+    }
+
+    return devId;
+}
+
+static void test_Reset(void)
+{
+    memset(s_pdsValid, 0, sizeof(s_pdsValid));
+    BLE_DM_DdsInit(NULL);
+}
+
+static void test_Aes(void)
+{
+    static const uint8_t key[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                     0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    static const uint8_t plain[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                       0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+    static const uint8_t cipher[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                        0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+    MW_AES_Ctx_T ctx;
+    uint8_t out[16];
+
+    //FIPS-197 appendix C.1
+    HT_CHECK_EQ(MW_AES_EcbEncryptInit(&ctx, (uint8_t *)key), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(MW_AES_AesEcbEncrypt(&ctx, 16, out, (uint8_t *)plain), MBA_RES_SUCCESS);
+    HT_CHECK(memcmp(out, cipher, 16) == 0);
+}
+
+static void test_Lookup(void)
+{
+    BLE_DM_PairedDevInfo_T info[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    BLE_DM_PairedDevInfo_T readBack;
+    BLE_GAP_Addr_T addr;
+    unsigned restoreCnt;
+    uint8_t i;
+
+    ht_Seed(6);
+    test_Reset();
+    for (i = 0; i < BLE_DM_MAX_PAIRED_DEVICE_NUM; i++)
+    {
+        test_MakeBond(i, &info[i]);
+        HT_CHECK_EQ(BLE_DM_DdsGetFreeDeviceId(), i);
+        HT_CHECK_EQ(BLE_DM_DdsSetPairedDevice(i, &info[i]), MBA_RES_SUCCESS);
+    }
+    HT_CHECK_EQ(BLE_DM_DdsGetFreeDeviceId(), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+
+    restoreCnt = s_pdsRestoreCnt;
+    for (i = 0; i < BLE_DM_MAX_PAIRED_DEVICE_NUM; i++)
+    {
+        addr = info[i].remoteAddr;
+        HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), i);
+        test_MakeRpa(info[i].remoteIrk, &addr);
+        HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), i);
+        HT_CHECK_EQ(test_FlashScanGetDeviceId(&addr), i);
+        restoreCnt += 2U * (i + 1U);
+    }
+    //Only the reference flash scan touched PDS
+    HT_CHECK_EQ(s_pdsRestoreCnt, restoreCnt);
+
+    addr.addrType = BLE_GAP_ADDR_TYPE_PUBLIC;
+    test_RandomBytes(addr.addr, GAP_MAX_BD_ADDRESS_LEN);
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+    addr = info[3].remoteAddr;
+    addr.addrType = BLE_GAP_ADDR_TYPE_RANDOM_NON_RESOLVABLE;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+
+    //A bond made under another local address is not ours
+    s_localAddr.addr[0] ^= 0xFFU;
+    addr = info[3].remoteAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+    s_localAddr.addr[0] ^= 0xFFU;
+
+    //Delete, then the freed ID is found and the address is gone
+    HT_CHECK_EQ(BLE_DM_DdsDeletePairedDevice(2), MBA_RES_SUCCESS);
+    HT_CHECK(!BLE_DM_DdsChkDeviceId(2));
+    HT_CHECK_EQ(BLE_DM_DdsGetFreeDeviceId(), 2);
+    addr = info[2].remoteAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+    test_MakeRpa(info[2].remoteIrk, &addr);
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+
+    //Reload from flash after a reset gives the same answers
+    BLE_DM_DdsInit(NULL);
+    HT_CHECK(!BLE_DM_DdsChkDeviceId(2));
+    addr = info[7].remoteAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), 7);
+    HT_CHECK_EQ(BLE_DM_DdsGetPairedDevice(7, &readBack), MBA_RES_SUCCESS);
+    HT_CHECK(memcmp(readBack.ltk, info[7].ltk, sizeof(readBack.ltk)) == 0);
+
+    HT_CHECK_EQ(BLE_DM_DdsDeleteAllPairedDevice(), MBA_RES_SUCCESS);
+    addr = info[7].remoteAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+    HT_CHECK_EQ(BLE_DM_DdsGetFreeDeviceId(), 0);
+}
+
+/* Cost of one lookup in ns, for the last bonded identity address and for a never seen private address. */
+static void test_Bench(void)
+{
+    static BLE_GAP_Addr_T rpa[BENCH_LOOKUPS];
+    BLE_DM_PairedDevInfo_T info;
+    BLE_GAP_Addr_T addr;
+    uint8_t unknownIrk[16];
+    uint64_t t0, tIdx, tScan, tIdxRpa, tScanRpa;
+    unsigned restoreCnt;
+    unsigned wrongCnt = 0;
+    uint8_t bondCnt;
+    unsigned i;
+
+    ht_Seed(66);
+    test_RandomBytes(unknownIrk, sizeof(unknownIrk));
+    for (i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        test_MakeRpa(unknownIrk, &rpa[i]);
+    }
+
+    printf("  bonds  identity: index / flash scan (restores)    unknown RPA: index / flash scan\n");
+    test_Reset();
+    for (bondCnt = 1; bondCnt <= BLE_DM_MAX_PAIRED_DEVICE_NUM; bondCnt++)
+    {
+        test_MakeBond(bondCnt, &info);
+        (void)BLE_DM_DdsSetPairedDevice(bondCnt - 1U, &info);
+        addr = info.remoteAddr;
+
+        t0 = ht_NowNs();
+        for (i = 0; i < BENCH_LOOKUPS; i++)
+        {
+            wrongCnt += (BLE_DM_DdsGetDeviceId(&addr) != (bondCnt - 1U)) ? 1U : 0U;
+        }
+        tIdx = ht_NowNs() - t0;
+
+        restoreCnt = s_pdsRestoreCnt;
+        t0 = ht_NowNs();
+        for (i = 0; i < BENCH_LOOKUPS; i++)
+        {
+            wrongCnt += (test_FlashScanGetDeviceId(&addr) != (bondCnt - 1U)) ? 1U : 0U;
+        }
+        tScan = ht_NowNs() - t0;
+        restoreCnt = s_pdsRestoreCnt - restoreCnt;
+
+        //Fresh addresses every time: the resolved-address cache never hits
+        s_ddsRpaCacheTick = 0;
+        memset(s_ddsRpaCache, 0, sizeof(s_ddsRpaCache));
+        t0 = ht_NowNs();
+        for (i = 0; i < BENCH_LOOKUPS; i++)
+        {
+            addr = rpa[i];
+            wrongCnt += (BLE_DM_DdsGetDeviceId(&addr) != BLE_DM_MAX_PAIRED_DEVICE_NUM) ? 1U : 0U;
+        }
+        tIdxRpa = ht_NowNs() - t0;
+
+        t0 = ht_NowNs();
+        for (i = 0; i < BENCH_LOOKUPS; i++)
+        {
+            addr = rpa[i];
+            wrongCnt += (test_FlashScanGetDeviceId(&addr) != BLE_DM_MAX_PAIRED_DEVICE_NUM) ? 1U : 0U;
+        }
+        tScanRpa = ht_NowNs() - t0;
+
+        printf("  %5u  %8.0f / %6.0f ns (%2u)                %8.0f / %6.0f ns\n", bondCnt,
+               (double)tIdx / BENCH_LOOKUPS, (double)tScan / BENCH_LOOKUPS, restoreCnt / BENCH_LOOKUPS,
+               (double)tIdxRpa / BENCH_LOOKUPS, (double)tScanRpa / BENCH_LOOKUPS);
+        addr = info.remoteAddr;
+    }
+    HT_CHECK_EQ(wrongCnt, 0);
+}
+
+/* The same peer bonded twice: ID 1 under the current local address, ID 0 under an older one. */
+static void test_LocalAddrOrder(void)
+{
+    BLE_DM_PairedDevInfo_T info;
+    BLE_GAP_Addr_T oldLocalAddr = s_localAddr;
+    BLE_GAP_Addr_T curLocalAddr = s_localAddr;
+    BLE_GAP_Addr_T addr, rpa;
+
+    ht_Seed(77);
+    test_Reset();
+    oldLocalAddr.addr[1] ^= 0x5AU;
+
+    test_MakeBond(0, &info);
+    info.localAddr = oldLocalAddr;
+    HT_CHECK_EQ(BLE_DM_DdsSetPairedDevice(0, &info), MBA_RES_SUCCESS);
+    info.localAddr = curLocalAddr;
+    HT_CHECK_EQ(BLE_DM_DdsSetPairedDevice(1, &info), MBA_RES_SUCCESS);
+    test_MakeRpa(info.remoteIrk, &rpa);
+
+    //The bond of the other local address is skipped before its IRK is tried
+    addr = rpa;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), 1);
+    HT_CHECK_EQ(test_FlashScanGetDeviceId(&addr), 1);
+    addr = info.remoteAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), 1);
+
+    //Cached result of the previous local address is not reused
+    s_localAddr = oldLocalAddr;
+    addr = rpa;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), 0);
+    HT_CHECK_EQ(test_FlashScanGetDeviceId(&addr), 0);
+    addr = info.remoteAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), 0);
+
+    //Neither bond belongs to a third local address
+    s_localAddr.addr[2] ^= 0xA5U;
+    addr = rpa;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), BLE_DM_MAX_PAIRED_DEVICE_NUM);
+    s_localAddr = curLocalAddr;
+    HT_CHECK_EQ(BLE_DM_DdsGetDeviceId(&addr), 1);
+}
+
+/* Resolution with the IRK expanded on every call, from RAM. */
+static uint8_t test_ExpandPerCallResolve(uint8_t const *p_addr)
+{
+    MW_AES_Ctx_T ctx;
+    uint8_t devId;
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if (s_ddsIndex[devId].valid && ble_dm_DdsIndexChkLocalAddr(devId, &s_localAddr)
+            && ble_dm_DdsIrkKeySet(&ctx, s_ddsIndex[devId].remoteIrk)
+            && ble_dm_DdsCheckResolveAddress(&ctx, p_addr))
+        {
+            break;
+        }
+    }
+
+    return devId;
+}
+
+static void test_ResolverBench(void)
+{
+    static BLE_GAP_Addr_T stream[BENCH_LOOKUPS];
+    BLE_GAP_Addr_T phone[STREAM_PHONES];
+    BLE_DM_PairedDevInfo_T info[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t phoneIrk[16];
+    uint8_t expect[BENCH_LOOKUPS];
+    uint64_t t0, tScan, tExpand, tSched, tCache;
+    unsigned wrongCnt = 0;
+    unsigned i, n;
+
+    ht_Seed(707);
+    test_Reset();
+    for (n = 0; n < BLE_DM_MAX_PAIRED_DEVICE_NUM; n++)
+    {
+        test_MakeBond((uint8_t)n, &info[n]);
+        (void)BLE_DM_DdsSetPairedDevice((uint8_t)n, &info[n]);
+    }
+
+    //Two phones are bonded, the others are strangers; each report comes from one of them
+    test_RandomBytes(phoneIrk, sizeof(phoneIrk));
+    for (n = 0; n < STREAM_PHONES; n++)
+    {
+        test_MakeRpa((n < 2U) ? info[n * 5U].remoteIrk : phoneIrk, &phone[n]);
+    }
+    for (i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        n = ht_Rand() % STREAM_PHONES;
+        stream[i] = phone[n];
+        expect[i] = (n < 2U) ? (uint8_t)(n * 5U) : BLE_DM_MAX_PAIRED_DEVICE_NUM;
+    }
+
+    t0 = ht_NowNs();
+    for (i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        wrongCnt += (test_FlashScanGetDeviceId(&stream[i]) != expect[i]) ? 1U : 0U;
+    }
+    tScan = ht_NowNs() - t0;
+
+    t0 = ht_NowNs();
+    for (i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        wrongCnt += (test_ExpandPerCallResolve(stream[i].addr) != expect[i]) ? 1U : 0U;
+    }
+    tExpand = ht_NowNs() - t0;
+
+    //Expanded schedules alone: the cache is emptied before every lookup
+    t0 = ht_NowNs();
+    for (i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        memset(s_ddsRpaCache, 0, sizeof(s_ddsRpaCache));
+        wrongCnt += (BLE_DM_DdsGetDeviceId(&stream[i]) != expect[i]) ? 1U : 0U;
+    }
+    tSched = ht_NowNs() - t0;
+
+    t0 = ht_NowNs();
+    for (i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        wrongCnt += (BLE_DM_DdsGetDeviceId(&stream[i]) != expect[i]) ? 1U : 0U;
+    }
+    tCache = ht_NowNs() - t0;
+
+    HT_CHECK_EQ(wrongCnt, 0);
+    printf("  RPA resolutions/s, %u bonds, %u phones (2 bonded), %u reports:\n",
+           BLE_DM_MAX_PAIRED_DEVICE_NUM, STREAM_PHONES, BENCH_LOOKUPS);
+    printf("    flash scan, IRK expanded per call  %10.0f\n", 1e9 * BENCH_LOOKUPS / tScan);
+    printf("    RAM index, IRK expanded per call   %10.0f\n", 1e9 * BENCH_LOOKUPS / tExpand);
+    printf("    expanded schedules                 %10.0f\n", 1e9 * BENCH_LOOKUPS / tSched);
+    printf("    schedules and address cache (%u)    %10.0f\n", BLE_DM_DDS_RPA_CACHE_SIZE, 1e9 * BENCH_LOOKUPS / tCache);
+}
+
+int main(void)
+{
+    s_localAddr.addrType = BLE_GAP_ADDR_TYPE_PUBLIC;
+    memcpy(s_localAddr.addr, "\x11\x22\x33\x44\x55\x66", GAP_MAX_BD_ADDRESS_LEN);
+
+    test_Aes();
+    test_Lookup();
+    test_Bench();
+    test_LocalAddrOrder();
+    test_ResolverBench();
+    return ht_Finish("test_dm_dds");
+}
@@ -0,0 +1,284 @@
+/*
+ * Host test and benchmark of the monitor stack event pool (app_ble_evt_pool.c).
+ *
+ * - Size class selection, fall through to the larger class and to the heap.
+ * - Statistics: claims, high-water, exhaustion, heap fallback.
+ * - Lock-free claim/release from several threads: no block is handed out twice.
+ * - Replay of a recorded event stream, pool against heap, in ns per event.
+ */
+
+#include <pthread.h>
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "app_ble/app_ble_evt_pool.c"
+
+#define THREAD_NUM          4
+#define THREAD_ITERATIONS   200000
+#define TRACE_MAX           4096
+#define REPLAY_ROUNDS       200
+#define HOLD_MAX            16
+
+typedef struct
+{
+    char        name[40];
+    uint16_t    len;
+    uint16_t    hold;
+} TraceEvt_T;
+
+static TraceEvt_T s_trace[TRACE_MAX];
+static unsigned s_traceLen;
+static volatile unsigned s_threadErrCnt;
+
+static void test_SizeClasses(void)
+{
+    APP_EVT_POOL_Stats_T stats;
+    void *p_small[APP_EVT_POOL_SMALL_BLOCK_NUM];
+    void *p_large[APP_EVT_POOL_LARGE_BLOCK_NUM];
+    void *p_spill;
+    void *p_heap;
+    unsigned mallocCnt;
+    unsigned i;
+
+    APP_EVT_POOL_Init();
+
+    for (i = 0; i < APP_EVT_POOL_SMALL_BLOCK_NUM; i++)
+    {
+        p_small[i] = APP_EVT_POOL_Alloc(APP_EVT_POOL_SMALL_BLOCK_SIZE);
+        HT_CHECK((uint8_t *)p_small[i] >= (uint8_t *)s_evtPoolSmall);
+        HT_CHECK((uint8_t *)p_small[i] < (uint8_t *)s_evtPoolSmall + sizeof(s_evtPoolSmall));
+    }
+
+    //Small class exhausted: a small event spills into the large class
+    p_spill = APP_EVT_POOL_Alloc(8);
+    HT_CHECK((uint8_t *)p_spill >= (uint8_t *)s_evtPoolLarge);
+    APP_EVT_POOL_Free(p_spill);
+
+    for (i = 0; i < APP_EVT_POOL_LARGE_BLOCK_NUM; i++)
+    {
+        p_large[i] = APP_EVT_POOL_Alloc(APP_EVT_POOL_LARGE_BLOCK_SIZE);
+        HT_CHECK((uint8_t *)p_large[i] >= (uint8_t *)s_evtPoolLarge);
+    }
+
+    //Both classes exhausted, and an oversized event: served by the heap
+    mallocCnt = g_htMallocCnt;
+    p_heap = APP_EVT_POOL_Alloc(16);
+    HT_CHECK(p_heap != NULL);
+    APP_EVT_POOL_Free(p_heap);
+    p_heap = APP_EVT_POOL_Alloc(APP_EVT_POOL_LARGE_BLOCK_SIZE + 1);
+    HT_CHECK(p_heap != NULL);
+    APP_EVT_POOL_Free(p_heap);
+    HT_CHECK_EQ(g_htMallocCnt - mallocCnt, 2);
+
+    APP_EVT_POOL_GetStats(&stats);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_SMALL], APP_EVT_POOL_SMALL_BLOCK_NUM);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_LARGE], APP_EVT_POOL_LARGE_BLOCK_NUM);
+    HT_CHECK_EQ(stats.highWater[APP_EVT_POOL_CLASS_SMALL], APP_EVT_POOL_SMALL_BLOCK_NUM);
+    HT_CHECK_EQ(stats.highWater[APP_EVT_POOL_CLASS_LARGE], APP_EVT_POOL_LARGE_BLOCK_NUM);
+    HT_CHECK_EQ(stats.claimCnt[APP_EVT_POOL_CLASS_LARGE], APP_EVT_POOL_LARGE_BLOCK_NUM + 1);
+    //The spill and the 16 byte event found the small class empty; the oversized one only fits the heap
+    HT_CHECK_EQ(stats.exhaustCnt[APP_EVT_POOL_CLASS_SMALL], 2);
+    HT_CHECK_EQ(stats.exhaustCnt[APP_EVT_POOL_CLASS_LARGE], 1);
+    HT_CHECK_EQ(stats.heapFallbackCnt, 2);
+    HT_CHECK_EQ(stats.failCnt, 0);
+
+    for (i = 0; i < APP_EVT_POOL_SMALL_BLOCK_NUM; i++)
+    {
+        APP_EVT_POOL_Free(p_small[i]);
+    }
+    for (i = 0; i < APP_EVT_POOL_LARGE_BLOCK_NUM; i++)
+    {
+        APP_EVT_POOL_Free(p_large[i]);
+    }
+    APP_EVT_POOL_Free(NULL);
+
+    APP_EVT_POOL_GetStats(&stats);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_SMALL], 0);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_LARGE], 0);
+    HT_CHECK_EQ(s_evtPoolFreeMask[APP_EVT_POOL_CLASS_SMALL], APP_EVT_POOL_MASK(APP_EVT_POOL_SMALL_BLOCK_NUM));
+    HT_CHECK_EQ(s_evtPoolFreeMask[APP_EVT_POOL_CLASS_LARGE], APP_EVT_POOL_MASK(APP_EVT_POOL_LARGE_BLOCK_NUM));
+}
+
+static void *test_Worker(void *p_arg)
+{
+    uint8_t marker = (uint8_t)(uintptr_t)p_arg;
+    unsigned i;
+
+    for (i = 0; i < THREAD_ITERATIONS; i++)
+    {
+        uint8_t *p_buf = APP_EVT_POOL_Alloc((i & 1U) ? 40 : 200);
+        unsigned j;
+
+        if (p_buf == NULL)
+        {
+            continue;
+        }
+        memset(p_buf, marker, 40);
+        for (j = 0; j < 40; j++)
+        {
+            if (p_buf[j] != marker)
+            {
+                s_threadErrCnt++;
+                break;
+            }
+        }
+        APP_EVT_POOL_Free(p_buf);
+    }
+
+    return NULL;
+}
+
+static void test_Concurrency(void)
+{
+    pthread_t thread[THREAD_NUM];
+    APP_EVT_POOL_Stats_T stats;
+    unsigned i;
+
+    APP_EVT_POOL_Init();
+    s_threadErrCnt = 0;
+    for (i = 0; i < THREAD_NUM; i++)
+    {
+        pthread_create(&thread[i], NULL, test_Worker, (void *)(uintptr_t)(i + 1));
+    }
+    for (i = 0; i < THREAD_NUM; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+
+    APP_EVT_POOL_GetStats(&stats);
+    HT_CHECK_EQ(s_threadErrCnt, 0);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_SMALL], 0);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_LARGE], 0);
+    HT_CHECK(stats.highWater[APP_EVT_POOL_CLASS_SMALL] <= THREAD_NUM);
+    HT_CHECK_EQ(s_evtPoolFreeMask[APP_EVT_POOL_CLASS_SMALL], APP_EVT_POOL_MASK(APP_EVT_POOL_SMALL_BLOCK_NUM));
+    HT_CHECK_EQ(s_evtPoolFreeMask[APP_EVT_POOL_CLASS_LARGE], APP_EVT_POOL_MASK(APP_EVT_POOL_LARGE_BLOCK_NUM));
+}
+
+static void test_LoadTrace(const char *p_path)
+{
+    char line[128];
+    FILE *p_file = fopen(p_path, "r");
+
+    s_traceLen = 0;
+    HT_CHECK(p_file != NULL);
+    if (p_file == NULL)
+    {
+        return;
+    }
+
+    while ((fgets(line, sizeof(line), p_file) != NULL) && (s_traceLen < TRACE_MAX))
+    {
+        TraceEvt_T *p_evt = &s_trace[s_traceLen];
+        unsigned len;
+        unsigned hold;
+
+        if ((line[0] == '#') || (sscanf(line, "%39s %u %u", p_evt->name, &len, &hold) != 3))
+        {
+            continue;
+        }
+        HT_CHECK(hold <= HOLD_MAX);
+        p_evt->len = (uint16_t)len;
+        p_evt->hold = (uint16_t)hold;
+        s_traceLen++;
+    }
+    fclose(p_file);
+}
+
+/* Replays the trace; a buffer is released once `hold` later events have arrived. */
+static uint64_t test_Replay(void *(*alloc)(uint16_t), void (*release)(void *), unsigned *p_lost)
+{
+    void *p_held[TRACE_MAX];
+    uint64_t start;
+    unsigned round;
+    unsigned i;
+    unsigned j;
+
+    *p_lost = 0;
+    start = ht_NowNs();
+    for (round = 0; round < REPLAY_ROUNDS; round++)
+    {
+        for (i = 0; i < s_traceLen; i++)
+        {
+            p_held[i] = alloc(s_trace[i].len);
+            if (p_held[i] == NULL)
+            {
+                (*p_lost)++;
+            }
+
+            for (j = (i > HOLD_MAX) ? (i - HOLD_MAX) : 0; j <= i; j++)
+            {
+                if ((p_held[j] != NULL) && (j + s_trace[j].hold == i))
+                {
+                    release(p_held[j]);
+                    p_held[j] = NULL;
+                }
+            }
+        }
+
+        //The application task drains its queue between rounds
+        for (j = 0; j < s_traceLen; j++)
+        {
+            if (p_held[j] != NULL)
+            {
+                release(p_held[j]);
+                p_held[j] = NULL;
+            }
+        }
+    }
+
+    return ht_NowNs() - start;
+}
+
+static void *test_HeapAlloc(uint16_t size)
+{
+    return malloc(size);
+}
+
+static void test_Benchmark(const char *p_path)
+{
+    APP_EVT_POOL_Stats_T stats;
+    uint64_t poolNs;
+    uint64_t heapNs;
+    unsigned lost;
+    unsigned events;
+
+    test_LoadTrace(p_path);
+    HT_CHECK(s_traceLen > 0);
+    if (s_traceLen == 0)
+    {
+        return;
+    }
+    events = s_traceLen * REPLAY_ROUNDS;
+
+    //The release scan is the same for both, so the difference is allocator cost
+    heapNs = test_Replay(test_HeapAlloc, free, &lost);
+
+    APP_EVT_POOL_Init();
+    g_htMallocCnt = 0;
+    poolNs = test_Replay(APP_EVT_POOL_Alloc, APP_EVT_POOL_Free, &lost);
+    APP_EVT_POOL_GetStats(&stats);
+
+    HT_CHECK_EQ(lost, 0);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_SMALL], 0);
+    HT_CHECK_EQ(stats.inUse[APP_EVT_POOL_CLASS_LARGE], 0);
+    //Only the oversized L2CAP SDUs of the trace go to the heap
+    HT_CHECK_EQ(stats.heapFallbackCnt, g_htMallocCnt);
+
+    printf("replay %s: %u events\n", p_path, events);
+    printf("  heap: %6.1f ns/event\n", (double)heapNs / events);
+    printf("  pool: %6.1f ns/event, heap fallbacks %u (%.2f%%)\n",
+           (double)poolNs / events, (unsigned)stats.heapFallbackCnt, 100.0 * stats.heapFallbackCnt / events);
+    printf("  high-water small %u/%u large %u/%u, exhausted small %u large %u\n",
+           stats.highWater[APP_EVT_POOL_CLASS_SMALL], APP_EVT_POOL_SMALL_BLOCK_NUM,
+           stats.highWater[APP_EVT_POOL_CLASS_LARGE], APP_EVT_POOL_LARGE_BLOCK_NUM,
+           (unsigned)stats.exhaustCnt[APP_EVT_POOL_CLASS_SMALL], (unsigned)stats.exhaustCnt[APP_EVT_POOL_CLASS_LARGE]);
+}
+
+int main(int argc, char **argv)
+{
+    test_SizeClasses();
+    test_Concurrency();
+    test_Benchmark((argc > 1) ? argv[1] : "traces/evt_stream_scan_connect.txt");
+
+    return ht_Finish("test_evt_pool");
+}
@@ -0,0 +1,176 @@
+/*
+ * Host test of the MTU exchange of the link optimization (app_link_opt.c)
+ * against a mock GATT Client.
+ *
+ * - No Exchange MTU Request on connection: discovery and the connect
+ *   bootstrap have the ATT bearer to themselves. The exchange goes out on
+ *   APP_LINK_OPT_BootstrapDone, once per link.
+ * - A busy bearer or no TX buffer keeps the exchange pending until
+ *   GATTC_EVT_PROTOCOL_AVAILABLE; a protocol available before the
+ *   bootstrap is done sends nothing.
+ * - A peer that refused the exchange before is not asked again, one that
+ *   accepted it is.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_ble/app_link_opt.c"
+
+#define HT_CONN_A           0x0010
+#define HT_CONN_B           0x0021
+
+static APP_PXPM_Ctx_T   s_htCtx;
+static unsigned         s_htMtuReqCnt;
+static uint16_t         s_htMtuReqLen;
+static uint16_t         s_htMtuResult = MBA_RES_SUCCESS;
+static unsigned         s_htPhyReqCnt;
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByHandle(uint16_t connHandle)
+{
+    return (connHandle == s_htCtx.connHandle) ? &s_htCtx : NULL;
+}
+
+uint16_t GATTC_ExchangeMTURequest(uint16_t connHandle, uint16_t mtuLen)
+{
+    HT_CHECK_EQ(connHandle, s_htCtx.connHandle);
+    if (s_htMtuResult != MBA_RES_SUCCESS)
+    {
+        return s_htMtuResult;
+    }
+    s_htMtuReqLen = mtuLen;
+    s_htMtuReqCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetPhy(uint16_t connHandle, uint8_t txPhys, uint8_t rxPhys, uint8_t phyOptions)
+{
+    (void)connHandle;
+    (void)txPhys;
+    (void)rxPhys;
+    (void)phyOptions;
+    s_htPhyReqCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetDefaultPhy(uint8_t txPhys, uint8_t rxPhys)
+{
+    (void)txPhys;
+    (void)rxPhys;
+    return MBA_RES_SUCCESS;
+}
+
+static void ht_Connect(uint16_t connHandle, uint8_t peer)
+{
+    memset(&s_htCtx, 0, sizeof(s_htCtx));
+    s_htCtx.connHandle = connHandle;
+    s_htCtx.peerAddr.addrType = BLE_GAP_ADDR_TYPE_PUBLIC;
+    s_htCtx.peerAddr.addr[0] = peer;
+    s_htMtuReqCnt = 0;
+    s_htPhyReqCnt = 0;
+    APP_LINK_OPT_Connected(connHandle);
+}
+
+static void test_after_bootstrap(void)
+{
+    APP_LINK_OPT_Stats_T stats;
+
+    APP_LINK_OPT_Init();
+    ht_Connect(HT_CONN_A, 1);
+
+    //The PHY update goes out, the exchange waits for the bootstrap
+    HT_CHECK_EQ(s_htPhyReqCnt, 1);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+    APP_LINK_OPT_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+
+    //Another link's bootstrap does not start it
+    APP_LINK_OPT_BootstrapDone(HT_CONN_B);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 1);
+    HT_CHECK_EQ(s_htMtuReqLen, APP_LINK_OPT_MTU);
+
+    //A later bootstrap of the link does not repeat it
+    APP_LINK_OPT_MtuUpdated(HT_CONN_A, APP_LINK_OPT_MTU);
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    APP_LINK_OPT_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 1);
+    HT_CHECK_EQ(s_htCtx.linkOpt.mtu, APP_LINK_OPT_MTU);
+
+    APP_LINK_OPT_GetStats(&stats);
+    HT_CHECK_EQ(stats.mtuReqCnt, 1);
+    HT_CHECK_EQ(stats.mtuDoneCnt, 1);
+}
+
+static void test_busy(void)
+{
+    APP_LINK_OPT_Init();
+    ht_Connect(HT_CONN_A, 2);
+
+    //An application request holds the bearer: sent when it is free
+    s_htMtuResult = MBA_RES_BUSY;
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+    HT_CHECK(s_htCtx.linkOpt.mtuPending);
+    s_htMtuResult = MBA_RES_SUCCESS;
+    APP_LINK_OPT_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 1);
+    HT_CHECK(!s_htCtx.linkOpt.mtuPending);
+
+    //No TX buffer: same
+    ht_Connect(HT_CONN_A, 3);
+    s_htMtuResult = MBA_RES_OOM;
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    s_htMtuResult = MBA_RES_SUCCESS;
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+    APP_LINK_OPT_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 1);
+
+    //Rejected: not retried
+    ht_Connect(HT_CONN_A, 4);
+    s_htMtuResult = MBA_RES_FAIL;
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    s_htMtuResult = MBA_RES_SUCCESS;
+    APP_LINK_OPT_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+}
+
+static void test_peers(void)
+{
+    APP_LINK_OPT_Peer_T peer;
+
+    APP_LINK_OPT_Init();
+
+    //Refused: the error response reports the default MTU
+    ht_Connect(HT_CONN_A, 5);
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    HT_CHECK_EQ(s_htMtuReqCnt, 1);
+    APP_LINK_OPT_MtuUpdated(HT_CONN_A, BLE_ATT_DEFAULT_MTU_LEN);
+    HT_CHECK(APP_LINK_OPT_GetPeer(&s_htCtx.peerAddr, &peer));
+    HT_CHECK_EQ(peer.mtu, BLE_ATT_DEFAULT_MTU_LEN);
+
+    ht_Connect(HT_CONN_B, 5);
+    APP_LINK_OPT_BootstrapDone(HT_CONN_B);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+    HT_CHECK_EQ(s_htCtx.linkOpt.mtu, BLE_ATT_DEFAULT_MTU_LEN);
+
+    //Accepted: asked again on the next connection, the peer may have lost it
+    ht_Connect(HT_CONN_A, 6);
+    APP_LINK_OPT_BootstrapDone(HT_CONN_A);
+    APP_LINK_OPT_MtuUpdated(HT_CONN_A, APP_LINK_OPT_MTU);
+    ht_Connect(HT_CONN_B, 6);
+    HT_CHECK_EQ(s_htMtuReqCnt, 0);
+    APP_LINK_OPT_BootstrapDone(HT_CONN_B);
+    HT_CHECK_EQ(s_htMtuReqCnt, 1);
+}
+
+int main(void)
+{
+    test_after_bootstrap();
+    test_busy();
+    test_peers();
+    return ht_Finish("test_link_opt");
+}
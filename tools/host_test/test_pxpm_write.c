@@ -0,0 +1,560 @@
+/*
+ * Host test of the PXPM Alert Level write queue (ble_pxpm.c) against a mock
+ * GATT Client, with the connection registry (ble_conn_reg.c) it resolves
+ * connection handles through.
+ *
+ * - One LLS Write Request on the bearer at a time; levels set while it is in
+ *   flight are coalesced, the latest is sent on the response.
+ * - IAS Write Commands do not wait for the request in flight.
+ * - Busy bearer or TX buffers keep the write pending until
+ *   GATTC_EVT_PROTOCOL_AVAILABLE or BLE_GAP_EVT_TX_BUF_AVAILABLE; other
+ *   errors drop it. An ATT Error Response frees the bearer like a response.
+ * - Writes and handles of one link do not leak into another, and a
+ *   disconnection clears what was pending.
+ * - BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND once a queue busy with a request in
+ *   flight or a write waiting for the bearer empties, and not for writes
+ *   that went out at once or responses to writes of other modules.
+ * - Connect bootstrap: one IAS Write Command carrying the given level, and
+ *   the LLS write stage ended only by the Write or Error Response of the LLS
+ *   Alert Level; responses to other handles on the link leave it waiting.
+ * - Button bursts: presses posted by the EIC callback, handled on the app
+ *   task, against a reporter answering each Write Request two 50 ms
+ *   connection events later. Reported per press rate: LLS writes on air and
+ *   the time from the last press to the reporter holding the last level,
+ *   with the queue and with one write per press sent in order. The queue
+ *   caps writes at one per 150 ms round trip and delivers the last level
+ *   150-200 ms after the last press at any rate. In order, the last level
+ *   arrives 1.1 s late at 10 presses per second and 4 s late at 20.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "ble_util/ble_conn_reg.c"
+#include "ble_pxpm/ble_pxpm.c"
+
+#define HT_CONN_A           0x0010
+#define HT_CONN_B           0x0021
+#define HT_LLS_HANDLE       0x0012
+#define HT_IAS_HANDLE       0x000E
+#define HT_TPS_HANDLE       0x0016
+#define HT_CCCD_HANDLE      0x0017
+#define HT_WRITE_MAX        4096
+
+#define SIM_CONN_INTERVAL_MS    50
+#define SIM_RSP_EVENTS          2       /* Write Request in one connection event, its response two later */
+#define SIM_BURST_MS            2000
+
+typedef struct HT_Write_T
+{
+    uint16_t    connHandle;
+    uint16_t    charHandle;
+    uint8_t     writeType;
+    uint8_t     value;
+    unsigned    seq;                /* Press the level was set by */
+} HT_Write_T;
+
+static HT_Write_T   s_htWrite[HT_WRITE_MAX];
+static unsigned     s_htWriteCnt;
+static uint16_t     s_htWriteResult = MBA_RES_SUCCESS;
+static unsigned     s_htWriteRspCnt;
+static unsigned     s_htSeq;
+static unsigned     s_htReadCnt;
+static uint16_t     s_htReadStart;
+static unsigned     s_htBootCnt;
+static unsigned     s_htQueueEmptyCnt;
+
+uint16_t BLE_DD_ServiceDiscoveryRegister(BLE_DD_DiscSvc_T *p_discSvc)
+{
+    (void)p_discSvc;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t GATTC_Write(uint16_t connHandle, GATTC_WriteParams_T *p_writeParams)
+{
+    if (s_htWriteResult != MBA_RES_SUCCESS)
+    {
+        return s_htWriteResult;
+    }
+
+    HT_CHECK(s_htWriteCnt < HT_WRITE_MAX);
+    HT_CHECK_EQ(p_writeParams->charLength, 1);
+    s_htWrite[s_htWriteCnt].connHandle = connHandle;
+    s_htWrite[s_htWriteCnt].charHandle = p_writeParams->charHandle;
+    s_htWrite[s_htWriteCnt].writeType = p_writeParams->writeType;
+    s_htWrite[s_htWriteCnt].value = p_writeParams->charValue[0];
+    s_htWrite[s_htWriteCnt].seq = s_htSeq;
+    s_htWriteCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t GATTC_Read(uint16_t connHandle, uint16_t charHandle, uint16_t offset)
+{
+    (void)connHandle;
+    (void)charHandle;
+    (void)offset;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t GATTC_ReadUsingUUID(uint16_t connHandle, GATTC_ReadByTypeParams_T *p_readParams)
+{
+    (void)connHandle;
+    s_htReadStart = p_readParams->startHandle;
+    s_htReadCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+static void ht_PxpmCb(BLE_PXPM_Event_T *p_event)
+{
+    if (p_event->eventId == BLE_PXPM_EVT_LLS_ALERT_LEVEL_WRITE_RSP_IND)
+    {
+        s_htWriteRspCnt++;
+    }
+    else if (p_event->eventId == BLE_PXPM_EVT_BOOTSTRAP_COMPLETE_IND)
+    {
+        s_htBootCnt++;
+    }
+    else if (p_event->eventId == BLE_PXPM_EVT_WRITE_QUEUE_EMPTY_IND)
+    {
+        HT_CHECK(BLE_PXPM_IsWriteQueueEmpty(p_event->eventField.evtWriteQueueEmpty.connHandle));
+        s_htQueueEmptyCnt++;
+    }
+}
+
+static void ht_StackEvt(uint8_t groupId, void *p_event)
+{
+    STACK_Event_T stackEvt;
+
+    stackEvt.groupId = groupId;
+    stackEvt.p_event = p_event;
+    BLE_CONN_REG_BleEventHandler(&stackEvt);
+    BLE_PXPM_BleEventHandler(&stackEvt);
+    BLE_CONN_REG_BleReleaseHandler(&stackEvt);
+}
+
+static void ht_Connect(uint16_t connHandle)
+{
+    BLE_GAP_Event_T evt;
+    BLE_PXPM_HandleCache_T cache;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_CONNECTED;
+    evt.eventField.evtConnect.status = GAP_STATUS_SUCCESS;
+    evt.eventField.evtConnect.connHandle = connHandle;
+    ht_StackEvt(STACK_GRP_BLE_GAP, &evt);
+
+    //Handles of a bonded reporter, no discovery
+    memset(&cache, 0, sizeof(cache));
+    cache.llsAlertLvHandle = HT_LLS_HANDLE;
+    cache.iasAlertLvHandle = HT_IAS_HANDLE;
+    cache.tpsTxPwrLvHandle = HT_TPS_HANDLE;
+    HT_CHECK_EQ(BLE_PXPM_RestoreHandleCache(connHandle, &cache), MBA_RES_SUCCESS);
+}
+
+static void ht_Disconnect(uint16_t connHandle)
+{
+    BLE_GAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_DISCONNECTED;
+    evt.eventField.evtDisconnect.connHandle = connHandle;
+    ht_StackEvt(STACK_GRP_BLE_GAP, &evt);
+}
+
+static void ht_WriteRsp(uint16_t connHandle, uint16_t charHandle)
+{
+    GATT_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = GATTC_EVT_WRITE_RESP;
+    evt.eventField.onWriteResp.connHandle = connHandle;
+    evt.eventField.onWriteResp.charHandle = charHandle;
+    ht_StackEvt(STACK_GRP_GATT, &evt);
+}
+
+static void ht_ErrorRsp(uint16_t connHandle, uint16_t attrHandle)
+{
+    GATT_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = GATTC_EVT_ERROR_RESP;
+    evt.eventField.onError.connHandle = connHandle;
+    evt.eventField.onError.reqOpcode = ATT_WRITE_REQ;
+    evt.eventField.onError.attrHandle = attrHandle;
+    evt.eventField.onError.errCode = ATT_ERRCODE_WRITE_NOT_PERMITTED;
+    ht_StackEvt(STACK_GRP_GATT, &evt);
+}
+
+static void ht_ReadUsingUuidRsp(uint16_t connHandle, uint16_t attrHandle, uint8_t value)
+{
+    GATT_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = GATTC_EVT_READ_USING_UUID_RESP;
+    evt.eventField.onReadUsingUuidResp.connHandle = connHandle;
+    evt.eventField.onReadUsingUuidResp.attrPairLength = 3;
+    evt.eventField.onReadUsingUuidResp.attrDataLength = 3;
+    evt.eventField.onReadUsingUuidResp.attrData[0] = (uint8_t)attrHandle;
+    evt.eventField.onReadUsingUuidResp.attrData[1] = (uint8_t)(attrHandle >> 8);
+    evt.eventField.onReadUsingUuidResp.attrData[2] = value;
+    ht_StackEvt(STACK_GRP_GATT, &evt);
+}
+
+static void ht_ProtocolAvailable(uint16_t connHandle)
+{
+    GATT_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = GATTC_EVT_PROTOCOL_AVAILABLE;
+    evt.eventField.onClientProtocolAvailable.connHandle = connHandle;
+    ht_StackEvt(STACK_GRP_GATT, &evt);
+}
+
+static void ht_TxBufAvailable(uint16_t connHandle)
+{
+    BLE_GAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_TX_BUF_AVAILABLE;
+    evt.eventField.evtTxBufAvailable.connHandle = connHandle;
+    ht_StackEvt(STACK_GRP_BLE_GAP, &evt);
+}
+
+static void ht_Reset(void)
+{
+    BLE_CONN_REG_Init();
+    HT_CHECK_EQ(BLE_PXPM_Init(), MBA_RES_SUCCESS);
+    BLE_PXPM_EventRegister(ht_PxpmCb);
+    s_htWriteCnt = 0;
+    s_htWriteRspCnt = 0;
+    s_htReadCnt = 0;
+    s_htBootCnt = 0;
+    s_htQueueEmptyCnt = 0;
+    s_htWriteResult = MBA_RES_SUCCESS;
+}
+
+static void test_coalesce(void)
+{
+    BLE_PXPM_WriteStats_T stats;
+
+    ht_Reset();
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_INVALID_PARA);
+    ht_Connect(HT_CONN_A);
+
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 1);
+    HT_CHECK_EQ(s_htWrite[0].charHandle, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWrite[0].writeType, ATT_WRITE_REQ);
+    HT_CHECK_EQ(s_htWrite[0].value, BLE_PXPM_ALERT_LEVEL_MILD);
+
+    //The request is in flight: the next levels wait, only the latest is kept
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 1);
+
+    //A Write Command goes out regardless
+    HT_CHECK_EQ(BLE_PXPM_WriteIasAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 2);
+    HT_CHECK_EQ(s_htWrite[1].charHandle, HT_IAS_HANDLE);
+    HT_CHECK_EQ(s_htWrite[1].writeType, ATT_WRITE_CMD);
+
+    ht_WriteRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWriteRspCnt, 1);
+    HT_CHECK_EQ(s_htWriteCnt, 3);
+    HT_CHECK_EQ(s_htWrite[2].charHandle, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWrite[2].value, BLE_PXPM_ALERT_LEVEL_NO);
+
+    //Nothing left behind the last response
+    ht_WriteRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWriteCnt, 3);
+
+    BLE_PXPM_GetWriteStats(&stats);
+    HT_CHECK_EQ(stats.writeCnt, 3);
+    HT_CHECK_EQ(stats.coalesceCnt, 1);
+    HT_CHECK_EQ(stats.retryCnt, 0);
+    HT_CHECK_EQ(stats.dropCnt, 0);
+}
+
+static void test_busy_and_errors(void)
+{
+    BLE_PXPM_WriteStats_T stats;
+
+    ht_Reset();
+    ht_Connect(HT_CONN_A);
+
+    //No bearer: kept pending, sent when the stack says so
+    s_htWriteResult = MBA_RES_BUSY;
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 0);
+    s_htWriteResult = MBA_RES_SUCCESS;
+    ht_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htWriteCnt, 1);
+    HT_CHECK_EQ(s_htWrite[0].value, BLE_PXPM_ALERT_LEVEL_HIGH);
+
+    //An Error Response frees the bearer like a Write Response
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 1);
+    ht_ErrorRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWriteRspCnt, 1);
+    HT_CHECK_EQ(s_htWriteCnt, 2);
+    HT_CHECK_EQ(s_htWrite[1].value, BLE_PXPM_ALERT_LEVEL_MILD);
+    ht_WriteRsp(HT_CONN_A, HT_LLS_HANDLE);
+
+    //No TX buffer for the command: sent on BLE_GAP_EVT_TX_BUF_AVAILABLE
+    s_htWriteResult = MBA_RES_NO_RESOURCE;
+    HT_CHECK_EQ(BLE_PXPM_WriteIasAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_SUCCESS);
+    s_htWriteResult = MBA_RES_SUCCESS;
+    ht_TxBufAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htWriteCnt, 3);
+    HT_CHECK_EQ(s_htWrite[2].charHandle, HT_IAS_HANDLE);
+
+    //Rejected: dropped, not retried
+    s_htWriteResult = MBA_RES_FAIL;
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_FAIL);
+    s_htWriteResult = MBA_RES_SUCCESS;
+    ht_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htWriteCnt, 3);
+
+    BLE_PXPM_GetWriteStats(&stats);
+    HT_CHECK_EQ(stats.writeCnt, 3);
+    HT_CHECK_EQ(stats.retryCnt, 2);
+    HT_CHECK_EQ(stats.dropCnt, 1);
+}
+
+static void test_links(void)
+{
+    ht_Reset();
+    ht_Connect(HT_CONN_A);
+    ht_Connect(HT_CONN_B);
+
+    //A request in flight on one link does not hold the other
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_B, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 2);
+    HT_CHECK_EQ(s_htWrite[0].connHandle, HT_CONN_A);
+    HT_CHECK_EQ(s_htWrite[1].connHandle, HT_CONN_B);
+
+    //Pending on A, then A is lost: nothing is sent to it or to the link reusing its slot
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_SUCCESS);
+    ht_Disconnect(HT_CONN_A);
+    ht_WriteRsp(HT_CONN_B, HT_LLS_HANDLE);
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_INVALID_PARA);
+    ht_Connect(HT_CONN_A + 0x40);
+    ht_ProtocolAvailable(HT_CONN_A + 0x40);
+    HT_CHECK_EQ(s_htWriteCnt, 2);
+
+    //The new link starts with a free bearer
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A + 0x40, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 3);
+    HT_CHECK_EQ(s_htWrite[2].connHandle, HT_CONN_A + 0x40);
+}
+
+static void test_queue_empty(void)
+{
+    ht_Reset();
+    HT_CHECK(BLE_PXPM_IsWriteQueueEmpty(HT_CONN_A));
+    ht_Connect(HT_CONN_A);
+    HT_CHECK(BLE_PXPM_IsWriteQueueEmpty(HT_CONN_A));
+
+    //A command out at once leaves nothing to report
+    HT_CHECK_EQ(BLE_PXPM_WriteIasAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH), MBA_RES_SUCCESS);
+    HT_CHECK(BLE_PXPM_IsWriteQueueEmpty(HT_CONN_A));
+    HT_CHECK_EQ(s_htQueueEmptyCnt, 0);
+
+    //Busy until the response of the request in flight
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_SUCCESS);
+    HT_CHECK(!BLE_PXPM_IsWriteQueueEmpty(HT_CONN_A));
+    HT_CHECK_EQ(BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_SUCCESS);
+    ht_WriteRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htQueueEmptyCnt, 0);
+    ht_ErrorRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htQueueEmptyCnt, 1);
+
+    //A command waiting for a TX buffer
+    s_htWriteResult = MBA_RES_OOM;
+    HT_CHECK_EQ(BLE_PXPM_WriteIasAlertLevel(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_SUCCESS);
+    HT_CHECK(!BLE_PXPM_IsWriteQueueEmpty(HT_CONN_A));
+    ht_TxBufAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htQueueEmptyCnt, 1);
+    s_htWriteResult = MBA_RES_SUCCESS;
+    ht_TxBufAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htQueueEmptyCnt, 2);
+
+    //Responses to writes of other modules
+    ht_WriteRsp(HT_CONN_A, HT_CCCD_HANDLE);
+    ht_ErrorRsp(HT_CONN_A, HT_CCCD_HANDLE);
+    ht_ProtocolAvailable(HT_CONN_A);
+    HT_CHECK_EQ(s_htQueueEmptyCnt, 2);
+}
+
+static unsigned sim_RspMs(unsigned sendMs)
+{
+    //Sent on the next connection event, answered SIM_RSP_EVENTS later
+    return ((sendMs / SIM_CONN_INTERVAL_MS) + 1U + SIM_RSP_EVENTS) * SIM_CONN_INTERVAL_MS;
+}
+
+static void test_bootstrap(void)
+{
+    BLE_PXPM_BootstrapStats_T stats;
+
+    ht_Reset();
+    ht_Connect(HT_CONN_A);
+
+    //One IAS Write Command with the level given, the LLS read goes out with it
+    HT_CHECK_EQ(BLE_PXPM_StartBootstrap(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(BLE_PXPM_StartBootstrap(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_HIGH, BLE_PXPM_ALERT_LEVEL_MILD), MBA_RES_BUSY);
+    HT_CHECK_EQ(s_htWriteCnt, 1);
+    HT_CHECK_EQ(s_htWrite[0].charHandle, HT_IAS_HANDLE);
+    HT_CHECK_EQ(s_htWrite[0].writeType, ATT_WRITE_CMD);
+    HT_CHECK_EQ(s_htWrite[0].value, BLE_PXPM_ALERT_LEVEL_MILD);
+    HT_CHECK_EQ(s_htReadCnt, 1);
+    HT_CHECK_EQ(s_htReadStart, HT_LLS_HANDLE);
+
+    //The reporter holds another level: the LLS Write Request follows
+    ht_ReadUsingUuidRsp(HT_CONN_A, HT_LLS_HANDLE, BLE_PXPM_ALERT_LEVEL_NO);
+    HT_CHECK_EQ(s_htWriteCnt, 2);
+    HT_CHECK_EQ(s_htWrite[1].charHandle, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWrite[1].value, BLE_PXPM_ALERT_LEVEL_HIGH);
+
+    //Responses to other handles of the link do not end the LLS write stage
+    ht_WriteRsp(HT_CONN_A, HT_CCCD_HANDLE);
+    ht_ErrorRsp(HT_CONN_A, HT_IAS_HANDLE);
+    ht_WriteRsp(HT_CONN_A, HT_IAS_HANDLE);
+    HT_CHECK_EQ(s_htReadCnt, 1);
+    HT_CHECK_EQ(s_htWriteRspCnt, 0);
+
+    //The LLS response does, TX Power Level is read next
+    ht_WriteRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htWriteRspCnt, 1);
+    HT_CHECK_EQ(s_htReadCnt, 2);
+    HT_CHECK_EQ(s_htReadStart, 0x0001);
+    HT_CHECK_EQ(s_htBootCnt, 0);
+    ht_ReadUsingUuidRsp(HT_CONN_A, HT_TPS_HANDLE, 0);
+    HT_CHECK_EQ(s_htBootCnt, 1);
+    HT_CHECK_EQ(s_htWriteCnt, 2);
+
+    //Same for the Error Response path
+    HT_CHECK_EQ(BLE_PXPM_StartBootstrap(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_MILD, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_htWriteCnt, 3);
+    HT_CHECK_EQ(s_htWrite[2].charHandle, HT_IAS_HANDLE);
+    HT_CHECK_EQ(s_htWrite[2].value, BLE_PXPM_ALERT_LEVEL_NO);
+    ht_ReadUsingUuidRsp(HT_CONN_A, HT_LLS_HANDLE, BLE_PXPM_ALERT_LEVEL_HIGH);
+    HT_CHECK_EQ(s_htWriteCnt, 4);
+    ht_ErrorRsp(HT_CONN_A, HT_IAS_HANDLE);
+    HT_CHECK_EQ(s_htReadCnt, 3);
+    ht_ErrorRsp(HT_CONN_A, HT_LLS_HANDLE);
+    HT_CHECK_EQ(s_htReadCnt, 4);
+    ht_ReadUsingUuidRsp(HT_CONN_A, HT_TPS_HANDLE, 0);
+    HT_CHECK_EQ(s_htBootCnt, 2);
+
+    //The level the reporter already holds is not written again
+    HT_CHECK_EQ(BLE_PXPM_StartBootstrap(HT_CONN_A, BLE_PXPM_ALERT_LEVEL_MILD, BLE_PXPM_ALERT_LEVEL_NO), MBA_RES_SUCCESS);
+    ht_ReadUsingUuidRsp(HT_CONN_A, HT_LLS_HANDLE, BLE_PXPM_ALERT_LEVEL_MILD);
+    HT_CHECK_EQ(s_htWriteCnt, 5);
+    HT_CHECK_EQ(s_htReadCnt, 6);
+    ht_ReadUsingUuidRsp(HT_CONN_A, HT_TPS_HANDLE, 0);
+    HT_CHECK_EQ(s_htBootCnt, 3);
+
+    BLE_PXPM_GetBootstrapStats(&stats);
+    HT_CHECK_EQ(stats.bootstrapCnt, 3);
+    HT_CHECK_EQ(stats.llsWriteSkipCnt, 1);
+}
+
+/* Press times are app task times: the EIC callback only posts APP_MSG_BTN_EVT */
+static void sim_Burst(unsigned pressPerSec, unsigned *p_writes, unsigned *p_lastMs, unsigned *p_fifoWrites, unsigned *p_fifoLastMs)
+{
+    BLE_PXPM_ConnList_T *p_conn;
+    unsigned pressCnt = (SIM_BURST_MS * pressPerSec) / 1000U;
+    unsigned pressGapMs = 1000U / pressPerSec;
+    unsigned press = 0;
+    unsigned nowMs;
+    unsigned rspMs = 0;
+    unsigned sentSeq = 0;
+    unsigned heldSeq = 0;
+    unsigned lastPressMs = 0;
+    unsigned doneMs = 0;
+    unsigned freeMs = 0;
+    unsigned i;
+    bool inFlight = false;
+
+    ht_Reset();
+    ht_Connect(HT_CONN_A);
+    p_conn = ble_pxpm_GetConnListByHandle(HT_CONN_A);
+    s_htSeq = 0;
+
+    for (nowMs = 0; (press < pressCnt) || inFlight; nowMs++)
+    {
+        if ((press < pressCnt) && (nowMs == press * pressGapMs))
+        {
+            s_htSeq++;
+            (void)BLE_PXPM_WriteLlsAlertLevel(HT_CONN_A, (BLE_PXPM_AlertLevel_T)(s_htSeq % 3U));
+            lastPressMs = nowMs;
+            press++;
+        }
+
+        if (inFlight && (nowMs == rspMs))
+        {
+            inFlight = false;
+            heldSeq = sentSeq;
+            ht_WriteRsp(HT_CONN_A, HT_LLS_HANDLE);
+        }
+
+        if (!inFlight && p_conn->writeReqInFlight)
+        {
+            inFlight = true;
+            sentSeq = s_htWrite[s_htWriteCnt - 1U].seq;
+            rspMs = sim_RspMs(nowMs);
+        }
+
+        if ((press == pressCnt) && (heldSeq == s_htSeq) && (doneMs == 0))
+        {
+            doneMs = nowMs;
+        }
+    }
+
+    HT_CHECK_EQ(heldSeq, pressCnt);
+    *p_writes = s_htWriteCnt;
+    *p_lastMs = doneMs - lastPressMs;
+
+    //In order, one Write Request per press, each waiting for the previous response
+    for (i = 0; i < pressCnt; i++)
+    {
+        freeMs = sim_RspMs((i * pressGapMs > freeMs) ? (i * pressGapMs) : freeMs);
+    }
+    *p_fifoWrites = pressCnt;
+    *p_fifoLastMs = freeMs - lastPressMs;
+}
+
+static void test_burst(void)
+{
+    static const unsigned rate[] = { 1, 2, 5, 10, 20 };
+    unsigned i;
+
+    printf("  button bursts for %u ms, %u ms connection interval, response %u events after the request\n",
+           SIM_BURST_MS, SIM_CONN_INTERVAL_MS, SIM_RSP_EVENTS);
+    printf("  presses/s   queue: writes  last level after   in order: writes  last level after\n");
+    for (i = 0; i < sizeof(rate) / sizeof(rate[0]); i++)
+    {
+        unsigned writes, lastMs, fifoWrites, fifoLastMs;
+
+        sim_Burst(rate[i], &writes, &lastMs, &fifoWrites, &fifoLastMs);
+        printf("  %9u   %13u  %13u ms   %16u  %13u ms\n", rate[i], writes, lastMs, fifoWrites, fifoLastMs);
+
+        //At most one write per round trip, the last level within two of them
+        HT_CHECK(writes <= fifoWrites);
+        HT_CHECK(lastMs <= 2U * (1U + SIM_RSP_EVENTS) * SIM_CONN_INTERVAL_MS);
+        HT_CHECK(lastMs <= fifoLastMs);
+    }
+}
+
+int main(void)
+{
+    test_coalesce();
+    test_busy_and_errors();
+    test_links();
+    test_queue_empty();
+    test_bootstrap();
+    test_burst();
+    return ht_Finish("test_pxpm_write");
+}
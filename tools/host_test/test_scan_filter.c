@@ -0,0 +1,397 @@
+/*
+ * Host test and benchmark of the monitor scan filter (app_ble_scan_filter.c).
+ *
+ * - Service Data matching on well-formed, foreign, padded and malformed AD.
+ * - Extended report rules: connectable and complete only.
+ * - Directed advertising carries no AD and never matches, which is why the
+ *   reporter does not advertise directed by default.
+ * - Filter Accept List learning, re-bonding under the same ID and pruning.
+ * - Post-allocation drops counted from two threads while acceptCnt stays exact.
+ * - Replay of synthetic crowded-room traffic through a bounded app queue:
+ *   drops before allocation against drops after it, with and without the filter.
+ */
+
+#include <pthread.h>
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "app_ble/app_ble_scan_filter.c"
+
+#define REPLAY_REPORTS      100000
+#define REPLAY_QUEUE_LEN    APP_MSG_QUEUE_LEN
+#define REPLAY_DRAIN_EVERY  8           /* Reports arriving per app task wake-up */
+#define REPLAY_DRAIN_NUM    3           /* Messages the app task handles per wake-up */
+#define THREAD_ITERATIONS   200000
+
+static uint8_t  s_pairedDevId[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+static uint8_t  s_pairedDevCnt;
+static uint8_t  s_stackAcceptList[BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM];
+static uint8_t  s_stackAcceptListCnt;
+static unsigned s_setAcceptListCallCnt;
+
+uint16_t BLE_GAP_SetScanningFilter(BLE_GAP_ScanFilterConfig_T *p_param)
+{
+    (void)p_param;
+    return MBA_RES_SUCCESS;
+}
+
+void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt)
+{
+    memcpy(p_devId, s_pairedDevId, s_pairedDevCnt);
+    *p_devCnt = s_pairedDevCnt;
+}
+
+uint16_t BLE_DM_SetFilterAcceptList(uint8_t devCnt, uint8_t const *p_devId)
+{
+    s_setAcceptListCallCnt++;
+    if (devCnt > BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM)
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+    memcpy(s_stackAcceptList, p_devId, devCnt);
+    s_stackAcceptListCnt = devCnt;
+    return MBA_RES_SUCCESS;
+}
+
+/* Flags, then the Service Data the reporter advertises. */
+static uint8_t test_BuildReporterAdv(uint8_t *p_adv)
+{
+    static const uint8_t adv[] = { 0x02, 0x01, 0x06, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x20 };
+
+    memcpy(p_adv, adv, sizeof(adv));
+    return sizeof(adv);
+}
+
+static uint8_t test_BuildForeignAdv(uint8_t *p_adv, uint32_t kind)
+{
+    static const uint8_t phone[] = { 0x02, 0x01, 0x1A, 0x0A, 0xFF, 0x4C, 0x00, 0x10, 0x05, 0x01, 0x18, 0x2B, 0x9E, 0x11 };
+    static const uint8_t beacon[] = { 0x02, 0x01, 0x06, 0x1A, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0xE2, 0xC5, 0x6D, 0xB5,
+                                      0xDF, 0xFB, 0x48, 0xD2, 0xB0, 0x60, 0xD0, 0xF5, 0xA7, 0x10, 0x96, 0xE0,
+                                      0x00, 0x00, 0x00, 0x00, 0xC5 };
+    static const uint8_t otherSvc[] = { 0x02, 0x01, 0x06, 0x05, 0x16, 0xDA, 0xFE, 0xFF, 0x21 };
+    static const uint8_t truncated[] = { 0x02, 0x01, 0x06, 0x09, 0x16, 0xDA, 0xFE, 0xFF };
+    const uint8_t *p_src;
+    uint8_t len;
+
+    switch (kind % 4U)
+    {
+        case 0: p_src = phone;      len = sizeof(phone);     break;
+        case 1: p_src = beacon;     len = sizeof(beacon);    break;
+        case 2: p_src = otherSvc;   len = sizeof(otherSvc);  break;
+        default: p_src = truncated; len = sizeof(truncated); break;
+    }
+    memcpy(p_adv, p_src, len);
+    return len;
+}
+
+static void test_Match(void)
+{
+    uint8_t adv[BLE_GAP_ADV_MAX_LENGTH];
+    uint8_t len;
+    uint32_t i;
+
+    len = test_BuildReporterAdv(adv);
+    HT_CHECK(app_scan_filter_MatchServiceData(adv, len));
+
+    //Zero padding after the match does not matter, before it ends the walk
+    memset(&adv[len], 0, sizeof(adv) - len);
+    HT_CHECK(app_scan_filter_MatchServiceData(adv, sizeof(adv)));
+    memmove(&adv[1], adv, len);
+    adv[0] = 0;
+    HT_CHECK(!app_scan_filter_MatchServiceData(adv, len + 1U));
+
+    //Service Data cut by the report length
+    len = test_BuildReporterAdv(adv);
+    HT_CHECK(!app_scan_filter_MatchServiceData(adv, len - 1U));
+
+    for (i = 0; i < 4U; i++)
+    {
+        len = test_BuildForeignAdv(adv, i);
+        HT_CHECK(!app_scan_filter_MatchServiceData(adv, len));
+    }
+
+    //Random bytes never read past the report
+    ht_Seed(7);
+    for (i = 0; i < 10000U; i++)
+    {
+        uint8_t j;
+
+        len = (uint8_t)(ht_Rand() % (sizeof(adv) + 1U));
+        for (j = 0; j < len; j++)
+        {
+            adv[j] = (uint8_t)ht_Rand();
+        }
+        (void)app_scan_filter_MatchServiceData(adv, len);
+    }
+}
+
+static void test_ExtReport(void)
+{
+    BLE_GAP_EvtExtAdvReport_T report;
+    APP_SCAN_FILTER_Stats_T stats;
+
+    s_pairedDevCnt = 0;
+    APP_SCAN_FILTER_Init();
+
+    memset(&report, 0, sizeof(report));
+    report.length = test_BuildReporterAdv(report.advData);
+    report.eventType = BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_CONNECTABLE;
+    report.dataStatus = BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE;
+#if APP_BLE_CONNECTIONLESS
+    report.periodAdvInterval = 80;
+#endif
+    HT_CHECK(APP_SCAN_FILTER_ProcExtAdvReport(&report));
+
+    report.dataStatus = BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_MORE;
+    HT_CHECK(!APP_SCAN_FILTER_ProcExtAdvReport(&report));
+
+#if !APP_BLE_CONNECTIONLESS
+    report.dataStatus = BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE;
+    report.eventType = 0;
+    HT_CHECK(!APP_SCAN_FILTER_ProcExtAdvReport(&report));
+#endif
+
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.rxCnt, 3 - APP_BLE_CONNECTIONLESS);
+    HT_CHECK_EQ(stats.acceptCnt, 1);
+    HT_CHECK_EQ(stats.dropPreAllocCnt, 2 - APP_BLE_CONNECTIONLESS);
+    HT_CHECK(stats.stackFilterEnabled);
+}
+
+static void test_Directed(void)
+{
+    BLE_GAP_EvtAdvReport_T report;
+    BLE_GAP_EvtExtAdvReport_T extReport;
+    APP_SCAN_FILTER_Stats_T stats;
+
+    s_pairedDevCnt = 0;
+    APP_SCAN_FILTER_Init();
+
+    //ADV_DIRECT_IND from a bonded reporter, addressed to this monitor
+    memset(&report, 0, sizeof(report));
+    report.eventType = BLE_GAP_ADV_REPORT_EVT_TYPE_ADV_DIRECT_IND;
+    report.length = 0;
+    HT_CHECK(!APP_SCAN_FILTER_ProcAdvReport(&report));
+
+    memset(&extReport, 0, sizeof(extReport));
+    extReport.eventType = BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_CONNECTABLE | BLE_GAP_EXT_ADV_REPORT_EVT_TYPE_DIRECTED;
+    extReport.dataStatus = BLE_GAP_EXT_ADV_REPORT_DATA_STATUS_COMPLETE;
+    extReport.length = 0;
+    HT_CHECK(!APP_SCAN_FILTER_ProcExtAdvReport(&extReport));
+
+    //The stack drops them before the application does
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK(stats.stackFilterEnabled);
+    HT_CHECK_EQ(stats.acceptCnt, 0);
+}
+
+static void test_AcceptList(void)
+{
+    APP_SCAN_FILTER_Stats_T stats;
+    uint8_t i;
+
+    //Bonds found at start-up are learned in order
+    s_pairedDevCnt = 3;
+    s_pairedDevId[0] = 4;
+    s_pairedDevId[1] = 1;
+    s_pairedDevId[2] = 6;
+    APP_SCAN_FILTER_Init();
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.acceptListCnt, 3);
+    HT_CHECK_EQ(s_stackAcceptListCnt, 3);
+    HT_CHECK_EQ(s_stackAcceptList[2], 6);
+
+    //Learning a known ID pushes the list again, the identity address may be new
+    s_setAcceptListCallCnt = 0;
+    HT_CHECK_EQ(APP_SCAN_FILTER_LearnPeer(1), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_setAcceptListCallCnt, 1);
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.acceptListCnt, 3);
+
+    //Forgetting the middle entry keeps the order of the others
+    HT_CHECK_EQ(APP_SCAN_FILTER_ForgetPeer(1), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_stackAcceptListCnt, 2);
+    HT_CHECK_EQ(s_stackAcceptList[0], 4);
+    HT_CHECK_EQ(s_stackAcceptList[1], 6);
+
+    //Unknown ID: nothing to send to the controller
+    s_setAcceptListCallCnt = 0;
+    HT_CHECK_EQ(APP_SCAN_FILTER_ForgetPeer(1), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_setAcceptListCallCnt, 0);
+
+    HT_CHECK_EQ(APP_SCAN_FILTER_ForgetPeer(4), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(APP_SCAN_FILTER_ForgetPeer(6), MBA_RES_SUCCESS);
+    HT_CHECK_EQ(s_stackAcceptListCnt, 0);
+
+    for (i = 0; i < BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM; i++)
+    {
+        HT_CHECK_EQ(APP_SCAN_FILTER_LearnPeer(i), MBA_RES_SUCCESS);
+    }
+    HT_CHECK_EQ(APP_SCAN_FILTER_LearnPeer(BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM), MBA_RES_NO_RESOURCE);
+
+    //Learning alone never narrows discovery unless the build asks for it
+    HT_CHECK_EQ(APP_SCAN_FILTER_GetScanFilterPolicy(),
+                APP_SCAN_FILTER_ACCEPT_LIST_ONLY ? BLE_GAP_SCAN_FP_ACCEPT_LIST : BLE_GAP_SCAN_FP_ACCEPT_ALL);
+}
+
+static void *test_DropThread(void *p_arg)
+{
+    unsigned i;
+
+    (void)p_arg;
+    for (i = 0; i < THREAD_ITERATIONS; i++)
+    {
+        APP_SCAN_FILTER_CountPostAllocDrop();
+    }
+    return NULL;
+}
+
+static void *test_AcceptThread(void *p_arg)
+{
+    BLE_GAP_EvtAdvReport_T *p_report = p_arg;
+    unsigned i;
+
+    for (i = 0; i < THREAD_ITERATIONS; i++)
+    {
+        (void)APP_SCAN_FILTER_ProcAdvReport(p_report);
+        APP_SCAN_FILTER_CountPostAllocDrop();
+    }
+    return NULL;
+}
+
+/* Stack callback and application task count drops at the same time. */
+static void test_Concurrency(void)
+{
+    BLE_GAP_EvtAdvReport_T report;
+    APP_SCAN_FILTER_Stats_T stats;
+    pthread_t stackThread, appThread;
+
+    s_pairedDevCnt = 0;
+    APP_SCAN_FILTER_Init();
+    memset(&report, 0, sizeof(report));
+    report.length = test_BuildReporterAdv(report.advData);
+
+    pthread_create(&stackThread, NULL, test_AcceptThread, &report);
+    pthread_create(&appThread, NULL, test_DropThread, NULL);
+    pthread_join(stackThread, NULL);
+    pthread_join(appThread, NULL);
+
+    APP_SCAN_FILTER_GetStats(&stats);
+    HT_CHECK_EQ(stats.acceptCnt, THREAD_ITERATIONS);
+    HT_CHECK_EQ(stats.dropPostAllocCnt, 2 * THREAD_ITERATIONS);
+}
+
+/* One minute in a crowded room: phones, beacons, other FEDA devices, and a few tags. */
+static void test_Replay(bool filterOn)
+{
+    BLE_GAP_EvtAdvReport_T report;
+    APP_SCAN_FILTER_Stats_T stats;
+    unsigned queueDepth = 0;
+    unsigned delivered = 0;
+    unsigned reporterCnt = 0;
+    unsigned reporterDelivered = 0;
+    bool accepted;
+    bool isReporter;
+    unsigned i;
+
+    s_pairedDevCnt = 0;
+    APP_SCAN_FILTER_Init();
+    ht_Seed(2024);
+    memset(&report, 0, sizeof(report));
+
+    for (i = 0; i < REPLAY_REPORTS; i++)
+    {
+        isReporter = (ht_Rand() % 100U) < 5U;
+        if (isReporter)
+        {
+            report.length = test_BuildReporterAdv(report.advData);
+            reporterCnt++;
+        }
+        else
+        {
+            report.length = test_BuildForeignAdv(report.advData, ht_Rand());
+        }
+
+        accepted = APP_SCAN_FILTER_ProcAdvReport(&report);
+
+        if (accepted || !filterOn)
+        {
+            if (queueDepth >= REPLAY_QUEUE_LEN)
+            {
+                APP_SCAN_FILTER_CountPostAllocDrop();
+            }
+            else
+            {
+                queueDepth++;
+                delivered++;
+                reporterDelivered += isReporter ? 1U : 0U;
+            }
+        }
+
+        if ((i % REPLAY_DRAIN_EVERY) == (REPLAY_DRAIN_EVERY - 1U))
+        {
+            queueDepth = (queueDepth > REPLAY_DRAIN_NUM) ? (queueDepth - REPLAY_DRAIN_NUM) : 0U;
+        }
+    }
+
+    APP_SCAN_FILTER_GetStats(&stats);
+    printf("  filter %-3s: %u reports, %u from tags, pre-alloc drops %u, post-alloc drops %u, "
+           "tag reports delivered %u (%.1f%%)\n",
+           filterOn ? "on" : "off", stats.rxCnt, reporterCnt,
+           filterOn ? stats.dropPreAllocCnt : 0U, stats.dropPostAllocCnt,
+           reporterDelivered, 100.0 * reporterDelivered / reporterCnt);
+
+    HT_CHECK_EQ(stats.rxCnt, REPLAY_REPORTS);
+    if (filterOn)
+    {
+        //Only tag reports are queued, and the app keeps up with them
+        HT_CHECK_EQ(stats.acceptCnt, reporterCnt);
+        HT_CHECK_EQ(stats.acceptCnt - stats.dropPostAllocCnt, delivered);
+        HT_CHECK_EQ(stats.dropPostAllocCnt, 0);
+        HT_CHECK_EQ(reporterDelivered, reporterCnt);
+    }
+    else
+    {
+        //Without the filter the queue saturates and tag reports are lost with the rest
+        HT_CHECK(stats.dropPostAllocCnt > REPLAY_REPORTS / 2U);
+        HT_CHECK(reporterDelivered < reporterCnt);
+    }
+}
+
+/* Cost of the check in the stack callback, over the mix the replay uses. */
+static void test_Bench(void)
+{
+    BLE_GAP_EvtAdvReport_T report[5];
+    volatile unsigned acceptCnt = 0;
+    uint64_t t0, t1;
+    unsigned i;
+
+    memset(report, 0, sizeof(report));
+    for (i = 0; i < 4U; i++)
+    {
+        report[i].length = test_BuildForeignAdv(report[i].advData, i);
+    }
+    report[4].length = test_BuildReporterAdv(report[4].advData);
+
+    t0 = ht_NowNs();
+    for (i = 0; i < 5U * REPLAY_REPORTS; i++)
+    {
+        acceptCnt += APP_SCAN_FILTER_ProcAdvReport(&report[i % 5U]) ? 1U : 0U;
+    }
+    t1 = ht_NowNs();
+    HT_CHECK_EQ(acceptCnt, REPLAY_REPORTS);
+    printf("  filter check: %.1f ns/report\n", (double)(t1 - t0) / (5U * REPLAY_REPORTS));
+}
+
+int main(void)
+{
+    test_Match();
+    test_ExtReport();
+    test_Directed();
+    test_AcceptList();
+    test_Concurrency();
+    test_Replay(true);
+    test_Replay(false);
+    test_Bench();
+    return ht_Finish("test_scan_filter");
+}
@@ -0,0 +1,570 @@
+/*
+ * Host test and simulation of the monitor scan scheduler (app_scan_sched.c).
+ *
+ * - Stage progression of a burst: interval window << n, durations doubling
+ *   from the base up to the 60 s cap, the background stage re-armed on every
+ *   timeout. Parameters are only ever set while scanning is disabled.
+ * - Per-bond profiles, their validation and the default for unbonded peers.
+ * - Resume, Stop and a failed enable: no stage moves while scanning is off.
+ * - Reconnect statistics: overlapping losses keep the first, the median.
+ * - Link loss simulation against a reporter running its own fast/slow
+ *   advertising (20 ms for 30 s, then 1022.5 ms). The reporter is back in
+ *   range after a random absence; its advertising events are received when
+ *   they fall inside a scan window. The same losses are replayed against the
+ *   fixed 100 ms / 20 ms scan the monitor used before, re-armed so that it
+ *   never stops. Reported per absence bucket: median and 90th percentile
+ *   time from the reporter being back in range to the connection, and
+ *   radio-on time per hour of link loss. The scheduler connects faster after
+ *   short dropouts for under a quarter of the radio-on time; a reporter back
+ *   after the burst waits for the 1.5% background stage, tens of seconds
+ *   instead of a few.
+ *
+ * Built twice: build/test_scan_sched with the legacy scanning APIs and
+ * build/test_scan_sched_ext with the extended ones (APP_BLE_LONG_RANGE).
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_ble/app_scan_sched.c"
+
+#define SIM_EPISODES            3000
+#define SIM_PACKET_LOSS         10          /* Percent of the advertising events received in a window that are lost */
+#define SIM_CONNECT_US          15000       /* CONNECT_IND to BLE_GAP_EVT_CONNECTED */
+#define SIM_FAST_INTERVAL_US    20000
+#define SIM_FAST_US             30000000
+#define SIM_SLOW_INTERVAL_US    1022500
+#define SIM_ADV_DELAY_US        10000       /* advDelay, 0 to 10 ms added to every advertising event */
+#define SIM_BUCKET_NUM          3
+
+typedef struct HT_Scan_T
+{
+    bool        on;
+    uint16_t    interval;           /* Unit: 0.625ms */
+    uint16_t    window;
+    uint16_t    duration;           /* Unit: 100ms, whatever the API takes */
+    uint8_t     phy;
+    uint64_t    startUs;
+} HT_Scan_T;
+
+static HT_Scan_T    s_htScan;
+static uint64_t     s_htNowUs;
+static unsigned     s_htEnableCnt;
+static unsigned     s_htDisableCnt;
+static unsigned     s_htParamWhileOnCnt;
+static unsigned     s_htDurationUnitErrCnt;
+static uint16_t     s_htEnableResult = MBA_RES_SUCCESS;
+
+uint8_t APP_SCAN_FILTER_GetScanFilterPolicy(void)
+{
+    return BLE_GAP_SCAN_FP_ACCEPT_ALL;
+}
+
+static void ht_SetNow(uint64_t us)
+{
+    s_htNowUs = us;
+    g_htTick = (TickType_t)(us / 1000U);
+}
+
+static uint16_t ht_ScanParam(uint16_t interval, uint16_t window, uint8_t phy)
+{
+    if (s_htScan.on)
+    {
+        s_htParamWhileOnCnt++;
+    }
+    s_htScan.interval = interval;
+    s_htScan.window = window;
+    s_htScan.phy = phy;
+    return MBA_RES_SUCCESS;
+}
+
+static uint16_t ht_ScanEnable(bool enable, uint16_t duration)
+{
+    if (!enable)
+    {
+        s_htScan.on = false;
+        s_htDisableCnt++;
+        return MBA_RES_SUCCESS;
+    }
+    if (s_htEnableResult != MBA_RES_SUCCESS)
+    {
+        return s_htEnableResult;
+    }
+    s_htScan.on = true;
+    s_htScan.duration = duration;
+    s_htScan.startUs = s_htNowUs;
+    s_htEnableCnt++;
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetScanningParam(BLE_GAP_ScanningParams_T *p_scanParams)
+{
+    return ht_ScanParam(p_scanParams->interval, p_scanParams->window, BLE_GAP_PHY_TYPE_LE_1M);
+}
+
+uint16_t BLE_GAP_SetScanningEnable(bool enable, uint8_t filterDuplicate, uint8_t mode, uint16_t duration)
+{
+    (void)filterDuplicate;
+    (void)mode;
+    return ht_ScanEnable(enable, duration);
+}
+
+uint16_t BLE_GAP_SetExtScanningParams(uint8_t filterPolicy, BLE_GAP_ExtScanningPhy_T *p_extScanPhy)
+{
+    (void)filterPolicy;
+    //Exactly one PHY is scanned
+    HT_CHECK(p_extScanPhy->le1mPhy.enable != p_extScanPhy->leCodedPhy.enable);
+    if (p_extScanPhy->leCodedPhy.enable)
+    {
+        return ht_ScanParam(p_extScanPhy->leCodedPhy.interval, p_extScanPhy->leCodedPhy.window, BLE_GAP_PHY_TYPE_LE_CODED);
+    }
+    return ht_ScanParam(p_extScanPhy->le1mPhy.interval, p_extScanPhy->le1mPhy.window, BLE_GAP_PHY_TYPE_LE_1M);
+}
+
+uint16_t BLE_GAP_SetExtScanningEnable(uint8_t mode, BLE_GAP_ExtScanningEnable_T *p_enable)
+{
+    (void)mode;
+    HT_CHECK_EQ(p_enable->period, 0);
+    //Extended durations are in 10 ms units; brought back to the 100 ms units of the legacy API
+    if ((p_enable->duration % 10U) != 0U)
+    {
+        s_htDurationUnitErrCnt++;
+    }
+    return ht_ScanEnable(p_enable->enable, (uint16_t)(p_enable->duration / 10U));
+}
+
+static void ht_Reset(void)
+{
+    memset(&s_htScan, 0, sizeof(s_htScan));
+    s_htEnableCnt = 0;
+    s_htDisableCnt = 0;
+    s_htParamWhileOnCnt = 0;
+    s_htDurationUnitErrCnt = 0;
+    s_htEnableResult = MBA_RES_SUCCESS;
+    ht_SetNow(1000000);
+    APP_SCAN_SCHED_Init();
+}
+
+static void ht_CheckStage(uint8_t stage, uint16_t duration)
+{
+    HT_CHECK(s_htScan.on);
+    HT_CHECK_EQ(s_htScan.window, APP_SCAN_SCHED_WINDOW);
+    HT_CHECK_EQ(s_htScan.interval, APP_SCAN_SCHED_WINDOW << stage);
+    HT_CHECK_EQ(s_htScan.duration, duration);
+    HT_CHECK_EQ(s_htScan.phy, APP_BLE_EXT_PHY);
+}
+
+/* Runs the current stage to its BLE_GAP_EVT_SCAN_TIMEOUT. */
+static void ht_Timeout(void)
+{
+    ht_SetNow(s_htScan.startUs + (uint64_t)s_htScan.duration * 100000U);
+    s_htScan.on = false;
+    APP_SCAN_SCHED_TimeoutHandler();
+}
+
+static void test_stages(void)
+{
+    static const uint16_t expDuration[] = { 20, 40, 80, 160, 320, 600, APP_SCAN_SCHED_BACKGROUND_DURATION };
+    APP_SCAN_SCHED_Stats_T stats;
+    uint32_t radioOnMs = 0;
+    uint64_t scanUs = 0;
+    uint8_t stage;
+
+    ht_Reset();
+    APP_SCAN_SCHED_StartBurst(BLE_DM_PEER_DEV_ID_INVALID);
+
+    for (stage = 0; stage <= APP_SCAN_SCHED_STAGE_MAX; stage++)
+    {
+        ht_CheckStage(stage, expDuration[stage]);
+        scanUs += (uint64_t)s_htScan.duration * 100000U;
+        radioOnMs += ((uint32_t)s_htScan.duration * 100U) >> stage;
+        ht_Timeout();
+    }
+
+    //The background stage is re-armed as is
+    ht_CheckStage(APP_SCAN_SCHED_STAGE_MAX, APP_SCAN_SCHED_BACKGROUND_DURATION);
+    ht_Timeout();
+    ht_CheckStage(APP_SCAN_SCHED_STAGE_MAX, APP_SCAN_SCHED_BACKGROUND_DURATION);
+    scanUs += APP_SCAN_SCHED_BACKGROUND_DURATION * 100000U;
+    radioOnMs += (APP_SCAN_SCHED_BACKGROUND_DURATION * 100U) >> APP_SCAN_SCHED_STAGE_MAX;
+
+    //Each stage is accounted at its own duty cycle
+    ht_SetNow(s_htScan.startUs);
+    APP_SCAN_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.scanMs, scanUs / 1000U);
+    HT_CHECK_EQ(stats.radioOnMs, radioOnMs);
+
+    //Every enable follows a disable, parameters never change under a running scan
+    HT_CHECK_EQ(s_htEnableCnt, APP_SCAN_SCHED_STAGE_MAX + 3U);
+    HT_CHECK_EQ(s_htDisableCnt, s_htEnableCnt);
+    HT_CHECK_EQ(s_htParamWhileOnCnt, 0);
+    HT_CHECK_EQ(s_htDurationUnitErrCnt, 0);
+
+    HT_CHECK_EQ(stats.stageCnt, APP_SCAN_SCHED_STAGE_MAX + 3U);
+    HT_CHECK_EQ(stats.reconnectCnt, 0);
+    HT_CHECK_EQ(stats.reconnectMedianMs, 0);
+}
+
+static void test_profile(void)
+{
+    APP_SCAN_SCHED_Profile_T profile;
+
+    ht_Reset();
+
+    //Rejected profiles leave the default in place
+    profile.firstStage = 2;
+    profile.lastStage = 4;
+    profile.baseDuration = 0;
+    HT_CHECK_EQ(APP_SCAN_SCHED_SetProfile(3, &profile), MBA_RES_INVALID_PARA);
+    profile.baseDuration = 10;
+    HT_CHECK_EQ(APP_SCAN_SCHED_SetProfile(BLE_DM_PEER_DEV_ID_INVALID, &profile), MBA_RES_INVALID_PARA);
+    HT_CHECK_EQ(APP_SCAN_SCHED_SetProfile(3, NULL), MBA_RES_INVALID_PARA);
+    profile.firstStage = 5;
+    HT_CHECK_EQ(APP_SCAN_SCHED_SetProfile(3, &profile), MBA_RES_INVALID_PARA);
+    profile.firstStage = 2;
+    profile.lastStage = APP_SCAN_SCHED_STAGE_MAX + 1U;
+    HT_CHECK_EQ(APP_SCAN_SCHED_SetProfile(3, &profile), MBA_RES_INVALID_PARA);
+    APP_SCAN_SCHED_StartBurst(3);
+    ht_CheckStage(0, APP_SCAN_SCHED_DEFAULT_BASE_DURATION);
+
+    profile.lastStage = 4;
+    HT_CHECK_EQ(APP_SCAN_SCHED_SetProfile(3, &profile), MBA_RES_SUCCESS);
+
+    //Device 3 bursts from stage 2, its base duration doubled per stage, into a stage 4 background
+    APP_SCAN_SCHED_StartBurst(3);
+    ht_CheckStage(2, 10);
+    ht_Timeout();
+    ht_CheckStage(3, 20);
+    ht_Timeout();
+    ht_CheckStage(4, APP_SCAN_SCHED_BACKGROUND_DURATION);
+    ht_Timeout();
+    ht_CheckStage(4, APP_SCAN_SCHED_BACKGROUND_DURATION);
+
+    //Other devices and unbonded peers keep the default
+    APP_SCAN_SCHED_StartBurst(2);
+    ht_CheckStage(0, APP_SCAN_SCHED_DEFAULT_BASE_DURATION);
+    APP_SCAN_SCHED_StartBurst(3);
+    ht_CheckStage(2, 10);
+    APP_SCAN_SCHED_StartBurst(BLE_DM_PEER_DEV_ID_INVALID);
+    ht_CheckStage(0, APP_SCAN_SCHED_DEFAULT_BASE_DURATION);
+
+    //The profile of the last burst also sets the background stage Resume falls back to
+    APP_SCAN_SCHED_StartBurst(3);
+    APP_SCAN_SCHED_Stop();
+    APP_SCAN_SCHED_Resume();
+    ht_CheckStage(4, APP_SCAN_SCHED_BACKGROUND_DURATION);
+
+    //Init brings every device back to the default
+    APP_SCAN_SCHED_Init();
+    APP_SCAN_SCHED_StartBurst(3);
+    ht_CheckStage(0, APP_SCAN_SCHED_DEFAULT_BASE_DURATION);
+    HT_CHECK_EQ(s_htParamWhileOnCnt, 0);
+}
+
+static void test_resume_stop(void)
+{
+    unsigned enableCnt;
+
+    ht_Reset();
+
+    //Resume before any burst scans in the background stage
+    APP_SCAN_SCHED_Resume();
+    ht_CheckStage(APP_SCAN_SCHED_STAGE_MAX, APP_SCAN_SCHED_BACKGROUND_DURATION);
+
+    //Resume while a burst runs keeps its stage and restarts the stage duration
+    APP_SCAN_SCHED_StartBurst(BLE_DM_PEER_DEV_ID_INVALID);
+    ht_Timeout();
+    ht_CheckStage(1, 40);
+    ht_SetNow(s_htNowUs + 1000000U);
+    APP_SCAN_SCHED_Resume();
+    ht_CheckStage(1, 40);
+    HT_CHECK_EQ(s_htScan.startUs, s_htNowUs);
+
+    //A timeout racing Stop does not restart scanning
+    APP_SCAN_SCHED_Stop();
+    HT_CHECK(!s_htScan.on);
+    enableCnt = s_htEnableCnt;
+    APP_SCAN_SCHED_TimeoutHandler();
+    HT_CHECK(!s_htScan.on);
+    HT_CHECK_EQ(s_htEnableCnt, enableCnt);
+
+    //A failed enable leaves the scheduler idle: timeouts are ignored, the next burst starts over
+    s_htEnableResult = MBA_RES_FAIL;
+    APP_SCAN_SCHED_StartBurst(BLE_DM_PEER_DEV_ID_INVALID);
+    HT_CHECK(!s_htScan.on);
+    APP_SCAN_SCHED_TimeoutHandler();
+    HT_CHECK(!s_htScan.on);
+    s_htEnableResult = MBA_RES_SUCCESS;
+    APP_SCAN_SCHED_StartBurst(BLE_DM_PEER_DEV_ID_INVALID);
+    ht_CheckStage(0, APP_SCAN_SCHED_DEFAULT_BASE_DURATION);
+    HT_CHECK_EQ(s_htParamWhileOnCnt, 0);
+}
+
+static void test_reconnect_stats(void)
+{
+    APP_SCAN_SCHED_Stats_T stats;
+    unsigned i;
+
+    ht_Reset();
+
+    //A connection without a pending loss is not a reconnect
+    APP_SCAN_SCHED_ConnectedHandler();
+    APP_SCAN_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.reconnectCnt, 0);
+
+    //Overlapping losses are timed from the first
+    APP_SCAN_SCHED_StartBurst(1);
+    ht_SetNow(s_htNowUs + 500000U);
+    APP_SCAN_SCHED_StartBurst(2);
+    ht_SetNow(s_htNowUs + 700000U);
+    APP_SCAN_SCHED_ConnectedHandler();
+    APP_SCAN_SCHED_ConnectedHandler();
+    APP_SCAN_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.reconnectCnt, 1);
+    HT_CHECK_EQ(stats.reconnectMedianMs, 1200);
+
+    //The median is over the last APP_SCAN_SCHED_RECONNECT_SAMPLES reconnects only
+    for (i = 0; i < APP_SCAN_SCHED_RECONNECT_SAMPLES * 2U; i++)
+    {
+        uint32_t ms = (i < APP_SCAN_SCHED_RECONNECT_SAMPLES) ? 100000U : (1000U + (i * 37U % 16U) * 100U);
+
+        APP_SCAN_SCHED_StartBurst(1);
+        ht_SetNow(s_htNowUs + (uint64_t)ms * 1000U);
+        APP_SCAN_SCHED_ConnectedHandler();
+    }
+    APP_SCAN_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.reconnectCnt, APP_SCAN_SCHED_RECONNECT_SAMPLES * 2U + 1U);
+    //16 samples, 1000 to 2500 ms in 100 ms steps: the upper median
+    HT_CHECK_EQ(stats.reconnectMedianMs, 1800);
+}
+
+// *****************************************************************************
+// Link loss simulation
+// *****************************************************************************
+typedef struct HT_Bucket_T
+{
+    const char  *label;
+    uint64_t    minUs;
+    uint64_t    maxUs;
+    unsigned    percent;            /* Share of the link losses */
+} HT_Bucket_T;
+
+typedef struct HT_Result_T
+{
+    uint32_t    reconnectMs[SIM_BUCKET_NUM][SIM_EPISODES];     /* Back in range to connected */
+    unsigned    num[SIM_BUCKET_NUM];
+    uint64_t    lossUs;             /* Time without a link */
+    uint64_t    radioOnUs;          /* Time inside scan windows */
+    uint64_t    missCnt;            /* Advertising events received in a window and lost */
+} HT_Result_T;
+
+static const HT_Bucket_T s_htBucket[SIM_BUCKET_NUM] =
+{
+    { "dropout  0-5s",    0U,         5000000U,    60 },
+    { "walk    5-60s",    5000000U,   60000000U,   25 },
+    { "away   1-30min",   60000000U,  1800000000U, 15 },
+};
+
+static HT_Result_T s_htSched;
+static HT_Result_T s_htFixed;
+
+/* Radio-on time of a scan running since startUs, up to endUs. */
+static uint64_t sim_RadioOn(uint64_t startUs, uint64_t endUs, uint64_t intervalUs, uint64_t windowUs)
+{
+    uint64_t elapsed = endUs - startUs;
+    uint64_t rem = elapsed % intervalUs;
+
+    return (elapsed / intervalUs) * windowUs + ((rem < windowUs) ? rem : windowUs);
+}
+
+static bool sim_InWindow(uint64_t us, uint64_t startUs, uint64_t intervalUs, uint64_t windowUs)
+{
+    return (us >= startUs) && (((us - startUs) % intervalUs) < windowUs);
+}
+
+/* Next advertising event of the reporter after the one at advUs, both since the link loss. */
+static uint64_t sim_NextAdv(uint64_t advUs)
+{
+    uint64_t interval = (advUs < SIM_FAST_US) ? SIM_FAST_INTERVAL_US : SIM_SLOW_INTERVAL_US;
+
+    return advUs + interval + (ht_Rand() % (SIM_ADV_DELAY_US + 1U));
+}
+
+static bool sim_Received(HT_Result_T *p_result)
+{
+    if ((ht_Rand() % 100U) < SIM_PACKET_LOSS)
+    {
+        p_result->missCnt++;
+        return false;
+    }
+    return true;
+}
+
+/* One link loss against the scheduler; the reporter is back in range at backUs after it. */
+static uint64_t sim_EpisodeSched(uint64_t lossUs, uint64_t backUs)
+{
+    uint64_t advUs = ht_Rand() % SIM_FAST_INTERVAL_US;
+    uint64_t radioOnUs = 0;
+
+    ht_SetNow(lossUs);
+    APP_SCAN_SCHED_StartBurst(0);
+
+    for (;;)
+    {
+        uint64_t startUs = s_htScan.startUs;
+        uint64_t intervalUs = (uint64_t)s_htScan.interval * 625U;
+        uint64_t windowUs = (uint64_t)s_htScan.window * 625U;
+        uint64_t endUs = startUs + (uint64_t)s_htScan.duration * 100000U;
+        uint64_t t = lossUs + advUs;
+
+        if (!s_htScan.on)
+        {
+            HT_CHECK(s_htScan.on);
+            return 0;
+        }
+
+        if (t >= endUs)
+        {
+            radioOnUs += sim_RadioOn(startUs, endUs, intervalUs, windowUs);
+            ht_Timeout();
+            continue;
+        }
+
+        if ((advUs >= backUs) && sim_InWindow(t, startUs, intervalUs, windowUs) && sim_Received(&s_htSched))
+        {
+            radioOnUs += sim_RadioOn(startUs, t, intervalUs, windowUs);
+            ht_SetNow(t + SIM_CONNECT_US);
+            APP_SCAN_SCHED_ConnectedHandler();
+            APP_SCAN_SCHED_Stop();
+            s_htSched.radioOnUs += radioOnUs;
+            s_htSched.lossUs += s_htNowUs - lossUs;
+            return s_htNowUs - lossUs;
+        }
+        advUs = sim_NextAdv(advUs);
+    }
+}
+
+/* The same link loss against the fixed 100 ms / 20 ms scan, running from the loss on. */
+static uint64_t sim_EpisodeFixed(uint64_t backUs)
+{
+    const uint64_t intervalUs = 160U * 625U;
+    const uint64_t windowUs = 32U * 625U;
+    uint64_t advUs = ht_Rand() % SIM_FAST_INTERVAL_US;
+
+    for (;;)
+    {
+        if ((advUs >= backUs) && sim_InWindow(advUs, 0, intervalUs, windowUs) && sim_Received(&s_htFixed))
+        {
+            uint64_t us = advUs + SIM_CONNECT_US;
+
+            s_htFixed.radioOnUs += sim_RadioOn(0, advUs, intervalUs, windowUs);
+            s_htFixed.lossUs += us;
+            return us;
+        }
+        advUs = sim_NextAdv(advUs);
+    }
+}
+
+static int sim_CmpU32(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+static uint32_t sim_Percentile(uint32_t *p_ms, unsigned num, unsigned percent)
+{
+    qsort(p_ms, num, sizeof(uint32_t), sim_CmpU32);
+    return p_ms[(num * percent) / 100U];
+}
+
+static void test_simulation(void)
+{
+    APP_SCAN_SCHED_Stats_T stats;
+    uint64_t lossUs;
+    uint32_t all[2][SIM_EPISODES];
+    unsigned allNum = 0;
+    unsigned i;
+    unsigned b;
+
+    ht_Reset();
+    ht_Seed(15);
+    memset(&s_htSched, 0, sizeof(s_htSched));
+    memset(&s_htFixed, 0, sizeof(s_htFixed));
+    lossUs = s_htNowUs;
+
+    for (i = 0; i < SIM_EPISODES; i++)
+    {
+        unsigned pick = ht_Rand() % 100U;
+        uint64_t backUs;
+        uint64_t schedUs;
+        uint64_t fixedUs;
+
+        for (b = 0; pick >= s_htBucket[b].percent; b++)
+        {
+            pick -= s_htBucket[b].percent;
+        }
+        backUs = s_htBucket[b].minUs + (ht_Rand() % (s_htBucket[b].maxUs - s_htBucket[b].minUs));
+
+        schedUs = sim_EpisodeSched(lossUs, backUs);
+        fixedUs = sim_EpisodeFixed(backUs);
+
+        //What the scan changes is the time from the reporter being back in range to the connection
+        s_htSched.reconnectMs[b][s_htSched.num[b]++] = (uint32_t)((schedUs - backUs) / 1000U);
+        s_htFixed.reconnectMs[b][s_htFixed.num[b]++] = (uint32_t)((fixedUs - backUs) / 1000U);
+        all[0][allNum] = (uint32_t)((schedUs - backUs) / 1000U);
+        all[1][allNum] = (uint32_t)((fixedUs - backUs) / 1000U);
+        allNum++;
+
+        //The link then stays up for a while
+        lossUs = s_htNowUs + 600000000U;
+    }
+
+    APP_SCAN_SCHED_GetStats(&stats);
+    HT_CHECK_EQ(stats.reconnectCnt, SIM_EPISODES);
+    //The estimate of the scheduler matches the windows it scanned. Links come up inside a window, so the
+    //simulation counts a little more there than the time x duty cycle estimate does.
+    HT_CHECK(llabs((long long)stats.radioOnMs - (long long)(s_htSched.radioOnUs / 1000U)) * 100 <= (long long)stats.radioOnMs);
+    HT_CHECK_EQ(s_htParamWhileOnCnt, 0);
+
+    printf("  %-16s %5s  %-21s %-21s\n", "absence", "num", "scheduler median/p90", "fixed median/p90");
+    for (b = 0; b < SIM_BUCKET_NUM; b++)
+    {
+        uint32_t schedMed = sim_Percentile(s_htSched.reconnectMs[b], s_htSched.num[b], 50);
+        uint32_t schedP90 = sim_Percentile(s_htSched.reconnectMs[b], s_htSched.num[b], 90);
+        uint32_t fixedMed = sim_Percentile(s_htFixed.reconnectMs[b], s_htFixed.num[b], 50);
+        uint32_t fixedP90 = sim_Percentile(s_htFixed.reconnectMs[b], s_htFixed.num[b], 90);
+
+        printf("  %-16s %5u  %7.1f/%-7.1f s     %7.1f/%-7.1f s\n", s_htBucket[b].label, s_htSched.num[b],
+               schedMed / 1000.0, schedP90 / 1000.0, fixedMed / 1000.0, fixedP90 / 1000.0);
+
+        //Short dropouts meet the full duty cycle first stage
+        if (b == 0U)
+        {
+            HT_CHECK(schedMed <= fixedMed);
+            HT_CHECK(schedP90 <= fixedP90);
+        }
+        //A reporter coming back after the burst waits for the background stage; with slow advertising one
+        //of every 64 events lands in a window
+        HT_CHECK(schedP90 <= 3U * (1U << APP_SCAN_SCHED_STAGE_MAX) * (SIM_SLOW_INTERVAL_US / 1000U));
+    }
+    printf("  %-16s %5u  %7.1f/%-7.1f s     %7.1f/%-7.1f s\n", "all", allNum,
+           sim_Percentile(all[0], allNum, 50) / 1000.0, sim_Percentile(all[0], allNum, 90) / 1000.0,
+           sim_Percentile(all[1], allNum, 50) / 1000.0, sim_Percentile(all[1], allNum, 90) / 1000.0);
+    printf("  radio-on per hour of link loss: scheduler %.1f s (%.2f%%), fixed %.1f s (%.2f%%)\n",
+           s_htSched.radioOnUs * 3600.0 / s_htSched.lossUs, s_htSched.radioOnUs * 100.0 / s_htSched.lossUs,
+           s_htFixed.radioOnUs * 3600.0 / s_htFixed.lossUs, s_htFixed.radioOnUs * 100.0 / s_htFixed.lossUs);
+    HT_CHECK(s_htSched.radioOnUs * 3U < s_htFixed.radioOnUs);
+}
+
+int main(void)
+{
+    test_stages();
+    test_profile();
+    test_resume_stop();
+    test_reconnect_stats();
+    test_simulation();
+    return ht_Finish(APP_BLE_EXT_API ? "test_scan_sched_ext" : "test_scan_sched");
+}
@@ -0,0 +1,616 @@
+/*
+ * Host test and benchmark of the app_timer wheel (app_timer.c) against a
+ * simulated FreeRTOS timer daemon.
+ *
+ * - Random: hundreds of nodes started, stopped and re-started with timeouts
+ *   spread over all four levels, from both the application and the node
+ *   callbacks, while the daemon applies driver commands and runs the driver
+ *   callback a few ticks late. Every expiry is checked against a reference
+ *   deadline: never early, never later than the daemon delays, never missed,
+ *   and never after a stop. Runs cross the 32 bit tick wrap.
+ * - Cascade: nodes landing on and around every level boundary expire on the
+ *   exact tick.
+ * - Stale wheel time: the wheel is only advanced by the driver, so after a
+ *   long quiet period its time lags the tick. Timers armed then, up to
+ *   APP_TIMER_MAX_TIMEOUT, must not be clamped or cascaded early.
+ * - Stats: accept delay, expiry lateness and daemon queue overflow counters.
+ * - Benchmark: arm, cancel and expire cost with many nodes pending.
+ */
+
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+
+#include "app_timer/app_timer.c"
+
+#define HT_NODE_NUM                 256
+#define HT_ACCEPT_MAX               4       /* Ticks the daemon may take to apply a driver command */
+#define HT_DAEMON_LATE_MAX          3       /* Ticks the daemon may take to run an expired driver timer */
+#define HT_LATE_BOUND               (HT_ACCEPT_MAX + HT_DAEMON_LATE_MAX + 1U)
+#define HT_CMD_MAX                  64
+#define RANDOM_ROUNDS               100000
+#define BENCH_NODE_NUM              1024
+#define BENCH_ROUNDS                200
+
+/* Simulated timer daemon: FIFO of driver commands, each applied some ticks after it was sent */
+typedef struct
+{
+    uint32_t    acceptTick;
+    uint32_t    period;
+} HT_Cmd_T;
+
+static uint8_t      s_htDriverObj;
+static HT_Cmd_T     s_htCmd[HT_CMD_MAX];
+static unsigned     s_htCmdHead;
+static unsigned     s_htCmdCnt;
+static bool         s_htDriverRunning;
+static uint32_t     s_htDriverExpiry;       /* Tick the running driver timer expires */
+static uint32_t     s_htDriverRunTick;      /* Tick the daemon gets round to its callback */
+static unsigned     s_htAcceptMax;
+static unsigned     s_htDaemonLateMax;
+static bool         s_htCmdFail;
+
+/* Reference model of each node */
+typedef struct
+{
+    APP_TIMER_Node_T    node;
+    bool                active;
+    bool                periodic;
+    uint32_t            deadline;
+    uint32_t            period;
+    unsigned            fireCnt;
+    uint32_t            lastFire;
+} HT_Timer_T;
+
+static HT_Timer_T   s_htTimer[HT_NODE_NUM];
+static unsigned     s_htEarlyCnt;
+static unsigned     s_htLateCnt;
+static unsigned     s_htStrayCnt;
+static unsigned     s_htMissCnt;
+static unsigned     s_htExpiresCnt;
+static uint32_t     s_htWorstLate;
+static bool         s_htCbOps;
+
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+TimerHandle_t xTimerCreate(const char * const pcTimerName, const TickType_t xTimerPeriodInTicks,
+                           const BaseType_t xAutoReload, void * const pvTimerID,
+                           TimerCallbackFunction_t pxCallbackFunction)
+{
+    (void)pcTimerName;
+    (void)xTimerPeriodInTicks;
+    (void)xAutoReload;
+    (void)pvTimerID;
+    (void)pxCallbackFunction;
+    return (TimerHandle_t)&s_htDriverObj;
+}
+
+BaseType_t xTimerGenericCommand(TimerHandle_t xTimer, const BaseType_t xCommandID, const TickType_t xOptionalValue,
+                                BaseType_t * const pxHigherPriorityTaskWoken, const TickType_t xTicksToWait)
+{
+    HT_Cmd_T *p_cmd;
+    uint32_t accept;
+
+    (void)xTimer;
+    (void)pxHigherPriorityTaskWoken;
+    (void)xTicksToWait;
+
+    if (s_htCmdFail || (s_htCmdCnt >= HT_CMD_MAX) || (xCommandID != tmrCOMMAND_CHANGE_PERIOD))
+    {
+        return pdFAIL;
+    }
+
+    //Commands are applied in order, so a late one holds back the ones behind it
+    accept = g_htTick + ((s_htAcceptMax != 0U) ? (ht_Rand() % (s_htAcceptMax + 1U)) : 0U);
+    if (s_htCmdCnt != 0U)
+    {
+        uint32_t prev = s_htCmd[(s_htCmdHead + s_htCmdCnt - 1U) % HT_CMD_MAX].acceptTick;
+
+        if ((int32_t)(accept - prev) < 0)
+        {
+            accept = prev;
+        }
+    }
+
+    p_cmd = &s_htCmd[(s_htCmdHead + s_htCmdCnt) % HT_CMD_MAX];
+    p_cmd->acceptTick = accept;
+    p_cmd->period = xOptionalValue;
+    s_htCmdCnt++;
+    return pdPASS;
+}
+
+TickType_t xTimerGetExpiryTime(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+    return s_htDriverExpiry;
+}
+
+static void ht_DaemonReset(void)
+{
+    s_htCmdHead = 0;
+    s_htCmdCnt = 0;
+    s_htDriverRunning = false;
+    s_htCmdFail = false;
+}
+
+/* Runs the daemon up to the target tick: applies commands and runs the driver callback as they fall due */
+static void ht_RunUntil(uint32_t target)
+{
+    for (;;)
+    {
+        bool haveCmd = (s_htCmdCnt != 0U);
+        uint32_t cmdTick = haveCmd ? s_htCmd[s_htCmdHead].acceptTick : 0U;
+
+        //Same tick: the daemon handles an expired timer before reading its command queue
+        if (s_htDriverRunning
+            && ((int32_t)(s_htDriverRunTick - target) <= 0)
+            && (!haveCmd || ((int32_t)(s_htDriverRunTick - cmdTick) <= 0)))
+        {
+            g_htTick = s_htDriverRunTick;
+            s_htDriverRunning = false;
+            app_timer_DriverExpiredHandle((TimerHandle_t)&s_htDriverObj);
+        }
+        else if (haveCmd && ((int32_t)(cmdTick - target) <= 0))
+        {
+            uint32_t period = s_htCmd[s_htCmdHead].period;
+
+            g_htTick = cmdTick;
+            s_htCmdHead = (s_htCmdHead + 1U) % HT_CMD_MAX;
+            s_htCmdCnt--;
+            s_htDriverRunning = true;
+            s_htDriverExpiry = g_htTick + period;
+            s_htDriverRunTick = s_htDriverExpiry
+                                + ((s_htDaemonLateMax != 0U) ? (ht_Rand() % (s_htDaemonLateMax + 1U)) : 0U);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    g_htTick = target;
+}
+
+static uint32_t ht_Ticks(uint32_t timeout)
+{
+    uint32_t ticks = timeout / portTICK_PERIOD_MS;
+
+    if (ticks == 0U)
+    {
+        ticks = 1;
+    }
+    return (ticks > APP_TIMER_WHEEL_MAX_TICKS) ? APP_TIMER_WHEEL_MAX_TICKS : ticks;
+}
+
+static void ht_Start(HT_Timer_T *p_timer, uint32_t timeout, bool periodic)
+{
+    HT_CHECK_EQ(APP_TIMER_NodeStart(&p_timer->node, timeout, periodic), APP_RES_SUCCESS);
+    p_timer->active = true;
+    p_timer->periodic = periodic;
+    p_timer->period = ht_Ticks(timeout);
+    p_timer->deadline = g_htTick + p_timer->period;
+}
+
+static void ht_Stop(HT_Timer_T *p_timer)
+{
+    APP_TIMER_NodeStop(&p_timer->node);
+    p_timer->active = false;
+}
+
+/* Timeouts spread evenly over the levels: a random bit length, then a random value of that length */
+static uint32_t ht_RandTimeout(void)
+{
+    unsigned bits = 1U + (ht_Rand() % 24U);
+
+    return (ht_Rand() & ((1UL << bits) - 1UL)) + 1UL;
+}
+
+static void ht_RandOp(void)
+{
+    HT_Timer_T *p_timer = &s_htTimer[ht_Rand() % HT_NODE_NUM];
+    uint32_t r = ht_Rand() % 16U;
+
+    if (r < 9U)
+    {
+        ht_Start(p_timer, ht_RandTimeout(), false);
+    }
+    else if (r < 10U)
+    {
+        //Periodic nodes get at least 100 ms so they do not flood the run
+        ht_Start(p_timer, 100U + (ht_Rand() % 5000U), true);
+    }
+    else if (r < 11U)
+    {
+        ht_Start(p_timer, APP_TIMER_MAX_TIMEOUT + (ht_Rand() % 2U) * 0x1000000U, false);
+    }
+    else
+    {
+        ht_Stop(p_timer);
+    }
+}
+
+static void ht_NodeCb(void *p_arg)
+{
+    HT_Timer_T *p_timer = (HT_Timer_T *)p_arg;
+    uint32_t late;
+
+    s_htExpiresCnt++;
+
+    if (!p_timer->active)
+    {
+        s_htStrayCnt++;
+        return;
+    }
+
+    late = g_htTick - p_timer->deadline;
+    if ((int32_t)late < 0)
+    {
+        s_htEarlyCnt++;
+    }
+    else
+    {
+        if (late > HT_LATE_BOUND)
+        {
+            s_htLateCnt++;
+        }
+        if (late > s_htWorstLate)
+        {
+            s_htWorstLate = late;
+        }
+    }
+
+    p_timer->fireCnt++;
+    p_timer->lastFire = g_htTick;
+
+    if (p_timer->periodic)
+    {
+        //Next deadline follows the previous one, or the next tick if that is already past
+        p_timer->deadline += p_timer->period;
+        if ((int32_t)(p_timer->deadline - g_htTick) <= 0)
+        {
+            p_timer->deadline = g_htTick + 1U;
+        }
+        if (p_timer->node.expires != p_timer->deadline)
+        {
+            s_htEarlyCnt++;
+        }
+    }
+    else
+    {
+        p_timer->active = false;
+    }
+
+    //Callbacks may start and stop any timer, including ones already collected in the same driver run
+    if (s_htCbOps && ((ht_Rand() % 8U) == 0U))
+    {
+        ht_RandOp();
+    }
+}
+
+/* A node the reference still expects and whose deadline is past every allowed delay was missed */
+static void ht_CheckMissed(void)
+{
+    unsigned i;
+
+    for (i = 0; i < HT_NODE_NUM; i++)
+    {
+        HT_Timer_T *p_timer = &s_htTimer[i];
+
+        if (p_timer->active && ((int32_t)(g_htTick - p_timer->deadline) > (int32_t)HT_LATE_BOUND))
+        {
+            s_htMissCnt++;
+            p_timer->active = false;
+        }
+        if (p_timer->active != APP_TIMER_NodeIsActive(&p_timer->node))
+        {
+            s_htMissCnt++;
+            p_timer->active = APP_TIMER_NodeIsActive(&p_timer->node);
+        }
+    }
+}
+
+static void ht_Reset(uint32_t tick, unsigned acceptMax, unsigned daemonLateMax)
+{
+    unsigned i;
+
+    g_htTick = tick;
+    ht_DaemonReset();
+    s_htAcceptMax = acceptMax;
+    s_htDaemonLateMax = daemonLateMax;
+    s_htEarlyCnt = 0;
+    s_htLateCnt = 0;
+    s_htStrayCnt = 0;
+    s_htMissCnt = 0;
+    s_htExpiresCnt = 0;
+    s_htWorstLate = 0;
+    s_htCbOps = false;
+    HT_CHECK_EQ(APP_TIMER_Init(), APP_RES_SUCCESS);
+
+    for (i = 0; i < HT_NODE_NUM; i++)
+    {
+        memset(&s_htTimer[i], 0, sizeof(HT_Timer_T));
+        APP_TIMER_NodeInit(&s_htTimer[i].node, ht_NodeCb, &s_htTimer[i]);
+    }
+}
+
+static void test_random(uint32_t seed, uint32_t startTick)
+{
+    APP_TIMER_Stats_T stats;
+    unsigned round;
+    unsigned i;
+
+    ht_Seed(seed);
+    ht_Reset(startTick, HT_ACCEPT_MAX, HT_DAEMON_LATE_MAX);
+    s_htCbOps = true;
+
+    for (round = 0; round < RANDOM_ROUNDS; round++)
+    {
+        //Mostly short steps, now and then a long quiet period that leaves the wheel time stale
+        uint32_t step = ((ht_Rand() % 256U) == 0U) ? (ht_Rand() % (1UL << 21)) : (ht_Rand() % 256U);
+
+        ht_RunUntil(g_htTick + step);
+        ht_CheckMissed();
+        ht_RandOp();
+    }
+
+    //Drain: stop the periodic nodes and let every one-shot fall due
+    for (i = 0; i < HT_NODE_NUM; i++)
+    {
+        if (s_htTimer[i].periodic)
+        {
+            ht_Stop(&s_htTimer[i]);
+        }
+    }
+    s_htCbOps = false;
+    ht_RunUntil(g_htTick + APP_TIMER_WHEEL_MAX_TICKS + HT_LATE_BOUND + 1U);
+    ht_CheckMissed();
+
+    for (i = 0; i < HT_NODE_NUM; i++)
+    {
+        HT_CHECK(!APP_TIMER_NodeIsActive(&s_htTimer[i].node));
+    }
+
+    APP_TIMER_GetStats(&stats);
+    printf("random seed 0x%08x from tick 0x%08x: %u expiries, worst lateness %u ticks, accept %u ticks\n",
+           (unsigned)seed, (unsigned)startTick, s_htExpiresCnt, (unsigned)s_htWorstLate,
+           (unsigned)stats.maxArmAcceptTicks);
+    HT_CHECK(s_htExpiresCnt > (RANDOM_ROUNDS / 4U));
+    HT_CHECK_EQ(s_htEarlyCnt, 0);
+    HT_CHECK_EQ(s_htLateCnt, 0);
+    HT_CHECK_EQ(s_htStrayCnt, 0);
+    HT_CHECK_EQ(s_htMissCnt, 0);
+    HT_CHECK_EQ(stats.expireCnt, s_htExpiresCnt);
+    HT_CHECK_EQ(stats.cmdFailCnt, 0);
+    HT_CHECK(stats.maxArmAcceptTicks <= HT_ACCEPT_MAX);
+    HT_CHECK(stats.maxExpiryLateTicks <= HT_LATE_BOUND);
+    HT_CHECK_EQ(stats.maxExpiryLateTicks, s_htWorstLate);
+}
+
+static void test_cascade(void)
+{
+    static const uint32_t dist[] =
+    {
+        1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 8191, 8192,
+        (1UL << 18) - 1UL, 1UL << 18, (1UL << 18) + 1UL, (1UL << 24) - 1UL - (1UL << 18),
+        APP_TIMER_WHEEL_MAX_TICKS - 1UL, APP_TIMER_WHEEL_MAX_TICKS,
+    };
+    static const uint32_t start[] =
+    {
+        0, 1, 62, 63, 64, 4095, 4096, (1UL << 18) - 1UL, (1UL << 24) - 1UL, 0xFFFFFFFFUL - 70UL, 0xFFFFFFFFUL,
+    };
+    unsigned s, d;
+
+    //Exact daemon: every node has to expire on its own tick, through as many cascades as its distance takes
+    for (s = 0; s < sizeof(start) / sizeof(start[0]); s++)
+    {
+        ht_Reset(start[s], 0, 0);
+
+        for (d = 0; d < sizeof(dist) / sizeof(dist[0]); d++)
+        {
+            ht_Start(&s_htTimer[d], dist[d], false);
+        }
+
+        ht_RunUntil(g_htTick + APP_TIMER_WHEEL_MAX_TICKS + 1U);
+
+        for (d = 0; d < sizeof(dist) / sizeof(dist[0]); d++)
+        {
+            HT_CHECK_EQ(s_htTimer[d].fireCnt, 1);
+            HT_CHECK_EQ(s_htTimer[d].lastFire, start[s] + dist[d]);
+        }
+        HT_CHECK_EQ(s_htEarlyCnt + s_htLateCnt + s_htStrayCnt, 0);
+    }
+}
+
+static void test_stale_now(void)
+{
+    static const uint32_t timeout[] = { 1, 10, 64, 5000, 1UL << 20, APP_TIMER_MAX_TIMEOUT - 1UL, APP_TIMER_MAX_TIMEOUT };
+    uint32_t quiet[] = { 1000, (1UL << 18) + 77U, (1UL << 23) + 12345U, APP_TIMER_WHEEL_MAX_TICKS - 5U };
+    unsigned q, t;
+
+    for (q = 0; q < sizeof(quiet) / sizeof(quiet[0]); q++)
+    {
+        for (t = 0; t < sizeof(timeout) / sizeof(timeout[0]); t++)
+        {
+            uint32_t arm;
+
+            //One far node keeps the driver asleep, so the wheel time stays where it was
+            ht_Reset(0xFFF00000UL + q * 4099U, 0, 0);
+            ht_Start(&s_htTimer[0], APP_TIMER_MAX_TIMEOUT, false);
+            ht_RunUntil(g_htTick + quiet[q]);
+            HT_CHECK(s_timerWheel.now != g_htTick);
+
+            arm = g_htTick;
+            ht_Start(&s_htTimer[1], timeout[t], false);
+            ht_RunUntil(arm + timeout[t] - 1U);
+            HT_CHECK_EQ(s_htTimer[1].fireCnt, 0);
+            ht_RunUntil(arm + timeout[t]);
+            HT_CHECK_EQ(s_htTimer[1].fireCnt, 1);
+            HT_CHECK_EQ(s_htTimer[1].lastFire, arm + timeout[t]);
+            HT_CHECK_EQ(s_htEarlyCnt, 0);
+        }
+    }
+}
+
+static void test_clamp(void)
+{
+    uint32_t arm;
+
+    //Timeouts past the wheel span expire at the span, as documented
+    ht_Reset(0x12345678UL, 0, 0);
+    arm = g_htTick;
+    APP_TIMER_NodeStart(&s_htTimer[0].node, 0xFFFFFFFFUL, false);
+    s_htTimer[0].active = true;
+    s_htTimer[0].deadline = arm + APP_TIMER_WHEEL_MAX_TICKS;
+    ht_RunUntil(arm + APP_TIMER_WHEEL_MAX_TICKS);
+    HT_CHECK_EQ(s_htTimer[0].fireCnt, 1);
+    HT_CHECK_EQ(s_htTimer[0].lastFire, arm + APP_TIMER_WHEEL_MAX_TICKS);
+
+    //Periodic nodes keep the clamped period
+    ht_Reset(0x12345678UL, 0, 0);
+    arm = g_htTick;
+    ht_Start(&s_htTimer[0], APP_TIMER_MAX_TIMEOUT * 2U, true);
+    ht_RunUntil(arm + 3U * APP_TIMER_WHEEL_MAX_TICKS);
+    HT_CHECK_EQ(s_htTimer[0].fireCnt, 3);
+    HT_CHECK_EQ(s_htTimer[0].lastFire, arm + 3U * APP_TIMER_WHEEL_MAX_TICKS);
+    HT_CHECK_EQ(s_htEarlyCnt + s_htLateCnt + s_htStrayCnt, 0);
+}
+
+static void test_stats(void)
+{
+    APP_TIMER_Stats_T stats;
+
+    //A command applied 3 ticks after it was sent; the deadline is in the current level 0 window, so one command covers it
+    ht_Reset(1024, 0, 0);
+    ht_Start(&s_htTimer[0], 30, false);
+    s_htCmd[s_htCmdHead].acceptTick += 3U;
+    s_htTimer[0].deadline += 3U;
+    ht_RunUntil(1100);
+    APP_TIMER_GetStats(&stats);
+    HT_CHECK_EQ(stats.armCnt, 1);
+    HT_CHECK_EQ(stats.expireCnt, 1);
+    HT_CHECK_EQ(stats.maxArmAcceptTicks, 3);
+    HT_CHECK_EQ(stats.maxExpiryLateTicks, 3);
+    HT_CHECK_EQ(s_htTimer[0].lastFire, 1057);
+
+    //A callback run 5 ticks after the driver expired
+    ht_Reset(1024, 0, 0);
+    ht_Start(&s_htTimer[0], 30, false);
+    ht_RunUntil(1024);
+    s_htDriverRunTick += 5U;
+    s_htTimer[0].deadline += 5U;
+    ht_RunUntil(1100);
+    APP_TIMER_GetStats(&stats);
+    HT_CHECK_EQ(stats.maxArmAcceptTicks, 0);
+    HT_CHECK_EQ(stats.maxExpiryLateTicks, 5);
+    HT_CHECK_EQ(s_htTimer[0].lastFire, 1059);
+
+    //A full daemon queue is counted, and the next arm programs the driver again
+    ht_Reset(1000, 0, 0);
+    s_htCmdFail = true;
+    ht_Start(&s_htTimer[0], 50, false);
+    s_htCmdFail = false;
+    APP_TIMER_GetStats(&stats);
+    HT_CHECK_EQ(stats.cmdFailCnt, 1);
+    HT_CHECK(!s_timerWheel.driverArmed);
+    ht_Start(&s_htTimer[1], 100, false);
+    ht_RunUntil(1200);
+    HT_CHECK_EQ(s_htTimer[0].fireCnt, 1);
+    HT_CHECK_EQ(s_htTimer[0].lastFire, 1050);
+    HT_CHECK_EQ(s_htTimer[1].lastFire, 1100);
+
+    //The fixed timer IDs post one APP_MSG_TIMER_EVT for any number of expiries
+    ht_Reset(1000, 0, 0);
+    ht_ClearMsg();
+    HT_CHECK_EQ(APP_TIMER_SetTimer(APP_TIMER_ID_0, 10, false), APP_RES_SUCCESS);
+    HT_CHECK_EQ(APP_TIMER_SetTimer(APP_TIMER_ID_1, 20, true), APP_RES_SUCCESS);
+    ht_RunUntil(1045);
+    HT_CHECK_EQ(g_htMsgCnt, 1);
+    HT_CHECK_EQ(g_htMsg[0].msgId, APP_MSG_TIMER_EVT);
+    HT_CHECK_EQ(APP_TIMER_GetExpired(), (1UL << APP_TIMER_ID_0) | (1UL << APP_TIMER_ID_1));
+    HT_CHECK(!APP_TIMER_IsTimerExisted(APP_TIMER_ID_0));
+    HT_CHECK(APP_TIMER_IsTimerExisted(APP_TIMER_ID_1));
+    HT_CHECK_EQ(APP_TIMER_StopTimer(APP_TIMER_ID_1), APP_RES_SUCCESS);
+    ht_RunUntil(1200);
+    HT_CHECK_EQ(g_htMsgCnt, 1);
+}
+
+static void bench(void)
+{
+    static HT_Timer_T s_bench[BENCH_NODE_NUM];
+    uint64_t armNs = 0, stopNs = 0, expireNs = 0, t0;
+    unsigned armCnt = 0, expireCnt = 0;
+    unsigned round, i;
+    unsigned wrongCnt = 0;
+    APP_TIMER_Stats_T stats;
+
+    ht_Seed(0xB0B0CAFEU);
+    ht_Reset(0, 0, 0);
+
+    for (i = 0; i < BENCH_NODE_NUM; i++)
+    {
+        APP_TIMER_NodeInit(&s_bench[i].node, NULL, NULL);
+    }
+
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        uint32_t timeout[BENCH_NODE_NUM];
+
+        for (i = 0; i < BENCH_NODE_NUM; i++)
+        {
+            timeout[i] = ht_RandTimeout();
+        }
+
+        t0 = ht_NowNs();
+        for (i = 0; i < BENCH_NODE_NUM; i++)
+        {
+            wrongCnt += (APP_TIMER_NodeStart(&s_bench[i].node, timeout[i], false) != APP_RES_SUCCESS);
+        }
+        armNs += ht_NowNs() - t0;
+        armCnt += BENCH_NODE_NUM;
+
+        //Cancel every other node, let the rest expire
+        t0 = ht_NowNs();
+        for (i = 0; i < BENCH_NODE_NUM; i += 2U)
+        {
+            APP_TIMER_NodeStop(&s_bench[i].node);
+        }
+        stopNs += ht_NowNs() - t0;
+
+        t0 = ht_NowNs();
+        ht_RunUntil(g_htTick + APP_TIMER_WHEEL_MAX_TICKS + 1U);
+        expireNs += ht_NowNs() - t0;
+        expireCnt += BENCH_NODE_NUM / 2U;
+
+        for (i = 0; i < BENCH_NODE_NUM; i++)
+        {
+            wrongCnt += APP_TIMER_NodeIsActive(&s_bench[i].node);
+        }
+    }
+
+    APP_TIMER_GetStats(&stats);
+    HT_CHECK_EQ(wrongCnt, 0);
+    HT_CHECK_EQ(stats.expireCnt, expireCnt);
+    printf("bench %u nodes: arm %.1f ns, cancel %.1f ns, expire %.1f ns per node incl. daemon simulation\n",
+           BENCH_NODE_NUM, (double)armNs / armCnt, (double)stopNs / (armCnt / 2U), (double)expireNs / expireCnt);
+}
+
+int main(void)
+{
+    test_cascade();
+    test_stale_now();
+    test_clamp();
+    test_stats();
+    test_random(0x1234567U, 0);
+    test_random(0x89ABCDEU, 0xFFFFFFFFUL - (1UL << 26));
+    test_random(0xDEADBEEU, 0x7FFFF000UL);
+    bench();
+    return ht_Finish("test_timer_wheel");
+}
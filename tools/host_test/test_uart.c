@@ -0,0 +1,315 @@
+/*
+ * Host test of the console transmit path (app_uart.c) against a simulated
+ * SERCOM0, built once against each app: build/test_uart for the monitor,
+ * build/test_uart_rep for the reporter.
+ *
+ * - Ordering: random writes interleaved with the UART draining, the line
+ *   carries exactly the accepted bytes in order.
+ * - Overflow: drop-newest keeps what was queued, drop-oldest keeps the
+ *   latest output; dropped bytes, overflows and high-water are counted.
+ * - Idle: APP_UART_IsTxIdle() stays false until the last character has left
+ *   the shift register (TXC), not only the ring buffer.
+ */
+
+#include "app.h"
+#include "definitions.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "app_uart/app_uart.h"
+
+/* The simulated peripheral replaces the register block and the NVIC */
+static sercom_registers_t s_htSercom;
+#undef SERCOM0_REGS
+#define SERCOM0_REGS                (&s_htSercom)
+#undef NVIC_SetPriority
+#define NVIC_SetPriority(irq, pri)  ((void)(irq), (void)(pri))
+#undef NVIC_EnableIRQ
+#define NVIC_EnableIRQ(irq)         ((void)(irq))
+
+static APP_UART_TxPolicy_T s_htPolicy = APP_UART_TX_POLICY_DROP_NEWEST;
+#undef APP_UART_TX_POLICY
+#define APP_UART_TX_POLICY          s_htPolicy
+
+#include "app_uart/app_uart.c"
+
+#define HT_DATA_EMPTY               (0xFFFFFFFFU)
+#define HT_CHAR_TICKS               3       /* Simulation steps to shift one character out */
+#define HT_LINE_MAX                 (64U * 1024U)
+#define ORDER_ROUNDS                20000
+
+/* Simulated SERCOM0: one holding register (DATA) in front of the shift register */
+static bool     s_htTxc;
+static unsigned s_htShiftTicks;                 /* 0: shift register idle */
+static uint8_t  s_htLine[HT_LINE_MAX];          /* Characters in the order they reach the line */
+static unsigned s_htLineLen;
+
+bool NVIC_INT_Disable(void)
+{
+    return true;
+}
+
+void NVIC_INT_Restore(bool state)
+{
+    (void)state;
+}
+
+bool SERCOM0_USART_TransmitComplete(void)
+{
+    return s_htTxc;
+}
+
+static void ht_UartReset(void)
+{
+    memset(&s_htSercom, 0, sizeof(s_htSercom));
+    s_htSercom.USART_INT.SERCOM_DATA = HT_DATA_EMPTY;
+    s_htSercom.USART_INT.SERCOM_INTFLAG = (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk;
+    s_htTxc = false;
+    s_htShiftTicks = 0;
+    s_htLineLen = 0;
+
+    s_uartTxInIdx = 0;
+    s_uartTxOutIdx = 0;
+    s_uartTxBusy = false;
+    APP_UART_Init();
+}
+
+static void ht_UartLoadShifter(void)
+{
+    uint32_t data = s_htSercom.USART_INT.SERCOM_DATA;
+
+    if ((s_htShiftTicks == 0U) && (data != HT_DATA_EMPTY))
+    {
+        if (s_htLineLen < HT_LINE_MAX)
+        {
+            s_htLine[s_htLineLen] = (uint8_t)data;
+        }
+        s_htLineLen++;
+        s_htShiftTicks = HT_CHAR_TICKS;
+        s_htSercom.USART_INT.SERCOM_DATA = HT_DATA_EMPTY;
+        s_htSercom.USART_INT.SERCOM_INTFLAG |= (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk;
+    }
+}
+
+/* One step of the peripheral: shift, then serve the DRE interrupt if it is pending */
+static void ht_UartStep(void)
+{
+    uint8_t intClr;
+
+    if (s_htShiftTicks != 0U)
+    {
+        s_htShiftTicks--;
+        if (s_htShiftTicks == 0U)
+        {
+            ht_UartLoadShifter();
+            if (s_htShiftTicks == 0U)
+            {
+                s_htTxc = true;
+            }
+        }
+    }
+
+    if (((s_htSercom.USART_INT.SERCOM_INTENSET & (uint8_t)SERCOM_USART_INT_INTENSET_DRE_Msk) != 0U)
+        && ((s_htSercom.USART_INT.SERCOM_INTFLAG & (uint8_t)SERCOM_USART_INT_INTFLAG_DRE_Msk) != 0U))
+    {
+        SERCOM0_Handler();
+
+        if (s_htSercom.USART_INT.SERCOM_DATA != HT_DATA_EMPTY)
+        {
+            s_htSercom.USART_INT.SERCOM_INTFLAG &= (uint8_t)~SERCOM_USART_INT_INTFLAG_DRE_Msk;
+            s_htTxc = false;
+            ht_UartLoadShifter();
+        }
+
+        //INTENCLR is write-one-to-clear on the device
+        intClr = s_htSercom.USART_INT.SERCOM_INTENCLR;
+        s_htSercom.USART_INT.SERCOM_INTENSET &= (uint8_t)~intClr;
+        s_htSercom.USART_INT.SERCOM_INTENCLR = 0;
+    }
+}
+
+static void ht_UartDrain(void)
+{
+    unsigned guard = 0;
+
+    while (!APP_UART_IsTxIdle() && (guard++ < (HT_LINE_MAX * (HT_CHAR_TICKS + 2U))))
+    {
+        ht_UartStep();
+    }
+}
+
+static void test_Ordering(void)
+{
+    static uint8_t expected[HT_LINE_MAX];
+    unsigned expectedLen = 0;
+    uint8_t chunk[96];
+    uint8_t seq = 0;
+    APP_UART_Stats_T stats;
+    size_t len, accepted;
+    unsigned round, i, steps;
+
+    ht_Seed(0x5EC0A0U);
+    s_htPolicy = APP_UART_TX_POLICY_DROP_NEWEST;
+    ht_UartReset();
+
+    for (round = 0; (round < ORDER_ROUNDS) && (expectedLen + sizeof(chunk) < HT_LINE_MAX); round++)
+    {
+        len = 1U + (ht_Rand() % sizeof(chunk));
+        for (i = 0; i < len; i++)
+        {
+            chunk[i] = seq++;
+        }
+
+        accepted = APP_UART_Write(chunk, len);
+        HT_CHECK(accepted <= len);
+        memcpy(&expected[expectedLen], chunk, accepted);
+        expectedLen += (unsigned)accepted;
+        //Bytes refused by drop-newest are never sent, keep the sequence contiguous
+        seq = (uint8_t)(seq - (len - accepted));
+
+        //Drain more slowly than the writer on average, so the buffer fills up now and then
+        steps = ht_Rand() % (unsigned)(len * HT_CHAR_TICKS);
+        for (i = 0; i < steps; i++)
+        {
+            ht_UartStep();
+        }
+    }
+
+    ht_UartDrain();
+    HT_CHECK(APP_UART_IsTxIdle());
+    HT_CHECK_EQ(APP_UART_GetPendingCnt(), 0);
+    HT_CHECK_EQ(s_htLineLen, expectedLen);
+    HT_CHECK(memcmp(s_htLine, expected, expectedLen) == 0);
+
+    APP_UART_GetStats(&stats);
+    HT_CHECK(stats.highWater <= APP_UART_TX_BUFFER_SIZE);
+    printf("ordering: %u bytes sent, %u dropped in %u overflows, high-water %u\n",
+        expectedLen, (unsigned)stats.droppedBytes, (unsigned)stats.overflowCnt, (unsigned)stats.highWater);
+}
+
+static void test_DropNewest(void)
+{
+    static uint8_t data[APP_UART_TX_BUFFER_SIZE + 100U];
+    APP_UART_Stats_T stats;
+    unsigned i;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 7U);
+    }
+
+    s_htPolicy = APP_UART_TX_POLICY_DROP_NEWEST;
+    ht_UartReset();
+
+    //Nothing drains while the interrupt is not served
+    HT_CHECK_EQ(APP_UART_Write(data, sizeof(data)), APP_UART_TX_BUFFER_SIZE);
+    HT_CHECK_EQ(APP_UART_Write(data, 10), 0);
+    HT_CHECK_EQ(APP_UART_GetPendingCnt(), APP_UART_TX_BUFFER_SIZE);
+
+    APP_UART_GetStats(&stats);
+    HT_CHECK_EQ(stats.droppedBytes, 110);
+    HT_CHECK_EQ(stats.overflowCnt, 2);
+    HT_CHECK_EQ(stats.highWater, APP_UART_TX_BUFFER_SIZE);
+
+    ht_UartDrain();
+    HT_CHECK_EQ(s_htLineLen, APP_UART_TX_BUFFER_SIZE);
+    HT_CHECK(memcmp(s_htLine, data, APP_UART_TX_BUFFER_SIZE) == 0);
+}
+
+static void test_DropOldest(void)
+{
+    static uint8_t data[APP_UART_TX_BUFFER_SIZE + 100U];
+    APP_UART_Stats_T stats;
+    unsigned i;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 13U);
+    }
+
+    s_htPolicy = APP_UART_TX_POLICY_DROP_OLDEST;
+    ht_UartReset();
+
+    //Half a buffer queued, then a full one: the first half and the oldest bytes of the second write go
+    HT_CHECK_EQ(APP_UART_Write(data, APP_UART_TX_BUFFER_SIZE / 2U), APP_UART_TX_BUFFER_SIZE / 2U);
+    HT_CHECK_EQ(APP_UART_Write(data, sizeof(data)), APP_UART_TX_BUFFER_SIZE);
+    HT_CHECK_EQ(APP_UART_GetPendingCnt(), APP_UART_TX_BUFFER_SIZE);
+
+    APP_UART_GetStats(&stats);
+    HT_CHECK_EQ(stats.droppedBytes, (APP_UART_TX_BUFFER_SIZE / 2U) + 100U);
+    HT_CHECK_EQ(stats.overflowCnt, 1);
+    HT_CHECK_EQ(stats.highWater, APP_UART_TX_BUFFER_SIZE);
+
+    ht_UartDrain();
+    HT_CHECK_EQ(s_htLineLen, APP_UART_TX_BUFFER_SIZE);
+    HT_CHECK(memcmp(s_htLine, &data[100], APP_UART_TX_BUFFER_SIZE) == 0);
+
+    //Partly full: only as many old bytes as needed are dropped
+    ht_UartReset();
+    HT_CHECK_EQ(APP_UART_Write(data, APP_UART_TX_BUFFER_SIZE - 4U), APP_UART_TX_BUFFER_SIZE - 4U);
+    HT_CHECK_EQ(APP_UART_Write(&data[APP_UART_TX_BUFFER_SIZE], 10), 10);
+    APP_UART_GetStats(&stats);
+    HT_CHECK_EQ(stats.droppedBytes, 6);
+    ht_UartDrain();
+    HT_CHECK_EQ(s_htLineLen, APP_UART_TX_BUFFER_SIZE);
+    HT_CHECK(memcmp(s_htLine, &data[6], APP_UART_TX_BUFFER_SIZE - 10U) == 0);
+    HT_CHECK(memcmp(&s_htLine[APP_UART_TX_BUFFER_SIZE - 10U], &data[APP_UART_TX_BUFFER_SIZE], 10) == 0);
+}
+
+static void test_IdleWaitsForTxc(void)
+{
+    unsigned guard = 0;
+
+    s_htPolicy = APP_UART_TX_POLICY_DROP_NEWEST;
+    ht_UartReset();
+
+    //Nothing sent since reset: idle although TXC was never set
+    HT_CHECK(APP_UART_IsTxIdle());
+
+    HT_CHECK_EQ(APP_UART_Write("AB", 2), 2);
+    HT_CHECK(!APP_UART_IsTxIdle());
+
+    //Run until the ring buffer is empty: the last character is still being shifted out
+    while ((APP_UART_GetPendingCnt() != 0U) && (guard++ < 100U))
+    {
+        ht_UartStep();
+    }
+    HT_CHECK_EQ(APP_UART_GetPendingCnt(), 0);
+    HT_CHECK(!s_htTxc);
+    HT_CHECK(!APP_UART_IsTxIdle());
+
+    guard = 0;
+    while (!s_htTxc && (guard++ < 100U))
+    {
+        ht_UartStep();
+    }
+    HT_CHECK(APP_UART_IsTxIdle());
+    HT_CHECK_EQ(s_htLineLen, 2);
+    HT_CHECK(memcmp(s_htLine, "AB", 2) == 0);
+
+    //The DRE interrupt is disabled once there is nothing left to send
+    ht_UartStep();
+    HT_CHECK((s_htSercom.USART_INT.SERCOM_INTENSET & (uint8_t)SERCOM_USART_INT_INTENSET_DRE_Msk) == 0U);
+
+    //A new write clears TXC on the first character
+    HT_CHECK_EQ(APP_UART_Write("C", 1), 1);
+    ht_UartStep();
+    HT_CHECK(!s_htTxc);
+    HT_CHECK(!APP_UART_IsTxIdle());
+    ht_UartDrain();
+    HT_CHECK(APP_UART_IsTxIdle());
+    HT_CHECK_EQ(s_htLineLen, 3);
+}
+
+int main(void)
+{
+    test_Ordering();
+    test_DropNewest();
+    test_DropOldest();
+    test_IdleWaitsForTxc();
+
+#ifndef HT_REPORTER
+    return ht_Finish("test_uart");
+#else
+    return ht_Finish("test_uart_rep");
+#endif
+}
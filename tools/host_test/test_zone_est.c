@@ -0,0 +1,591 @@
+/*
+ * Replay test of the RSSI zone estimator (app_zone_est.c).
+ *
+ * traces/zone_est_rssi.txt holds what BLE_GAP_GetRssi returns on each 20 ms
+ * sampling tick of one link. The controller refreshes the RSSI only once per
+ * effective connection event, interval x (1 + latency), so with relaxed
+ * connection parameters a reading repeats over many ticks. The trace holds
+ * those stale repeats as they are returned.
+ *
+ * - No stale repeat reaches the filter, whatever the connection parameters.
+ * - Steady segments (4 dB Gaussian RSSI noise around a 45 dB path loss) raise
+ *   no zone change; the first one is 100k samples at the 20 ms interval.
+ * - Step segments (45 <-> 70 dB) raise exactly one change. The detection
+ *   delay is reported in samples and ms per connection parameter set: about
+ *   12 samples (235 ms at the 20 ms interval) for 45 -> 70 dB.
+ * - The one-shot sampling timer is re-armed for the link due first: no
+ *   wakeup samples nothing, every link is sampled about once per effective
+ *   connection event, and the application task wakes up that often instead
+ *   of every 20 ms (once against 50 times a second with one 200 ms link at
+ *   latency 4, 46 with one 20 ms link, the handling jitter included). Sampling stops without monitored links, a new link is
+ *   sampled within 20 ms, and an expiry lost on a full queue is retried.
+ *
+ * The trace is generated with a fixed seed:
+ *     build/test_zone_est --gen > traces/zone_est_rssi.txt
+ */
+
+#include <math.h>
+#include "app.h"
+#include "host_test.h"
+#include "host_stub.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "app_ble/app_zone_est.c"
+
+#define TRACE_FILE                  "traces/zone_est_rssi.txt"
+#define HT_TICK_MS                  APP_ZONE_EST_SAMPLE_INTERVAL
+#define HT_JITTER_MAX               3       /* Ticks the application task may take to handle APP_MSG_RSSI_EVT */
+#define HT_NOISE_DB                 4.0
+#define HT_PARAM_SET_MAX            8
+#define HT_LINK_MAX                 2
+#define HT_WAKE_MS                  60000   /* Simulated time of each wakeup scenario */
+
+static APP_PXPM_Ctx_T   s_htCtx;
+static int8_t           s_htRssi;
+static unsigned         s_htRssiEvt;            /* Connection event the current reading comes from */
+static unsigned         s_htLastReadEvt = ~0U;
+static unsigned         s_htReadCnt;
+static unsigned         s_htRepeatCnt;
+static unsigned         s_htZoneChangeCnt;
+static APP_PXPM_Ctx_T   *s_htLink[HT_LINK_MAX] = { &s_htCtx };
+static unsigned         s_htLinkReadCnt[HT_LINK_MAX];
+static bool             s_htTimerActive;
+static bool             s_htTimerPeriodic;
+static uint32_t         s_htTimerTimeout;
+static TickType_t       s_htTimerStart;
+
+APP_PXPM_Ctx_T *APP_PXPM_CTX_GetByIndex(uint8_t index)
+{
+    return (index < HT_LINK_MAX) ? s_htLink[index] : NULL;
+}
+
+void APP_PXPM_CTX_StampZoneEvt(APP_PXPM_Ctx_T *p_ctx, uint32_t stamp)
+{
+    (void)p_ctx;
+    (void)stamp;
+}
+
+void APP_PXPM_CTX_SetZone(APP_PXPM_Ctx_T *p_ctx, uint8_t zone)
+{
+    p_ctx->zone = zone;
+    s_htZoneChangeCnt++;
+}
+
+void APP_LINK_OPT_Update(uint16_t connHandle, int8_t rssi)
+{
+    (void)connHandle;
+    (void)rssi;
+}
+
+void APP_CONN_POLICY_Update(uint16_t connHandle, bool zoneChanged)
+{
+    (void)connHandle;
+    (void)zoneChanged;
+}
+
+uint32_t RTC_Timer32CounterGet(void)
+{
+    return 0;
+}
+
+void APP_TIMER_NodeInit(APP_TIMER_Node_T *p_node, APP_TIMER_NodeCb_T cb, void *p_arg)
+{
+    (void)p_node;
+    (void)cb;
+    (void)p_arg;
+}
+
+uint16_t APP_TIMER_NodeStart(APP_TIMER_Node_T *p_node, uint32_t timeout, bool isPeriodicTimer)
+{
+    (void)p_node;
+    s_htTimerActive = true;
+    s_htTimerPeriodic = isPeriodicTimer;
+    s_htTimerTimeout = timeout;
+    s_htTimerStart = g_htTick;
+    return APP_RES_SUCCESS;
+}
+
+void APP_TIMER_NodeStop(APP_TIMER_Node_T *p_node)
+{
+    (void)p_node;
+    s_htTimerActive = false;
+}
+
+bool APP_TIMER_NodeIsActive(APP_TIMER_Node_T const *p_node)
+{
+    (void)p_node;
+    return s_htTimerActive;
+}
+
+uint16_t BLE_GAP_GetRssi(uint16_t connHandle, int8_t *p_rssi)
+{
+    s_htLinkReadCnt[connHandle % HT_LINK_MAX]++;
+    s_htReadCnt++;
+    if (s_htRssiEvt == s_htLastReadEvt)
+    {
+        s_htRepeatCnt++;
+    }
+    s_htLastReadEvt = s_htRssiEvt;
+    *p_rssi = s_htRssi;
+    return MBA_RES_SUCCESS;
+}
+
+/* Zone of a true path loss away from the thresholds, as the estimator should settle on it */
+static uint8_t ht_ZoneOf(int pathLoss)
+{
+    if (pathLoss > (APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD + APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS))
+    {
+        return APP_ZONE_EST_ZONE_HIGH;
+    }
+    if (pathLoss < (APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD - APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS))
+    {
+        return APP_ZONE_EST_ZONE_LOW;
+    }
+    return APP_ZONE_EST_ZONE_MIDDLE;
+}
+
+/* Generator: one link with the given parameters, sampled every tick; prints the readings run-length encoded */
+static unsigned s_genTokens;
+static int      s_genValue = -45;           /* Reading before the first connection event of a segment */
+
+static double gen_Gauss(void)
+{
+    double u1 = ((double)(ht_Rand() % 1000000U) + 0.5) / 1000000.0;
+    double u2 = ((double)(ht_Rand() % 1000000U) + 0.5) / 1000000.0;
+
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static void gen_Segment(const char *label, unsigned interval, unsigned latency, int pathLoss, unsigned ticks)
+{
+    double evtMs = interval * 1.25 * (1U + latency);
+    double nextEvtMs = evtMs * (double)(ht_Rand() % 1000U) / 1000.0;
+    unsigned tick;
+    unsigned run = 0;
+
+    printf("s %s %d\n", label, pathLoss);
+
+    for (tick = 0; tick < ticks; tick++)
+    {
+        double nowMs = (double)tick * HT_TICK_MS;
+        bool fresh = false;
+
+        //Latest effective connection event at or before this tick
+        while (nextEvtMs <= nowMs)
+        {
+            long rssi = -lround(pathLoss + HT_NOISE_DB * gen_Gauss());
+
+            s_genValue = (int)((rssi < -127) ? -127 : rssi);
+            nextEvtMs += evtMs;
+            fresh = true;
+        }
+
+        if (fresh || (run == 0U))
+        {
+            if (run > 1U)
+            {
+                printf("*%u", run);
+            }
+            if (run != 0U)
+            {
+                printf(((++s_genTokens % 24U) == 0U) ? "\n" : " ");
+            }
+            printf("%d", -s_genValue);
+            run = 0;
+        }
+        run++;
+    }
+
+    if (run > 1U)
+    {
+        printf("*%u", run);
+    }
+    printf("\n");
+    s_genTokens = 0;
+}
+
+static void gen_ParamSet(unsigned interval, unsigned latency, unsigned steadyTicks, unsigned stepNum)
+{
+    unsigned evtTicks = (unsigned)ceil(interval * 1.25 * (1U + latency) / HT_TICK_MS);
+    unsigned i;
+
+    printf("p %u %u\n", interval, latency);
+    gen_Segment("steady", interval, latency, 45, steadyTicks);
+
+    //A step holds 60 connection events, enough for the filter and the dwell count to settle
+    for (i = 0; i < stepNum; i++)
+    {
+        gen_Segment("step", interval, latency, 70, 60U * evtTicks);
+        gen_Segment("step", interval, latency, 45, 60U * evtTicks);
+    }
+}
+
+static void gen_Trace(void)
+{
+    ht_Seed(0x20E5E57U);
+    printf("# Zone estimator replay trace for test_zone_est.c, generated by test_zone_est --gen.\n");
+    printf("# One BLE_GAP_GetRssi reading per %u ms sampling tick, 4 dB Gaussian noise around the true path loss.\n",
+           HT_TICK_MS);
+    printf("# Tokens are -RSSI (dBm); <v>*<n> is a reading returned on n ticks, the controller only refreshes it\n");
+    printf("# once per effective connection event, interval x (1 + latency).\n");
+    printf("# p <interval, 1.25 ms> <latency>: connection parameters from here on.\n");
+    printf("# s <steady|step> <path loss>: segment of the given true path loss (dB), TX power 0 dBm.\n");
+    gen_ParamSet(16, 0, 100000, 20);
+    gen_ParamSet(40, 0, 20000, 10);
+    gen_ParamSet(80, 2, 15000, 10);
+    gen_ParamSet(160, 4, 10000, 5);
+}
+
+/* Replay */
+typedef struct
+{
+    unsigned    interval;
+    unsigned    latency;
+    unsigned    ticks;
+    unsigned    evts;
+    unsigned    reads;
+    unsigned    repeats;
+    unsigned    falseCnt;
+    unsigned    steadySamples;
+    unsigned    stepCnt[2];             /* [0]: 45 -> 70 dB, [1]: 70 -> 45 dB */
+    unsigned    stepDetectSum[2];       /* Samples */
+    unsigned    stepDetectMax[2];
+    unsigned    stepMissCnt;
+    unsigned    stepFlapCnt;
+} HT_ParamSet_T;
+
+static HT_ParamSet_T    s_htSet[HT_PARAM_SET_MAX];
+static unsigned         s_htSetNum;
+static unsigned         s_htTick = 1000;       /* Sampling ticks since boot */
+
+/* Segment state */
+static bool             s_htSegStep;
+static uint8_t          s_htSegZone;
+static unsigned         s_htSegChanges;
+static unsigned         s_htSegReads;
+static int              s_htSegDetect;
+
+static void ht_SegmentEnd(void)
+{
+    HT_ParamSet_T *p_set = &s_htSet[s_htSetNum - 1U];
+    unsigned changes = s_htZoneChangeCnt - s_htSegChanges;
+    unsigned dir = (s_htSegZone == APP_ZONE_EST_ZONE_HIGH) ? 0U : 1U;
+
+    if (!s_htSegStep)
+    {
+        p_set->falseCnt += changes;
+        p_set->steadySamples += s_htReadCnt - s_htSegReads;
+        return;
+    }
+
+    if (s_htSegDetect < 0)
+    {
+        p_set->stepMissCnt++;
+    }
+    else
+    {
+        p_set->stepCnt[dir]++;
+        p_set->stepDetectSum[dir] += (unsigned)s_htSegDetect;
+        if ((unsigned)s_htSegDetect > p_set->stepDetectMax[dir])
+        {
+            p_set->stepDetectMax[dir] = (unsigned)s_htSegDetect;
+        }
+    }
+    if (changes != 1U)
+    {
+        p_set->stepFlapCnt++;
+    }
+}
+
+static void ht_Sample(int rssi, unsigned run)
+{
+    HT_ParamSet_T *p_set = &s_htSet[s_htSetNum - 1U];
+    unsigned i;
+
+    s_htRssi = (int8_t)rssi;
+    s_htRssiEvt++;
+    p_set->evts++;
+
+    for (i = 0; i < run; i++)
+    {
+        unsigned reads = s_htReadCnt;
+        unsigned repeats = s_htRepeatCnt;
+
+        g_htTick = (TickType_t)(s_htTick * HT_TICK_MS + (ht_Rand() % (HT_JITTER_MAX + 1U)));
+        s_htTick++;
+        p_set->ticks++;
+        APP_ZONE_EST_SampleLinks();
+        p_set->reads += s_htReadCnt - reads;
+        p_set->repeats += s_htRepeatCnt - repeats;
+
+        if ((s_htSegDetect < 0) && (s_htCtx.zoneEst.zone == s_htSegZone))
+        {
+            s_htSegDetect = (int)(s_htReadCnt - s_htSegReads);
+        }
+    }
+}
+
+static bool ht_Replay(void)
+{
+    FILE *p_file = fopen(TRACE_FILE, "r");
+    char line[512];
+    bool inSeg = false;
+
+    if (p_file == NULL)
+    {
+        printf("cannot open %s\n", TRACE_FILE);
+        return false;
+    }
+
+    memset(&s_htCtx, 0, sizeof(s_htCtx));
+    s_htCtx.state = APP_PXPM_CTX_STATE_MONITORING;
+    s_htCtx.txPowerLevel = 0;
+    s_htCtx.pathLossParams.highThreshold = APP_PXPM_CTX_PATH_LOSS_HIGH_THRESHOLD;
+    s_htCtx.pathLossParams.highHysteresis = APP_PXPM_CTX_PATH_LOSS_HIGH_HYSTERESIS;
+    s_htCtx.pathLossParams.lowThreshold = APP_PXPM_CTX_PATH_LOSS_LOW_THRESHOLD;
+    s_htCtx.pathLossParams.lowHysteresis = APP_PXPM_CTX_PATH_LOSS_LOW_HYSTERESIS;
+    APP_ZONE_EST_Reset(&s_htCtx.zoneEst, APP_ZONE_EST_ZONE_MIDDLE);
+    ht_Seed(0x5A3B1E7U);
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        char *p_tok;
+        char label[16];
+        unsigned a, b;
+        int pathLoss;
+
+        if (line[0] == '#')
+        {
+            continue;
+        }
+
+        if (sscanf(line, "p %u %u", &a, &b) == 2)
+        {
+            if (inSeg)
+            {
+                ht_SegmentEnd();
+                inSeg = false;
+            }
+            if (s_htSetNum >= HT_PARAM_SET_MAX)
+            {
+                break;
+            }
+            memset(&s_htSet[s_htSetNum], 0, sizeof(HT_ParamSet_T));
+            s_htSet[s_htSetNum].interval = a;
+            s_htSet[s_htSetNum].latency = b;
+            s_htSetNum++;
+            s_htCtx.connInterval = (uint16_t)a;
+            s_htCtx.connLatency = (uint16_t)b;
+            continue;
+        }
+
+        if (sscanf(line, "s %15s %d", label, &pathLoss) == 2)
+        {
+            if (inSeg)
+            {
+                ht_SegmentEnd();
+            }
+            inSeg = true;
+            s_htSegStep = (strcmp(label, "step") == 0);
+            s_htSegZone = ht_ZoneOf(pathLoss);
+            s_htSegChanges = s_htZoneChangeCnt;
+            s_htSegReads = s_htReadCnt;
+            s_htSegDetect = -1;
+            continue;
+        }
+
+        for (p_tok = strtok(line, " \n"); p_tok != NULL; p_tok = strtok(NULL, " \n"))
+        {
+            char *p_run = strchr(p_tok, '*');
+
+            ht_Sample(-atoi(p_tok), (p_run != NULL) ? (unsigned)atoi(p_run + 1) : 1U);
+        }
+    }
+
+    if (inSeg)
+    {
+        ht_SegmentEnd();
+    }
+    fclose(p_file);
+    return true;
+}
+
+static void test_replay(void)
+{
+    unsigned i, dir;
+
+    HT_CHECK(ht_Replay());
+    HT_CHECK_EQ(s_htSetNum, 4);
+
+    printf("  interval latency  events samples repeats steady/false  detect avg/max, 45->70 dB   70->45 dB\n");
+    for (i = 0; i < s_htSetNum; i++)
+    {
+        HT_ParamSet_T *p_set = &s_htSet[i];
+        double sampleMs = (double)p_set->ticks * HT_TICK_MS / p_set->reads;
+
+        printf("  %5.1fms %7u %7u %7u %7u %7u/%-5u", p_set->interval * 1.25, p_set->latency, p_set->evts,
+               p_set->reads, p_set->repeats, p_set->steadySamples, p_set->falseCnt);
+
+        for (dir = 0; dir < 2U; dir++)
+        {
+            double avg = (double)p_set->stepDetectSum[dir] / p_set->stepCnt[dir];
+
+            printf("  %4.1f/%-2u samples %5.0f ms", avg, p_set->stepDetectMax[dir], avg * sampleMs);
+            //The delay in samples does not depend on the connection parameters. Leaving the high zone takes longer:
+            //the filter has to come down by the whole step plus the hysteresis before the dwell count starts.
+            HT_CHECK(avg <= ((dir == 0U) ? 13.0 : 19.0));
+            HT_CHECK(p_set->stepDetectMax[dir] <= ((dir == 0U) ? 15U : 24U));
+        }
+        printf("\n");
+
+        //Every sample is a fresh connection event, and most events are sampled
+        HT_CHECK_EQ(p_set->repeats, 0);
+        HT_CHECK(p_set->reads * 10U >= p_set->evts * 7U);
+        HT_CHECK_EQ(p_set->falseCnt, 0);
+        HT_CHECK_EQ(p_set->stepMissCnt, 0);
+        HT_CHECK_EQ(p_set->stepFlapCnt, 0);
+    }
+
+    //100k samples at the 20 ms interval without a false zone change
+    HT_CHECK(s_htSet[0].steadySamples >= 100000U);
+}
+
+/* Wakeups of the sampling timer */
+typedef struct
+{
+    const char  *name;
+    unsigned    linkNum;
+    uint16_t    interval[HT_LINK_MAX];
+    uint16_t    latency[HT_LINK_MAX];
+} HT_WakeSet_T;
+
+static const HT_WakeSet_T s_htWakeSet[] =
+{
+    { "20 ms",                      1, { 16 },      { 0 } },
+    { "50 ms",                      1, { 40 },      { 0 } },
+    { "100 ms lat 2",               1, { 80 },      { 2 } },
+    { "200 ms lat 4",               1, { 160 },     { 4 } },
+    { "20 ms + 200 ms lat 4",       2, { 16, 160 }, { 0, 4 } },
+    { "50 ms + 100 ms lat 2",       2, { 40, 80 },  { 0, 2 } },
+};
+
+static APP_PXPM_Ctx_T   s_htCtx2;
+
+/* Expiry of the sampling timer, then the application task handling APP_MSG_RSSI_EVT a few ticks later */
+static void ht_Wakeup(void)
+{
+    HT_CHECK(s_htTimerActive && !s_htTimerPeriodic);
+    g_htTick = s_htTimerStart + pdMS_TO_TICKS(s_htTimerTimeout);
+    s_htTimerActive = false;
+    app_zone_est_TimerExpired(NULL);
+    HT_CHECK_EQ(g_htMsgCnt, 1);
+    HT_CHECK_EQ(g_htMsg[0].msgId, APP_MSG_RSSI_EVT);
+    ht_ClearMsg();
+
+    g_htTick += ht_Rand() % (HT_JITTER_MAX + 1U);
+    APP_ZONE_EST_SampleLinks();
+}
+
+static void test_wakeups(void)
+{
+    unsigned i, l;
+
+    s_htLink[1] = &s_htCtx2;
+    ht_Seed(0x3A7E51U);
+
+    printf("  links                 wakeups/s was   now  samples/s per link\n");
+    for (i = 0; i < sizeof(s_htWakeSet) / sizeof(s_htWakeSet[0]); i++)
+    {
+        const HT_WakeSet_T *p_set = &s_htWakeSet[i];
+        TickType_t end;
+        unsigned wakeups = 0;
+        unsigned emptyCnt = 0;
+
+        for (l = 0; l < HT_LINK_MAX; l++)
+        {
+            memset(s_htLink[l], 0, sizeof(APP_PXPM_Ctx_T));
+            s_htLink[l]->connHandle = (uint16_t)l;
+            s_htLink[l]->connInterval = p_set->interval[l];
+            s_htLink[l]->connLatency = p_set->latency[l];
+            s_htLink[l]->state = (l < p_set->linkNum) ? APP_PXPM_CTX_STATE_MONITORING : APP_PXPM_CTX_STATE_CONNECTED;
+            APP_ZONE_EST_Reset(&s_htLink[l]->zoneEst, APP_ZONE_EST_ZONE_MIDDLE);
+            s_htLinkReadCnt[l] = 0;
+        }
+
+        g_htTick += 1000U;
+        s_htTimerActive = false;
+        APP_ZONE_EST_StartSampling();
+        HT_CHECK_EQ(s_htTimerTimeout, APP_ZONE_EST_SAMPLE_INTERVAL);
+
+        end = g_htTick + pdMS_TO_TICKS(HT_WAKE_MS);
+        while ((int32_t)(g_htTick - end) < 0)
+        {
+            unsigned reads = s_htReadCnt;
+
+            ht_Wakeup();
+            wakeups++;
+            if (s_htReadCnt == reads)
+            {
+                emptyCnt++;
+            }
+        }
+
+        printf("  %-20s  %13u  %4u ", p_set->name, 1000U / APP_ZONE_EST_SAMPLE_INTERVAL, wakeups * 1000U / HT_WAKE_MS);
+        HT_CHECK_EQ(emptyCnt, 0);
+        HT_CHECK(wakeups <= (HT_WAKE_MS / APP_ZONE_EST_SAMPLE_INTERVAL));
+
+        for (l = 0; l < p_set->linkNum; l++)
+        {
+            unsigned evtMs = (p_set->interval[l] * 5U * (1U + p_set->latency[l])) / 4U;
+            unsigned evts = HT_WAKE_MS / evtMs;
+
+            printf(" %5.1f", (double)s_htLinkReadCnt[l] * 1000.0 / HT_WAKE_MS);
+            //At most once per effective connection event, the handling jitter costs a few of them
+            HT_CHECK(s_htLinkReadCnt[l] * 10U >= evts * 8U);
+            HT_CHECK(s_htLinkReadCnt[l] <= evts + 1U);
+        }
+        printf("\n");
+    }
+
+    //No monitored link left: the pass stops sampling instead of re-arming
+    s_htCtx.state = APP_PXPM_CTX_STATE_CONNECTED;
+    s_htCtx2.state = APP_PXPM_CTX_STATE_CONNECTED;
+    ht_Wakeup();
+    HT_CHECK(!s_htTimerActive);
+
+    //A new link restarts it, and is sampled soon even while the timer waits for a slow link
+    s_htCtx.state = APP_PXPM_CTX_STATE_MONITORING;
+    APP_ZONE_EST_StartSampling();
+    HT_CHECK(s_htTimerActive);
+    ht_Wakeup();
+    HT_CHECK_EQ(s_htTimerTimeout, (s_htCtx.connInterval * 5U * (1U + s_htCtx.connLatency)) / 4U);
+    s_htCtx2.state = APP_PXPM_CTX_STATE_MONITORING;
+    APP_ZONE_EST_StartSampling();
+    HT_CHECK_EQ(s_htTimerTimeout, APP_ZONE_EST_SAMPLE_INTERVAL);
+
+    //An expiry that cannot be queued is retried
+    g_htQueueFull = true;
+    g_htTick = s_htTimerStart + pdMS_TO_TICKS(s_htTimerTimeout);
+    s_htTimerActive = false;
+    app_zone_est_TimerExpired(NULL);
+    g_htQueueFull = false;
+    HT_CHECK_EQ(g_htMsgCnt, 0);
+    HT_CHECK(s_htTimerActive);
+    ht_Wakeup();
+    HT_CHECK(s_htTimerActive);
+
+    s_htLink[1] = NULL;
+}
+
+int main(int argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "--gen") == 0))
+    {
+        gen_Trace();
+        return 0;
+    }
+
+    test_replay();
+    test_wakeups();
+    return ht_Finish("test_zone_est");
+}